@@ -0,0 +1,385 @@
+/****************************************************************************
+       Module: AGGREGATE.c
+     Engineer: agent
+  Description: Contains fixed memory rolling aggregates of the particle data.
+               Each second's sample is rolled up into minute, quarter hour
+               and hour buckets holding the minimum, maximum, sum and count,
+               so longer term figures are available without keeping the
+               individual samples.
+
+               Each level keeps a ring of its newest completed buckets: the
+               last AGGREGATE_SECONDS seconds, AGGREGATE_MINUTES minutes,
+               AGGREGATE_QUARTER_HOURS quarter hours and AGGREGATE_HOURS
+               hours. A bucket is filled as the level below completes its
+               buckets, and is moved into the ring once it holds a full ring
+               of them, so a roll-up never sums the ring below.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       A ring of completed buckets at each level.
+****************************************************************************/
+#include "includes.h"
+
+// Completed buckets kept at each level, indexed by TyAggregateLevel. A
+// bucket at each level above AGGREGATE_SECOND is made from a full ring of
+// the level below. An hour of one second low pulse times (up to 1000000us
+// each) fits in ulSum...
+static const unsigned char pucLocalRingSize[AGGREGATE_LEVEL_COUNT] = {AGGREGATE_SECONDS, AGGREGATE_MINUTES, AGGREGATE_QUARTER_HOURS, AGGREGATE_HOURS};
+
+// Start of each level's ring in ptyRings. A second holds a single sample,
+// so only its value is kept, in pulSeconds....
+static const unsigned short pusLocalRingStart[AGGREGATE_LEVEL_COUNT] = {0, 0, AGGREGATE_MINUTES, AGGREGATE_MINUTES + AGGREGATE_QUARTER_HOURS};
+
+#define AGGREGATE_RING_BUCKETS    (AGGREGATE_MINUTES + AGGREGATE_QUARTER_HOURS + AGGREGATE_HOURS)
+
+typedef struct
+{
+   // The completed seconds, and the completed buckets of the other levels...
+   unsigned long     pulSeconds[AGGREGATE_SECONDS];
+   TyAggregateBucket ptyRings[AGGREGATE_RING_BUCKETS];
+   // Index of the oldest completed bucket at each level, which the next one
+   // replaces, and the number of completed buckets held...
+   unsigned char     pucNext[AGGREGATE_LEVEL_COUNT];
+   unsigned char     pucHeld[AGGREGATE_LEVEL_COUNT];
+   // The bucket being filled at each level, and the number of buckets of
+   // the level below in it (there is no current second)...
+   TyAggregateBucket ptyCurrent[AGGREGATE_LEVEL_COUNT];
+   unsigned char     pucParts[AGGREGATE_LEVEL_COUNT];
+} TyAggregateChannel;
+
+static TyAggregateChannel ptyLocalChannels[AGGREGATE_CHANNEL_COUNT];
+
+
+/****************************************************************************
+     Function: AGGREGATE_ClearBucket
+     Engineer: agent
+        Input: TyAggregateBucket *ptyBucket: Bucket to clear.
+       Output: N/A
+  Description: Empties a bucket.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void AGGREGATE_ClearBucket(TyAggregateBucket *ptyBucket)
+{
+   ptyBucket->ulMinimum = 0xFFFFFFFF;
+   ptyBucket->ulMaximum = 0;
+   ptyBucket->ulSum     = 0;
+   ptyBucket->ulCount   = 0;
+}
+
+
+/****************************************************************************
+     Function: AGGREGATE_MergeBucket
+     Engineer: agent
+        Input: TyAggregateBucket *ptyInto: Bucket to merge into.
+               const TyAggregateBucket *ptyFrom: Bucket to merge.
+       Output: N/A
+  Description: Adds the samples of one bucket to another.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void AGGREGATE_MergeBucket(TyAggregateBucket *ptyInto, const TyAggregateBucket *ptyFrom)
+{
+   if (ptyFrom->ulMinimum < ptyInto->ulMinimum)
+      ptyInto->ulMinimum = ptyFrom->ulMinimum;
+   if (ptyFrom->ulMaximum > ptyInto->ulMaximum)
+      ptyInto->ulMaximum = ptyFrom->ulMaximum;
+
+   ptyInto->ulSum   += ptyFrom->ulSum;
+   ptyInto->ulCount += ptyFrom->ulCount;
+}
+
+
+/****************************************************************************
+     Function: AGGREGATE_SecondBucket
+     Engineer: agent
+        Input: unsigned long ulValue: One second sample.
+               TyAggregateBucket *ptyBucket: Storage for the bucket.
+       Output: N/A
+  Description: Makes the bucket of a second, which holds a single sample.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void AGGREGATE_SecondBucket(unsigned long ulValue, TyAggregateBucket *ptyBucket)
+{
+   ptyBucket->ulMinimum = ulValue;
+   ptyBucket->ulMaximum = ulValue;
+   ptyBucket->ulSum     = ulValue;
+   ptyBucket->ulCount   = 1;
+}
+
+
+/****************************************************************************
+     Function: AGGREGATE_Slot
+     Engineer: agent
+        Input: const TyAggregateChannel *ptyChannel: Channel.
+               unsigned char ucLevel: Level (TyAggregateLevel).
+               unsigned char ucAge: 0 for the newest completed bucket, 1 for
+                  the one before it and so on.
+       Output: unsigned char: Index of the bucket in its level's ring.
+  Description: Finds a completed bucket in a ring. The caller checks that
+               ucAge is less than the number held.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char AGGREGATE_Slot(const TyAggregateChannel *ptyChannel, unsigned char ucLevel, unsigned char ucAge)
+{
+   unsigned short usSlot;
+
+   usSlot = (unsigned short)ptyChannel->pucNext[ucLevel] + pucLocalRingSize[ucLevel] - 1 - ucAge;
+   if (usSlot >= pucLocalRingSize[ucLevel])
+      usSlot -= pucLocalRingSize[ucLevel];
+
+   return (unsigned char)usSlot;
+}
+
+
+/****************************************************************************
+     Function: AGGREGATE_Completed
+     Engineer: agent
+        Input: TyAggregateChannel *ptyChannel: Channel.
+               unsigned char ucLevel: Level (TyAggregateLevel).
+       Output: N/A
+  Description: Counts a bucket moved into the slot at pucNext, which moves
+               on to the next oldest.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void AGGREGATE_Completed(TyAggregateChannel *ptyChannel, unsigned char ucLevel)
+{
+   ptyChannel->pucNext[ucLevel]++;
+   if (ptyChannel->pucNext[ucLevel] >= pucLocalRingSize[ucLevel])
+      ptyChannel->pucNext[ucLevel] = 0;
+
+   if (ptyChannel->pucHeld[ucLevel] < pucLocalRingSize[ucLevel])
+      ptyChannel->pucHeld[ucLevel]++;
+}
+
+
+/****************************************************************************
+     Function: AGGREGATE_Initialise
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Empties all the buckets.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Empties the rings.
+****************************************************************************/
+void AGGREGATE_Initialise(void)
+{
+   unsigned char i, j;
+
+   for (i=0; i < AGGREGATE_CHANNEL_COUNT; i++)
+      {
+      for (j=0; j < AGGREGATE_LEVEL_COUNT; j++)
+         {
+         AGGREGATE_ClearBucket(&ptyLocalChannels[i].ptyCurrent[j]);
+         ptyLocalChannels[i].pucParts[j] = 0;
+         ptyLocalChannels[i].pucNext[j]  = 0;
+         ptyLocalChannels[i].pucHeld[j]  = 0;
+         }
+      }
+}
+
+
+/****************************************************************************
+     Function: AGGREGATE_AddSample
+     Engineer: agent
+        Input: unsigned char ucChannel: Channel (PPD42NJ_Px_CHANNEL)
+               unsigned long ulValue: One second sample.
+       Output: N/A
+  Description: Adds a one second sample, rolling completed buckets up to the
+               next level. Takes a fixed time however many levels complete.
+               Called from the PPD42NJ timer interrupt.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Completed buckets are kept in the rings.
+****************************************************************************/
+void AGGREGATE_AddSample(unsigned char ucChannel, unsigned long ulValue)
+{
+   unsigned char i;
+   TyAggregateChannel *ptyChannel;
+   TyAggregateBucket tyCompleted, *ptySlot;
+
+   if (ucChannel >= AGGREGATE_CHANNEL_COUNT)
+      return;
+
+   ptyChannel = &ptyLocalChannels[ucChannel];
+
+   ptyChannel->pulSeconds[ptyChannel->pucNext[AGGREGATE_SECOND]] = ulValue;
+   AGGREGATE_Completed(ptyChannel, AGGREGATE_SECOND);
+   AGGREGATE_SecondBucket(ulValue, &tyCompleted);
+
+   // Roll up through the levels until one is not yet complete....
+   for (i=AGGREGATE_MINUTE; i < AGGREGATE_LEVEL_COUNT; i++)
+      {
+      AGGREGATE_MergeBucket(&ptyChannel->ptyCurrent[i], &tyCompleted);
+      ptyChannel->pucParts[i]++;
+
+      if (ptyChannel->pucParts[i] < pucLocalRingSize[i - 1])
+         break;
+
+      tyCompleted = ptyChannel->ptyCurrent[i];
+
+      ptySlot  = &ptyChannel->ptyRings[pusLocalRingStart[i] + ptyChannel->pucNext[i]];
+      *ptySlot = tyCompleted;
+      AGGREGATE_Completed(ptyChannel, i);
+
+      AGGREGATE_ClearBucket(&ptyChannel->ptyCurrent[i]);
+      ptyChannel->pucParts[i] = 0;
+      }
+}
+
+
+/****************************************************************************
+     Function: AGGREGATE_GetBucket
+     Engineer: agent
+        Input: const TyAggregateBucket *ptySource: Bucket to copy.
+               TyAggregateBucket *ptyBucket: Storage for the copy.
+       Output: TRUE: Bucket holds samples, FALSE: Bucket is empty.
+  Description: Copies a bucket with interrupts disabled, so that the copy is
+               not split by the timer interrupt.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char AGGREGATE_GetBucket(const TyAggregateBucket *ptySource, TyAggregateBucket *ptyBucket)
+{
+   tBoolean bInterruptsDisabled;
+
+   bInterruptsDisabled = MAP_IntMasterDisable();
+   *ptyBucket = *ptySource;
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+
+   return (ptyBucket->ulCount != 0) ? TRUE : FALSE;
+}
+
+
+/****************************************************************************
+     Function: AGGREGATE_GetCompleted
+     Engineer: agent
+        Input: unsigned char ucChannel: Channel (PPD42NJ_Px_CHANNEL)
+               TyAggregateLevel tyLevel: Level of the bucket.
+               unsigned char ucAge: 0 for the newest completed bucket, 1 for
+                  the one before it and so on.
+               TyAggregateBucket *ptyBucket: Storage for the bucket.
+       Output: TRUE: Success, FALSE: Failure (invalid or not held).
+  Description: Returns a completed bucket at a level, e.g. the last whole
+               minute (ucAge 0) or the one before it (ucAge 1).
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Any of the buckets held in the ring.
+****************************************************************************/
+unsigned char AGGREGATE_GetCompleted(unsigned char ucChannel, TyAggregateLevel tyLevel, unsigned char ucAge, TyAggregateBucket *ptyBucket)
+{
+   unsigned char bHeld;
+   tBoolean bInterruptsDisabled;
+   const TyAggregateChannel *ptyChannel;
+
+   if ((ucChannel >= AGGREGATE_CHANNEL_COUNT) || (tyLevel >= AGGREGATE_LEVEL_COUNT) || (ptyBucket == NULL))
+      return FALSE;
+
+   ptyChannel = &ptyLocalChannels[ucChannel];
+
+   bInterruptsDisabled = MAP_IntMasterDisable();
+
+   bHeld = (ucAge < ptyChannel->pucHeld[tyLevel]) ? TRUE : FALSE;
+   if (bHeld)
+      {
+      if (tyLevel == AGGREGATE_SECOND)
+         AGGREGATE_SecondBucket(ptyChannel->pulSeconds[AGGREGATE_Slot(ptyChannel, tyLevel, ucAge)], ptyBucket);
+      else
+         *ptyBucket = ptyChannel->ptyRings[pusLocalRingStart[tyLevel] + AGGREGATE_Slot(ptyChannel, tyLevel, ucAge)];
+      }
+
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+
+   return bHeld;
+}
+
+
+/****************************************************************************
+     Function: AGGREGATE_GetCurrent
+     Engineer: agent
+        Input: unsigned char ucChannel: Channel (PPD42NJ_Px_CHANNEL)
+               TyAggregateLevel tyLevel: Level of the bucket.
+               TyAggregateBucket *ptyBucket: Storage for the bucket.
+       Output: TRUE: Success, FALSE: Failure (invalid or bucket empty).
+  Description: Returns the bucket being filled at a level, e.g. the minute
+               so far. This only includes the completed buckets of the level
+               below, so the quarter hour so far is made up of whole minutes.
+               There is no current bucket at the AGGREGATE_SECOND level.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char AGGREGATE_GetCurrent(unsigned char ucChannel, TyAggregateLevel tyLevel, TyAggregateBucket *ptyBucket)
+{
+   if ((ucChannel >= AGGREGATE_CHANNEL_COUNT) || (tyLevel >= AGGREGATE_LEVEL_COUNT) || (ptyBucket == NULL))
+      return FALSE;
+
+   return AGGREGATE_GetBucket(&ptyLocalChannels[ucChannel].ptyCurrent[tyLevel], ptyBucket);
+}
+
+
+/****************************************************************************
+     Function: AGGREGATE_GetMean
+     Engineer: agent
+        Input: unsigned char ucChannel: Channel (PPD42NJ_Px_CHANNEL)
+               TyAggregateLevel tyLevel: Level of the buckets.
+               unsigned char ucBuckets: Number of the newest completed
+                  buckets to take the mean over.
+               unsigned long *pulMean: Storage for the mean.
+       Output: TRUE: Success, FALSE: Failure (invalid or fewer held).
+  Description: Returns the mean one second sample over the newest completed
+               buckets at a level, e.g. the last hour from the last 4
+               quarter hours. The sum is 64 bit, so any number of hours can
+               be taken. Interrupts are disabled while the buckets are
+               summed, which is at most AGGREGATE_HOURS of them.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char AGGREGATE_GetMean(unsigned char ucChannel, TyAggregateLevel tyLevel, unsigned char ucBuckets, unsigned long *pulMean)
+{
+   unsigned char i, bHeld;
+   unsigned long ulCount;
+   unsigned long long ullSum;
+   tBoolean bInterruptsDisabled;
+   const TyAggregateChannel *ptyChannel;
+   const TyAggregateBucket *ptyBucket;
+
+   if ((ucChannel >= AGGREGATE_CHANNEL_COUNT) || (tyLevel >= AGGREGATE_LEVEL_COUNT) || (ucBuckets == 0) || (pulMean == NULL))
+      return FALSE;
+
+   ptyChannel = &ptyLocalChannels[ucChannel];
+   ullSum     = 0;
+   ulCount    = 0;
+
+   bInterruptsDisabled = MAP_IntMasterDisable();
+
+   bHeld = (ucBuckets <= ptyChannel->pucHeld[tyLevel]) ? TRUE : FALSE;
+   for (i=0; bHeld && (i < ucBuckets); i++)
+      {
+      if (tyLevel == AGGREGATE_SECOND)
+         {
+         ullSum += ptyChannel->pulSeconds[AGGREGATE_Slot(ptyChannel, tyLevel, i)];
+         ulCount++;
+         }
+      else
+         {
+         ptyBucket = &ptyChannel->ptyRings[pusLocalRingStart[tyLevel] + AGGREGATE_Slot(ptyChannel, tyLevel, i)];
+         ullSum  += ptyBucket->ulSum;
+         ulCount += ptyBucket->ulCount;
+         }
+      }
+
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+
+   if (bHeld == FALSE)
+      return FALSE;
+
+   *pulMean = (unsigned long)(ullSum / ulCount);
+
+   return TRUE;
+}
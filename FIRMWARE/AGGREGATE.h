@@ -0,0 +1,60 @@
+/****************************************************************************
+       Module: AGGREGATE.h
+     Engineer: agent
+  Description: Contains the types and function prototypes for the rolling
+               aggregates of the particle data.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       One channel per PPD42NJ channel.
+17-OCT-2026    agent       A ring of completed buckets at each level. Added
+                           AGGREGATE_GetMean.
+****************************************************************************/
+
+// Channels aggregated (the PPD42NJ low pulse times, indexed by
+// PPD42NJ_P1_CHANNEL / PPD42NJ_P2_CHANNEL)...
+#define AGGREGATE_CHANNEL_COUNT   PPD42NJ_CHANNEL_COUNT
+
+// Each level is rolled up from the level below it: 60 seconds make a minute,
+// 15 minutes make a quarter hour and 4 quarter hours make an hour. Each
+// level keeps a ring of its newest completed buckets, so a bucket is made
+// from a full ring of the level below.
+typedef enum
+{
+   AGGREGATE_SECOND       = 0,
+   AGGREGATE_MINUTE       = 1,
+   AGGREGATE_QUARTER_HOUR = 2,
+   AGGREGATE_HOUR         = 3
+} TyAggregateLevel;
+
+#define AGGREGATE_LEVEL_COUNT     4
+
+// Completed buckets kept at each level. The number of hours can be set for
+// the build (e.g. --define=AGGREGATE_HOURS=48).
+#define AGGREGATE_SECONDS         60
+#define AGGREGATE_MINUTES         15
+#define AGGREGATE_QUARTER_HOURS   4
+
+#ifndef AGGREGATE_HOURS
+#define AGGREGATE_HOURS           24
+#endif
+
+#if (AGGREGATE_HOURS < 1) || (AGGREGATE_HOURS > 255)
+#error AGGREGATE_HOURS must be 1 to 255.
+#endif
+
+// One bucket of samples. The mean is ulSum / ulCount.
+typedef struct
+{
+   unsigned long ulMinimum;
+   unsigned long ulMaximum;
+   unsigned long ulSum;
+   unsigned long ulCount;    // Number of one second samples.
+} TyAggregateBucket;
+
+
+// Function prototypes from the AGGREGATE module...
+void AGGREGATE_Initialise(void);
+void AGGREGATE_AddSample(unsigned char ucChannel, unsigned long ulValue);
+unsigned char AGGREGATE_GetCompleted(unsigned char ucChannel, TyAggregateLevel tyLevel, unsigned char ucAge, TyAggregateBucket *ptyBucket);
+unsigned char AGGREGATE_GetCurrent(unsigned char ucChannel, TyAggregateLevel tyLevel, TyAggregateBucket *ptyBucket);
+unsigned char AGGREGATE_GetMean(unsigned char ucChannel, TyAggregateLevel tyLevel, unsigned char ucBuckets, unsigned long *pulMean);
@@ -1,62 +1,457 @@
 /****************************************************************************
        Module: DELAY.c
      Engineer: Martin Hannon
-  Description: Contains an accurate delay routine.
+  Description: Contains an accurate delay routine, a millisecond time base
+               and software timers.
 Date           Initials    Description
 16-DEC-2016    MH          Initial
+17-OCT-2026    agent       Moved from TIMERA1 to TIMERA3.
+17-OCT-2026    agent       Added the SysTick millisecond time base and
+                           scheduled callbacks.
+17-OCT-2026    agent       Replaced the scheduled callbacks with a sorted
+                           list of one shot and periodic software timers.
+                           TIMER_Delay counts SysTick ticks, so TIMERA3 is
+                           no longer used.
+17-OCT-2026    agent       Added tickless sleep and the idle time measurement.
+17-OCT-2026    agent       Optionally profiles the SysTick interrupt.
+17-OCT-2026    agent       The millisecond arithmetic is masked to 32 bits,
+                           and the count starts a minute before it wraps.
 ****************************************************************************/
 #include "includes.h"
+#include "systick.h"
+#include "hw_nvic.h"
 
 #define SYSTEM_CLOCK_SPEED 80 // Mhz
 
-static volatile unsigned char bLocalDelayElapsed;
+// SysTick reload value for a 1ms tick...
+#define SYSTICK_PERIOD     (SYSTEM_CLOCK_SPEED * 1000)
+
+// SysTick is 24 bits, which is 209ms at 80MHz. This limits the length of a
+// tickless sleep...
+#define TIMER_MAX_SLEEP_TICKS 200
+
+// The tick is not suppressed if the current tick is within this many SysTick
+// counts of ending, as it could end before the SysTick has been reloaded...
+#define TIMER_SLEEP_MARGIN    (SYSTEM_CLOCK_SPEED * 10) // 10 microseconds
+
+static volatile unsigned long ulLocalMilliseconds;
+
+// Number of milliseconds represented by the next SysTick interrupt. This is
+// more than one at the end of a tickless sleep...
+static volatile unsigned long ulLocalTicksPending;
+
+// Running timers, in order of expiry...
+static TySoftwareTimer       *ptyLocalTimers;
+
+// Idle time measurement...
+static unsigned long          ulLocalIdleCycles;       // Part millisecond
+static unsigned long          ulLocalIdleMilliseconds;
+static unsigned long          ulLocalIdleStart;        // Milliseconds
+
 
 /****************************************************************************
-     Function: DELAY_TimerInterrupt
+     Function: TIMER_Delay
      Engineer: Martin Hannon
+        Input: unsigned long ulDelay: Delay time in us.
+       Output: N/A
+  Description: Delays for the specified time. TIMER_Initialise must have been
+               called first. The SysTick count is polled, so this also works
+               with interrupts disabled.
+Date           Initials    Description
+05-DEC-2016    MH          Initial
+17-OCT-2026    agent       Counts SysTick ticks rather than starting a timer.
+****************************************************************************/
+void TIMER_Delay(unsigned long ulDelay)
+{
+   unsigned long ulRemaining, ulLast, ulNow, ulElapsed;
+
+   // SysTick clocks in 12.5ns ticks (or 1/80 of a microsecond)
+   ulRemaining = ulDelay * SYSTEM_CLOCK_SPEED;
+
+   ulLast = MAP_SysTickValueGet();
+
+   while (ulRemaining > 0)
+      {
+      // SysTick counts down and reloads every millisecond...
+      ulNow = MAP_SysTickValueGet();
+      if (ulNow <= ulLast)
+         ulElapsed = ulLast - ulNow;
+      else
+         ulElapsed = ulLast + SYSTICK_PERIOD - ulNow;
+      ulLast = ulNow;
+
+      if (ulElapsed >= ulRemaining)
+         ulRemaining = 0;
+      else
+         ulRemaining -= ulElapsed;
+      }
+}
+
+
+/****************************************************************************
+     Function: TIMER_Insert
+     Engineer: agent
+        Input: TySoftwareTimer *ptyTimer: Timer to add.
+       Output: N/A
+  Description: Adds a timer to the list in order of expiry, after any timers
+               with the same expiry. Interrupts must be disabled.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void TIMER_Insert(TySoftwareTimer *ptyTimer)
+{
+   TySoftwareTimer **pptyLink;
+
+   pptyLink = &ptyLocalTimers;
+   while ((*pptyLink != NULL) && (TIMER_DIFF((*pptyLink)->ulExpiry, ptyTimer->ulExpiry) <= 0))
+      {
+      pptyLink = &(*pptyLink)->ptyNext;
+      }
+
+   ptyTimer->ptyNext = *pptyLink;
+   *pptyLink = ptyTimer;
+}
+
+
+/****************************************************************************
+     Function: TIMER_Remove
+     Engineer: agent
+        Input: TySoftwareTimer *ptyTimer: Timer to remove.
+       Output: N/A
+  Description: Removes a timer from the list, if it is in it. Interrupts must
+               be disabled.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void TIMER_Remove(TySoftwareTimer *ptyTimer)
+{
+   TySoftwareTimer **pptyLink;
+
+   pptyLink = &ptyLocalTimers;
+   while (*pptyLink != NULL)
+      {
+      if (*pptyLink == ptyTimer)
+         {
+         *pptyLink = ptyTimer->ptyNext;
+         break;
+         }
+      pptyLink = &(*pptyLink)->ptyNext;
+      }
+
+   ptyTimer->ptyNext  = NULL;
+   ptyTimer->bRunning = FALSE;
+}
+
+
+/****************************************************************************
+     Function: DELAY_SysTickInterrupt
+     Engineer: agent
         Input: N/A
        Output: N/A
-  Description: Interrupt handler for the DELAY timer interrupt
+  Description: Interrupt handler for the SysTick interrupt. Advances the
+               millisecond count and invokes the callbacks of any timers
+               which have expired.
 Date           Initials    Description
-16-DEC-2016    MH          Initial
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Only the head of the timer list is checked.
+17-OCT-2026    agent       Accounts for the ticks of a tickless sleep.
+17-OCT-2026    agent       Optionally profiled. The counter reloads on the
+                           tick, so its count down so far is the latency.
 ****************************************************************************/
-static void DELAY_TimerInterrupt(void)
+static void DELAY_SysTickInterrupt(void)
 {
-   // Clear the timer interrupt...
-   Timer_IF_InterruptClear(TIMERA1_BASE);
+   TySoftwareTimer *ptyTimer;
+
+   PROFILE_START(PROFILE_SYSTICK_INTERRUPT);
+   PROFILE_LATENCY(PROFILE_SYSTICK_INTERRUPT, (SYSTICK_PERIOD - 1) - MAP_SysTickValueGet());
+
+   ulLocalMilliseconds  = TIMER_WRAP(ulLocalMilliseconds + ulLocalTicksPending);
+   ulLocalTicksPending  = 1;
 
-   // Stop the timer...
-   Timer_IF_Stop(TIMERA1_BASE, TIMER_A);
-   Timer_IF_DeInit(TIMERA1_BASE, TIMER_A);
+   while ((ptyLocalTimers != NULL) && (TIMER_DIFF(ulLocalMilliseconds, ptyLocalTimers->ulExpiry) >= 0))
+      {
+      ptyTimer = ptyLocalTimers;
+      ptyLocalTimers = ptyTimer->ptyNext;
+
+      // Reschedule or stop the timer first, so that the callback can stop or
+      // restart it. Periodic timers are rescheduled from the previous expiry
+      // so that they do not drift...
+      if (ptyTimer->ulPeriod != 0)
+         {
+         ptyTimer->ulExpiry = TIMER_WRAP(ptyTimer->ulExpiry + ptyTimer->ulPeriod);
+         TIMER_Insert(ptyTimer);
+         }
+      else
+         {
+         ptyTimer->ptyNext  = NULL;
+         ptyTimer->bRunning = FALSE;
+         }
 
-   bLocalDelayElapsed = TRUE;
+      ptyTimer->tyCallback();
+      }
+
+   PROFILE_END(PROFILE_SYSTICK_INTERRUPT);
 }
 
 /****************************************************************************
-     Function: TIMER_Delay
-     Engineer: Martin Hannon
-        Input: unsigned long ulDelay: Delay time in us.
+     Function: TIMER_Initialise
+     Engineer: agent
+        Input: N/A
        Output: N/A
-  Description: Delays for the specified time.
+  Description: Starts the SysTick millisecond time base.
 Date           Initials    Description
-05-DEC-2016    MH          Initial
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Resets the idle time measurement.
+17-OCT-2026    agent       Starts the count at TIMER_INITIAL_MILLISECONDS.
 ****************************************************************************/
-void TIMER_Delay(unsigned long ulDelay)
+void TIMER_Initialise(void)
+{
+   ulLocalMilliseconds     = TIMER_INITIAL_MILLISECONDS;
+   ulLocalTicksPending     = 1;
+   ptyLocalTimers          = NULL;
+   ulLocalIdleCycles       = 0;
+   ulLocalIdleMilliseconds = 0;
+   ulLocalIdleStart        = TIMER_INITIAL_MILLISECONDS;
+
+   MAP_SysTickPeriodSet(SYSTICK_PERIOD);
+   MAP_SysTickIntRegister(DELAY_SysTickInterrupt);
+   MAP_SysTickIntEnable();
+   MAP_SysTickEnable();
+}
+
+/****************************************************************************
+     Function: TIMER_GetMilliseconds
+     Engineer: agent
+        Input: N/A
+       Output: Millisecond count.
+  Description: Returns the millisecond count. This wraps a minute after
+               TIMER_Initialise, and then every 49 days or so, so only
+               differences between counts (see TIMER_WRAP) should be used.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned long TIMER_GetMilliseconds(void)
 {
-   bLocalDelayElapsed = FALSE;
+   return ulLocalMilliseconds;
+}
+
+/****************************************************************************
+     Function: TIMER_Start
+     Engineer: agent
+        Input: TySoftwareTimer *ptyTimer: Timer to start.
+               unsigned long ulMilliseconds: Minimum time before the first
+                  expiry.
+               unsigned long ulPeriod: Time between later expiries, 0 for a
+                  one shot timer.
+               TyTimerCallback tyCallback: Function to invoke on expiry.
+       Output: TRUE: Success, FALSE: Failure.
+  Description: Starts (or restarts) a software timer. The callback is
+               invoked from the SysTick interrupt handler. May be called from
+               an interrupt handler, including a timer callback.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char TIMER_Start(TySoftwareTimer *ptyTimer, unsigned long ulMilliseconds, unsigned long ulPeriod, TyTimerCallback tyCallback)
+{
+   tBoolean bInterruptsDisabled;
+
+   if ((ptyTimer == NULL) || (tyCallback == NULL))
+      return FALSE;
+
+   bInterruptsDisabled = MAP_IntMasterDisable();
 
-   // Timer clocks in 12.5ns ticks (or 1/80 of a microsecond)
-   ulDelay *= 80;
+   if (ptyTimer->bRunning)
+      TIMER_Remove(ptyTimer);
 
-   // Initial the TIMERA for the specified timeout...
-   Timer_IF_Init(PRCM_TIMERA1, TIMERA1_BASE, TIMER_CFG_PERIODIC_UP, TIMER_A, 0);
-   Timer_IF_IntSetup(TIMERA1_BASE, TIMER_A, DELAY_TimerInterrupt);
+   // Add one as the current millisecond is already partly over...
+   ptyTimer->ulExpiry   = TIMER_WRAP(ulLocalMilliseconds + ulMilliseconds + 1);
+   ptyTimer->ulPeriod   = ulPeriod;
+   ptyTimer->tyCallback = tyCallback;
+   ptyTimer->bRunning   = TRUE;
+   TIMER_Insert(ptyTimer);
+
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+
+   return TRUE;
+}
+
+/****************************************************************************
+     Function: TIMER_Stop
+     Engineer: agent
+        Input: TySoftwareTimer *ptyTimer: Timer to stop.
+       Output: N/A
+  Description: Stops a software timer. Does nothing if it is not running.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void TIMER_Stop(TySoftwareTimer *ptyTimer)
+{
+   tBoolean bInterruptsDisabled;
 
-   MAP_TimerLoadSet(TIMERA1_BASE,TIMER_A, ulDelay);
-   MAP_TimerEnable(TIMERA1_BASE,TIMER_A);
+   if (ptyTimer == NULL)
+      return;
 
-   while (bLocalDelayElapsed == FALSE)
+   bInterruptsDisabled = MAP_IntMasterDisable();
+   if (ptyTimer->bRunning)
+      TIMER_Remove(ptyTimer);
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+}
+
+/****************************************************************************
+     Function: TIMER_IsRunning
+     Engineer: agent
+        Input: TySoftwareTimer *ptyTimer: Timer to check.
+       Output: TRUE: Running, FALSE: Stopped or expired.
+  Description: Reports whether a software timer is running.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char TIMER_IsRunning(TySoftwareTimer *ptyTimer)
+{
+   return ptyTimer->bRunning ? TRUE : FALSE;
+}
+
+/****************************************************************************
+     Function: TIMER_SetSysTickCount
+     Engineer: agent
+        Input: unsigned long ulCount: SysTick counts to the next interrupt.
+       Output: N/A
+  Description: Restarts the SysTick so that the next interrupt is after
+               ulCount counts, followed by the normal 1ms period.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void TIMER_SetSysTickCount(unsigned long ulCount)
+{
+   // A reload value of 0 stops the SysTick...
+   if (ulCount < 2)
+      ulCount = 2;
+
+   // Writing the current value clears it, so it is reloaded on the next
+   // count. Wait for the reload before setting the normal period back...
+   MAP_SysTickPeriodSet(ulCount);
+   HWREG(NVIC_ST_CURRENT) = 0;
+   while (MAP_SysTickValueGet() == 0)
       {
       ;;
       }
+   MAP_SysTickPeriodSet(SYSTICK_PERIOD);
+}
+
+/****************************************************************************
+     Function: TIMER_Sleep
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Puts the processor into sleep mode until the next interrupt.
+               The SysTick interrupts are suppressed until the first
+               software timer is due, so that a sleep is not ended by ticks
+               with nothing to do. The time spent asleep is added to the
+               idle time. Must be called with interrupts disabled, so that
+               the caller can check for work without missing a wake up. The
+               interrupt which ended the sleep runs once the caller enables
+               interrupts.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void TIMER_Sleep(void)
+{
+   long lUntilExpiry;
+   unsigned long ulTicks, ulValue, ulCount, ulNow, ulSlept, ulMissed;
+
+   // Ticks until the first timer expires...
+   ulTicks = TIMER_MAX_SLEEP_TICKS;
+   if (ptyLocalTimers != NULL)
+      {
+      lUntilExpiry = TIMER_DIFF(ptyLocalTimers->ulExpiry, ulLocalMilliseconds);
+      if (lUntilExpiry < 1)
+         ulTicks = 1;
+      else if (lUntilExpiry < TIMER_MAX_SLEEP_TICKS)
+         ulTicks = (unsigned long)lUntilExpiry;
+      }
+
+   // Counts left in the current tick. If the tick has already ended the
+   // interrupt is waiting to run, so there is no point sleeping....
+   ulValue = MAP_SysTickValueGet();
+   if (HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_PEND_SYST)
+      return;
+
+   if ((ulTicks > 1) && (ulValue > TIMER_SLEEP_MARGIN))
+      {
+      // Suppress the ticks up to the expiry...
+      ulCount = ulValue + ((ulTicks - 1) * SYSTICK_PERIOD);
+      TIMER_SetSysTickCount(ulCount);
+      ulLocalTicksPending = ulTicks;
+      }
+   else
+      {
+      ulTicks = 1;
+      ulCount = ulValue;
+      }
+
+   MAP_PRCMSleepEnter();
+
+   ulNow = MAP_SysTickValueGet();
+   if (HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_PEND_SYST)
+      {
+      // Slept until the SysTick interrupt, which accounts for the ticks...
+      ulSlept = ulCount + (SYSTICK_PERIOD - 1 - ulNow);
+      }
+   else
+      {
+      ulSlept = ulCount - ulNow;
+
+      if (ulTicks > 1)
+         {
+         // Woken early by another interrupt. Count the ticks which have
+         // passed and put the SysTick back in step with them...
+         if (ulSlept < ulValue)
+            ulMissed = 0;
+         else
+            ulMissed = ((ulSlept - ulValue) / SYSTICK_PERIOD) + 1;
+
+         ulLocalMilliseconds  = TIMER_WRAP(ulLocalMilliseconds + ulMissed);
+         ulLocalTicksPending  = 1;
+         TIMER_SetSysTickCount(ulValue + (ulMissed * SYSTICK_PERIOD) - ulSlept);
+         }
+      }
+
+   ulLocalIdleCycles       += ulSlept;
+   ulLocalIdleMilliseconds += ulLocalIdleCycles / SYSTICK_PERIOD;
+   ulLocalIdleCycles       %= SYSTICK_PERIOD;
+}
+
+/****************************************************************************
+     Function: TIMER_GetIdlePercentage
+     Engineer: agent
+        Input: N/A
+       Output: Percentage of the time spent in TIMER_Sleep (0 to 100).
+  Description: Returns the percentage of the time spent asleep since the
+               previous call (or TIMER_Initialise), and starts a new
+               measurement.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char TIMER_GetIdlePercentage(void)
+{
+   unsigned long ulElapsed, ulIdle;
+   tBoolean bInterruptsDisabled;
+
+   bInterruptsDisabled = MAP_IntMasterDisable();
+   ulElapsed = TIMER_WRAP(ulLocalMilliseconds - ulLocalIdleStart);
+   ulIdle    = ulLocalIdleMilliseconds;
+   ulLocalIdleStart        = ulLocalMilliseconds;
+   ulLocalIdleMilliseconds = 0;
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+
+   if (ulElapsed == 0)
+      return 0;
+
+   if (ulIdle >= ulElapsed)
+      return 100;
+
+   return (unsigned char)((ulIdle * 100) / ulElapsed);
 }
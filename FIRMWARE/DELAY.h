@@ -4,6 +4,48 @@
   Description: Contains the function prototypes from the DELAY.c module.
 Date           Initials    Description
 16-DEC-2016    MH          Initial
+17-OCT-2026    agent       Added the millisecond time base.
+17-OCT-2026    agent       Replaced the scheduled callbacks with software
+                           timers.
+17-OCT-2026    agent       Added TIMER_Sleep and TIMER_GetIdlePercentage.
+17-OCT-2026    agent       Added TIMER_WRAP and TIMER_DIFF.
 ****************************************************************************/
 
+// The millisecond count, and the other counts which wrap, are 32 bits on the
+// target. The host build has 64 bit longs, so the sums and differences of
+// such counts are masked to 32 bits with TIMER_WRAP. On the target the mask
+// compiles away....
+#define TIMER_WRAP(ulCount)        ((ulCount) & 0xFFFFFFFFul)
+
+// Signed difference, ulLater - ulEarlier, between two 32 bit counts....
+#define TIMER_DIFF(ulLater, ulEarlier)  ((long)(int)TIMER_WRAP((ulLater) - (ulEarlier)))
+
+// The millisecond count starts a minute before it wraps, so that the wrap is
+// exercised soon after every start rather than after 49 days....
+#ifndef TIMER_INITIAL_MILLISECONDS
+#define TIMER_INITIAL_MILLISECONDS TIMER_WRAP(0ul - 60000ul)
+#endif
+
+// Software timer callback. NOTE:- This is invoked from the SysTick interrupt
+// handler.
+typedef void (*TyTimerCallback)(void);
+
+// A software timer. The storage is owned by the caller and must remain valid
+// while the timer is running. The fields are private to the DELAY module.
+typedef struct TySoftwareTimer
+{
+   TyTimerCallback         tyCallback;
+   unsigned long           ulExpiry;   // Millisecond count at which it expires.
+   unsigned long           ulPeriod;   // Milliseconds, 0 = one shot.
+   volatile unsigned char  bRunning;
+   struct TySoftwareTimer *ptyNext;
+} TySoftwareTimer;
+
 void TIMER_Delay(unsigned long ulDelay);
+void TIMER_Initialise(void);
+unsigned long TIMER_GetMilliseconds(void);
+unsigned char TIMER_Start(TySoftwareTimer *ptyTimer, unsigned long ulMilliseconds, unsigned long ulPeriod, TyTimerCallback tyCallback);
+void TIMER_Stop(TySoftwareTimer *ptyTimer);
+unsigned char TIMER_IsRunning(TySoftwareTimer *ptyTimer);
+void TIMER_Sleep(void);
+unsigned char TIMER_GetIdlePercentage(void);
@@ -0,0 +1,900 @@
+/****************************************************************************
+       Module: FLASHLOG.c
+     Engineer: agent
+  Description: Contains the sample log kept in the serial flash, through the
+               SimpleLink file system, so that the samples are not lost
+               while nothing is listening on the console.
+
+               The log is a ring of FLASHLOG_SEGMENTS files. The file system
+               erases a file when it is opened for writing, so a segment is
+               opened once, written and closed, then left alone until the
+               ring comes round to it again. Every segment
+               is erased once per trip round the ring, which spreads the
+               wear evenly, and nothing is written in place (there is no
+               index or pointer to keep up to date).
+
+               The serial flash belongs to the network processor, which
+               draws far more than the rest of the chip while it runs. So it
+               is started only to read or write the log and stopped again
+               straight after, rather than left running between writes and
+               undoing the low power idle. As it cannot be stopped with a
+               segment open, each page is written as it fills to a staging
+               file of its own (one for each page of a segment, so a staging
+               file is erased once per segment rather than once per page),
+               and once the last page of a segment is staged the pages are
+               copied from the staging files into the segment. At a sample
+               every 30 seconds that is a start, an erase and a page write
+               every 7.5 minutes, and a copy of the segment every 1.9
+               hours. A power failure loses at most the
+               FLASHLOG_RECORDS_PER_PAGE - 1 records of the page being
+               filled. The staging files are erased FLASHLOG_SEGMENTS times
+               as often as the segments: 100,000 erases take 21 years at a
+               sample every 30 seconds.
+
+               Records are laid out in pages, each with its own header and
+               CRC, so that a torn write loses only the pages it had not
+               finished. Each page has a sequence number, which also
+               gives its place in the ring: segment (sequence / pages per
+               segment) modulo the number of segments, page (sequence modulo
+               pages per segment). The staging file of a page is its page
+               number.
+
+               At boot the newest segment, the newest page in it and the
+               oldest segment are each found by a binary search on the
+               sequence numbers, so recovery reads about
+               2 log2(FLASHLOG_SEGMENTS) + log2(FLASHLOG_PAGES_PER_SEGMENT)
+               pages rather than all of them. The pages staged for a newer
+               segment (or more of the newest, if the power failed while it
+               was being copied) are found by another binary search, from
+               the first staging file, and copied into their segment there
+               and then, which may leave it part filled. The log carries
+               on in the segment after the newest, as opening that one
+               again would erase it.
+
+               Page (multi byte fields little endian):
+                  Sequence       4 bytes  Pages since the log was started
+                  Boot           2 bytes  Counts up at every recovery
+                  Record count   1 byte
+                  Records        FLASHLOG_RECORD_SIZE bytes each
+                  Unused         0xFF
+                  CRC            2 bytes  CRC-16/CCITT of the rest of the
+                                          page, in its last 2 bytes
+
+               Record:
+                  Timestamp      4 bytes
+                  Temperature    2 bytes (signed)
+                  Humidity       2 bytes
+                  P1 low time    4 bytes
+                  P2 low time    4 bytes
+
+               The file system calls wait for the network processor, which
+               takes tens of milliseconds to start and again when a file is
+               opened and erased, so the log must only be used from a low
+               priority task.
+
+               The log is a backup of the console output, so a failure is
+               reported to the caller and the firmware carries on. If the
+               log could not be recovered at boot, the recovery is tried
+               again each time a page is due to be written.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Retries the recovery if it failed at boot.
+17-OCT-2026    agent       Stops the network processor between writes, so
+                           a whole segment is held in RAM.
+17-OCT-2026    agent       Writes each page as it fills, to a staging file,
+                           and copies the pages to the segment once it is
+                           full. Only a page is held in RAM.
+****************************************************************************/
+#include "includes.h"
+#include "simplelink.h"
+
+// Page layout....
+#define FLASHLOG_SEQUENCE_OFFSET  0
+#define FLASHLOG_BOOT_OFFSET      4
+#define FLASHLOG_COUNT_OFFSET     6
+#define FLASHLOG_CRC_OFFSET       (FLASHLOG_PAGE_SIZE - FLASHLOG_CRC_SIZE)
+
+// Longest wait for the network processor to stop, in ms....
+#define FLASHLOG_STOP_TIMEOUT     200
+
+// Segment and staging file names, the same length. The last two characters
+// are the segment or page number....
+static unsigned char pucLocalName[]       = "/sensorweb/log00";
+static unsigned char pucLocalStagedName[] = "/sensorweb/pag00";
+
+static unsigned char  pucLocalPage[FLASHLOG_PAGE_SIZE];       // Page being filled.
+static unsigned char  pucLocalReadPage[FLASHLOG_PAGE_SIZE];   // Page read back.
+static unsigned char  ucLocalRecordCount; // Records in the page being filled.
+static unsigned short usLocalBoot;
+static unsigned long  ulLocalSequence;    // Sequence of the page being filled.
+static unsigned long  ulLocalOldest;      // Sequence of the oldest page held.
+static unsigned long  ulLocalReadEnd;     // Pages before this are in their segments,
+                                          // those from it to ulLocalSequence are staged.
+static unsigned char  bLocalRecovered;    // FALSE until the log is recovered.
+
+
+/****************************************************************************
+     Function: FLASHLOG_PutShort
+     Engineer: agent
+        Input: unsigned char *pucBuffer: Where to write the value.
+               unsigned short usValue: Value to write.
+       Output: unsigned char *: Position after the value.
+  Description: Writes a 16 bit value, little endian.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char *FLASHLOG_PutShort(unsigned char *pucBuffer, unsigned short usValue)
+{
+   pucBuffer[0] = (unsigned char)usValue;
+   pucBuffer[1] = (unsigned char)(usValue >> 8);
+
+   return pucBuffer + 2;
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_PutLong
+     Engineer: agent
+        Input: unsigned char *pucBuffer: Where to write the value.
+               unsigned long ulValue: Value to write.
+       Output: unsigned char *: Position after the value.
+  Description: Writes a 32 bit value, little endian.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char *FLASHLOG_PutLong(unsigned char *pucBuffer, unsigned long ulValue)
+{
+   pucBuffer[0] = (unsigned char)ulValue;
+   pucBuffer[1] = (unsigned char)(ulValue >> 8);
+   pucBuffer[2] = (unsigned char)(ulValue >> 16);
+   pucBuffer[3] = (unsigned char)(ulValue >> 24);
+
+   return pucBuffer + 4;
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_GetShort
+     Engineer: agent
+        Input: const unsigned char *pucBuffer: Where to read the value.
+       Output: unsigned short: The value.
+  Description: Reads a 16 bit value, little endian.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned short FLASHLOG_GetShort(const unsigned char *pucBuffer)
+{
+   return (unsigned short)(pucBuffer[0] | (pucBuffer[1] << 8));
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_GetLong
+     Engineer: agent
+        Input: const unsigned char *pucBuffer: Where to read the value.
+       Output: unsigned long: The value.
+  Description: Reads a 32 bit value, little endian.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned long FLASHLOG_GetLong(const unsigned char *pucBuffer)
+{
+   return (unsigned long)pucBuffer[0]         | ((unsigned long)pucBuffer[1] << 8) |
+          ((unsigned long)pucBuffer[2] << 16) | ((unsigned long)pucBuffer[3] << 24);
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_SetName
+     Engineer: agent
+        Input: unsigned long ulSequence: Sequence of a page.
+               unsigned char bStaged: TRUE for the page's staging file.
+       Output: unsigned char *: File name.
+  Description: Sets the name of the segment (or staging file) holding the
+               page.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added the staging files.
+****************************************************************************/
+static unsigned char *FLASHLOG_SetName(unsigned long ulSequence, unsigned char bStaged)
+{
+   unsigned char *pucName;
+   unsigned long ulNumber;
+
+   if (bStaged == TRUE)
+      {
+      pucName  = pucLocalStagedName;
+      ulNumber = ulSequence % FLASHLOG_PAGES_PER_SEGMENT;
+      }
+   else
+      {
+      pucName  = pucLocalName;
+      ulNumber = (ulSequence / FLASHLOG_PAGES_PER_SEGMENT) % FLASHLOG_SEGMENTS;
+      }
+
+   pucName[sizeof(pucLocalName) - 3] = (unsigned char)('0' + (ulNumber / 10));
+   pucName[sizeof(pucLocalName) - 2] = (unsigned char)('0' + (ulNumber % 10));
+
+   return pucName;
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_ReadAt
+     Engineer: agent
+        Input: unsigned long ulSequence: Any sequence of the place to read,
+                  e.g. the segment number times the pages per segment.
+               unsigned char bStaged: TRUE to read the staging file of the
+                  page rather than its segment.
+       Output: unsigned char: TRUE if the place holds a good page.
+  Description: Reads the page at a place in the ring (or in the staging
+               files) into pucLocalReadPage and checks it. A page which has
+               not been written, or was being written when the power
+               failed, fails the check. So does a page whose sequence does
+               not belong at the place.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added the staging files.
+****************************************************************************/
+static unsigned char FLASHLOG_ReadAt(unsigned long ulSequence, unsigned char bStaged)
+{
+   _i32 lFile, lRead;
+   unsigned long ulHeld, ulOffset;
+
+   // A file which does not open has not been written yet....
+   if (sl_FsOpen(FLASHLOG_SetName(ulSequence, bStaged), FS_MODE_OPEN_READ, NULL, &lFile) < 0)
+      return FALSE;
+
+   ulOffset = (bStaged == TRUE) ? 0 : (ulSequence % FLASHLOG_PAGES_PER_SEGMENT) * FLASHLOG_PAGE_SIZE;
+
+   lRead = sl_FsRead(lFile, ulOffset, pucLocalReadPage, FLASHLOG_PAGE_SIZE);
+   sl_FsClose(lFile, NULL, NULL, 0);
+
+   if (lRead != FLASHLOG_PAGE_SIZE)
+      return FALSE;
+
+   if (TELEMETRY_Crc(pucLocalReadPage, FLASHLOG_CRC_OFFSET) != FLASHLOG_GetShort(&pucLocalReadPage[FLASHLOG_CRC_OFFSET]))
+      return FALSE;
+
+   ulHeld = FLASHLOG_GetLong(&pucLocalReadPage[FLASHLOG_SEQUENCE_OFFSET]);
+
+   if ((ulHeld % FLASHLOG_PAGES_PER_SEGMENT) != (ulSequence % FLASHLOG_PAGES_PER_SEGMENT))
+      return FALSE;
+
+   // A staging file holds its page of any segment....
+   if ((bStaged == FALSE) &&
+       (((ulHeld / FLASHLOG_PAGES_PER_SEGMENT) % FLASHLOG_SEGMENTS) != ((ulSequence / FLASHLOG_PAGES_PER_SEGMENT) % FLASHLOG_SEGMENTS)))
+      return FALSE;
+
+   return (pucLocalReadPage[FLASHLOG_COUNT_OFFSET] <= FLASHLOG_RECORDS_PER_PAGE);
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_Holds
+     Engineer: agent
+        Input: unsigned long ulSequence: Sequence of the page.
+               unsigned char bStaged: TRUE to look in the staging file of
+                  the page rather than its segment.
+       Output: unsigned char: TRUE if the page is in the log.
+  Description: Reads a page into pucLocalReadPage, checking that it is the
+               one with the sequence given rather than an older one at the
+               same place.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added the staging files.
+****************************************************************************/
+static unsigned char FLASHLOG_Holds(unsigned long ulSequence, unsigned char bStaged)
+{
+   if (FLASHLOG_ReadAt(ulSequence, bStaged) == FALSE)
+      return FALSE;
+
+   return (FLASHLOG_GetLong(&pucLocalReadPage[FLASHLOG_SEQUENCE_OFFSET]) == ulSequence);
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_OpenWrite
+     Engineer: agent
+        Input: unsigned char *pucName: File to open.
+               unsigned long ulSize: Size to create the file with.
+               _i32 *plFile: Set to the open file.
+       Output: unsigned char: TRUE if the file was opened.
+  Description: Opens a file to be written, erasing it. The first time the
+               file is created.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char FLASHLOG_OpenWrite(unsigned char *pucName, unsigned long ulSize, _i32 *plFile)
+{
+   if (sl_FsOpen(pucName, FS_MODE_OPEN_WRITE, NULL, plFile) < 0)
+      {
+      if (sl_FsOpen(pucName, FS_MODE_OPEN_CREATE(ulSize, _FS_FILE_PUBLIC_WRITE), NULL, plFile) < 0)
+         return FALSE;
+      }
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_WriteSegment
+     Engineer: agent
+        Input: unsigned long ulFirst: Sequence of the segment's first page.
+               unsigned char ucPages: Pages staged for it.
+       Output: unsigned char: TRUE if the segment was written.
+  Description: Opens the segment, erasing it, and copies its pages from the
+               staging files. The network processor must be started.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Copies the pages from the staging files.
+****************************************************************************/
+static unsigned char FLASHLOG_WriteSegment(unsigned long ulFirst, unsigned char ucPages)
+{
+   unsigned char bSuccess, ucPage;
+   unsigned long ulOldest;
+   _i32 lFile;
+
+   // The segment's old pages are gone as soon as it is opened....
+   if (ulFirst >= ((FLASHLOG_SEGMENTS - 1) * FLASHLOG_PAGES_PER_SEGMENT))
+      {
+      ulOldest = ulFirst - ((FLASHLOG_SEGMENTS - 1) * FLASHLOG_PAGES_PER_SEGMENT);
+      if (ulLocalOldest < ulOldest)
+         ulLocalOldest = ulOldest;
+      }
+
+   if (FLASHLOG_OpenWrite(FLASHLOG_SetName(ulFirst, FALSE), FLASHLOG_SEGMENT_SIZE, &lFile) == FALSE)
+      return FALSE;
+
+   bSuccess = TRUE;
+
+   for (ucPage=0; (bSuccess == TRUE) && (ucPage < ucPages); ucPage++)
+      {
+      bSuccess = FLASHLOG_Holds(ulFirst + ucPage, TRUE);
+
+      if ((bSuccess == TRUE) &&
+          (sl_FsWrite(lFile, (unsigned long)ucPage * FLASHLOG_PAGE_SIZE, pucLocalReadPage, FLASHLOG_PAGE_SIZE) != FLASHLOG_PAGE_SIZE))
+         bSuccess = FALSE;
+      }
+
+   sl_FsClose(lFile, NULL, NULL, 0);
+
+   return bSuccess;
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_Recover
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Finds the newest and oldest pages in the flash, and sets up
+               to carry on from the segment after the newest. Each search
+               relies on the segments (or pages) following on from each
+               other in sequence from a known good one, up to the point
+               where they stop doing so. Pages staged after the newest are
+               first copied into their segment.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Copies the staged pages into their segment.
+****************************************************************************/
+static void FLASHLOG_Recover(void)
+{
+   unsigned short usLow, usHigh, usMiddle, usBoot;
+   unsigned long ulFirst, ulBack, ulNewest;
+   unsigned char bFound;
+
+   ulFirst  = 0;
+   ulNewest = 0;
+   usBoot   = 0;
+   bFound   = TRUE;
+
+   // Find the newest segment. Those from segment 0 up to the newest follow
+   // on from it; the rest are from the last trip round the ring, or have not
+   // been written....
+   if (FLASHLOG_ReadAt(0, FALSE) == TRUE)
+      {
+      ulFirst = FLASHLOG_GetLong(&pucLocalReadPage[FLASHLOG_SEQUENCE_OFFSET]);
+      usBoot  = FLASHLOG_GetShort(&pucLocalReadPage[FLASHLOG_BOOT_OFFSET]);
+      usLow   = 0;
+      usHigh  = FLASHLOG_SEGMENTS;
+
+      while ((usHigh - usLow) > 1)
+         {
+         usMiddle = (usLow + usHigh) / 2;
+
+         if (FLASHLOG_Holds(ulFirst + ((unsigned long)usMiddle * FLASHLOG_PAGES_PER_SEGMENT), FALSE) == TRUE)
+            {
+            usLow  = usMiddle;
+            usBoot = FLASHLOG_GetShort(&pucLocalReadPage[FLASHLOG_BOOT_OFFSET]);
+            }
+         else
+            {
+            usHigh = usMiddle;
+            }
+         }
+
+      ulFirst += (unsigned long)usLow * FLASHLOG_PAGES_PER_SEGMENT;
+      }
+   else if (FLASHLOG_ReadAt((FLASHLOG_SEGMENTS - 1) * FLASHLOG_PAGES_PER_SEGMENT, FALSE) == TRUE)
+      {
+      // Segment 0 was being started when the power failed, so the last
+      // segment is the newest....
+      ulFirst = FLASHLOG_GetLong(&pucLocalReadPage[FLASHLOG_SEQUENCE_OFFSET]);
+      usBoot  = FLASHLOG_GetShort(&pucLocalReadPage[FLASHLOG_BOOT_OFFSET]);
+      }
+   else
+      {
+      // No segment has been written....
+      bFound = FALSE;
+      }
+
+   if (bFound == TRUE)
+      {
+      // Find the newest page in the newest segment....
+      usLow  = 0;
+      usHigh = FLASHLOG_PAGES_PER_SEGMENT;
+
+      while ((usHigh - usLow) > 1)
+         {
+         usMiddle = (usLow + usHigh) / 2;
+
+         if (FLASHLOG_Holds(ulFirst + usMiddle, FALSE) == TRUE)
+            {
+            usLow  = usMiddle;
+            usBoot = FLASHLOG_GetShort(&pucLocalReadPage[FLASHLOG_BOOT_OFFSET]);
+            }
+         else
+            {
+            usHigh = usMiddle;
+            }
+         }
+
+      ulNewest = ulFirst + usLow;
+      }
+
+   // The first staging file holds the first page of the segment staged
+   // last. Find the newest page staged for it, and if that is newer than
+   // the newest in the segments, copy the staged pages into the segment....
+   if (FLASHLOG_ReadAt(0, TRUE) == TRUE)
+      {
+      ulBack = FLASHLOG_GetLong(&pucLocalReadPage[FLASHLOG_SEQUENCE_OFFSET]);
+      usLow  = 0;
+      usHigh = FLASHLOG_PAGES_PER_SEGMENT;
+
+      while ((usHigh - usLow) > 1)
+         {
+         usMiddle = (usLow + usHigh) / 2;
+
+         if (FLASHLOG_Holds(ulBack + usMiddle, TRUE) == TRUE)
+            usLow = usMiddle;
+         else
+            usHigh = usMiddle;
+         }
+
+      if ((bFound == FALSE) || ((ulBack + usLow) > ulNewest))
+         {
+         // The boot of the newest staged page....
+         FLASHLOG_Holds(ulBack + usLow, TRUE);
+         usBoot  = FLASHLOG_GetShort(&pucLocalReadPage[FLASHLOG_BOOT_OFFSET]);
+         ulFirst = ulBack;
+         bFound  = TRUE;
+
+         FLASHLOG_WriteSegment(ulFirst, (unsigned char)(usLow + 1));
+         }
+      }
+
+   // Nothing has been logged....
+   if (bFound == FALSE)
+      return;
+
+   // Find the oldest segment, going back from the newest....
+   usLow  = 0;
+   usHigh = FLASHLOG_SEGMENTS;
+
+   while ((usHigh - usLow) > 1)
+      {
+      usMiddle = (usLow + usHigh) / 2;
+      ulBack   = (unsigned long)usMiddle * FLASHLOG_PAGES_PER_SEGMENT;
+
+      if ((ulFirst >= ulBack) && (FLASHLOG_Holds(ulFirst - ulBack, FALSE) == TRUE))
+         usLow = usMiddle;
+      else
+         usHigh = usMiddle;
+      }
+
+   ulLocalOldest   = ulFirst - ((unsigned long)usLow * FLASHLOG_PAGES_PER_SEGMENT);
+   ulLocalSequence = ulFirst + FLASHLOG_PAGES_PER_SEGMENT;
+   ulLocalReadEnd  = ulLocalSequence;
+   usLocalBoot     = usBoot + 1;
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_Start
+     Engineer: agent
+        Input: N/A
+       Output: unsigned char: TRUE if the flash can be used.
+  Description: Starts the network processor, which owns the serial flash,
+               recovering the log from it the first time. FLASHLOG_Stop
+               must follow once the flash has been used.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Only recovers the log the first time.
+****************************************************************************/
+static unsigned char FLASHLOG_Start(void)
+{
+   if (sl_Start(NULL, NULL, NULL) < 0)
+      return FALSE;
+
+   if (bLocalRecovered == FALSE)
+      {
+      FLASHLOG_Recover();
+      bLocalRecovered = TRUE;
+      }
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_Stop
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Stops the network processor, so that it draws nothing until
+               the log is next read or written.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void FLASHLOG_Stop(void)
+{
+   sl_Stop(FLASHLOG_STOP_TIMEOUT);
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_WritePage
+     Engineer: agent
+        Input: N/A
+       Output: unsigned char: TRUE if the page was written.
+  Description: Fills in the header and CRC of the page held in RAM, which
+               is left until now as the sequence is not known until the
+               log has been recovered, and writes it to its staging file.
+               Once the last page of a segment is staged the segment is
+               written. If a page cannot be staged its records are lost,
+               the pages staged before it are written to the segment and
+               the log carries on in the next, as a segment is only ever
+               cut short.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Writes the page to a staging file.
+****************************************************************************/
+static unsigned char FLASHLOG_WritePage(void)
+{
+   unsigned char bSuccess, ucStaged;
+   unsigned long ulFirst;
+   unsigned short i;
+   _i32 lFile;
+
+   bSuccess = FLASHLOG_Start();
+
+   if (bSuccess == TRUE)
+      {
+      FLASHLOG_PutLong(&pucLocalPage[FLASHLOG_SEQUENCE_OFFSET], ulLocalSequence);
+      FLASHLOG_PutShort(&pucLocalPage[FLASHLOG_BOOT_OFFSET], usLocalBoot);
+      pucLocalPage[FLASHLOG_COUNT_OFFSET] = ucLocalRecordCount;
+
+      // Leave the unused bytes as they are in the erased flash....
+      for (i=FLASHLOG_HEADER_SIZE + (ucLocalRecordCount * FLASHLOG_RECORD_SIZE); i < FLASHLOG_CRC_OFFSET; i++)
+         pucLocalPage[i] = 0xFF;
+
+      FLASHLOG_PutShort(&pucLocalPage[FLASHLOG_CRC_OFFSET], TELEMETRY_Crc(pucLocalPage, FLASHLOG_CRC_OFFSET));
+
+      bSuccess = FLASHLOG_OpenWrite(FLASHLOG_SetName(ulLocalSequence, TRUE), FLASHLOG_PAGE_SIZE, &lFile);
+      if (bSuccess == TRUE)
+         {
+         if (sl_FsWrite(lFile, 0, pucLocalPage, FLASHLOG_PAGE_SIZE) != FLASHLOG_PAGE_SIZE)
+            bSuccess = FALSE;
+
+         sl_FsClose(lFile, NULL, NULL, 0);
+         }
+
+      ulFirst  = ulLocalSequence - (ulLocalSequence % FLASHLOG_PAGES_PER_SEGMENT);
+      ucStaged = (unsigned char)(ulLocalSequence - ulFirst);
+
+      if (bSuccess == TRUE)
+         {
+         ucStaged++;
+         ulLocalSequence++;
+         }
+
+      if ((bSuccess == FALSE) || (ucStaged == FLASHLOG_PAGES_PER_SEGMENT))
+         {
+         if ((ucStaged != 0) && (FLASHLOG_WriteSegment(ulFirst, ucStaged) == FALSE))
+            bSuccess = FALSE;
+
+         ulLocalSequence = ulFirst + FLASHLOG_PAGES_PER_SEGMENT;
+         ulLocalReadEnd  = ulLocalSequence;
+         }
+
+      FLASHLOG_Stop();
+      }
+
+   ucLocalRecordCount = 0;
+
+   return bSuccess;
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_Initialise
+     Engineer: agent
+        Input: N/A
+       Output: unsigned char: TRUE if the log was recovered. If not, the
+                  samples can still be appended, and the recovery is tried
+                  again when a page is due to be written.
+  Description: Recovers the log from the serial flash, leaving the network
+               processor stopped.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       The log can still be used if this fails.
+17-OCT-2026    agent       Stops the network processor after the recovery.
+****************************************************************************/
+unsigned char FLASHLOG_Initialise(void)
+{
+   ucLocalRecordCount = 0;
+   usLocalBoot        = 0;
+   ulLocalSequence    = 0;
+   ulLocalOldest      = 0;
+   ulLocalReadEnd     = 0;
+   bLocalRecovered    = FALSE;
+
+   if (FLASHLOG_Start() != TRUE)
+      return FALSE;
+
+   FLASHLOG_Stop();
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_Append
+     Engineer: agent
+        Input: const TyTelemetrySample *ptySample: Sample to log.
+       Output: unsigned char: FALSE if a page or segment could not be
+                  written.
+  Description: Adds a sample to the page being filled, writing the page
+               once it holds FLASHLOG_RECORDS_PER_PAGE records. Must not be
+               called from an interrupt handler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Fills a segment rather than a page.
+17-OCT-2026    agent       Fills a page again, as pages are staged.
+****************************************************************************/
+unsigned char FLASHLOG_Append(const TyTelemetrySample *ptySample)
+{
+   unsigned char *pucRecord;
+
+   pucRecord = &pucLocalPage[FLASHLOG_HEADER_SIZE + (ucLocalRecordCount * FLASHLOG_RECORD_SIZE)];
+
+   pucRecord = FLASHLOG_PutLong(pucRecord, ptySample->ulTimestamp);
+   pucRecord = FLASHLOG_PutShort(pucRecord, (unsigned short)ptySample->sTemperature);
+   pucRecord = FLASHLOG_PutShort(pucRecord, ptySample->usHumidity);
+   pucRecord = FLASHLOG_PutLong(pucRecord, ptySample->ulP1LowTime);
+   FLASHLOG_PutLong(pucRecord, ptySample->ulP2LowTime);
+
+   ucLocalRecordCount++;
+
+   if (ucLocalRecordCount >= FLASHLOG_RECORDS_PER_PAGE)
+      return FLASHLOG_WritePage();
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_Close
+     Engineer: agent
+        Input: N/A
+       Output: unsigned char: FALSE if the last page could not be written.
+  Description: Writes the records not yet written, as a part filled page,
+               so that they can be read. The next append starts a new page.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Writes a part filled segment.
+17-OCT-2026    agent       Writes a part filled page, which is staged.
+****************************************************************************/
+unsigned char FLASHLOG_Close(void)
+{
+   if (ucLocalRecordCount == 0)
+      return TRUE;
+
+   return FLASHLOG_WritePage();
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_GetBuffered
+     Engineer: agent
+        Input: N/A
+       Output: unsigned char: Number of records.
+  Description: Returns the number of records waiting in RAM for their page
+               to be written.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Counts the records of the whole segment.
+17-OCT-2026    agent       Counts the records of the page again.
+****************************************************************************/
+unsigned char FLASHLOG_GetBuffered(void)
+{
+   return ucLocalRecordCount;
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_GetOldest
+     Engineer: agent
+        Input: N/A
+       Output: unsigned long: Sequence of the page.
+  Description: Returns the sequence of the oldest page held, to start
+               reading from.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned long FLASHLOG_GetOldest(void)
+{
+   return ulLocalOldest;
+}
+
+
+/****************************************************************************
+     Function: FLASHLOG_ReadPage
+     Engineer: agent
+        Input: unsigned long *pulSequence: Page to read. Set to the page
+                  after the one read.
+               TyFlashLogRecord *ptyRecords: Storage for
+                  FLASHLOG_RECORDS_PER_PAGE records.
+               unsigned char *pucCount: Set to the number of records.
+       Output: unsigned char: FALSE if there are no more pages, or the
+                  flash could not be read.
+  Description: Reads the page with the sequence given, or the next one after
+               it that is held. The rest of a segment is skipped at the
+               first page missing from it, as a segment is only ever cut
+               short. The pages of the segment being filled are read from
+               their staging files. The records of the page still in RAM
+               cannot be read until it is written. The network processor
+               is started and stopped for each call. Must not be called
+               from an interrupt handler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Starts the network processor to read.
+17-OCT-2026    agent       Reads the staged pages.
+****************************************************************************/
+unsigned char FLASHLOG_ReadPage(unsigned long *pulSequence, TyFlashLogRecord *ptyRecords, unsigned char *pucCount)
+{
+   unsigned long ulSequence;
+   unsigned short usBoot;
+   unsigned char i, bFound;
+   const unsigned char *pucRecord;
+
+   ulSequence = *pulSequence;
+   if (ulSequence < ulLocalOldest)
+      ulSequence = ulLocalOldest;
+
+   bFound = FALSE;
+
+   if ((ulSequence < ulLocalSequence) && (FLASHLOG_Start() == TRUE))
+      {
+      while ((bFound == FALSE) && (ulSequence < ulLocalSequence))
+         {
+         if (FLASHLOG_Holds(ulSequence, (ulSequence >= ulLocalReadEnd)) == TRUE)
+            {
+            usBoot    = FLASHLOG_GetShort(&pucLocalReadPage[FLASHLOG_BOOT_OFFSET]);
+            *pucCount = pucLocalReadPage[FLASHLOG_COUNT_OFFSET];
+            pucRecord = &pucLocalReadPage[FLASHLOG_HEADER_SIZE];
+
+            for (i=0; i < *pucCount; i++)
+               {
+               ptyRecords[i].usBoot       = usBoot;
+               ptyRecords[i].ulTimestamp  = FLASHLOG_GetLong(&pucRecord[0]);
+               ptyRecords[i].sTemperature = (short)FLASHLOG_GetShort(&pucRecord[4]);
+               ptyRecords[i].usHumidity   = FLASHLOG_GetShort(&pucRecord[6]);
+               ptyRecords[i].ulP1LowTime  = FLASHLOG_GetLong(&pucRecord[8]);
+               ptyRecords[i].ulP2LowTime  = FLASHLOG_GetLong(&pucRecord[12]);
+               pucRecord += FLASHLOG_RECORD_SIZE;
+               }
+
+            ulSequence++;
+            bFound = TRUE;
+            }
+         else
+            {
+            ulSequence += FLASHLOG_PAGES_PER_SEGMENT - (ulSequence % FLASHLOG_PAGES_PER_SEGMENT);
+            }
+         }
+
+      FLASHLOG_Stop();
+      }
+
+   *pulSequence = ulSequence;
+   return bFound;
+}
+
+
+//*****************************************************************************
+//                  SimpleLink event handlers
+//*****************************************************************************
+// The SimpleLink driver calls these for the network events. Only the file
+// system is used, so there is nothing to do....
+
+/****************************************************************************
+     Function: SimpleLinkWlanEventHandler
+     Engineer: agent
+        Input: SlWlanEvent_t *pSlWlanEvent: The event.
+       Output: N/A
+  Description: WLAN events, not used.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SimpleLinkWlanEventHandler(SlWlanEvent_t *pSlWlanEvent)
+{
+}
+
+
+/****************************************************************************
+     Function: SimpleLinkNetAppEventHandler
+     Engineer: agent
+        Input: SlNetAppEvent_t *pNetAppEvent: The event.
+       Output: N/A
+  Description: Network application events, not used.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SimpleLinkNetAppEventHandler(SlNetAppEvent_t *pNetAppEvent)
+{
+}
+
+
+/****************************************************************************
+     Function: SimpleLinkHttpServerCallback
+     Engineer: agent
+        Input: SlHttpServerEvent_t *pHttpEvent: The event.
+               SlHttpServerResponse_t *pHttpResponse: The response.
+       Output: N/A
+  Description: HTTP server events, not used.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SimpleLinkHttpServerCallback(SlHttpServerEvent_t *pHttpEvent, SlHttpServerResponse_t *pHttpResponse)
+{
+}
+
+
+/****************************************************************************
+     Function: SimpleLinkGeneralEventHandler
+     Engineer: agent
+        Input: SlDeviceEvent_t *pDevEvent: The event.
+       Output: N/A
+  Description: Device events, not used.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SimpleLinkGeneralEventHandler(SlDeviceEvent_t *pDevEvent)
+{
+}
+
+
+/****************************************************************************
+     Function: SimpleLinkSockEventHandler
+     Engineer: agent
+        Input: SlSockEvent_t *pSock: The event.
+       Output: N/A
+  Description: Socket events, not used.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SimpleLinkSockEventHandler(SlSockEvent_t *pSock)
+{
+}
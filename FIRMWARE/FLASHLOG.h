@@ -0,0 +1,56 @@
+/****************************************************************************
+       Module: FLASHLOG.h
+     Engineer: agent
+  Description: Contains the types and function prototypes for the sample log
+               kept in the serial flash.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added FLASHLOG_RECORDS_PER_SEGMENT.
+17-OCT-2026    agent       Pages are staged until their segment is full.
+****************************************************************************/
+
+// The log is a ring of FLASHLOG_SEGMENTS files, each written from start to
+// end before the next is started. The number of files can be set for the
+// build (e.g. --define=FLASHLOG_SEGMENTS=32).
+#ifndef FLASHLOG_SEGMENTS
+#define FLASHLOG_SEGMENTS             16
+#endif
+
+#if (FLASHLOG_SEGMENTS < 2) || (FLASHLOG_SEGMENTS > 100)
+#error FLASHLOG_SEGMENTS must be 2 to 100.
+#endif
+
+// Records are held in RAM until a page is full, then the page is staged in
+// a file of its own until its segment is full. Fifteen pages make a
+// segment, so that a segment fits in one 4 KB block of the serial flash with
+// room to spare for the file system....
+#define FLASHLOG_PAGE_SIZE            256
+#define FLASHLOG_PAGES_PER_SEGMENT    15
+#define FLASHLOG_SEGMENT_SIZE         (FLASHLOG_PAGE_SIZE * FLASHLOG_PAGES_PER_SEGMENT)
+
+#define FLASHLOG_HEADER_SIZE          7
+#define FLASHLOG_RECORD_SIZE          16
+#define FLASHLOG_CRC_SIZE             2
+#define FLASHLOG_RECORDS_PER_PAGE     ((FLASHLOG_PAGE_SIZE - FLASHLOG_HEADER_SIZE - FLASHLOG_CRC_SIZE) / FLASHLOG_RECORD_SIZE)
+#define FLASHLOG_RECORDS_PER_SEGMENT  (FLASHLOG_RECORDS_PER_PAGE * FLASHLOG_PAGES_PER_SEGMENT)
+
+// A sample read back from the log. The timestamp restarts at every boot, so
+// the boot number is kept with it....
+typedef struct
+{
+   unsigned short usBoot;            // Counts up each time the log is recovered.
+   unsigned long  ulTimestamp;       // Seconds since monitoring started.
+   short          sTemperature;      // In 0.01 degree C units
+   unsigned short usHumidity;        // In 0.01 % units
+   unsigned long  ulP1LowTime;       // Mean P1 low time per second, 1 us units
+   unsigned long  ulP2LowTime;       // Mean P2 low time per second, 1 us units
+} TyFlashLogRecord;
+
+
+// Function prototypes from the FLASHLOG module...
+unsigned char FLASHLOG_Initialise(void);
+unsigned char FLASHLOG_Append(const TyTelemetrySample *ptySample);
+unsigned char FLASHLOG_Close(void);
+unsigned char FLASHLOG_GetBuffered(void);
+unsigned long FLASHLOG_GetOldest(void);
+unsigned char FLASHLOG_ReadPage(unsigned long *pulSequence, TyFlashLogRecord *ptyRecords, unsigned char *pucCount);
@@ -5,6 +5,18 @@
                temperature / humidity sensor.
 Date           Initials    Description
 05-DEC-2016    MH          Initial
+17-OCT-2026    agent       Added non-blocking reads using the I2C queue.
+17-OCT-2026    agent       Added the timed conversion scheduler.
+17-OCT-2026    agent       Added the combined temperature and humidity read.
+17-OCT-2026    agent       Added configurable resolution.
+17-OCT-2026    agent       Uses a software timer for the conversion time.
+17-OCT-2026    agent       Optionally profiles the non-blocking reads.
+17-OCT-2026    agent       A measurement is read once, at the conversion
+                           time plus a margin, rather than retried until
+                           the device answers. The blocking reads sleep
+                           until then.
+17-OCT-2026    agent       The non-blocking reads convert in integers, to
+                           0.01 units.
 ****************************************************************************/
 #include "includes.h"
 
@@ -22,11 +34,272 @@ Date           Initials    Description
 
 #define RESET_BIT_MASK    0x80 // Bit mask to do a soft reset in CONFIG_HIGH_BYTE
 #define HEAT_BIT_MASK     0x20 // Bit mask to enable the heater in CONFIG_HIGH_BYTE.
+#define MODE_BIT_MASK     0x10 // Bit mask to acquire temperature and humidity in sequence in CONFIG_HIGH_BYTE.
+#define TRES_BIT_MASK     0x04 // Bit mask for the temperature resolution in CONFIG_HIGH_BYTE.
+#define HRES_BIT_MASK     0x03 // Bit mask for the humidity resolution in CONFIG_HIGH_BYTE.
 
 // HDC1080 delay times for powerup to readiness state (15ms)...
 // Delay values are as per the HDC1080 datasheet.
 #define POWERUP_DELAY          15000 // 15000 microseconds
 
+// HDC1080 conversion times in microseconds, indexed by TyHDC1080Resolution.
+// Values are as per the HDC1080 datasheet (0 = resolution not supported).
+static const unsigned short pusLocalTemperatureConversionTimes[] = {6350, 3650,    0};
+static const unsigned short pusLocalHumidityConversionTimes[]    = {6500, 3850, 2500};
+
+// TRES / HRES bits for each resolution, indexed by TyHDC1080Resolution...
+static const unsigned char pucLocalTemperatureResolutionBits[] = {0x00, 0x04, 0x00};
+static const unsigned char pucLocalHumidityResolutionBits[]    = {0x00, 0x01, 0x02};
+
+// The HDC1080 NACKs the read of a measurement until the conversion has
+// completed. The measurement is read once, this long after the datasheet
+// conversion time, and a NACK then fails the read...
+#define HDC1080_CONVERSION_MARGIN     1    // 1 millisecond
+
+// Copy of the high byte of the configuration register....
+static unsigned char     ucLocalConfigHighByte;
+
+// Conversion times for the configured resolution....
+static unsigned long     ulLocalTemperatureConversionTime; // Microseconds
+static unsigned long     ulLocalHumidityConversionTime;    // Microseconds
+
+// State of the conversion in progress. Only one conversion (blocking or
+// non-blocking) may be in progress at a time....
+static volatile unsigned char bLocalConversionInProgress;
+static volatile unsigned char bLocalConversionElapsed; // Set by the timer.
+static TyHDC1080Channel  tyLocalConversionChannel;
+static TySoftwareTimer   tyLocalConversionTimer;
+
+// Storage for the non-blocking reads....
+static TyI2CTransaction  tyLocalTransaction;
+static unsigned char     pucLocalTxData[0x3];
+static unsigned char     pucLocalRxData[0x4];
+static TyHDC1080Callback tyLocalCallback;
+static TyHDC1080CombinedCallback tyLocalCombinedCallback;
+
+
+/****************************************************************************
+     Function: HDC1080_ConvertTemperature
+     Engineer: agent
+        Input: unsigned char *pucData: Raw measurement (MSB first).
+       Output: Temperature in degrees C.
+  Description: Converts a raw temperature measurement.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static double HDC1080_ConvertTemperature(unsigned char *pucData)
+{
+   double dTemperature;
+
+   dTemperature = pucData[0x0];
+   dTemperature *= 0x100;
+   dTemperature += pucData[0x1];
+
+   dTemperature = (dTemperature / 0x10000) * 165 - 40; // As per HDC1080 datasheet
+
+   return dTemperature;
+}
+
+/****************************************************************************
+     Function: HDC1080_ConvertHumidity
+     Engineer: agent
+        Input: unsigned char *pucData: Raw measurement (MSB first).
+       Output: Humidity in %.
+  Description: Converts a raw humidity measurement.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static double HDC1080_ConvertHumidity(unsigned char *pucData)
+{
+   double dHumidity;
+
+   dHumidity = pucData[0x0];
+   dHumidity *= 0x100;
+   dHumidity += pucData[0x1];
+
+   dHumidity = (dHumidity / 0x10000) * 100; // As per HDC1080 datasheet
+
+   return dHumidity;
+}
+
+/****************************************************************************
+     Function: HDC1080_CentiTemperature
+     Engineer: agent
+        Input: unsigned char *pucData: Raw measurement (MSB first).
+       Output: Temperature in 0.01 degree C units.
+  Description: Converts a raw temperature measurement without floating
+               point, rounding down.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static short HDC1080_CentiTemperature(unsigned char *pucData)
+{
+   unsigned long ulRaw;
+
+   ulRaw = ((unsigned long)pucData[0x0] << 8) | pucData[0x1];
+
+   // (raw / 2^16) * 165 - 40 degrees, as per HDC1080 datasheet. The raw
+   // part is positive, so the shift rounds it down....
+   return (short)((long)((ulRaw * 16500ul) >> 16) - 4000l);
+}
+
+/****************************************************************************
+     Function: HDC1080_CentiHumidity
+     Engineer: agent
+        Input: unsigned char *pucData: Raw measurement (MSB first).
+       Output: Humidity in 0.01 % units.
+  Description: Converts a raw humidity measurement without floating point,
+               rounding down.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned short HDC1080_CentiHumidity(unsigned char *pucData)
+{
+   unsigned long ulRaw;
+
+   ulRaw = ((unsigned long)pucData[0x0] << 8) | pucData[0x1];
+
+   // (raw / 2^16) * 100 %, as per HDC1080 datasheet....
+   return (unsigned short)((ulRaw * 10000ul) >> 16);
+}
+
+/****************************************************************************
+     Function: HDC1080_ConversionTime
+     Engineer: agent
+        Input: TyHDC1080Channel tyChannel: Channel(s) being measured.
+       Output: Time to wait in whole milliseconds (rounded up).
+  Description: Returns the datasheet conversion time for a measurement at
+               the configured resolution, plus HDC1080_CONVERSION_MARGIN.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Adds the margin.
+****************************************************************************/
+static unsigned long HDC1080_ConversionTime(TyHDC1080Channel tyChannel)
+{
+   unsigned long ulConversionTime;
+
+   switch (tyChannel)
+      {
+      case HDC1080_TEMPERATURE:
+         ulConversionTime = ulLocalTemperatureConversionTime;
+      break;
+      case HDC1080_HUMIDITY:
+         ulConversionTime = ulLocalHumidityConversionTime;
+      break;
+      default:
+         // Temperature then humidity....
+         ulConversionTime = ulLocalTemperatureConversionTime + ulLocalHumidityConversionTime;
+      break;
+      }
+
+   return ((ulConversionTime + 999) / 1000) + HDC1080_CONVERSION_MARGIN;
+}
+
+/****************************************************************************
+     Function: HDC1080_ConversionConfig
+     Engineer: agent
+        Input: TyHDC1080Channel tyChannel: Channel(s) to measure.
+       Output: High byte of the configuration register for the measurement.
+  Description: The device converts both channels in sequence when the mode
+               bit is set, and only the addressed channel when it is clear.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char HDC1080_ConversionConfig(TyHDC1080Channel tyChannel)
+{
+   if (tyChannel == HDC1080_TEMPERATURE_AND_HUMIDITY)
+      return (unsigned char)(ucLocalConfigHighByte | MODE_BIT_MASK);
+
+   return (unsigned char)(ucLocalConfigHighByte & ~MODE_BIT_MASK);
+}
+
+/****************************************************************************
+     Function: HDC1080_ConvertMeasurement
+     Engineer: agent
+        Input: unsigned char *pucData: Raw measurement(s) (MSB first).
+               double *pdValues: Storage for the measurement(s).
+       Output: N/A
+  Description: Converts the raw measurement of the conversion in progress.
+               A combined measurement is stored as the temperature followed
+               by the humidity.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void HDC1080_ConvertMeasurement(unsigned char *pucData, double *pdValues)
+{
+   switch (tyLocalConversionChannel)
+      {
+      case HDC1080_TEMPERATURE:
+         pdValues[0] = HDC1080_ConvertTemperature(pucData);
+      break;
+      case HDC1080_HUMIDITY:
+         pdValues[0] = HDC1080_ConvertHumidity(pucData);
+      break;
+      default:
+         pdValues[0] = HDC1080_ConvertTemperature(&pucData[0]);
+         pdValues[1] = HDC1080_ConvertHumidity(&pucData[2]);
+      break;
+      }
+}
+
+/****************************************************************************
+     Function: HDC1080_ClaimConversion
+     Engineer: agent
+        Input: TyHDC1080Channel tyChannel: Channel(s) to measure.
+       Output: TRUE: Success, FALSE: Failure (conversion already in progress).
+  Description: Marks a conversion as in progress.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char HDC1080_ClaimConversion(TyHDC1080Channel tyChannel)
+{
+   tBoolean bInterruptsDisabled;
+   unsigned char bClaimed;
+
+   bInterruptsDisabled = MAP_IntMasterDisable();
+   bClaimed = (bLocalConversionInProgress == FALSE) ? TRUE : FALSE;
+   bLocalConversionInProgress = TRUE;
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+
+   if (bClaimed)
+      {
+      tyLocalConversionChannel = tyChannel;
+      }
+
+   return bClaimed;
+}
+
+/****************************************************************************
+     Function: HDC1080_WriteConfiguration
+     Engineer: agent
+        Input: unsigned char ucConfigHighByte: High byte of the
+                  configuration register.
+       Output: TRUE: Success, FALSE: Failure.
+  Description: Programs the configuration register.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char HDC1080_WriteConfiguration(unsigned char ucConfigHighByte)
+{
+   unsigned char pucTxRxData[0x3];
+
+   // Make sure that the I2C queue is not using the peripheral....
+   I2CQUEUE_WaitForIdle();
+
+   // Program the configuration register....
+   pucTxRxData[0] =  CONFIGURATION_REG;
+   pucTxRxData[1] =  ucConfigHighByte;
+   pucTxRxData[2] =  CONFIG_LOW_BYTE;
+
+   if (I2C_IF_Write(HDC1080_DEVICE_ADDR,pucTxRxData,3,1) != SUCCESS)
+   {
+      return FALSE;
+   }
+
+   return TRUE;
+}
+
 
 /****************************************************************************
      Function: HDC1080_Initialise
@@ -41,6 +314,15 @@ unsigned char HDC1080_Initialise(void)
 {
    unsigned char pucTxRxData[0x3];
 
+   // Make sure that the I2C queue is not using the peripheral....
+   I2CQUEUE_WaitForIdle();
+
+   bLocalConversionInProgress = FALSE;
+   ucLocalConfigHighByte      = CONFIG_HIGH_BYTE;
+
+   ulLocalTemperatureConversionTime = pusLocalTemperatureConversionTimes[HDC1080_RESOLUTION_14_BIT];
+   ulLocalHumidityConversionTime    = pusLocalHumidityConversionTimes[HDC1080_RESOLUTION_14_BIT];
+
    // Program the configuration register....
    pucTxRxData[0] =  CONFIGURATION_REG;
    pucTxRxData[1] =  CONFIG_HIGH_BYTE;
@@ -71,68 +353,255 @@ unsigned char HDC1080_Initialise(void)
   Description: Control function for enabling / disabling the heater.
 Date           Initials    Description
 12-DEC-2016    MH          Initial
+17-OCT-2026    agent       Preserve the rest of the configuration.
 ****************************************************************************/
 unsigned char HDC1080_HeaterControl(unsigned char bEnable)
 {
-   unsigned char pucTxRxData[0x3];
+   unsigned char ucConfigHighByte;
 
-   // Program the configuration register....
-   pucTxRxData[0] =  CONFIGURATION_REG;
-   pucTxRxData[1] =  CONFIG_HIGH_BYTE;
+   ucConfigHighByte = ucLocalConfigHighByte & ~HEAT_BIT_MASK;
 
    if (bEnable)
    {
-      pucTxRxData[1] |= HEAT_BIT_MASK;
+      ucConfigHighByte |= HEAT_BIT_MASK;
    }
 
-   pucTxRxData[2] =  CONFIG_LOW_BYTE;
+   if (HDC1080_WriteConfiguration(ucConfigHighByte) == FALSE)
+   {
+      return FALSE;
+   }
 
-   if (I2C_IF_Write(HDC1080_DEVICE_ADDR,pucTxRxData,3,1) != SUCCESS)
+   ucLocalConfigHighByte = ucConfigHighByte;
+
+   return TRUE;
+}
+
+/****************************************************************************
+     Function: HDC1080_SetResolution
+     Engineer: agent
+        Input: TyHDC1080Resolution tyTemperatureResolution: 14 or 11 bit.
+               TyHDC1080Resolution tyHumidityResolution: 14, 11 or 8 bit.
+       Output: TRUE: Success, FALSE: Failure.
+  Description: Configures the measurement resolution of each channel. The
+               conversion wait is adjusted to suit. Lower resolutions have
+               shorter conversion times. The unused low bits of a lower
+               resolution measurement read as zero, so the conversion to
+               degrees C / % is the same at every resolution.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char HDC1080_SetResolution(TyHDC1080Resolution tyTemperatureResolution, TyHDC1080Resolution tyHumidityResolution)
+{
+   unsigned char ucConfigHighByte;
+
+   if ((tyTemperatureResolution > HDC1080_RESOLUTION_8_BIT) ||
+       (tyHumidityResolution > HDC1080_RESOLUTION_8_BIT)    ||
+       (pusLocalTemperatureConversionTimes[tyTemperatureResolution] == 0))
    {
       return FALSE;
    }
 
+   // The resolution must not change part way through a conversion....
+   if (bLocalConversionInProgress)
+   {
+      return FALSE;
+   }
+
+   ucConfigHighByte  = ucLocalConfigHighByte & ~(TRES_BIT_MASK | HRES_BIT_MASK);
+   ucConfigHighByte |= pucLocalTemperatureResolutionBits[tyTemperatureResolution];
+   ucConfigHighByte |= pucLocalHumidityResolutionBits[tyHumidityResolution];
+
+   if (HDC1080_WriteConfiguration(ucConfigHighByte) == FALSE)
+   {
+      return FALSE;
+   }
+
+   ucLocalConfigHighByte = ucConfigHighByte;
+
+   ulLocalTemperatureConversionTime = pusLocalTemperatureConversionTimes[tyTemperatureResolution];
+   ulLocalHumidityConversionTime    = pusLocalHumidityConversionTimes[tyHumidityResolution];
+
    return TRUE;
 }
 
 /****************************************************************************
-     Function: HDC1080_ReadTemperature
-     Engineer: Martin Hannon
-        Input: double *pdTemperature: Storage for temperature value.
+     Function: HDC1080_ConversionDone
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Timer callback invoked once the conversion time of a
+               conversion started by HDC1080_StartConversion has elapsed.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void HDC1080_ConversionDone(void)
+{
+   bLocalConversionElapsed = TRUE;
+}
+
+/****************************************************************************
+     Function: HDC1080_StartConversion
+     Engineer: agent
+        Input: TyHDC1080Channel tyChannel: Channel(s) to measure.
        Output: TRUE: Success, FALSE: Failure.
-  Description: Reads the temperature value (in degrees C) from the HDC1080 
-               sensor.
+  Description: Triggers a measurement, and starts a timer for its
+               conversion time. The result is collected with
+               HDC1080_PollConversion.
 Date           Initials    Description
-05-DEC-2016    MH          Initial
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Times the conversion with a software timer.
 ****************************************************************************/
-unsigned char HDC1080_ReadTemperature(double *pdTemperature)
+unsigned char HDC1080_StartConversion(TyHDC1080Channel tyChannel)
 {
-   unsigned char pucTxRxData[0x2];
-   double dTemperature;
+   unsigned char pucTxRxData[0x1];
+   unsigned char ucConfigHighByte;
 
-   pucTxRxData[0] =  TEMPERATURE_REG;
+   if (HDC1080_ClaimConversion(tyChannel) == FALSE)
+      {
+      return FALSE;
+      }
 
-   // Trigger the measurement by writing TEMPERATURE_REG to the pointer register...
+   // Switch the acquisition mode if required....
+   ucConfigHighByte = HDC1080_ConversionConfig(tyChannel);
+   if (ucConfigHighByte != ucLocalConfigHighByte)
+   {
+      if (HDC1080_WriteConfiguration(ucConfigHighByte) == FALSE)
+      {
+         bLocalConversionInProgress = FALSE;
+         return FALSE;
+      }
+      ucLocalConfigHighByte = ucConfigHighByte;
+   }
+
+   // Make sure that the I2C queue is not using the peripheral....
+   I2CQUEUE_WaitForIdle();
+
+   // Both channels are triggered by TEMPERATURE_REG in sequence mode....
+   if (tyChannel == HDC1080_HUMIDITY)
+      pucTxRxData[0] =  HUMIDITY_REG;
+   else
+      pucTxRxData[0] =  TEMPERATURE_REG;
+
+   // Trigger the measurement by writing the register to the pointer register...
    if (I2C_IF_Write(HDC1080_DEVICE_ADDR,pucTxRxData,1,0) != SUCCESS)
    {
+      bLocalConversionInProgress = FALSE;
+      return FALSE;
+   }
+
+   bLocalConversionElapsed = FALSE;
+
+   if (TIMER_Start(&tyLocalConversionTimer, HDC1080_ConversionTime(tyChannel), 0, HDC1080_ConversionDone) == FALSE)
+   {
+      bLocalConversionInProgress = FALSE;
       return FALSE;
    }
 
+   return TRUE;
+}
+
+/****************************************************************************
+     Function: HDC1080_PollConversion
+     Engineer: agent
+        Input: double *pdValues: Storage for the measurement. For
+                  HDC1080_TEMPERATURE_AND_HUMIDITY this holds two values, the
+                  temperature followed by the humidity.
+       Output: HDC1080_CONVERSION_BUSY: Conversion still in progress.
+               HDC1080_CONVERSION_READY: pdValues holds the measurement.
+               HDC1080_CONVERSION_TIMEOUT: The device did not have the
+                  measurement at the end of the conversion time.
+               HDC1080_CONVERSION_ERROR: No conversion was started.
+  Description: Checks on the conversion started by HDC1080_StartConversion.
+               The bus is not accessed until the conversion time has
+               elapsed, and then only once.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Reads once, when the timer has expired.
+****************************************************************************/
+TyHDC1080ConversionStatus HDC1080_PollConversion(double *pdValues)
+{
+   unsigned char pucTxRxData[0x4];
+   unsigned char ucLength;
+
+   if (bLocalConversionInProgress == FALSE)
+      {
+      return HDC1080_CONVERSION_ERROR;
+      }
+
+   if (bLocalConversionElapsed == FALSE)
+      {
+      return HDC1080_CONVERSION_BUSY;
+      }
+
+   // Make sure that the I2C queue is not using the peripheral....
+   I2CQUEUE_WaitForIdle();
+
+   ucLength = (tyLocalConversionChannel == HDC1080_TEMPERATURE_AND_HUMIDITY) ? 4 : 2;
+
    // Read the result...
-   while (I2C_IF_Read(HDC1080_DEVICE_ADDR,pucTxRxData,2) != SUCCESS)
+   if (I2C_IF_Read(HDC1080_DEVICE_ADDR,pucTxRxData,ucLength) == SUCCESS)
    {
-   ;;
+      HDC1080_ConvertMeasurement(pucTxRxData, pdValues);
+      bLocalConversionInProgress = FALSE;
+      return HDC1080_CONVERSION_READY;
    }
 
-   dTemperature = pucTxRxData[0x0];
-   dTemperature *= 0x100;
-   dTemperature += pucTxRxData[0x1];
+   bLocalConversionInProgress = FALSE;
+   return HDC1080_CONVERSION_TIMEOUT;
+}
 
-   dTemperature = (dTemperature / 0x10000) * 165 - 40; // As per HDC1080 datasheet
+/****************************************************************************
+     Function: HDC1080_ReadChannel
+     Engineer: agent
+        Input: TyHDC1080Channel tyChannel: Channel(s) to measure.
+               double *pdValues: Storage for the measurement(s).
+       Output: TRUE: Success, FALSE: Failure.
+  Description: Performs a measurement, sleeping (see TIMER_Sleep) until the
+               conversion time has elapsed. Must be called with interrupts
+               enabled.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Sleeps rather than polling.
+****************************************************************************/
+static unsigned char HDC1080_ReadChannel(TyHDC1080Channel tyChannel, double *pdValues)
+{
+   TyHDC1080ConversionStatus tyStatus;
 
-   *pdTemperature = dTemperature;
+   if (HDC1080_StartConversion(tyChannel) == FALSE)
+   {
+      return FALSE;
+   }
 
-   return TRUE;
+   do
+      {
+      // Check the timer with interrupts disabled, so that it cannot
+      // expire between the check and the sleep....
+      MAP_IntMasterDisable();
+      if (bLocalConversionElapsed == FALSE)
+         TIMER_Sleep();
+      MAP_IntMasterEnable();
+
+      tyStatus = HDC1080_PollConversion(pdValues);
+      }
+   while (tyStatus == HDC1080_CONVERSION_BUSY);
+
+   return (tyStatus == HDC1080_CONVERSION_READY) ? TRUE : FALSE;
+}
+
+/****************************************************************************
+     Function: HDC1080_ReadTemperature
+     Engineer: Martin Hannon
+        Input: double *pdTemperature: Storage for temperature value.
+       Output: TRUE: Success, FALSE: Failure.
+  Description: Reads the temperature value (in degrees C) from the HDC1080 
+               sensor.
+Date           Initials    Description
+05-DEC-2016    MH          Initial
+17-OCT-2026    agent       Bounded by the conversion time.
+****************************************************************************/
+unsigned char HDC1080_ReadTemperature(double *pdTemperature)
+{
+   return HDC1080_ReadChannel(HDC1080_TEMPERATURE, pdTemperature);
 }
 
 /****************************************************************************
@@ -143,34 +612,317 @@ unsigned char HDC1080_ReadTemperature(double *pdTemperature)
   Description: Reads the humidity value (in %) from the HDC1080 sensor.
 Date           Initials    Description
 05-DEC-2016    MH          Initial
+17-OCT-2026    agent       Bounded by the conversion time.
 ****************************************************************************/
 unsigned char HDC1080_ReadHumidity(double *pdHumidity)
 {
-   unsigned char pucTxRxData[0x2];
-   double dHumidity;
+   return HDC1080_ReadChannel(HDC1080_HUMIDITY, pdHumidity);
+}
 
-   pucTxRxData[0] =  HUMIDITY_REG;
+/****************************************************************************
+     Function: HDC1080_ReadTemperatureAndHumidity
+     Engineer: agent
+        Input: double *pdTemperature: Storage for temperature value.
+               double *pdHumidity: Storage for humidity.
+       Output: TRUE: Success, FALSE: Failure.
+  Description: Reads the temperature (in degrees C) and humidity (in %) from
+               the HDC1080 sensor using a single trigger and read, with the
+               device acquiring both in sequence.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char HDC1080_ReadTemperatureAndHumidity(double *pdTemperature, double *pdHumidity)
+{
+   double pdValues[0x2];
 
-   // Trigger the measurement by writing HUMIDITY_REG to the pointer register...
-   if (I2C_IF_Write(HDC1080_DEVICE_ADDR,pucTxRxData,1,0) != SUCCESS)
+   if (HDC1080_ReadChannel(HDC1080_TEMPERATURE_AND_HUMIDITY, pdValues) == FALSE)
    {
       return FALSE;
    }
 
-   // Read the result...
-   while (I2C_IF_Read(HDC1080_DEVICE_ADDR,pucTxRxData,2) != SUCCESS)
-   {
-   ;;
-   }
+   *pdTemperature = pdValues[0];
+   *pdHumidity    = pdValues[1];
 
-   dHumidity = pucTxRxData[0x0];
-   dHumidity *= 0x100;
-   dHumidity += pucTxRxData[0x1];
+   return TRUE;
+}
 
-   dHumidity = (dHumidity / 0x10000) * 100; // As per HDC1080 datasheet
 
-   *pdHumidity    = dHumidity;
+/****************************************************************************
+     Function: HDC1080_FinishRead
+     Engineer: agent
+        Input: unsigned char bSuccess: TRUE if the read succeeded.
+       Output: N/A
+  Description: Ends a non-blocking read and reports the result, in 0.01
+               units.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Ends the profiling before the callback, which may
+                           start another read.
+17-OCT-2026    agent       Converts in integers.
+****************************************************************************/
+static void HDC1080_FinishRead(unsigned char bSuccess)
+{
+   TyHDC1080Callback tyCallback;
+   TyHDC1080CombinedCallback tyCombinedCallback;
+   short sValue;
+   unsigned short usHumidity;
+
+   PROFILE_END(PROFILE_HDC1080_READ);
+
+   sValue     = 0;
+   usHumidity = 0;
+
+   if (bSuccess)
+      {
+      switch (tyLocalConversionChannel)
+         {
+         case HDC1080_TEMPERATURE:
+            sValue = HDC1080_CentiTemperature(pucLocalRxData);
+         break;
+         case HDC1080_HUMIDITY:
+            sValue = (short)HDC1080_CentiHumidity(pucLocalRxData);
+         break;
+         default:
+            sValue     = HDC1080_CentiTemperature(&pucLocalRxData[0]);
+            usHumidity = HDC1080_CentiHumidity(&pucLocalRxData[2]);
+         break;
+         }
+      }
+
+   // Release the conversion before the callback so that the callback can
+   // start another read....
+   tyCallback         = tyLocalCallback;
+   tyCombinedCallback = tyLocalCombinedCallback;
+   bLocalConversionInProgress = FALSE;
+
+   if (tyCombinedCallback != NULL)
+      tyCombinedCallback(bSuccess, sValue, usHumidity);
+   else
+      tyCallback(bSuccess, sValue);
+}
+
+/****************************************************************************
+     Function: HDC1080_ReadComplete
+     Engineer: agent
+        Input: TyI2CTransaction *ptyTransaction: Completed transaction.
+       Output: N/A
+  Description: I2C queue callback for the read of a measurement. A NACK
+               means the device was still converting at the end of the
+               conversion time, and fails the read.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       No longer retries the read.
+****************************************************************************/
+static void HDC1080_ReadComplete(TyI2CTransaction *ptyTransaction)
+{
+   HDC1080_FinishRead((ptyTransaction->ucStatus == I2C_TRANSACTION_COMPLETE) ? TRUE : FALSE);
+}
+
+/****************************************************************************
+     Function: HDC1080_ConversionElapsed
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Timer callback invoked once the conversion time has elapsed.
+               Queues the read of the result.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void HDC1080_ConversionElapsed(void)
+{
+   tyLocalTransaction.ucTxLength = 0;
+   tyLocalTransaction.pucRxData  = pucLocalRxData;
+   tyLocalTransaction.ucRxLength = (tyLocalConversionChannel == HDC1080_TEMPERATURE_AND_HUMIDITY) ? 4 : 2;
+   tyLocalTransaction.tyCallback = HDC1080_ReadComplete;
+
+   if (I2CQUEUE_Submit(&tyLocalTransaction) == FALSE)
+      HDC1080_FinishRead(FALSE);
+}
+
+/****************************************************************************
+     Function: HDC1080_TriggerComplete
+     Engineer: agent
+        Input: TyI2CTransaction *ptyTransaction: Completed transaction.
+       Output: N/A
+  Description: I2C queue callback for the write of the pointer register which
+               triggers a measurement. Waits for the conversion time without
+               blocking.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void HDC1080_TriggerComplete(TyI2CTransaction *ptyTransaction)
+{
+   if (ptyTransaction->ucStatus == I2C_TRANSACTION_COMPLETE)
+      {
+      if (TIMER_Start(&tyLocalConversionTimer, HDC1080_ConversionTime(tyLocalConversionChannel), 0, HDC1080_ConversionElapsed))
+         return;
+      }
+
+   HDC1080_FinishRead(FALSE);
+}
+
+/****************************************************************************
+     Function: HDC1080_SubmitTrigger
+     Engineer: agent
+        Input: N/A
+       Output: TRUE: Success, FALSE: Failure.
+  Description: Queues the write of the pointer register which triggers the
+               measurement.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char HDC1080_SubmitTrigger(void)
+{
+   // Both channels are triggered by TEMPERATURE_REG in sequence mode....
+   if (tyLocalConversionChannel == HDC1080_HUMIDITY)
+      pucLocalTxData[0] = HUMIDITY_REG;
+   else
+      pucLocalTxData[0] = TEMPERATURE_REG;
+
+   tyLocalTransaction.ucDeviceAddress = HDC1080_DEVICE_ADDR;
+   tyLocalTransaction.pucTxData       = pucLocalTxData;
+   tyLocalTransaction.ucTxLength      = 1;
+   tyLocalTransaction.pucRxData       = NULL;
+   tyLocalTransaction.ucRxLength      = 0;
+   tyLocalTransaction.tyCallback      = HDC1080_TriggerComplete;
+   tyLocalTransaction.pvContext       = NULL;
+
+   return I2CQUEUE_Submit(&tyLocalTransaction);
+}
+
+/****************************************************************************
+     Function: HDC1080_ConfigurationComplete
+     Engineer: agent
+        Input: TyI2CTransaction *ptyTransaction: Completed transaction.
+       Output: N/A
+  Description: I2C queue callback for the write of the configuration register
+               when the acquisition mode is switched. Queues the trigger.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void HDC1080_ConfigurationComplete(TyI2CTransaction *ptyTransaction)
+{
+   if (ptyTransaction->ucStatus == I2C_TRANSACTION_COMPLETE)
+      {
+      ucLocalConfigHighByte = pucLocalTxData[1];
+
+      if (HDC1080_SubmitTrigger())
+         return;
+      }
+
+   HDC1080_FinishRead(FALSE);
+}
+
+/****************************************************************************
+     Function: HDC1080_StartRead
+     Engineer: agent
+        Input: TyHDC1080Channel tyChannel: Channel(s) to measure.
+               TyHDC1080Callback tyCallback: Invoked with the result of a
+                  single channel.
+               TyHDC1080CombinedCallback tyCombinedCallback: Invoked with the
+                  result of HDC1080_TEMPERATURE_AND_HUMIDITY.
+       Output: TRUE: Read started, FALSE: Failure (read already in progress).
+  Description: Starts a non-blocking measurement.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Optionally profiled to the completion.
+****************************************************************************/
+static unsigned char HDC1080_StartRead(TyHDC1080Channel tyChannel, TyHDC1080Callback tyCallback, TyHDC1080CombinedCallback tyCombinedCallback)
+{
+   unsigned char ucConfigHighByte, bSubmitted;
+
+   if ((tyCallback == NULL) && (tyCombinedCallback == NULL))
+      return FALSE;
+
+   if (HDC1080_ClaimConversion(tyChannel) == FALSE)
+      return FALSE;
+
+   PROFILE_START(PROFILE_HDC1080_READ);
+
+   tyLocalCallback         = tyCallback;
+   tyLocalCombinedCallback = tyCombinedCallback;
+
+   ucConfigHighByte = HDC1080_ConversionConfig(tyChannel);
+   if (ucConfigHighByte != ucLocalConfigHighByte)
+      {
+      // Switch the acquisition mode before triggering the measurement...
+      pucLocalTxData[0] = CONFIGURATION_REG;
+      pucLocalTxData[1] = ucConfigHighByte;
+      pucLocalTxData[2] = CONFIG_LOW_BYTE;
+
+      tyLocalTransaction.ucDeviceAddress = HDC1080_DEVICE_ADDR;
+      tyLocalTransaction.pucTxData       = pucLocalTxData;
+      tyLocalTransaction.ucTxLength      = 3;
+      tyLocalTransaction.pucRxData       = NULL;
+      tyLocalTransaction.ucRxLength      = 0;
+      tyLocalTransaction.tyCallback      = HDC1080_ConfigurationComplete;
+      tyLocalTransaction.pvContext       = NULL;
+
+      bSubmitted = I2CQUEUE_Submit(&tyLocalTransaction);
+      }
+   else
+      {
+      bSubmitted = HDC1080_SubmitTrigger();
+      }
+
+   if (bSubmitted == FALSE)
+      {
+      bLocalConversionInProgress = FALSE;
+      return FALSE;
+      }
 
    return TRUE;
 }
 
+/****************************************************************************
+     Function: HDC1080_ReadTemperatureAsync
+     Engineer: agent
+        Input: TyHDC1080Callback tyCallback: Invoked with the temperature (in
+                  0.01 degree C units) when the read completes.
+       Output: TRUE: Read started, FALSE: Failure (read already in progress).
+  Description: Non-blocking version of HDC1080_ReadTemperature. The callback
+               is invoked from the I2C or SysTick interrupt handler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char HDC1080_ReadTemperatureAsync(TyHDC1080Callback tyCallback)
+{
+   return HDC1080_StartRead(HDC1080_TEMPERATURE, tyCallback, NULL);
+}
+
+/****************************************************************************
+     Function: HDC1080_ReadHumidityAsync
+     Engineer: agent
+        Input: TyHDC1080Callback tyCallback: Invoked with the humidity (in
+                  0.01 % units) when the read completes.
+       Output: TRUE: Read started, FALSE: Failure (read already in progress).
+  Description: Non-blocking version of HDC1080_ReadHumidity. The callback is
+               invoked from the I2C or SysTick interrupt handler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char HDC1080_ReadHumidityAsync(TyHDC1080Callback tyCallback)
+{
+   return HDC1080_StartRead(HDC1080_HUMIDITY, tyCallback, NULL);
+}
+
+/****************************************************************************
+     Function: HDC1080_ReadTemperatureAndHumidityAsync
+     Engineer: agent
+        Input: TyHDC1080CombinedCallback tyCallback: Invoked with the
+                  temperature and humidity (in 0.01 units) when the read
+                  completes.
+       Output: TRUE: Read started, FALSE: Failure (read already in progress).
+  Description: Non-blocking version of HDC1080_ReadTemperatureAndHumidity.
+               The callback is invoked from the I2C or SysTick interrupt
+               handler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char HDC1080_ReadTemperatureAndHumidityAsync(TyHDC1080CombinedCallback tyCallback)
+{
+   if (tyCallback == NULL)
+      return FALSE;
+
+   return HDC1080_StartRead(HDC1080_TEMPERATURE_AND_HUMIDITY, NULL, tyCallback);
+}
@@ -5,10 +5,54 @@
                temperature / humidity sensor.
 Date           Initials    Description
 05-DEC-2016    MH          Initial
+17-OCT-2026    agent       Added non-blocking reads.
+17-OCT-2026    agent       Added the timed conversion scheduler.
+17-OCT-2026    agent       Added the combined temperature and humidity read.
+17-OCT-2026    agent       Added configurable resolution.
+17-OCT-2026    agent       Removed the conversion timeout.
+17-OCT-2026    agent       The non-blocking reads report in 0.01 units.
 ****************************************************************************/
 
+typedef enum
+{
+   HDC1080_TEMPERATURE = 0,
+   HDC1080_HUMIDITY    = 1,
+   HDC1080_TEMPERATURE_AND_HUMIDITY = 2
+} TyHDC1080Channel;
+
+// Measurement resolution. NOTE:- 8 bit is only supported for humidity.
+typedef enum
+{
+   HDC1080_RESOLUTION_14_BIT = 0,
+   HDC1080_RESOLUTION_11_BIT = 1,
+   HDC1080_RESOLUTION_8_BIT  = 2
+} TyHDC1080Resolution;
+
+typedef enum
+{
+   HDC1080_CONVERSION_BUSY    = 0,
+   HDC1080_CONVERSION_READY   = 1,
+   HDC1080_CONVERSION_TIMEOUT = 2,  // Not ready at the end of the conversion time.
+   HDC1080_CONVERSION_ERROR   = 3
+} TyHDC1080ConversionStatus;
+
+// Callback for the non-blocking reads. bSuccess is FALSE if the read failed.
+// The temperature is in 0.01 degree C units and the humidity in 0.01 %
+// units, each the step of the resolution at or below the measurement, so
+// that no floating point is needed.
+// NOTE:- This is invoked from the I2C or SysTick interrupt handler.
+typedef void (*TyHDC1080Callback)(unsigned char bSuccess, short sValue);
+typedef void (*TyHDC1080CombinedCallback)(unsigned char bSuccess, short sTemperature, unsigned short usHumidity);
+
 unsigned char HDC1080_Initialise(void);
 unsigned char HDC1080_HeaterControl(unsigned char bEnable);
+unsigned char HDC1080_SetResolution(TyHDC1080Resolution tyTemperatureResolution, TyHDC1080Resolution tyHumidityResolution);
+unsigned char HDC1080_StartConversion(TyHDC1080Channel tyChannel);
+TyHDC1080ConversionStatus HDC1080_PollConversion(double *pdValues);
 unsigned char HDC1080_ReadTemperature(double *pdTemperature);
 unsigned char HDC1080_ReadHumidity(double *pdHumidity);
+unsigned char HDC1080_ReadTemperatureAndHumidity(double *pdTemperature, double *pdHumidity);
+unsigned char HDC1080_ReadTemperatureAsync(TyHDC1080Callback tyCallback);
+unsigned char HDC1080_ReadHumidityAsync(TyHDC1080Callback tyCallback);
+unsigned char HDC1080_ReadTemperatureAndHumidityAsync(TyHDC1080CombinedCallback tyCallback);
 
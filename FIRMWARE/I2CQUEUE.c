@@ -0,0 +1,315 @@
+/****************************************************************************
+       Module: I2CQUEUE.c
+     Engineer: agent
+  Description: Contains an interrupt driven, non-blocking I2C transaction
+               queue. Transactions are queued by I2CQUEUE_Submit and run to
+               completion one after another by the I2C interrupt, which
+               invokes each transaction's completion callback.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Optionally profiles each transaction.
+****************************************************************************/
+#include "includes.h"
+#include "i2c.h"
+
+#define I2C_BASE                 I2CA0_BASE
+
+// Master interrupts used to step through a transaction...
+#define I2C_QUEUE_INTERRUPTS     (I2C_MASTER_INT_DATA | I2C_MASTER_INT_TIMEOUT)
+
+// Bus timeout, as used by the I2C_IF module.
+#define I2C_TIMEOUT_VAL          0x7D
+
+static TyI2CTransaction * volatile ptyLocalHead; // Transaction in progress.
+static TyI2CTransaction * volatile ptyLocalTail;
+
+
+/****************************************************************************
+     Function: I2CQUEUE_StartRead
+     Engineer: agent
+        Input: TyI2CTransaction *ptyTransaction: Transaction in progress.
+       Output: N/A
+  Description: Starts the read phase of a transaction, using a repeated
+               start if it follows the write phase.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void I2CQUEUE_StartRead(TyI2CTransaction *ptyTransaction)
+{
+   ptyTransaction->bReading = TRUE;
+
+   MAP_I2CMasterSlaveAddrSet(I2C_BASE, ptyTransaction->ucDeviceAddress, true);
+
+   if (ptyTransaction->ucRxLength == 1)
+      MAP_I2CMasterControl(I2C_BASE, I2C_MASTER_CMD_SINGLE_RECEIVE);
+   else
+      MAP_I2CMasterControl(I2C_BASE, I2C_MASTER_CMD_BURST_RECEIVE_START);
+}
+
+
+/****************************************************************************
+     Function: I2CQUEUE_Start
+     Engineer: agent
+        Input: TyI2CTransaction *ptyTransaction: Transaction to start.
+       Output: N/A
+  Description: Starts the first byte of a transaction. The rest of the
+               transaction is run by the interrupt handler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Optionally profiled to the completion.
+****************************************************************************/
+static void I2CQUEUE_Start(TyI2CTransaction *ptyTransaction)
+{
+   PROFILE_START(PROFILE_I2C_TRANSFER);
+
+   ptyTransaction->ucTxIndex = 0;
+   ptyTransaction->ucRxIndex = 0;
+   ptyTransaction->bReading  = FALSE;
+
+   // Clear any stale interrupts and enable the interrupts for the
+   // transaction...
+   MAP_I2CMasterIntClearEx(I2C_BASE, MAP_I2CMasterIntStatusEx(I2C_BASE, false));
+   MAP_I2CMasterIntEnableEx(I2C_BASE, I2C_QUEUE_INTERRUPTS);
+
+   if (ptyTransaction->ucTxLength == 0)
+      {
+      I2CQUEUE_StartRead(ptyTransaction);
+      return;
+      }
+
+   MAP_I2CMasterSlaveAddrSet(I2C_BASE, ptyTransaction->ucDeviceAddress, false);
+   MAP_I2CMasterDataPut(I2C_BASE, ptyTransaction->pucTxData[0]);
+   ptyTransaction->ucTxIndex = 1;
+
+   if ((ptyTransaction->ucTxLength == 1) && (ptyTransaction->ucRxLength == 0))
+      MAP_I2CMasterControl(I2C_BASE, I2C_MASTER_CMD_SINGLE_SEND);
+   else
+      MAP_I2CMasterControl(I2C_BASE, I2C_MASTER_CMD_BURST_SEND_START);
+}
+
+
+/****************************************************************************
+     Function: I2CQUEUE_Complete
+     Engineer: agent
+        Input: unsigned char ucStatus: I2C_TRANSACTION_COMPLETE or
+                  I2C_TRANSACTION_FAILED.
+       Output: N/A
+  Description: Completes the transaction at the head of the queue, invokes
+               its callback and starts the next transaction, if any.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Ends the profiling before the callback, which may
+                           start another transaction.
+****************************************************************************/
+static void I2CQUEUE_Complete(unsigned char ucStatus)
+{
+   TyI2CTransaction *ptyTransaction, *ptyNext;
+
+   PROFILE_END(PROFILE_I2C_TRANSFER);
+
+   ptyTransaction = ptyLocalHead;
+   ptyNext = ptyTransaction->ptyNext;
+
+   // Remove the transaction from the queue...
+   ptyLocalHead = ptyNext;
+   if (ptyNext == NULL)
+      {
+      ptyLocalTail = NULL;
+
+      // Nothing more to do, hand the peripheral back for synchronous use...
+      MAP_I2CMasterIntDisableEx(I2C_BASE, I2C_QUEUE_INTERRUPTS);
+      }
+
+   ptyTransaction->ucStatus = ucStatus;
+
+   // The callback may submit (or resubmit) transactions. If the queue was
+   // empty the first of these has already been started by I2CQUEUE_Submit.
+   if (ptyTransaction->tyCallback != NULL)
+      ptyTransaction->tyCallback(ptyTransaction);
+
+   if (ptyNext != NULL)
+      I2CQUEUE_Start(ptyNext);
+}
+
+
+/****************************************************************************
+     Function: I2CQUEUE_Interrupt
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Interrupt handler for the I2C master. Steps the transaction at
+               the head of the queue on by one byte.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void I2CQUEUE_Interrupt(void)
+{
+   unsigned long ulStatus;
+   unsigned char ucRemaining;
+   TyI2CTransaction *ptyTransaction;
+
+   ulStatus = MAP_I2CMasterIntStatusEx(I2C_BASE, true);
+   MAP_I2CMasterIntClearEx(I2C_BASE, ulStatus);
+
+   ptyTransaction = ptyLocalHead;
+   if (ptyTransaction == NULL)
+      return;
+
+   // Check for any errors in the transfer...
+   if ((ulStatus & I2C_MASTER_INT_TIMEOUT) || (MAP_I2CMasterErr(I2C_BASE) != I2C_MASTER_ERR_NONE))
+      {
+      if (ptyTransaction->bReading)
+         MAP_I2CMasterControl(I2C_BASE, I2C_MASTER_CMD_BURST_RECEIVE_ERROR_STOP);
+      else
+         MAP_I2CMasterControl(I2C_BASE, I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+
+      I2CQUEUE_Complete(I2C_TRANSACTION_FAILED);
+      return;
+      }
+
+   if (ptyTransaction->bReading == FALSE)
+      {
+      if (ptyTransaction->ucTxIndex < ptyTransaction->ucTxLength)
+         {
+         // Write the next byte, with a stop after the last if there is
+         // nothing to read...
+         MAP_I2CMasterDataPut(I2C_BASE, ptyTransaction->pucTxData[ptyTransaction->ucTxIndex]);
+         ptyTransaction->ucTxIndex++;
+
+         if ((ptyTransaction->ucTxIndex == ptyTransaction->ucTxLength) && (ptyTransaction->ucRxLength == 0))
+            MAP_I2CMasterControl(I2C_BASE, I2C_MASTER_CMD_BURST_SEND_FINISH);
+         else
+            MAP_I2CMasterControl(I2C_BASE, I2C_MASTER_CMD_BURST_SEND_CONT);
+         }
+      else if (ptyTransaction->ucRxLength == 0)
+         {
+         // Write only transaction and the stop has been sent...
+         I2CQUEUE_Complete(I2C_TRANSACTION_COMPLETE);
+         }
+      else
+         {
+         I2CQUEUE_StartRead(ptyTransaction);
+         }
+      return;
+      }
+
+   // Store the byte that has been read...
+   ptyTransaction->pucRxData[ptyTransaction->ucRxIndex] = (unsigned char)MAP_I2CMasterDataGet(I2C_BASE);
+   ptyTransaction->ucRxIndex++;
+
+   ucRemaining = ptyTransaction->ucRxLength - ptyTransaction->ucRxIndex;
+
+   if (ucRemaining == 0)
+      I2CQUEUE_Complete(I2C_TRANSACTION_COMPLETE);
+   else if (ucRemaining == 1)
+      MAP_I2CMasterControl(I2C_BASE, I2C_MASTER_CMD_BURST_RECEIVE_FINISH);
+   else
+      MAP_I2CMasterControl(I2C_BASE, I2C_MASTER_CMD_BURST_RECEIVE_CONT);
+}
+
+
+/****************************************************************************
+     Function: I2CQUEUE_Initialise
+     Engineer: agent
+        Input: N/A
+       Output: TRUE: Success, FALSE: Failure.
+  Description: Initialises the I2C transaction queue. I2C_IF_Open must have
+               been called first to configure the I2C peripheral.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char I2CQUEUE_Initialise(void)
+{
+   ptyLocalHead = NULL;
+   ptyLocalTail = NULL;
+
+   // The master interrupts are only enabled while a transaction is in
+   // progress, as the synchronous I2C_IF routines poll the raw status.
+   MAP_I2CMasterIntDisableEx(I2C_BASE, I2C_QUEUE_INTERRUPTS);
+   MAP_I2CMasterTimeoutSet(I2C_BASE, I2C_TIMEOUT_VAL);
+   MAP_I2CIntRegister(I2C_BASE, I2CQUEUE_Interrupt);
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: I2CQUEUE_Submit
+     Engineer: agent
+        Input: TyI2CTransaction *ptyTransaction: Transaction to queue.
+       Output: TRUE: Success, FALSE: Failure.
+  Description: Adds a transaction to the end of the queue, starting it
+               straight away if the queue is empty. Returns without waiting
+               for the transaction; completion is reported through the
+               transaction's ucStatus and callback. May be called from an
+               interrupt handler, including a completion callback.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char I2CQUEUE_Submit(TyI2CTransaction *ptyTransaction)
+{
+   tBoolean bInterruptsDisabled;
+
+   if ((ptyTransaction == NULL) ||
+       ((ptyTransaction->ucTxLength == 0) && (ptyTransaction->ucRxLength == 0)))
+      {
+      return FALSE;
+      }
+
+   ptyTransaction->ucStatus = I2C_TRANSACTION_PENDING;
+   ptyTransaction->ptyNext  = NULL;
+
+   bInterruptsDisabled = MAP_IntMasterDisable();
+
+   if (ptyLocalTail == NULL)
+      {
+      ptyLocalHead = ptyTransaction;
+      ptyLocalTail = ptyTransaction;
+      I2CQUEUE_Start(ptyTransaction);
+      }
+   else
+      {
+      ptyLocalTail->ptyNext = ptyTransaction;
+      ptyLocalTail = ptyTransaction;
+      }
+
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: I2CQUEUE_IsIdle
+     Engineer: agent
+        Input: N/A
+       Output: TRUE: No transactions queued, FALSE: Transactions queued.
+  Description: Reports whether the queue is empty.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char I2CQUEUE_IsIdle(void)
+{
+   return (ptyLocalHead == NULL) ? TRUE : FALSE;
+}
+
+
+/****************************************************************************
+     Function: I2CQUEUE_WaitForIdle
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Waits for all queued transactions to complete, so that the
+               synchronous I2C_IF routines can be used. Must not be called
+               from an interrupt handler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void I2CQUEUE_WaitForIdle(void)
+{
+   while (ptyLocalHead != NULL)
+      {
+      ;;
+      }
+}
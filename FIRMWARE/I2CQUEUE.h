@@ -0,0 +1,52 @@
+/****************************************************************************
+       Module: I2CQUEUE.h
+     Engineer: agent
+  Description: Contains the types and function prototypes for the interrupt
+               driven I2C transaction queue.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+
+// The following values are reported in the ucStatus field of a transaction.
+#define I2C_TRANSACTION_PENDING   0  // Queued or in progress.
+#define I2C_TRANSACTION_COMPLETE  1  // Completed successfully.
+#define I2C_TRANSACTION_FAILED    2  // NACK, arbitration lost or bus timeout.
+
+typedef struct TyI2CTransaction TyI2CTransaction;
+
+// Completion callback. NOTE:- This is invoked from the I2C interrupt handler,
+// and its execution time therefore should be kept to a minimum. It may submit
+// further transactions.
+typedef void (*TyI2CCompletionCallback)(TyI2CTransaction *ptyTransaction);
+
+// Describes one I2C transaction: an optional write of ucTxLength bytes
+// followed by an optional read of ucRxLength bytes (using a repeated start).
+// The storage is owned by the caller and must remain valid until the
+// completion callback has been invoked.
+struct TyI2CTransaction
+{
+   unsigned char ucDeviceAddress;
+   unsigned char *pucTxData;
+   unsigned char ucTxLength;
+   unsigned char *pucRxData;
+   unsigned char ucRxLength;
+   TyI2CCompletionCallback tyCallback;  // May be NULL.
+   void *pvContext;                     // For use by the caller.
+   volatile unsigned char ucStatus;     // I2C_TRANSACTION_xxx
+   // The following fields are private to the I2CQUEUE module.
+   unsigned char ucTxIndex;
+   unsigned char ucRxIndex;
+   unsigned char bReading;
+   TyI2CTransaction *ptyNext;
+};
+
+
+// Function prototypes from the I2CQUEUE module...
+//
+// NOTE:- The synchronous I2C_IF routines share the I2C peripheral with the
+// queue, so they must only be used while I2CQUEUE_IsIdle() returns TRUE
+// (see I2CQUEUE_WaitForIdle).
+unsigned char I2CQUEUE_Initialise(void);
+unsigned char I2CQUEUE_Submit(TyI2CTransaction *ptyTransaction);
+unsigned char I2CQUEUE_IsIdle(void);
+void I2CQUEUE_WaitForIdle(void);
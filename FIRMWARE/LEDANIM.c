@@ -0,0 +1,284 @@
+/****************************************************************************
+       Module: LEDANIM.c
+     Engineer: agent
+  Description: Contains the LED animation engine. Each LED bank runs its own
+               keyframe animation (ramps, breathing, colour blends etc.),
+               updated by periodic calls to LEDANIM_Update and written to
+               the TLC59116 without blocking.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Uses a periodic software timer for the tick.
+17-OCT-2026    agent       The application calls LEDANIM_Update, so that the
+                           updates run as a scheduler task rather than in
+                           the SysTick interrupt.
+****************************************************************************/
+#include "includes.h"
+
+#define LEDANIM_BANK_COUNT    4
+
+// Animation state of one bank...
+typedef struct
+{
+   const TyLedAnimation * volatile ptyAnimation; // NULL when not running.
+   unsigned char         ucKeyframe;   // Keyframe being faded to.
+   unsigned long         ulElapsed;    // Milliseconds into the fade.
+} TyLedBankAnimation;
+
+static TyLedBankAnimation     ptyLocalBanks[LEDANIM_BANK_COUNT];
+static unsigned long          ulLocalLastTick;
+static volatile unsigned long ulLocalCommitFailures;
+
+
+/****************************************************************************
+     Function: LEDANIM_Interpolate
+     Engineer: agent
+        Input: unsigned char ucFrom: Value at the start of the fade.
+               unsigned char ucTo: Value at the end of the fade.
+               unsigned long ulElapsed: Time into the fade.
+               unsigned long ulDuration: Length of the fade (non zero).
+       Output: Value at ulElapsed.
+  Description: Linear interpolation in integer maths.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char LEDANIM_Interpolate(unsigned char ucFrom, unsigned char ucTo, unsigned long ulElapsed, unsigned long ulDuration)
+{
+   long lDelta;
+
+   lDelta  = (long)ucTo - (long)ucFrom;
+   lDelta *= (long)ulElapsed;
+   lDelta /= (long)ulDuration;
+
+   return (unsigned char)((long)ucFrom + lDelta);
+}
+
+
+/****************************************************************************
+     Function: LEDANIM_Advance
+     Engineer: agent
+        Input: unsigned char ucBank: Bank to advance.
+               unsigned long ulElapsed: Time since the last update.
+       Output: N/A
+  Description: Moves a bank's animation on and sets the resulting colour.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void LEDANIM_Advance(unsigned char ucBank, unsigned long ulElapsed)
+{
+   TyLedBankAnimation *ptyBank;
+   const TyLedAnimation *ptyAnimation;
+   const TyLedKeyframe *ptyFrom, *ptyTo;
+
+   ptyBank      = &ptyLocalBanks[ucBank];
+   ptyAnimation = ptyBank->ptyAnimation;
+
+   ptyBank->ulElapsed += ulElapsed;
+
+   // Move on past any keyframes which have been reached....
+   while ((ptyBank->ucKeyframe < ptyAnimation->ucKeyframeCount) &&
+          (ptyBank->ulElapsed >= ptyAnimation->ptyKeyframes[ptyBank->ucKeyframe].usDuration))
+      {
+      ptyBank->ulElapsed -= ptyAnimation->ptyKeyframes[ptyBank->ucKeyframe].usDuration;
+      ptyBank->ucKeyframe++;
+
+      if ((ptyBank->ucKeyframe >= ptyAnimation->ucKeyframeCount) && ptyAnimation->bRepeat)
+         {
+         // Start again from the first keyframe...
+         ptyBank->ucKeyframe = 1;
+         }
+      }
+
+   if (ptyBank->ucKeyframe >= ptyAnimation->ucKeyframeCount)
+      {
+      // Finished, leave the bank at the last colour....
+      ptyTo = &ptyAnimation->ptyKeyframes[ptyAnimation->ucKeyframeCount - 1];
+
+      TLC59116_LedBankIntensity((TyLedBank)ucBank, (TyLedIntensity)ptyTo->ucBlue, (TyLedIntensity)ptyTo->ucGreen, (TyLedIntensity)ptyTo->ucRed);
+
+      ptyBank->ptyAnimation = NULL;
+      return;
+      }
+
+   ptyFrom = &ptyAnimation->ptyKeyframes[ptyBank->ucKeyframe - 1];
+   ptyTo   = &ptyAnimation->ptyKeyframes[ptyBank->ucKeyframe];
+
+   TLC59116_LedBankIntensity((TyLedBank)ucBank,
+                             (TyLedIntensity)LEDANIM_Interpolate(ptyFrom->ucBlue,  ptyTo->ucBlue,  ptyBank->ulElapsed, ptyTo->usDuration),
+                             (TyLedIntensity)LEDANIM_Interpolate(ptyFrom->ucGreen, ptyTo->ucGreen, ptyBank->ulElapsed, ptyTo->usDuration),
+                             (TyLedIntensity)LEDANIM_Interpolate(ptyFrom->ucRed,   ptyTo->ucRed,   ptyBank->ulElapsed, ptyTo->usDuration));
+}
+
+
+/****************************************************************************
+     Function: LEDANIM_CommitComplete
+     Engineer: agent
+        Input: unsigned char bSuccess: TRUE if the commit succeeded.
+       Output: N/A
+  Description: Completion callback for the TLC59116 commit.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void LEDANIM_CommitComplete(unsigned char bSuccess)
+{
+   if (bSuccess == FALSE)
+      ulLocalCommitFailures++;
+}
+
+
+/****************************************************************************
+     Function: LEDANIM_Update
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Called every LEDANIM_TICK_PERIOD. Advances the animations and
+               starts writing the changes to the TLC59116.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Runs from a periodic timer.
+17-OCT-2026    agent       Renamed from LEDANIM_Tick and made public.
+17-OCT-2026    agent       The elapsed time is masked to 32 bits.
+****************************************************************************/
+void LEDANIM_Update(void)
+{
+   unsigned char i;
+   unsigned long ulNow, ulElapsed;
+
+   // Use the actual time since the last update, so that a late tick does
+   // not slow the animations down....
+   ulNow     = TIMER_GetMilliseconds();
+   ulElapsed = TIMER_WRAP(ulNow - ulLocalLastTick);
+   ulLocalLastTick = ulNow;
+
+   for (i=0; i < LEDANIM_BANK_COUNT; i++)
+      {
+      if (ptyLocalBanks[i].ptyAnimation != NULL)
+         LEDANIM_Advance(i, ulElapsed);
+      }
+
+   // If the previous commit is still in progress the changes stay dirty and
+   // are written on the next tick....
+   TLC59116_CommitAsync(LEDANIM_CommitComplete);
+}
+
+
+/****************************************************************************
+     Function: LEDANIM_Initialise
+     Engineer: agent
+        Input: N/A
+       Output: TRUE: Success, FALSE: Failure.
+  Description: Initialises the animation engine. TIMER_Initialise and
+               TLC59116_Initialise must have been called first.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       The tick timer is now run by the application.
+****************************************************************************/
+unsigned char LEDANIM_Initialise(void)
+{
+   unsigned char i;
+
+   for (i=0; i < LEDANIM_BANK_COUNT; i++)
+      {
+      ptyLocalBanks[i].ptyAnimation = NULL;
+      }
+
+   ulLocalCommitFailures = 0;
+   ulLocalLastTick       = TIMER_GetMilliseconds();
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: LEDANIM_Start
+     Engineer: agent
+        Input: TyLedBank tyLedBank: LED bank to animate (0 to 3)
+               const TyLedAnimation *ptyAnimation: Animation to run. This
+                  must remain valid while the animation is running.
+       Output: TRUE: Success, FALSE: Failure (invalid animation).
+  Description: Starts an animation on a bank, replacing any animation that
+               is already running on it.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char LEDANIM_Start(TyLedBank tyLedBank, const TyLedAnimation *ptyAnimation)
+{
+   unsigned char i;
+   unsigned long ulLength;
+   tBoolean bInterruptsDisabled;
+
+   if ((tyLedBank > LED_BANK_3) || (ptyAnimation == NULL) ||
+       (ptyAnimation->ptyKeyframes == NULL) || (ptyAnimation->ucKeyframeCount == 0))
+      {
+      return FALSE;
+      }
+
+   // A repeating animation must take some time, or it would never end....
+   ulLength = 0;
+   for (i=1; i < ptyAnimation->ucKeyframeCount; i++)
+      {
+      ulLength += ptyAnimation->ptyKeyframes[i].usDuration;
+      }
+   if (ptyAnimation->bRepeat && (ulLength == 0))
+      {
+      return FALSE;
+      }
+
+   bInterruptsDisabled = MAP_IntMasterDisable();
+   ptyLocalBanks[tyLedBank].ucKeyframe   = 1;
+   ptyLocalBanks[tyLedBank].ulElapsed    = 0;
+   ptyLocalBanks[tyLedBank].ptyAnimation = ptyAnimation;
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: LEDANIM_Stop
+     Engineer: agent
+        Input: TyLedBank tyLedBank: LED bank (0 to 3)
+       Output: N/A
+  Description: Stops the animation on a bank, leaving the current colour.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void LEDANIM_Stop(TyLedBank tyLedBank)
+{
+   if (tyLedBank <= LED_BANK_3)
+      ptyLocalBanks[tyLedBank].ptyAnimation = NULL;
+}
+
+
+/****************************************************************************
+     Function: LEDANIM_IsRunning
+     Engineer: agent
+        Input: TyLedBank tyLedBank: LED bank (0 to 3)
+       Output: TRUE: Animation running, FALSE: No animation running.
+  Description: Reports whether a bank's animation is still running.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char LEDANIM_IsRunning(TyLedBank tyLedBank)
+{
+   if (tyLedBank > LED_BANK_3)
+      return FALSE;
+
+   return (ptyLocalBanks[tyLedBank].ptyAnimation != NULL) ? TRUE : FALSE;
+}
+
+
+/****************************************************************************
+     Function: LEDANIM_GetCommitFailures
+     Engineer: agent
+        Input: N/A
+       Output: Number of failed writes to the TLC59116.
+  Description: Returns the number of animation updates which could not be
+               written to the TLC59116.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned long LEDANIM_GetCommitFailures(void)
+{
+   return ulLocalCommitFailures;
+}
@@ -0,0 +1,40 @@
+/****************************************************************************
+       Module: LEDANIM.h
+     Engineer: agent
+  Description: Contains the types and function prototypes for the LED
+               animation engine.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added LEDANIM_Update.
+****************************************************************************/
+
+// Time between calls to LEDANIM_Update...
+#define LEDANIM_TICK_PERIOD   20 // 20 milliseconds
+
+// One point in an animation. The bank fades from the colour of the
+// previous keyframe to this colour over usDuration milliseconds. The
+// duration of the first keyframe is not used. A keyframe with the same
+// colour as the previous one holds the colour.
+typedef struct
+{
+   unsigned short usDuration;   // Milliseconds
+   unsigned char  ucBlue;       // TyLedIntensity
+   unsigned char  ucGreen;      // TyLedIntensity
+   unsigned char  ucRed;        // TyLedIntensity
+} TyLedKeyframe;
+
+typedef struct
+{
+   const TyLedKeyframe *ptyKeyframes;
+   unsigned char        ucKeyframeCount;
+   unsigned char        bRepeat;   // TRUE = Start again after the last keyframe.
+} TyLedAnimation;
+
+
+// Function prototypes from the LEDANIM module...
+unsigned char LEDANIM_Initialise(void);
+void LEDANIM_Update(void);
+unsigned char LEDANIM_Start(TyLedBank tyLedBank, const TyLedAnimation *ptyAnimation);
+void LEDANIM_Stop(TyLedBank tyLedBank);
+unsigned char LEDANIM_IsRunning(TyLedBank tyLedBank);
+unsigned long LEDANIM_GetCommitFailures(void);
@@ -5,29 +5,443 @@
                particle sensor.
 Date           Initials    Description
 05-DEC-2016    MH          Initial
+17-OCT-2026    agent       Integer low pulse width calculation.
+17-OCT-2026    agent       History held as a ring buffer with running totals.
+17-OCT-2026    agent       Double buffered snapshot of the measurements.
+17-OCT-2026    agent       Optional timer edge-time capture of P1 / P2.
+17-OCT-2026    agent       Capture timers are clocked in sleep mode.
+17-OCT-2026    agent       Notification callbacks are deferred to the
+                           scheduler through a lock-free queue.
+17-OCT-2026    agent       Added the particle concentration estimate.
+17-OCT-2026    agent       Feeds the rolling aggregates.
+17-OCT-2026    agent       Channels described by a table rather than P1 / P2
+                           being handled separately.
+17-OCT-2026    agent       Optionally profiles the interrupt handlers.
+17-OCT-2026    agent       The capture timers take both edges and the pin is
+                           read to tell them apart.
+17-OCT-2026    agent       The concentration functions are shared with the
+                           host tests. Corrected the rounding of the PM10
+                           mass factor.
+17-OCT-2026    agent       The low pulse width is shared with the host
+                           tests.
+17-OCT-2026    agent       The concentration estimate and the change of
+                           window are worked out by the notification
+                           processing, not the timer interrupt.
+17-OCT-2026    agent       The second counter is masked to 32 bits, and
+                           starts shortly before it wraps.
 ****************************************************************************/
 #include "includes.h"
 
 
-#define P1_GPIO_BASE       GPIOA1_BASE
-#define P1_GPIO_INTERRUPT  GPIO_INT_PIN_5
+#if defined(PPD42NJ_TIMER_CAPTURE)
 
-#define P2_GPIO_BASE       GPIOA1_BASE
-#define P2_GPIO_INTERRUPT  GPIO_INT_PIN_4
+// Describes a pulse channel timed by one half of a general purpose timer.
+// Each channel needs a timer of its own, as configuring a timer sets up both
+// halves. The timer captures both edges, and the level of the pin, read
+// through its GPIO port, tells which edge it was.
+typedef struct
+{
+   unsigned long ulPin;          // Pin muxed to the capture input.
+   unsigned long ulPeripheral;   // Capture timer peripheral.
+   unsigned long ulBase;         // Capture timer base address.
+   unsigned long ulTimer;        // TIMER_A or TIMER_B.
+   unsigned long ulConfig;       // Edge-time capture configuration.
+   unsigned long ulEvent;        // Capture event interrupt.
+   unsigned long ulGpioBase;     // GPIO port base address of the pin.
+   unsigned char ucGpioPin;      // GPIO_INT_PIN_x
+} TyPPD42NJChannel;
+
+// Channels in PPD42NJ_P1_CHANNEL / PPD42NJ_P2_CHANNEL order...
+static const TyPPD42NJChannel ptyLocalChannels[] =
+{
+   // P1 is on PIN_04 (GPIO13), which is GT_CCP04 and captured by TIMERA2 A...
+   {PIN_04, PRCM_TIMERA2, TIMERA2_BASE, TIMER_A, TIMER_CFG_A_CAP_TIME, TIMER_CAPA_EVENT, GPIOA1_BASE, GPIO_INT_PIN_5},
+   // P2 is on PIN_03 (GPIO12), which is GT_CCP03 and captured by TIMERA1 B...
+   {PIN_03, PRCM_TIMERA1, TIMERA1_BASE, TIMER_B, TIMER_CFG_B_CAP_TIME, TIMER_CAPB_EVENT, GPIOA1_BASE, GPIO_INT_PIN_4}
+};
+
+#define CAPTURE_PIN_MODE      PIN_MODE_12
+
+// In edge-time mode the capture timers count down through 24 bits (16 bit
+// timer plus 8 bit prescaler), so wrap every 209.7 ms. Low pulses longer
+// than this cannot be timed; the PPD42NJ low pulses are 10 to 90 ms.
+#define CAPTURE_TIMER_MASK    0x00FFFFFFul
+
+#else
+
+// Describes a pulse channel timed by a GPIO edge interrupt. The channels
+// should be listed grouped by port, as the interrupt status of a port is
+// read once for each group.
+typedef struct
+{
+   unsigned long ulGpioBase;     // GPIO port base address.
+   unsigned char ucGpioPin;      // GPIO_INT_PIN_x
+} TyPPD42NJChannel;
+
+// Channels in PPD42NJ_P1_CHANNEL / PPD42NJ_P2_CHANNEL order...
+static const TyPPD42NJChannel ptyLocalChannels[] =
+{
+   {GPIOA1_BASE, GPIO_INT_PIN_5},   // P1
+   {GPIOA1_BASE, GPIO_INT_PIN_4}    // P2
+};
+
+#endif
+
+// Check that the channel table matches PPD42NJ_CHANNEL_COUNT. The array size
+// is negative, and so will not compile, if it does not....
+typedef char TyPPD42NJChannelTableCheck[((sizeof(ptyLocalChannels) / sizeof(ptyLocalChannels[0])) == PPD42NJ_CHANNEL_COUNT) ? 1 : -1];
+
+// TIMERA0 clocks in 12.5 ns ticks (or 1/80 of a microsecond) and wraps
+// once per second. The capture timers use the same clock.
+#define TIMER_TICKS_PER_MICROSECOND  80ul
+#define TIMER_TICKS_PER_PERIOD       MILLISECONDS_TO_TICKS(1000ul)
+
+// The second counter starts shortly before it wraps, so that the wrap is
+// exercised (see TIMER_INITIAL_MILLISECONDS)....
+#ifndef PPD42NJ_INITIAL_SECOND
+#define PPD42NJ_INITIAL_SECOND       TIMER_WRAP(0ul - 16ul)
+#endif
 
 static volatile unsigned long ulLocalSecondCounter;
 
-static volatile unsigned long ulLocalP1FallTime;
-static volatile unsigned long ulLocalP2FallTime;
+// Time of each channel's last falling edge, 0xFFFFFFFF when not in a low
+// pulse...
+static volatile unsigned long pulLocalFallTimes[PPD42NJ_CHANNEL_COUNT];
+
+static volatile unsigned long pulLocalAccumulated[PPD42NJ_CHANNEL_COUNT]; // In 1 us units
+
+// The air quality measurements are double buffered. Each second the timer
+// interrupt brings the back buffer up to date and then publishes it, so the
+// published buffer is never written while it is published and is left
+// untouched until the second timer interrupt after it was replaced.
+static volatile TyAirQualityMeasurements ptyLocalAirQualityMeasurements[2];
+static volatile unsigned char ucLocalPublished; // Index of the published buffer.
+
+// Particle concentration curve, as used for the PPD42NJ by the Shinyei / 
+// Chris Nafis measurements:
+//    pcs/0.01cf = 1.1r^3 - 3.8r^2 + 520r + 0.62 (r = low pulse occupancy %)
+// With r held in 0.001 % units and the result in 0.01 pcs/0.01cf units this
+// becomes:
+//    (((110r - 380000)r + 52000000000)r) / 1000000000 + 62
+#define CONCENTRATION_CUBIC       110ll
+#define CONCENTRATION_SQUARE      380000ll
+#define CONCENTRATION_LINEAR      52000000000ll
+#define CONCENTRATION_SCALE       1000000000ll
+#define CONCENTRATION_OFFSET      62ul
+
+// Mass of one particle per 0.01 cf in ug/m3, in millionths. The particles are
+// taken as spheres of density 1.65e12 ug/m3, with a radius of 0.44 um for
+// PM2.5 and 2.6 um for PM10 (0.01 cf = 2.83168e-4 m3)...
+#define PM25_MASS_FACTOR          2079ull
+#define PM10_MASS_FACTOR          428991ull
+#define MASS_FACTOR_SCALE         1000000ull
+
+// Window in seconds for the next concentration estimates....
+static volatile unsigned short usLocalWindowSeconds;
 
-static volatile unsigned long ulLocalP1Accumulated; // In 1 us units
-static volatile unsigned long ulLocalP2Accumulated; // In 1 us units
+// A change of window is worked out by PPD42NJ_ProcessNotifications from the
+// published buffer, and handed to the timer interrupt to carry on from. The
+// totals are only taken if the back buffer has been brought up to the second
+// they were worked out for. bLocalWindowPending is cleared before the rest is
+// written and set after, so the interrupt never takes a part written change.
+static volatile unsigned char bLocalWindowPending;
+static volatile unsigned short usLocalPendingWindow;
+static volatile unsigned long ulLocalPendingSecond;
+static volatile unsigned long pulLocalPendingTotals[PPD42NJ_CHANNEL_COUNT]; // In 1 us units
 
-static volatile TyAirQualityMeasurements tyLocalAirQualityMeasurements;
+// Second and window of the last estimate worked out, so that polling the
+// processing does not work it out again....
+static unsigned long ulLocalEstimatedSecond;
+static unsigned short usLocalEstimatedWindow;
 
 static TyNotificationCallback tyLocalOneSecondCallback;
 static TyNotificationCallback tyLocalMaxHistoryCallback;
 
+// Notifications are passed from the timer interrupt (the only producer) to
+// PPD42NJ_ProcessNotifications (the only consumer) through a single
+// producer / single consumer queue. Only the producer writes ucLocalEventHead
+// and only the consumer writes ucLocalEventTail, so no locking is needed.
+// The indices run freely and are masked, so the size must be a power of 2.
+#define PPD42NJ_EVENT_QUEUE_SIZE  4
+
+static volatile unsigned char pucLocalEvents[PPD42NJ_EVENT_QUEUE_SIZE]; // NOTIFICATION_xxx
+static volatile unsigned char ucLocalEventHead;
+static volatile unsigned char ucLocalEventTail;
+static volatile unsigned long ulLocalEventsDropped;
+
+// TRUE while the processing of the queue is posted to the scheduler...
+static volatile unsigned char bLocalProcessingPosted;
+
+
+/****************************************************************************
+     Function: PPD42NJ_AddMeasurements
+     Engineer: agent
+        Input: volatile TyAirQualityMeasurements *ptyAirQualityMeasurements:
+                  Air quality measurements buffer to update.
+               const volatile unsigned long *pulTimes: Pulse time of each 
+                  channel for the second (1 us units)
+       Output: N/A
+  Description: Adds one second of measurements to a buffer, replacing the 
+               oldest measurements in the ring buffers and keeping the 
+               running totals up to date.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Keep the window totals up to date.
+17-OCT-2026    agent       Takes the pulse times of all the channels.
+****************************************************************************/
+static void PPD42NJ_AddMeasurements(volatile TyAirQualityMeasurements *ptyAirQualityMeasurements, const volatile unsigned long *pulTimes)
+{
+   unsigned char ucChannel;
+   unsigned short usHead, usLeaving;
+   volatile unsigned long *pulHistory;
+
+   usHead = ptyAirQualityMeasurements->usHead;
+
+   // Replace the entry leaving the window. When the window is the whole
+   // history this is the entry about to be overwritten....
+   usLeaving = (usHead + MAXIMUM_HISTORY_IN_SECONDS - ptyAirQualityMeasurements->usWindowSeconds) % MAXIMUM_HISTORY_IN_SECONDS;
+
+   for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
+      {
+      pulHistory = ptyAirQualityMeasurements->ppulTimes[ucChannel];
+
+      ptyAirQualityMeasurements->pulWindowTotals[ucChannel] -= pulHistory[usLeaving];
+      ptyAirQualityMeasurements->pulWindowTotals[ucChannel] += pulTimes[ucChannel];
+
+      ptyAirQualityMeasurements->pulTotals[ucChannel] -= pulHistory[usHead];
+      ptyAirQualityMeasurements->pulTotals[ucChannel] += pulTimes[ucChannel];
+      pulHistory[usHead] = pulTimes[ucChannel];
+      }
+
+   // Move the head on to the next oldest entry....
+   usHead++;
+   if (usHead >= MAXIMUM_HISTORY_IN_SECONDS)
+      usHead = 0;
+   ptyAirQualityMeasurements->usHead = usHead;
+
+   ptyAirQualityMeasurements->ulSecondsElapsed++;
+}
+
+
+/****************************************************************************
+     Function: PPD42NJ_CopyWindow
+     Engineer: agent
+        Input: volatile TyAirQualityMeasurements *ptyAirQualityMeasurements:
+                  Air quality measurements buffer to update.
+               unsigned short usSeconds: New window (1 to
+                  MAXIMUM_HISTORY_IN_SECONDS).
+               const volatile unsigned long *pulTotals: Totals of the
+                  newest usSeconds entries of each channel.
+       Output: N/A
+  Description: Changes the window of a buffer to one whose totals have
+               already been worked out, from a buffer holding the same
+               measurements.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void PPD42NJ_CopyWindow(volatile TyAirQualityMeasurements *ptyAirQualityMeasurements, unsigned short usSeconds, const volatile unsigned long *pulTotals)
+{
+   unsigned char ucChannel;
+
+   ptyAirQualityMeasurements->usWindowSeconds = usSeconds;
+
+   for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
+      ptyAirQualityMeasurements->pulWindowTotals[ucChannel] = pulTotals[ucChannel];
+}
+
+
+/****************************************************************************
+     Function: PPD42NJ_SumWindow
+     Engineer: agent
+        Input: const volatile TyAirQualityMeasurements *ptyAirQualityMeasurements:
+                  Air quality measurements buffer.
+               unsigned short usSeconds: Window (1 to
+                  MAXIMUM_HISTORY_IN_SECONDS).
+               unsigned long *pulTotals: Storage for the totals of each 
+                  channel.
+       Output: N/A
+  Description: Works out the window totals of a buffer for a new window
+               from its ring buffers. This takes time in proportion to the
+               window, so is not called from the timer interrupt.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void PPD42NJ_SumWindow(const volatile TyAirQualityMeasurements *ptyAirQualityMeasurements, unsigned short usSeconds, unsigned long *pulTotals)
+{
+   unsigned char ucChannel;
+   unsigned short i, usIndex;
+   unsigned long ulTotal;
+
+   for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
+      {
+      // Sum the newest usSeconds entries, which are just before the head...
+      ulTotal = 0;
+      usIndex = ptyAirQualityMeasurements->usHead;
+      for (i=0; i < usSeconds; i++)
+         {
+         if (usIndex == 0)
+            usIndex = MAXIMUM_HISTORY_IN_SECONDS;
+         usIndex--;
+
+         ulTotal += ptyAirQualityMeasurements->ppulTimes[ucChannel][usIndex];
+         }
+
+      pulTotals[ucChannel] = ulTotal;
+      }
+}
+
+
+/****************************************************************************
+     Function: PPD42NJ_Concentration
+     Engineer: agent
+        Input: unsigned long ulRatio: Low pulse occupancy (0.001 % units).
+       Output: Particle concentration (0.01 pcs / 0.01 cf units).
+  Description: Evaluates the particle concentration curve in fixed point.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       No longer static.
+****************************************************************************/
+unsigned long PPD42NJ_Concentration(unsigned long ulRatio)
+{
+   long long llRatio, llConcentration;
+
+   llRatio = (long long)ulRatio;
+
+   llConcentration = (CONCENTRATION_CUBIC * llRatio) - CONCENTRATION_SQUARE;
+   llConcentration = (llConcentration * llRatio) + CONCENTRATION_LINEAR;
+   llConcentration = (llConcentration * llRatio) / CONCENTRATION_SCALE;
+
+   return (unsigned long)llConcentration + CONCENTRATION_OFFSET;
+}
+
+
+/****************************************************************************
+     Function: PPD42NJ_CalculateConcentration
+     Engineer: agent
+        Input: const unsigned long *pulWindowTotals: Low pulse time of each
+                  channel over the window (1 us units).
+               unsigned short usWindowSeconds: Window.
+               unsigned long ulSecondsElapsed: Seconds measured so far.
+               TyParticleConcentration *ptyConcentration: Storage for the 
+                  estimate.
+       Output: N/A
+  Description: Works out the particle concentration estimate from the window
+               totals of a buffer. Uses 64 bit maths, so is not called from
+               the timer interrupt.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Estimates each channel and sensor.
+17-OCT-2026    agent       No longer static.
+17-OCT-2026    agent       Takes the window totals and stores the estimate
+                           apart from the buffer.
+****************************************************************************/
+void PPD42NJ_CalculateConcentration(const unsigned long *pulWindowTotals, unsigned short usWindowSeconds, unsigned long ulSecondsElapsed, TyParticleConcentration *ptyConcentration)
+{
+   unsigned char ucChannel, ucSensor;
+   unsigned short usSeconds;
+   unsigned long ulSmall, ulP1Concentration, ulP2Concentration;
+
+   ptyConcentration->ulSecondsElapsed = ulSecondsElapsed;
+
+   // Until the window has filled only the seconds so far count....
+   usSeconds = usWindowSeconds;
+   if (ulSecondsElapsed < usSeconds)
+      usSeconds = (unsigned short)ulSecondsElapsed;
+   ptyConcentration->usWindowSeconds = usSeconds;
+
+   if (usSeconds == 0)
+      return;
+
+   for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
+      {
+      // Total in us / (seconds * 1000000us) * 100% / 0.001%....
+      ptyConcentration->pulRatio[ucChannel] = pulWindowTotals[ucChannel] / ((unsigned long)usSeconds * 10ul);
+      ptyConcentration->pulConcentration[ucChannel] = PPD42NJ_Concentration(ptyConcentration->pulRatio[ucChannel]);
+      }
+
+   for (ucSensor=0; ucSensor < PPD42NJ_SENSOR_COUNT; ucSensor++)
+      {
+      ulP1Concentration = ptyConcentration->pulConcentration[PPD42NJ_P1_CHANNEL(ucSensor)];
+      ulP2Concentration = ptyConcentration->pulConcentration[PPD42NJ_P2_CHANNEL(ucSensor)];
+
+      // Particles between 1 um and 2.5 um....
+      if (ulP1Concentration > ulP2Concentration)
+         ulSmall = ulP1Concentration - ulP2Concentration;
+      else
+         ulSmall = 0;
+
+      ptyConcentration->pulPM25[ucSensor] = (unsigned long)(((unsigned long long)ulSmall * PM25_MASS_FACTOR) / MASS_FACTOR_SCALE);
+      ptyConcentration->pulPM10[ucSensor] = (unsigned long)(((unsigned long long)ulP2Concentration * PM10_MASS_FACTOR) / MASS_FACTOR_SCALE);
+      }
+}
+
+
+/****************************************************************************
+     Function: PPD42NJ_ProcessingEvent
+     Engineer: agent
+        Input: unsigned long ulParameter: Not used.
+       Output: N/A
+  Description: Scheduler event handler which processes the queued
+               notifications.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void PPD42NJ_ProcessingEvent(unsigned long ulParameter)
+{
+   PPD42NJ_ProcessNotifications();
+}
+
+
+/****************************************************************************
+     Function: PPD42NJ_PostProcessing
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Posts the processing of the notifications and the 
+               concentration estimate to the scheduler, unless it is already
+               posted. Called from the timer interrupt only.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void PPD42NJ_PostProcessing(void)
+{
+   if (bLocalProcessingPosted == FALSE)
+      {
+      if (SCHEDULER_Post(SCHEDULER_PRIORITY_HIGH, PPD42NJ_ProcessingEvent, 0))
+         bLocalProcessingPosted = TRUE;
+      }
+}
+
+
+/****************************************************************************
+     Function: PPD42NJ_QueueNotification
+     Engineer: agent
+        Input: unsigned char ucNotificationType: NOTIFICATION_xxx
+       Output: N/A
+  Description: Adds a notification to the queue. Called from the timer 
+               interrupt only. The notification is dropped if the queue is
+               full.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       The processing is posted by the timer interrupt.
+****************************************************************************/
+static void PPD42NJ_QueueNotification(unsigned char ucNotificationType)
+{
+   unsigned char ucHead;
+
+   ucHead = ucLocalEventHead;
+
+   if ((unsigned char)(ucHead - ucLocalEventTail) >= PPD42NJ_EVENT_QUEUE_SIZE)
+      {
+      ulLocalEventsDropped++;
+      return;
+      }
+
+   // Write the event before making it visible to the consumer...
+   pucLocalEvents[ucHead & (PPD42NJ_EVENT_QUEUE_SIZE - 1)] = ucNotificationType;
+   ucLocalEventHead = ucHead + 1;
+}
+
 
 /****************************************************************************
      Function: PPD42NJ_TimerInterrupt
@@ -37,139 +451,334 @@ static TyNotificationCallback tyLocalMaxHistoryCallback;
   Description: Interrupt handler for the PPD42NJ timer interrupt
 Date           Initials    Description
 05-DEC-2016    MH          Initial
+17-OCT-2026    agent       Replaced the FIFO shift with a ring buffer.
+17-OCT-2026    agent       Double buffered the measurements.
+17-OCT-2026    agent       Queues the notifications rather than invoking the
+                           callbacks.
+17-OCT-2026    agent       Updates the concentration estimate.
+17-OCT-2026    agent       Adds each second to the rolling aggregates.
+17-OCT-2026    agent       Handles all the channels.
+17-OCT-2026    agent       Optionally profiled. The timer counts up from 0
+                           after the timeout, so its count is the latency.
+17-OCT-2026    agent       Only publishes the measurements. The estimate
+                           and the change of window are worked out by
+                           PPD42NJ_ProcessNotifications, which is posted
+                           every second.
+17-OCT-2026    agent       The second counter is masked to 32 bits.
 ****************************************************************************/
 static void PPD42NJ_TimerInterrupt(void)
 {
-   unsigned char i;
+   unsigned char ucChannel;
+   unsigned short usNewest;
+   unsigned long pulNewest[PPD42NJ_CHANNEL_COUNT];
+   unsigned long pulAccumulated[PPD42NJ_CHANNEL_COUNT];
+   volatile TyAirQualityMeasurements *ptyPublished, *ptyBack;
+
+   PROFILE_START(PROFILE_PPD42NJ_TIMER_INTERRUPT);
+   PROFILE_LATENCY(PROFILE_PPD42NJ_TIMER_INTERRUPT, MAP_TimerValueGet(TIMERA0_BASE, TIMER_A));
+
    // Clear the timer interrupt.
    Timer_IF_InterruptClear(TIMERA0_BASE);
 
-   // Bump the local second counter...
-   ulLocalSecondCounter++;
+   // Take the accumulated counts and reset them for the next second...
+   for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
+      {
+      pulAccumulated[ucChannel] = pulLocalAccumulated[ucChannel];
+      pulLocalAccumulated[ucChannel] = 0;
 
-   // Update the air quality measurements...
-   tyLocalAirQualityMeasurements.ulSecondsElapsed = ulLocalSecondCounter;
+      AGGREGATE_AddSample(ucChannel, pulAccumulated[ucChannel]);
+      }
 
-   // Shift all measurements through the FIFO....
-   for (i=1; i < MAXIMUM_HISTORY_IN_SECONDS; i++)
+   ptyPublished = &ptyLocalAirQualityMeasurements[ucLocalPublished];
+   ptyBack      = &ptyLocalAirQualityMeasurements[ucLocalPublished ^ 1];
+
+   // The back buffer was last updated two seconds ago (except on the first
+   // second), so first bring it up to date with the newest measurements in
+   // the published buffer....
+   if (ptyBack->ulSecondsElapsed != ptyPublished->ulSecondsElapsed)
       {
-      tyLocalAirQualityMeasurements.pulP1Times[i-1] = tyLocalAirQualityMeasurements.pulP1Times[i];
-      tyLocalAirQualityMeasurements.pulP2Times[i-1] = tyLocalAirQualityMeasurements.pulP2Times[i];
+      usNewest = ptyPublished->usHead;
+      if (usNewest == 0)
+         usNewest = MAXIMUM_HISTORY_IN_SECONDS;
+      usNewest--;
+
+      for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
+         pulNewest[ucChannel] = ptyPublished->ppulTimes[ucChannel][usNewest];
+
+      PPD42NJ_AddMeasurements(ptyBack, pulNewest);
       }
 
-   // Add in the latest measurements at the end....
-   tyLocalAirQualityMeasurements.pulP1Times[MAXIMUM_HISTORY_IN_SECONDS-1] = ulLocalP1Accumulated;
-   tyLocalAirQualityMeasurements.pulP2Times[MAXIMUM_HISTORY_IN_SECONDS-1] = ulLocalP2Accumulated;
+   // The back buffer now holds the same measurements as the published
+   // buffer, so can take its window, or a change of window worked out
+   // from it....
+   if (ptyBack->usWindowSeconds != ptyPublished->usWindowSeconds)
+      PPD42NJ_CopyWindow(ptyBack, ptyPublished->usWindowSeconds, ptyPublished->pulWindowTotals);
+   if (bLocalWindowPending)
+      {
+      if (ulLocalPendingSecond == ptyBack->ulSecondsElapsed)
+         PPD42NJ_CopyWindow(ptyBack, usLocalPendingWindow, pulLocalPendingTotals);
+      bLocalWindowPending = FALSE;
+      }
+
+   // Add in the latest measurements....
+   PPD42NJ_AddMeasurements(ptyBack, pulAccumulated);
+
+   // Publish the back buffer....
+   ucLocalPublished ^= 1;
+
+   // Bump the local second counter...
+   ulLocalSecondCounter = TIMER_WRAP(ulLocalSecondCounter + 1);
 
-   // Reset the accumulated counts...
-   ulLocalP1Accumulated = 0;
-   ulLocalP2Accumulated = 0;
+   // The concentration estimate is worked out by the processing....
+   PPD42NJ_PostProcessing();
 
-   // Invoke the callbacks if configured....
+   // Queue the notifications if configured....
    if (tyLocalOneSecondCallback != NULL)
-      tyLocalOneSecondCallback();
+      PPD42NJ_QueueNotification(NOTIFICATION_1_SECOND_UPDATE);
    if (tyLocalMaxHistoryCallback != NULL)
       {
-      if ((ulLocalSecondCounter % MAXIMUM_HISTORY_IN_SECONDS) == 0)
-         tyLocalMaxHistoryCallback();
+      if ((TIMER_WRAP(ulLocalSecondCounter - PPD42NJ_INITIAL_SECOND) % MAXIMUM_HISTORY_IN_SECONDS) == 0)
+         PPD42NJ_QueueNotification(NOTIFICATION_MAX_HISTORY_UPDATE);
       }
+
+   PROFILE_END(PROFILE_PPD42NJ_TIMER_INTERRUPT);
 }
 
 
 /****************************************************************************
-     Function: PPD42NJ_PortLineInterrupt
-     Engineer: Martin Hannon
+     Function: PPD42NJ_LowPulseWidth
+     Engineer: agent
+        Input: unsigned long ulFallTime: TIMERA0 value at the falling edge.
+               unsigned long ulRiseTime: TIMERA0 value at the rising edge.
+       Output: unsigned long: Low pulse width in 1 us units.
+  Description: Calculates the width of a low pulse from the TIMERA0 values
+               captured on its edges, allowing for the timer wrapping at the
+               end of the one second period. Integer only, as the build uses
+               software floating point and this is called from the port line
+               interrupt on every rising edge.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       No longer static, for the host tests.
+****************************************************************************/
+unsigned long PPD42NJ_LowPulseWidth(unsigned long ulFallTime, unsigned long ulRiseTime)
+{
+   unsigned long ulTicks;
+
+   if (ulRiseTime < ulFallTime)
+      {
+      // The timer has wrapped between the falling and rising edges...
+      ulTicks = (TIMER_TICKS_PER_PERIOD - ulFallTime) + ulRiseTime;
+      }
+   else
+      {
+      ulTicks = ulRiseTime - ulFallTime;
+      }
+
+   // ulTicks is in 12.5 ns units. Change to 1 us units...
+   return ulTicks / TIMER_TICKS_PER_MICROSECOND;
+}
+
+
+#if defined(PPD42NJ_TIMER_CAPTURE)
+
+/****************************************************************************
+     Function: PPD42NJ_CapturedPulseWidth
+     Engineer: agent
+        Input: unsigned long ulFallTime: Captured time of the falling edge.
+               unsigned long ulRiseTime: Captured time of the rising edge.
+       Output: unsigned long: Low pulse width in 1 us units.
+  Description: Calculates the width of a low pulse from the capture timer 
+               values latched on its edges. The capture timers count down, 
+               and the mask allows for them wrapping during the pulse.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned long PPD42NJ_CapturedPulseWidth(unsigned long ulFallTime, unsigned long ulRiseTime)
+{
+   unsigned long ulTicks;
+
+   ulTicks = (ulFallTime - ulRiseTime) & CAPTURE_TIMER_MASK;
+
+   // ulTicks is in 12.5 ns units. Change to 1 us units...
+   return ulTicks / TIMER_TICKS_PER_MICROSECOND;
+}
+
+
+/****************************************************************************
+     Function: PPD42NJ_CaptureInterrupt
+     Engineer: agent
         Input: N/A
        Output: N/A
-  Description: Interrupt handler for the P1 / P1 inputs.
+  Description: Interrupt handler for the capture timers, shared by all the
+               channels. The timers latch the time of the edge in hardware,
+               so the interrupt latency does not affect the measurement. Both
+               edges are captured and the pin is read to tell which it was,
+               as the port line interrupt does. If an edge is missed (a
+               second edge before the interrupt is serviced, or the pin
+               already low when the capture started) the pulse it belonged
+               to is dropped, rather than the channel timing the high time
+               from then on.
 Date           Initials    Description
-05-DEC-2016    MH          Initial
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Replaced the P1 / P2 handlers with one handler
+                           driven by the channel table.
+17-OCT-2026    agent       Optionally profiled.
+17-OCT-2026    agent       Reads the pin rather than alternating the edge
+                           captured.
 ****************************************************************************/
-static void PPD42NJ_PortLineInterrupt(void)
+static void PPD42NJ_CaptureInterrupt(void)
 {
-   long lInterruptStatus;
-   unsigned long ulCurrentTimer;
-   double dDownTime;
+   unsigned char ucChannel, ucLevel;
+   unsigned long ulCaptureTime;
+   const TyPPD42NJChannel *ptyChannel;
 
+   PROFILE_START(PROFILE_PPD42NJ_EDGE_INTERRUPT);
 
-   lInterruptStatus = MAP_GPIOIntStatus(P1_GPIO_BASE, true);
+   for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
+      {
+      ptyChannel = &ptyLocalChannels[ucChannel];
+
+      if ((MAP_TimerIntStatus(ptyChannel->ulBase, true) & ptyChannel->ulEvent) == 0)
+         continue;
+
+      MAP_TimerIntClear(ptyChannel->ulBase, ptyChannel->ulEvent);
 
-   if (lInterruptStatus & P1_GPIO_INTERRUPT)
-   {
-      MAP_GPIOIntClear(P1_GPIO_BASE, P1_GPIO_INTERRUPT);
+      ulCaptureTime = MAP_TimerValueGet(ptyChannel->ulBase, ptyChannel->ulTimer);
+      ucLevel = (unsigned char)MAP_GPIOPinRead(ptyChannel->ulGpioBase, ptyChannel->ucGpioPin);
 
-      if (GPIOPinRead(P1_GPIO_BASE, P1_GPIO_INTERRUPT) == 0)
+      if (ucLevel == 0)
          {
-         // Falling edge...
-         ulLocalP1FallTime = MAP_TimerValueGet(TIMERA0_BASE, TIMER_A);
+         // Falling edge. Any earlier fall without a rise is dropped...
+         pulLocalFallTimes[ucChannel] = ulCaptureTime;
          }
-      else
+      else if (pulLocalFallTimes[ucChannel] != 0xFFFFFFFF)
          {
-         if (ulLocalP1FallTime != 0xFFFFFFFF)
-            {
-            // Rising edge...
-            ulCurrentTimer = MAP_TimerValueGet(TIMERA0_BASE, TIMER_A);
-
-            if (ulCurrentTimer < ulLocalP1FallTime)
-               {
-               dDownTime = MILLISECONDS_TO_TICKS(1000ul);
-               dDownTime -= ulLocalP1FallTime;
-               dDownTime += ulCurrentTimer;
-               }
-            else
-               {
-               dDownTime = ulCurrentTimer - ulLocalP1FallTime;
-               }
-
-           // dDownTime is in 12.5 ns units. Change to 1 us units...
-           dDownTime /= 80;
-
-           ulLocalP1Accumulated += (unsigned long)dDownTime;
-           ulLocalP1FallTime = 0xFFFFFFFF;
+         // Rising edge...
+         pulLocalAccumulated[ucChannel] += PPD42NJ_CapturedPulseWidth(pulLocalFallTimes[ucChannel], ulCaptureTime);
+         pulLocalFallTimes[ucChannel] = 0xFFFFFFFF;
          }
       }
-   }
 
+   PROFILE_END(PROFILE_PPD42NJ_EDGE_INTERRUPT);
+}
 
-   lInterruptStatus = MAP_GPIOIntStatus(P2_GPIO_BASE, true);
 
-   if (lInterruptStatus & P2_GPIO_INTERRUPT)
-      {
-      MAP_GPIOIntClear(P2_GPIO_BASE, P2_GPIO_INTERRUPT);
+/****************************************************************************
+     Function: PPD42NJ_ConfigureCapture
+     Engineer: agent
+        Input: const TyPPD42NJChannel *ptyChannel: Channel to configure.
+       Output: N/A
+  Description: Configures one half of a timer in edge-time capture mode,
+               capturing both edges.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Clock the timer in sleep mode.
+17-OCT-2026    agent       Takes the channel descriptor.
+17-OCT-2026    agent       Captures both edges.
+****************************************************************************/
+static void PPD42NJ_ConfigureCapture(const TyPPD42NJChannel *ptyChannel)
+{
+   // Route the pin to the timer capture input...
+   MAP_PinTypeTimer(ptyChannel->ulPin, CAPTURE_PIN_MODE);
+   MAP_PRCMPeripheralClkEnable(ptyChannel->ulPeripheral, PRCM_RUN_MODE_CLK | PRCM_SLP_MODE_CLK);
 
-      if (GPIOPinRead(P2_GPIO_BASE, P2_GPIO_INTERRUPT) == 0)
-      {
-         // Falling edge...
-         ulLocalP2FallTime = MAP_TimerValueGet(TIMERA0_BASE, TIMER_A);
-      }
-      else
+   // Free running 24 bit edge-time capture...
+   MAP_TimerConfigure(ptyChannel->ulBase, TIMER_CFG_SPLIT_PAIR | ptyChannel->ulConfig);
+   MAP_TimerControlEvent(ptyChannel->ulBase, ptyChannel->ulTimer, TIMER_EVENT_BOTH_EDGES);
+   MAP_TimerLoadSet(ptyChannel->ulBase, ptyChannel->ulTimer, 0xFFFF);
+   MAP_TimerPrescaleSet(ptyChannel->ulBase, ptyChannel->ulTimer, 0xFF);
+
+   MAP_TimerIntRegister(ptyChannel->ulBase, ptyChannel->ulTimer, PPD42NJ_CaptureInterrupt);
+   MAP_TimerIntEnable(ptyChannel->ulBase, ptyChannel->ulEvent);
+   MAP_TimerEnable(ptyChannel->ulBase, ptyChannel->ulTimer);
+}
+
+#else
+
+/****************************************************************************
+     Function: PPD42NJ_PortLineInterrupt
+     Engineer: Martin Hannon
+        Input: N/A
+       Output: N/A
+  Description: Interrupt handler for the channel inputs. The interrupt 
+               status, pin levels and timer are read once for each group of
+               channels on the same port, and each channel with a pending 
+               edge is then handled from the channel table.
+
+               An edge is timed when the handler reads the timer, not when
+               it happens. An edge that arrives while the handler is running
+               for another channel (e.g. P2 behind P1) waits for the next
+               run, so is timed up to a whole run late, and the pulse it
+               starts or ends is measured short or long by that much. A
+               few us is well under 0.1 % of the 10 to 90 ms sensor pulses,
+               but pulses only a few handler runs wide can lose a large
+               part of their time (see the short workload of the
+               benchmark). The PPD42NJ_TIMER_CAPTURE build
+               latches each edge in hardware and does not have this loss.
+Date           Initials    Description
+05-DEC-2016    MH          Initial
+17-OCT-2026    agent       Driven by the channel table, rather than P1 / P2
+                           being handled separately.
+17-OCT-2026    agent       Optionally profiled.
+****************************************************************************/
+static void PPD42NJ_PortLineInterrupt(void)
+{
+   unsigned char i, ucChannel, ucChannelPins, ucLevels;
+   unsigned long ulGpioBase, ulInterruptStatus, ulCurrentTimer;
+   const TyPPD42NJChannel *ptyChannel;
+
+   PROFILE_START(PROFILE_PPD42NJ_EDGE_INTERRUPT);
+
+   ulGpioBase        = 0;
+   ulInterruptStatus = 0;
+   ucLevels          = 0;
+   ulCurrentTimer    = 0;
+
+   for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
       {
-         if (ulLocalP2FallTime != 0xFFFFFFFF)
+      ptyChannel = &ptyLocalChannels[ucChannel];
+
+      if (ptyChannel->ulGpioBase != ulGpioBase)
+         {
+         // First channel on this port, so read and clear the interrupts for
+         // all the channels on the port...
+         ulGpioBase = ptyChannel->ulGpioBase;
+         ulInterruptStatus = MAP_GPIOIntStatus(ulGpioBase, true);
+
+         ucChannelPins = 0;
+         for (i=ucChannel; (i < PPD42NJ_CHANNEL_COUNT) && (ptyLocalChannels[i].ulGpioBase == ulGpioBase); i++)
+            ucChannelPins |= ptyLocalChannels[i].ucGpioPin;
+
+         ulInterruptStatus &= ucChannelPins;
+         if (ulInterruptStatus != 0)
             {
-            // Rising edge...
+            MAP_GPIOIntClear(ulGpioBase, ulInterruptStatus);
+            ucLevels = (unsigned char)MAP_GPIOPinRead(ulGpioBase, ucChannelPins);
             ulCurrentTimer = MAP_TimerValueGet(TIMERA0_BASE, TIMER_A);
+            }
+         }
+
+      if ((ulInterruptStatus & ptyChannel->ucGpioPin) == 0)
+         continue;
 
-            if (ulCurrentTimer < ulLocalP2FallTime)
-               {
-               dDownTime = MILLISECONDS_TO_TICKS(1000ul);
-               dDownTime -= ulLocalP2FallTime;
-               dDownTime += ulCurrentTimer;
-               }
-            else
-               {
-               dDownTime = ulCurrentTimer - ulLocalP2FallTime;
-               }
-
-          // dDownTime is in 12.5 ns units. Change to 1 us units...
-          dDownTime /= 80;
-
-          ulLocalP2Accumulated += (unsigned long)dDownTime;
-          ulLocalP2FallTime = 0xFFFFFFFF;
+      if ((ucLevels & ptyChannel->ucGpioPin) == 0)
+         {
+         // Falling edge...
+         pulLocalFallTimes[ucChannel] = ulCurrentTimer;
+         }
+      else if (pulLocalFallTimes[ucChannel] != 0xFFFFFFFF)
+         {
+         // Rising edge...
+         pulLocalAccumulated[ucChannel] += PPD42NJ_LowPulseWidth(pulLocalFallTimes[ucChannel], ulCurrentTimer);
+         pulLocalFallTimes[ucChannel] = 0xFFFFFFFF;
          }
       }
-   }
+
+   PROFILE_END(PROFILE_PPD42NJ_EDGE_INTERRUPT);
 }
 
+#endif
+
 /****************************************************************************
      Function: PPD42NJ_Initialise
      Engineer: Martin Hannon
@@ -178,28 +787,66 @@ static void PPD42NJ_PortLineInterrupt(void)
   Description: Initialises the PPD42NJ sensor
 Date           Initials    Description
 05-DEC-2016    MH          Initial
+17-OCT-2026    agent       Timer capture configuration.
+17-OCT-2026    agent       Reset the notification queue.
+17-OCT-2026    agent       Reset the concentration estimate.
+17-OCT-2026    agent       Reset the rolling aggregates.
+17-OCT-2026    agent       Configures the channels from the channel table.
+17-OCT-2026    agent       Reset the change of window.
+17-OCT-2026    agent       The second counter starts at
+                           PPD42NJ_INITIAL_SECOND.
 ****************************************************************************/
 unsigned char PPD42NJ_Initialise(void)
 {
-   unsigned char i;
+   unsigned char j, ucChannel;
+   unsigned short i;
 
    // Initialise the local variables....
-   ulLocalSecondCounter = 0;
-   ulLocalP1FallTime = 0xFFFFFFFF;
-   ulLocalP2FallTime = 0xFFFFFFFF;
-   ulLocalP1Accumulated = 0;
-   ulLocalP2Accumulated = 0;
+   ulLocalSecondCounter = PPD42NJ_INITIAL_SECOND;
+   for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
+      {
+      pulLocalFallTimes[ucChannel] = 0xFFFFFFFF;
+      pulLocalAccumulated[ucChannel] = 0;
+      }
    tyLocalOneSecondCallback = NULL;
    tyLocalMaxHistoryCallback = NULL;
+   ucLocalEventHead = 0;
+   ucLocalEventTail = 0;
+   ulLocalEventsDropped = 0;
+   bLocalProcessingPosted = FALSE;
+   usLocalWindowSeconds = PPD42NJ_DEFAULT_WINDOW_IN_SECONDS;
+   bLocalWindowPending = FALSE;
+   ulLocalEstimatedSecond = 0;
+   usLocalEstimatedWindow = PPD42NJ_DEFAULT_WINDOW_IN_SECONDS;
+   AGGREGATE_Initialise();
 
-   // Reset the air quality measurements...
-   tyLocalAirQualityMeasurements.ulSecondsElapsed = 0;
-
-   // Reset all the measurements through the FIFO....
-   for (i=0; i < MAXIMUM_HISTORY_IN_SECONDS; i++)
+   // Reset both air quality measurement buffers...
+   ucLocalPublished = 0;
+   for (j=0; j < 2; j++)
       {
-      tyLocalAirQualityMeasurements.pulP1Times[i] = 0;
-      tyLocalAirQualityMeasurements.pulP2Times[i] = 0;
+      ptyLocalAirQualityMeasurements[j].ulSecondsElapsed = 0;
+      ptyLocalAirQualityMeasurements[j].usHead = 0;
+      ptyLocalAirQualityMeasurements[j].usWindowSeconds = PPD42NJ_DEFAULT_WINDOW_IN_SECONDS;
+      ptyLocalAirQualityMeasurements[j].tyConcentration.ulSecondsElapsed = 0;
+      ptyLocalAirQualityMeasurements[j].tyConcentration.usWindowSeconds = 0;
+
+      for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
+         {
+         ptyLocalAirQualityMeasurements[j].pulTotals[ucChannel] = 0;
+         ptyLocalAirQualityMeasurements[j].pulWindowTotals[ucChannel] = 0;
+         ptyLocalAirQualityMeasurements[j].tyConcentration.pulRatio[ucChannel] = 0;
+         ptyLocalAirQualityMeasurements[j].tyConcentration.pulConcentration[ucChannel] = 0;
+
+         // Reset all the measurements in the ring buffer....
+         for (i=0; i < MAXIMUM_HISTORY_IN_SECONDS; i++)
+            ptyLocalAirQualityMeasurements[j].ppulTimes[ucChannel][i] = 0;
+         }
+
+      for (i=0; i < PPD42NJ_SENSOR_COUNT; i++)
+         {
+         ptyLocalAirQualityMeasurements[j].tyConcentration.pulPM25[i] = 0;
+         ptyLocalAirQualityMeasurements[j].tyConcentration.pulPM10[i] = 0;
+         }
       }
 
    // Initial the TIMERA for a 1 second periodic timeout...
@@ -207,9 +854,16 @@ unsigned char PPD42NJ_Initialise(void)
    Timer_IF_IntSetup(TIMERA0_BASE, TIMER_A, PPD42NJ_TimerInterrupt);
    Timer_IF_Start(TIMERA0_BASE, TIMER_A, 1000ul);
 
-   // Configure the port line interrupts....
-   GPIO_IF_ConfigureNIntEnable(P1_GPIO_BASE, P1_GPIO_INTERRUPT, GPIO_BOTH_EDGES, PPD42NJ_PortLineInterrupt);
-   GPIO_IF_ConfigureNIntEnable(P2_GPIO_BASE, P2_GPIO_INTERRUPT, GPIO_BOTH_EDGES, PPD42NJ_PortLineInterrupt);
+   for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
+      {
+#if defined(PPD42NJ_TIMER_CAPTURE)
+      // Configure the capture timer....
+      PPD42NJ_ConfigureCapture(&ptyLocalChannels[ucChannel]);
+#else
+      // Configure the port line interrupt....
+      GPIO_IF_ConfigureNIntEnable(ptyLocalChannels[ucChannel].ulGpioBase, ptyLocalChannels[ucChannel].ucGpioPin, GPIO_BOTH_EDGES, PPD42NJ_PortLineInterrupt);
+#endif
+      }
     
    return TRUE;
 }
@@ -225,10 +879,13 @@ unsigned char PPD42NJ_Initialise(void)
        Output: TRUE: Success, FALSE: Failure.
   Description: Configures the notification callback function pointers.
   
-               NOTE:- These callbacks are invoked from an interrupt handler, 
-               and their execution time therefore should be kept to a minimum.
+               The callbacks are invoked from PPD42NJ_ProcessNotifications,
+               which is posted to the scheduler by the timer interrupt, so
+               they do not run at interrupt level.
 Date           Initials    Description
 05-DEC-2016    MH          Initial
+17-OCT-2026    agent       The callbacks are no longer invoked from the
+                           timer interrupt.
 ****************************************************************************/
 unsigned char PPD42NJ_SetupNotifications(unsigned char ucNotificationType, TyNotificationCallback tyNotificationCallback)
 {
@@ -246,29 +903,222 @@ unsigned char PPD42NJ_SetupNotifications(unsigned char ucNotificationType, TyNot
       }
 }
 
+/****************************************************************************
+     Function: PPD42NJ_SetConcentrationWindow
+     Engineer: agent
+        Input: unsigned short usSeconds: Seconds of measurements to estimate
+                  the particle concentration over (1 to 
+                  MAXIMUM_HISTORY_IN_SECONDS).
+       Output: TRUE: Success, FALSE: Failure (invalid window).
+  Description: Sets the window for the particle concentration estimate. The
+               new window is used from the next time the notifications are
+               processed.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Taken up by the processing, not the timer
+                           interrupt.
+****************************************************************************/
+unsigned char PPD42NJ_SetConcentrationWindow(unsigned short usSeconds)
+{
+   if ((usSeconds == 0) || (usSeconds > MAXIMUM_HISTORY_IN_SECONDS))
+      return FALSE;
+
+   usLocalWindowSeconds = usSeconds;
+
+   return TRUE;
+}
+
 /****************************************************************************
      Function: PPD42NJ_GetAirQualityMeasurements
      Engineer: Martin Hannon
         Input: TyAirQualityMeasurements *ptyAirQualityMeasurements: 
                   Storage for the air quality measurements.
        Output: TRUE: Success, FALSE: Failure.
-  Description: Returns the air quality measurements.
+  Description: Returns a copy of the air quality measurements. 
+  
+               The copy is taken from the published buffer, which is not
+               written until the second timer interrupt after this call. 
+               FALSE is only returned if the copy was held up for that long, 
+               in which case it may be inconsistent. There is no retry, so 
+               the time taken is bounded.
 Date           Initials    Description
 05-DEC-2016    MH          Initial
+17-OCT-2026    agent       Copy from the published buffer without retrying.
+17-OCT-2026    agent       The second counter is masked to 32 bits.
 ****************************************************************************/
 unsigned char PPD42NJ_GetAirQualityMeasurements(TyAirQualityMeasurements *ptyAirQualityMeasurements)
 {
-   unsigned long ulSecondCounter = 0;
+   unsigned long ulSecondCounter;
+
+   // Take a copy of the current second counter...
+   ulSecondCounter = ulLocalSecondCounter;
+
+   // Copy over the air quality measurements....
+   *ptyAirQualityMeasurements = ptyLocalAirQualityMeasurements[ucLocalPublished];
+
+   // If the buffer has been written during the copy, the copy is not valid.
+   if (TIMER_WRAP(ulLocalSecondCounter - ulSecondCounter) >= 2)
+      return FALSE;
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: PPD42NJ_GetAirQualityMeasurementsSnapshot
+     Engineer: agent
+        Input: N/A
+       Output: const TyAirQualityMeasurements *: The published air quality
+                  measurements.
+  Description: Returns a pointer to the published air quality measurements
+               without copying them. The buffer pointed to is left untouched
+               until the second timer interrupt after this call, i.e. for at
+               least one second, after which the pointer must not be used.
+
+               Called from a notification callback, this is normally the
+               snapshot that was published with the notification.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+const TyAirQualityMeasurements *PPD42NJ_GetAirQualityMeasurementsSnapshot(void)
+{
+   return (const TyAirQualityMeasurements *)&ptyLocalAirQualityMeasurements[ucLocalPublished];
+}
+
+
+/****************************************************************************
+     Function: PPD42NJ_UpdateConcentration
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Works out the concentration estimate of the published buffer,
+               unless it has already been worked out for its second and the
+               current window, and stores it in the buffer. A change of 
+               window is summed from the published buffer here and handed 
+               to the timer interrupt, which carries on from it.
+
+               The published buffer is not written by the timer interrupt 
+               until the second interrupt after it was replaced, and never 
+               has its estimate written, so it can be read here without 
+               locking. If that second interrupt has already happened the
+               estimate is not stored, and is worked out again by the next
+               processing.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       The second counter is masked to 32 bits.
+****************************************************************************/
+static void PPD42NJ_UpdateConcentration(void)
+{
+   unsigned char ucChannel;
+   unsigned short usWindowSeconds;
+   unsigned long ulSecondCounter, ulSecondsElapsed;
+   unsigned long pulTotals[PPD42NJ_CHANNEL_COUNT];
+   volatile TyAirQualityMeasurements *ptyPublished;
+   TyParticleConcentration tyConcentration;
+
+   ulSecondCounter  = ulLocalSecondCounter;
+   ptyPublished     = &ptyLocalAirQualityMeasurements[ucLocalPublished];
+   ulSecondsElapsed = ptyPublished->ulSecondsElapsed;
+   usWindowSeconds  = usLocalWindowSeconds;
 
-   do
+   if ((ulSecondsElapsed == ulLocalEstimatedSecond) && (usWindowSeconds == usLocalEstimatedWindow))
+      return;
+
+   if (usWindowSeconds != ptyPublished->usWindowSeconds)
       {
-         // Take a copy of the current second counter...
-         ulSecondCounter = ulLocalSecondCounter;
+      PPD42NJ_SumWindow(ptyPublished, usWindowSeconds, pulTotals);
 
-         // Copy over the air quality measurements....
-         *ptyAirQualityMeasurements = tyLocalAirQualityMeasurements;
+      // Hand the new window to the timer interrupt....
+      bLocalWindowPending = FALSE;
+      usLocalPendingWindow = usWindowSeconds;
+      ulLocalPendingSecond = ulSecondsElapsed;
+      for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
+         pulLocalPendingTotals[ucChannel] = pulTotals[ucChannel];
+      bLocalWindowPending = TRUE;
+      }
+   else
+      {
+      for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
+         pulTotals[ucChannel] = ptyPublished->pulWindowTotals[ucChannel];
       }
-   while (ulSecondCounter != ulLocalSecondCounter); // If interrupt has occurred during the copy, retry.
 
-   return TRUE;
+   PPD42NJ_CalculateConcentration(pulTotals, usWindowSeconds, ulSecondsElapsed, &tyConcentration);
+
+   // If the buffer has been written in the meantime the estimate is not
+   // valid....
+   if (TIMER_WRAP(ulLocalSecondCounter - ulSecondCounter) >= 2)
+      return;
+
+   ptyPublished->tyConcentration = tyConcentration;
+   ulLocalEstimatedSecond = ulSecondsElapsed;
+   usLocalEstimatedWindow = usWindowSeconds;
+}
+
+
+/****************************************************************************
+     Function: PPD42NJ_ProcessNotifications
+     Engineer: agent
+        Input: N/A
+       Output: Number of notifications processed.
+  Description: Brings the concentration estimate up to date, then invokes
+               the callbacks for the notifications queued by the timer 
+               interrupt. This is posted to the scheduler every second, but
+               may also be polled. Must not be called from an interrupt 
+               handler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Works out the concentration estimate.
+****************************************************************************/
+unsigned char PPD42NJ_ProcessNotifications(void)
+{
+   unsigned char ucTail, ucNotificationType, ucProcessed;
+   TyNotificationCallback tyCallback;
+
+   // Clear the flag first, so that a notification queued from here on is
+   // posted again rather than being missed....
+   bLocalProcessingPosted = FALSE;
+
+   // Before the callbacks, so that they see the estimate for the second....
+   PPD42NJ_UpdateConcentration();
+
+   ucProcessed = 0;
+   ucTail = ucLocalEventTail;
+
+   while (ucTail != ucLocalEventHead)
+      {
+      ucNotificationType = pucLocalEvents[ucTail & (PPD42NJ_EVENT_QUEUE_SIZE - 1)];
+
+      // Free the entry before the callback, which may take some time....
+      ucTail++;
+      ucLocalEventTail = ucTail;
+
+      if (ucNotificationType == NOTIFICATION_1_SECOND_UPDATE)
+         tyCallback = tyLocalOneSecondCallback;
+      else
+         tyCallback = tyLocalMaxHistoryCallback;
+
+      if (tyCallback != NULL)
+         tyCallback();
+
+      ucProcessed++;
+      }
+
+   return ucProcessed;
+}
+
+
+/****************************************************************************
+     Function: PPD42NJ_GetDroppedNotifications
+     Engineer: agent
+        Input: N/A
+       Output: Number of notifications dropped.
+  Description: Returns the number of notifications lost because the queue
+               was full, i.e. because the notifications were not processed
+               for several seconds.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned long PPD42NJ_GetDroppedNotifications(void)
+{
+   return ulLocalEventsDropped;
 }
@@ -5,29 +5,117 @@
                particle sensor.
 Date           Initials    Description
 05-DEC-2016    MH          Initial
+17-OCT-2026    agent       History held as a ring buffer with running totals.
+17-OCT-2026    agent       Added PPD42NJ_GetAirQualityMeasurementsSnapshot.
+17-OCT-2026    agent       Added PPD42NJ_TIMER_CAPTURE build option.
+17-OCT-2026    agent       Added PPD42NJ_ProcessNotifications.
+17-OCT-2026    agent       Added the particle concentration estimate.
+17-OCT-2026    agent       Configurable history length and sensor count,
+                           with the measurements held per channel.
+17-OCT-2026    agent       Added PPD42NJ_Concentration and
+                           PPD42NJ_CalculateConcentration.
+17-OCT-2026    agent       Added PPD42NJ_LowPulseWidth.
+17-OCT-2026    agent       The concentration estimate is worked out by
+                           PPD42NJ_ProcessNotifications.
 ****************************************************************************/
 
+// The P1 / P2 low pulses are timed using GPIO edge interrupts and TIMERA0 by
+// default. Define PPD42NJ_TIMER_CAPTURE (--define=PPD42NJ_TIMER_CAPTURE) to 
+// time them with the general purpose timer edge-time capture mode instead 
+// (P1 on TIMERA2 A, P2 on TIMERA1 B), which latches the time of each edge in 
+// hardware and so removes the interrupt latency from the measurement.
+
+// The history length and the number of sensors can be set for the build
+// (e.g. --define=MAXIMUM_HISTORY_IN_SECONDS=60). Each sensor has two pulse
+// channels, P1 and P2, and each channel is described by an entry in the
+// channel table in PPD42NJ.c, which must have PPD42NJ_CHANNEL_COUNT entries.
+#ifndef MAXIMUM_HISTORY_IN_SECONDS
 #define MAXIMUM_HISTORY_IN_SECONDS 30
+#endif
+
+#ifndef PPD42NJ_SENSOR_COUNT
+#define PPD42NJ_SENSOR_COUNT       1
+#endif
+
+#define PPD42NJ_CHANNEL_COUNT      (PPD42NJ_SENSOR_COUNT * 2)
+
+// Channel index of a sensor's P1 / P2 output...
+#define PPD42NJ_P1_CHANNEL(ucSensor)  ((ucSensor) * 2)
+#define PPD42NJ_P2_CHANNEL(ucSensor)  (((ucSensor) * 2) + 1)
+
+#if (MAXIMUM_HISTORY_IN_SECONDS < 1) || (PPD42NJ_SENSOR_COUNT < 1)
+#error MAXIMUM_HISTORY_IN_SECONDS and PPD42NJ_SENSOR_COUNT must be at least 1.
+#endif
+
+// The running totals below hold up to MAXIMUM_HISTORY_IN_SECONDS seconds of
+// low pulse time in 1 us units, so the history must fit in an unsigned long.
+#if (MAXIMUM_HISTORY_IN_SECONDS > 4294)
+#error MAXIMUM_HISTORY_IN_SECONDS is too large for the running totals.
+#endif
+
+// The particle concentration is estimated from the low pulse occupancy over
+// a window of the most recent measurements, up to the whole history. The
+// window can be changed with PPD42NJ_SetConcentrationWindow.
+#define PPD42NJ_DEFAULT_WINDOW_IN_SECONDS MAXIMUM_HISTORY_IN_SECONDS
 
+// Particle concentration estimate. This is worked out in integer maths, so
+// the values are held in fixed point units. P1 counts particles over 1 um
+// and P2 particles over 2.5 um.
 typedef struct
 {
+   // ulSecondsElapsed contains the ulSecondsElapsed of the measurements the
+   // estimate was worked out from.
+   unsigned long ulSecondsElapsed;
+   // usWindowSeconds contains the number of seconds the estimate is taken
+   // over. This is less than the configured window until enough seconds
+   // have elapsed.
+   unsigned short usWindowSeconds;
+   // pulRatio contains the low pulse occupancy of each channel, i.e. the
+   // percentage of the time that the output was low.
+   unsigned long pulRatio[PPD42NJ_CHANNEL_COUNT]; // In 0.001 % units
+   // pulConcentration contains the particle count of each channel from the
+   // sensor's occupancy curve.
+   unsigned long pulConcentration[PPD42NJ_CHANNEL_COUNT]; // In 0.01 pcs / 0.01 cf units
+   // pulPM25 / pulPM10 contain the mass concentrations of each sensor, with 
+   // the P1 - P2 particles counted as PM2.5 and the P2 particles counted as 
+   // PM10.
+   unsigned long pulPM25[PPD42NJ_SENSOR_COUNT]; // In 0.01 ug/m3 units
+   unsigned long pulPM10[PPD42NJ_SENSOR_COUNT]; // In 0.01 ug/m3 units
+} TyParticleConcentration;
 
-   // pulP1Times contains the accumulated P1 pulse times per second for the 
-   // last MAXIMUM_HISTORY_IN_SECONDS seconds. pulP1Times[0] contains the 
-   // oldest data. pulP1Times[MAXIMUM_HISTORY_IN_SECONDS -1] contains the 
-   // newest data.
-   unsigned long pulP1Times[MAXIMUM_HISTORY_IN_SECONDS]; // In 1 us units
-   // pulP2Times contains the accumulated P2 pulse times per second for the 
-   // last MAXIMUM_HISTORY_IN_SECONDS seconds. pulP2Times[0] contains the 
-   // oldest data. pulP2Times[MAXIMUM_HISTORY_IN_SECONDS -1] contains the 
+typedef struct
+{
+
+   // ppulTimes contains the accumulated pulse times per second of each 
+   // channel for the last MAXIMUM_HISTORY_IN_SECONDS seconds, held as ring
+   // buffers. ppulTimes[channel][usHead] contains the oldest data. The entry
+   // before it (wrapping round to MAXIMUM_HISTORY_IN_SECONDS -1) contains the
    // newest data.
-   unsigned long pulP2Times[MAXIMUM_HISTORY_IN_SECONDS]; // In 1 us units
+   unsigned long ppulTimes[PPD42NJ_CHANNEL_COUNT][MAXIMUM_HISTORY_IN_SECONDS]; // In 1 us units
+   // usHead is the index of the oldest entry in the ring buffers. It is
+   // overwritten by the next second of data.
+   unsigned short usHead;
+   // pulTotals contains the sum of all the entries in each channel's ring
+   // buffer, i.e. the total pulse time over the whole history.
+   unsigned long pulTotals[PPD42NJ_CHANNEL_COUNT]; // In 1 us units
    // ulSecondsElapsed contains the number of seconds since monitoring started.
    // Wraps every 136 years.
    unsigned long ulSecondsElapsed;
+   // pulWindowTotals contains the sum of the newest usWindowSeconds entries
+   // in each channel's ring buffer.
+   unsigned short usWindowSeconds;
+   unsigned long pulWindowTotals[PPD42NJ_CHANNEL_COUNT]; // In 1 us units
+   // tyConcentration contains the particle concentration estimated from the
+   // window totals. It is worked out by PPD42NJ_ProcessNotifications after
+   // the buffer is published, not by the timer interrupt, so until then it
+   // holds an older estimate (see its ulSecondsElapsed). The callbacks are
+   // invoked after it has been worked out.
+   TyParticleConcentration tyConcentration;
 } TyAirQualityMeasurements;
 
 
+// Notification callback. This is invoked from PPD42NJ_ProcessNotifications,
+// not from the timer interrupt.
 typedef void (*TyNotificationCallback)(void);
 
 
@@ -41,4 +129,17 @@ typedef void (*TyNotificationCallback)(void);
 unsigned char PPD42NJ_Initialise(void);
 unsigned char PPD42NJ_SetupNotifications(unsigned char ucNotificationType, TyNotificationCallback tyNotificationCallback);
 unsigned char PPD42NJ_GetAirQualityMeasurements(TyAirQualityMeasurements *ptyAirQualityMeasurements);
+const TyAirQualityMeasurements *PPD42NJ_GetAirQualityMeasurementsSnapshot(void);
+unsigned char PPD42NJ_ProcessNotifications(void);
+unsigned char PPD42NJ_SetConcentrationWindow(unsigned short usSeconds);
+unsigned long PPD42NJ_GetDroppedNotifications(void);
+
+// Used by PPD42NJ_ProcessNotifications, and by the host tests to check the
+// fixed point maths....
+unsigned long PPD42NJ_Concentration(unsigned long ulRatio);
+void PPD42NJ_CalculateConcentration(const unsigned long *pulWindowTotals, unsigned short usWindowSeconds, unsigned long ulSecondsElapsed, TyParticleConcentration *ptyConcentration);
+
+// Used by the port line interrupt, and by the host tests to check the 
+// integer pulse width....
+unsigned long PPD42NJ_LowPulseWidth(unsigned long ulFallTime, unsigned long ulRiseTime);
 
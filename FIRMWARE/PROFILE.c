@@ -0,0 +1,461 @@
+/****************************************************************************
+       Module: PROFILE.c
+     Engineer: agent
+  Description: Contains the optional timing of the interrupt handlers and
+               driver calls. The Cortex-M4 DWT cycle counter is read at the
+               start and end of each point, and the minimum, maximum and mean
+               duration, a histogram of the durations and, where it is
+               known, the entry latency are kept for each point in fixed
+               memory.
+
+               The console is polled for single character commands: 'p'
+               reports the figures and 'r' resets them.
+
+               Only built if PROFILE_ENABLED is defined (see PROFILE.h).
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#include "includes.h"
+
+#if defined(PROFILE_ENABLED)
+#include "uart.h"
+
+// Cortex-M4 debug registers. The cycle counter runs while the trace is
+// enabled; it is never written, so the durations are taken as differences
+// and a wrap does no harm.
+#define PROFILE_DEMCR              0xE000EDFC
+#define PROFILE_DEMCR_TRCENA       0x01000000
+#define PROFILE_DWT_CTRL           0xE0001000
+#define PROFILE_DWT_CTRL_CYCCNTENA 0x00000001
+#define PROFILE_DWT_CYCCNT         0xE0001004
+
+// Empty start / end pairs timed to find the cost of the profiling itself....
+#define PROFILE_CALIBRATION_RUNS   8
+
+// Length of the longest report line, with the terminator....
+#define PROFILE_LINE_SIZE          160
+
+typedef struct
+{
+   unsigned long      ulStart;
+   unsigned long      ulCount;
+   unsigned long      ulMinimum;
+   unsigned long      ulMaximum;
+   unsigned long long ullTotal;
+   unsigned long      ulLatencyCount;
+   unsigned long      ulLatencyMinimum;
+   unsigned long      ulLatencyMaximum;
+   unsigned long long ullLatencyTotal;
+   unsigned long      pulHistogram[PROFILE_HISTOGRAM_BINS];
+} TyProfileStatistics;
+
+static const char *ppcLocalNames[PROFILE_POINT_COUNT] =
+{
+   "SysTick ISR  ",
+   "PPD42NJ timer",
+   "PPD42NJ edge ",
+   "I2C transfer ",
+   "HDC1080 read "
+};
+
+static TyProfileStatistics ptyLocalPoints[PROFILE_POINT_COUNT];
+static unsigned long       ulLocalOverhead;
+static TySoftwareTimer     tyLocalCommandTimer;
+
+
+/****************************************************************************
+     Function: PROFILE_ClearPoint
+     Engineer: agent
+        Input: TyProfileStatistics *ptyPoint: Point to clear.
+       Output: N/A
+  Description: Empties the figures of a point.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void PROFILE_ClearPoint(TyProfileStatistics *ptyPoint)
+{
+   unsigned char i;
+
+   ptyPoint->ulCount          = 0;
+   ptyPoint->ulMinimum        = 0xFFFFFFFF;
+   ptyPoint->ulMaximum        = 0;
+   ptyPoint->ullTotal         = 0;
+   ptyPoint->ulLatencyCount   = 0;
+   ptyPoint->ulLatencyMinimum = 0xFFFFFFFF;
+   ptyPoint->ulLatencyMaximum = 0;
+   ptyPoint->ullLatencyTotal  = 0;
+
+   for (i=0; i < PROFILE_HISTOGRAM_BINS; i++)
+      ptyPoint->pulHistogram[i] = 0;
+}
+
+
+/****************************************************************************
+     Function: PROFILE_AppendString
+     Engineer: agent
+        Input: char *pcLine: End of the line being built.
+               const char *pcString: String to append.
+       Output: char *: New end of the line.
+  Description: Appends a string to a report line.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static char *PROFILE_AppendString(char *pcLine, const char *pcString)
+{
+   while (*pcString != '\0')
+      *pcLine++ = *pcString++;
+
+   *pcLine = '\0';
+   return pcLine;
+}
+
+
+/****************************************************************************
+     Function: PROFILE_AppendNumber
+     Engineer: agent
+        Input: char *pcLine: End of the line being built.
+               unsigned long ulValue: Number to append.
+       Output: char *: New end of the line.
+  Description: Appends a number in decimal to a report line, so that the
+               report does not need the printf library.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static char *PROFILE_AppendNumber(char *pcLine, unsigned long ulValue)
+{
+   char pcDigits[10];
+   unsigned char ucCount = 0;
+
+   do
+      {
+      pcDigits[ucCount++] = (char)('0' + (ulValue % 10));
+      ulValue /= 10;
+      }
+   while (ulValue != 0);
+
+   while (ucCount > 0)
+      *pcLine++ = pcDigits[--ucCount];
+
+   *pcLine = '\0';
+   return pcLine;
+}
+
+
+/****************************************************************************
+     Function: PROFILE_WriteLine
+     Engineer: agent
+        Input: const char *pcLine: Line to write.
+       Output: N/A
+  Description: Writes a report line once the UART buffer has emptied, so
+               that a long report is not dropped part way through.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void PROFILE_WriteLine(const char *pcLine)
+{
+   UARTTX_WaitForIdle();
+   UARTTX_WriteString(pcLine);
+}
+
+
+/****************************************************************************
+     Function: PROFILE_ReportTask
+     Engineer: agent
+        Input: unsigned long ulParameter: Not used.
+       Output: N/A
+  Description: Scheduler task which reports the figures.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void PROFILE_ReportTask(unsigned long ulParameter)
+{
+   PROFILE_Report();
+}
+
+
+/****************************************************************************
+     Function: PROFILE_ResetTask
+     Engineer: agent
+        Input: unsigned long ulParameter: Not used.
+       Output: N/A
+  Description: Scheduler task which resets the figures.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void PROFILE_ResetTask(unsigned long ulParameter)
+{
+   PROFILE_Reset();
+   PROFILE_WriteLine("\n\rProfile reset.\n\r");
+}
+
+
+/****************************************************************************
+     Function: PROFILE_CommandCallback
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Software timer callback which checks the console for a
+               command. Runs in the SysTick interrupt, so the work is posted
+               to the scheduler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void PROFILE_CommandCallback(void)
+{
+   long lCharacter;
+
+   while (MAP_UARTCharsAvail(CONSOLE))
+      {
+      lCharacter = MAP_UARTCharGetNonBlocking(CONSOLE);
+
+      if (lCharacter == 'p')
+         SCHEDULER_Post(SCHEDULER_PRIORITY_LOW, PROFILE_ReportTask, 0);
+      else if (lCharacter == 'r')
+         SCHEDULER_Post(SCHEDULER_PRIORITY_LOW, PROFILE_ResetTask, 0);
+      }
+}
+
+
+/****************************************************************************
+     Function: PROFILE_Initialise
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Starts the cycle counter, measures the cost of the profiling
+               and starts polling the console for commands. Called once the
+               scheduler and the UART transmit are running.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void PROFILE_Initialise(void)
+{
+   unsigned char i;
+
+   HWREG(PROFILE_DEMCR)    |= PROFILE_DEMCR_TRCENA;
+   HWREG(PROFILE_DWT_CTRL) |= PROFILE_DWT_CTRL_CYCCNTENA;
+
+   // The shortest of the empty pairs is what the start and end add to every
+   // duration, and is taken off from now on....
+   ulLocalOverhead = 0;
+   PROFILE_Reset();
+
+   for (i=0; i < PROFILE_CALIBRATION_RUNS; i++)
+      {
+      PROFILE_Start(PROFILE_SYSTICK_INTERRUPT);
+      PROFILE_End(PROFILE_SYSTICK_INTERRUPT);
+      }
+
+   ulLocalOverhead = ptyLocalPoints[PROFILE_SYSTICK_INTERRUPT].ulMinimum;
+   PROFILE_Reset();
+
+   TIMER_Start(&tyLocalCommandTimer, PROFILE_COMMAND_PERIOD, PROFILE_COMMAND_PERIOD, PROFILE_CommandCallback);
+}
+
+
+/****************************************************************************
+     Function: PROFILE_Start
+     Engineer: agent
+        Input: TyProfilePoint tyPoint: Point starting.
+       Output: N/A
+  Description: Records the cycle count at the start of a point.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void PROFILE_Start(TyProfilePoint tyPoint)
+{
+   ptyLocalPoints[tyPoint].ulStart = HWREG(PROFILE_DWT_CYCCNT);
+}
+
+
+/****************************************************************************
+     Function: PROFILE_End
+     Engineer: agent
+        Input: TyProfilePoint tyPoint: Point ending.
+       Output: N/A
+  Description: Adds the cycles since the point started to its figures.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       The cycle count is masked to 32 bits.
+****************************************************************************/
+void PROFILE_End(TyProfilePoint tyPoint)
+{
+   unsigned long ulCycles;
+   unsigned long ulBinLimit;
+   unsigned char ucBin;
+   tBoolean bInterruptsDisabled;
+   TyProfileStatistics *ptyPoint;
+
+   ptyPoint = &ptyLocalPoints[tyPoint];
+   ulCycles = TIMER_WRAP(HWREG(PROFILE_DWT_CYCCNT) - ptyPoint->ulStart);
+
+   if (ulCycles > ulLocalOverhead)
+      ulCycles -= ulLocalOverhead;
+   else
+      ulCycles = 0;
+
+   // Bin k counts durations below 4^(k+1) cycles....
+   ucBin      = 0;
+   ulBinLimit = 4;
+   while ((ucBin < (PROFILE_HISTOGRAM_BINS - 1)) && (ulCycles >= ulBinLimit))
+      {
+      ucBin++;
+      ulBinLimit <<= 2;
+      }
+
+   // A report or reset may be copying the figures....
+   bInterruptsDisabled = MAP_IntMasterDisable();
+
+   if (ulCycles < ptyPoint->ulMinimum)
+      ptyPoint->ulMinimum = ulCycles;
+   if (ulCycles > ptyPoint->ulMaximum)
+      ptyPoint->ulMaximum = ulCycles;
+
+   ptyPoint->ullTotal += ulCycles;
+   ptyPoint->ulCount++;
+   ptyPoint->pulHistogram[ucBin]++;
+
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+}
+
+
+/****************************************************************************
+     Function: PROFILE_Latency
+     Engineer: agent
+        Input: TyProfilePoint tyPoint: Point started.
+               unsigned long ulCycles: Cycles between the interrupt being
+                                       raised and the handler starting.
+       Output: N/A
+  Description: Adds an entry latency to the figures of a point.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void PROFILE_Latency(TyProfilePoint tyPoint, unsigned long ulCycles)
+{
+   tBoolean bInterruptsDisabled;
+   TyProfileStatistics *ptyPoint;
+
+   ptyPoint = &ptyLocalPoints[tyPoint];
+
+   bInterruptsDisabled = MAP_IntMasterDisable();
+
+   if (ulCycles < ptyPoint->ulLatencyMinimum)
+      ptyPoint->ulLatencyMinimum = ulCycles;
+   if (ulCycles > ptyPoint->ulLatencyMaximum)
+      ptyPoint->ulLatencyMaximum = ulCycles;
+
+   ptyPoint->ullLatencyTotal += ulCycles;
+   ptyPoint->ulLatencyCount++;
+
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+}
+
+
+/****************************************************************************
+     Function: PROFILE_Reset
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Empties the figures of every point. A point which has started
+               still ends normally.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void PROFILE_Reset(void)
+{
+   unsigned char i;
+   tBoolean bInterruptsDisabled;
+
+   bInterruptsDisabled = MAP_IntMasterDisable();
+
+   for (i=0; i < PROFILE_POINT_COUNT; i++)
+      PROFILE_ClearPoint(&ptyLocalPoints[i]);
+
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+}
+
+
+/****************************************************************************
+     Function: PROFILE_Report
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Writes the figures of every point to the console, in cycles
+               of the system clock. Each point is written as a line of
+               count, minimum, maximum and mean duration and entry latency
+               ("-" where the latency is not known) and a line of the
+               histogram counts. Waits for the UART, so is only called from
+               a task.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void PROFILE_Report(void)
+{
+   unsigned char i, j;
+   char pcLine[PROFILE_LINE_SIZE];
+   char *pcEnd;
+   tBoolean bInterruptsDisabled;
+   TyProfileStatistics tyPoint;
+
+   // Keep any batched samples ahead of the text....
+   TELEMETRY_Flush();
+
+   pcEnd = PROFILE_AppendString(pcLine, "\n\rProfile, cycles (overhead ");
+   pcEnd = PROFILE_AppendNumber(pcEnd, ulLocalOverhead);
+   pcEnd = PROFILE_AppendString(pcEnd, " removed)\n\r");
+   PROFILE_WriteLine(pcLine);
+   PROFILE_WriteLine("point          count min max mean / latency min max mean\n\r");
+   PROFILE_WriteLine("   histogram <4 <16 <64 ... <4^11, >=4^11\n\r");
+
+   for (i=0; i < PROFILE_POINT_COUNT; i++)
+      {
+      bInterruptsDisabled = MAP_IntMasterDisable();
+      tyPoint = ptyLocalPoints[i];
+      if (!bInterruptsDisabled)
+         MAP_IntMasterEnable();
+
+      pcEnd = PROFILE_AppendString(pcLine, ppcLocalNames[i]);
+      pcEnd = PROFILE_AppendString(pcEnd, "  ");
+      pcEnd = PROFILE_AppendNumber(pcEnd, tyPoint.ulCount);
+
+      if (tyPoint.ulCount != 0)
+         {
+         pcEnd = PROFILE_AppendString(pcEnd, " ");
+         pcEnd = PROFILE_AppendNumber(pcEnd, tyPoint.ulMinimum);
+         pcEnd = PROFILE_AppendString(pcEnd, " ");
+         pcEnd = PROFILE_AppendNumber(pcEnd, tyPoint.ulMaximum);
+         pcEnd = PROFILE_AppendString(pcEnd, " ");
+         pcEnd = PROFILE_AppendNumber(pcEnd, (unsigned long)(tyPoint.ullTotal / tyPoint.ulCount));
+         }
+      else
+         pcEnd = PROFILE_AppendString(pcEnd, " - - -");
+
+      if (tyPoint.ulLatencyCount != 0)
+         {
+         pcEnd = PROFILE_AppendString(pcEnd, " / ");
+         pcEnd = PROFILE_AppendNumber(pcEnd, tyPoint.ulLatencyMinimum);
+         pcEnd = PROFILE_AppendString(pcEnd, " ");
+         pcEnd = PROFILE_AppendNumber(pcEnd, tyPoint.ulLatencyMaximum);
+         pcEnd = PROFILE_AppendString(pcEnd, " ");
+         pcEnd = PROFILE_AppendNumber(pcEnd, (unsigned long)(tyPoint.ullLatencyTotal / tyPoint.ulLatencyCount));
+         }
+      else
+         pcEnd = PROFILE_AppendString(pcEnd, " / - - -");
+
+      PROFILE_AppendString(pcEnd, "\n\r");
+      PROFILE_WriteLine(pcLine);
+
+      pcEnd = PROFILE_AppendString(pcLine, "   histogram");
+      for (j=0; j < PROFILE_HISTOGRAM_BINS; j++)
+         {
+         pcEnd = PROFILE_AppendString(pcEnd, " ");
+         pcEnd = PROFILE_AppendNumber(pcEnd, tyPoint.pulHistogram[j]);
+         }
+      PROFILE_AppendString(pcEnd, "\n\r");
+      PROFILE_WriteLine(pcLine);
+      }
+}
+
+#endif
@@ -0,0 +1,63 @@
+/****************************************************************************
+       Module: PROFILE.h
+     Engineer: agent
+  Description: Contains the types, macros and function prototypes for timing
+               the interrupt handlers and driver calls with the DWT cycle
+               counter.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+
+// The profiling is only built in if PROFILE_ENABLED is defined for the build
+// (--define=PROFILE_ENABLED). Otherwise the macros below are empty, so the
+// instrumented code is exactly as it would be without them, and PROFILE.c
+// compiles to nothing.
+//
+// The code being timed is wrapped in PROFILE_START / PROFILE_END. Where the
+// hardware shows how long ago the interrupt was raised, the handler passes
+// that to PROFILE_LATENCY. Typing 'p' on the console reports the figures and
+// 'r' resets them.
+
+// Points timed. Each has one start time, so a point must not be started
+// again (e.g. by a nested interrupt) before it has ended.
+typedef enum
+{
+   PROFILE_SYSTICK_INTERRUPT       = 0,
+   PROFILE_PPD42NJ_TIMER_INTERRUPT = 1,
+   PROFILE_PPD42NJ_EDGE_INTERRUPT  = 2,   // Port line or capture.
+   PROFILE_I2C_TRANSFER            = 3,   // Queued transaction, start to end.
+   PROFILE_HDC1080_READ            = 4    // Non-blocking read, start to callback.
+} TyProfilePoint;
+
+#define PROFILE_POINT_COUNT        5
+
+// The durations are counted in a histogram with bins of increasing powers of
+// 4 cycles: below 4, below 16, ... The last bin counts everything above.
+#define PROFILE_HISTOGRAM_BINS     12
+
+// How often the console is checked for a command....
+#define PROFILE_COMMAND_PERIOD     100 // ms
+
+#if defined(PROFILE_ENABLED)
+
+#define PROFILE_INITIALISE()                  PROFILE_Initialise()
+#define PROFILE_START(tyPoint)                PROFILE_Start(tyPoint)
+#define PROFILE_END(tyPoint)                  PROFILE_End(tyPoint)
+#define PROFILE_LATENCY(tyPoint, ulCycles)    PROFILE_Latency((tyPoint), (ulCycles))
+
+// Function prototypes from the PROFILE module...
+void PROFILE_Initialise(void);
+void PROFILE_Start(TyProfilePoint tyPoint);
+void PROFILE_End(TyProfilePoint tyPoint);
+void PROFILE_Latency(TyProfilePoint tyPoint, unsigned long ulCycles);
+void PROFILE_Reset(void);
+void PROFILE_Report(void);
+
+#else
+
+#define PROFILE_INITIALISE()
+#define PROFILE_START(tyPoint)
+#define PROFILE_END(tyPoint)
+#define PROFILE_LATENCY(tyPoint, ulCycles)
+
+#endif
@@ -0,0 +1,222 @@
+/****************************************************************************
+       Module: SCHEDULER.c
+     Engineer: agent
+  Description: Contains a cooperative, run to completion event scheduler.
+               Interrupt handlers (and tasks) post events to a queue for each
+               priority, and SCHEDULER_Run runs them one at a time, sleeping
+               when there is nothing to do.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#include "includes.h"
+
+typedef struct
+{
+   TyEventHandler tyHandler;
+   unsigned long  ulParameter;
+   unsigned long  ulPosted;     // Millisecond count when posted.
+} TyEvent;
+
+typedef struct
+{
+   TyEvent       ptyEvents[SCHEDULER_QUEUE_SIZE];
+   unsigned char ucHead;        // Next event to run.
+   unsigned char ucCount;
+} TyEventQueue;
+
+static TyEventQueue           ptyLocalQueues[SCHEDULER_PRIORITY_COUNT];
+static volatile unsigned char bLocalStopped;
+static unsigned long          ulLocalMaxLatency;       // Milliseconds
+static volatile unsigned long ulLocalDroppedEvents;
+
+
+/****************************************************************************
+     Function: SCHEDULER_Initialise
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Empties the event queues. TIMER_Initialise must have been
+               called first.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SCHEDULER_Initialise(void)
+{
+   unsigned char i;
+
+   for (i=0; i < SCHEDULER_PRIORITY_COUNT; i++)
+      {
+      ptyLocalQueues[i].ucHead  = 0;
+      ptyLocalQueues[i].ucCount = 0;
+      }
+
+   bLocalStopped        = FALSE;
+   ulLocalMaxLatency    = 0;
+   ulLocalDroppedEvents = 0;
+}
+
+
+/****************************************************************************
+     Function: SCHEDULER_Post
+     Engineer: agent
+        Input: TySchedulerPriority tyPriority: Priority of the event.
+               TyEventHandler tyHandler: Function to run.
+               unsigned long ulParameter: Passed to the handler.
+       Output: TRUE: Success, FALSE: Failure (invalid or queue full).
+  Description: Adds an event to the end of the queue for its priority. May
+               be called from an interrupt handler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char SCHEDULER_Post(TySchedulerPriority tyPriority, TyEventHandler tyHandler, unsigned long ulParameter)
+{
+   TyEventQueue *ptyQueue;
+   TyEvent *ptyEvent;
+   unsigned char bPosted;
+   tBoolean bInterruptsDisabled;
+
+   if ((tyPriority >= SCHEDULER_PRIORITY_COUNT) || (tyHandler == NULL))
+      return FALSE;
+
+   ptyQueue = &ptyLocalQueues[tyPriority];
+   bPosted  = FALSE;
+
+   bInterruptsDisabled = MAP_IntMasterDisable();
+   if (ptyQueue->ucCount < SCHEDULER_QUEUE_SIZE)
+      {
+      ptyEvent = &ptyQueue->ptyEvents[(ptyQueue->ucHead + ptyQueue->ucCount) % SCHEDULER_QUEUE_SIZE];
+      ptyEvent->tyHandler   = tyHandler;
+      ptyEvent->ulParameter = ulParameter;
+      ptyEvent->ulPosted    = TIMER_GetMilliseconds();
+      ptyQueue->ucCount++;
+      bPosted = TRUE;
+      }
+   else
+      {
+      ulLocalDroppedEvents++;
+      }
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+
+   return bPosted;
+}
+
+
+/****************************************************************************
+     Function: SCHEDULER_Next
+     Engineer: agent
+        Input: TyEvent *ptyEvent: Storage for the event.
+       Output: TRUE: Event removed, FALSE: No events pending.
+  Description: Removes the highest priority pending event from its queue.
+               Interrupts must be disabled.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SCHEDULER_Next(TyEvent *ptyEvent)
+{
+   unsigned char i;
+   TyEventQueue *ptyQueue;
+
+   for (i=0; i < SCHEDULER_PRIORITY_COUNT; i++)
+      {
+      ptyQueue = &ptyLocalQueues[i];
+
+      if (ptyQueue->ucCount != 0)
+         {
+         *ptyEvent = ptyQueue->ptyEvents[ptyQueue->ucHead];
+         ptyQueue->ucHead = (ptyQueue->ucHead + 1) % SCHEDULER_QUEUE_SIZE;
+         ptyQueue->ucCount--;
+         return TRUE;
+         }
+      }
+
+   return FALSE;
+}
+
+
+/****************************************************************************
+     Function: SCHEDULER_Run
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Runs the posted events until SCHEDULER_Stop is called. The
+               processor sleeps (see TIMER_Sleep) while no events are
+               pending.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       The latency is masked to 32 bits.
+****************************************************************************/
+void SCHEDULER_Run(void)
+{
+   TyEvent tyEvent;
+   unsigned long ulLatency;
+   unsigned char bEventPending;
+
+   while (bLocalStopped == FALSE)
+      {
+      // Check for an event with interrupts disabled, so that an event posted
+      // just before sleeping still wakes the processor...
+      MAP_IntMasterDisable();
+      bEventPending = SCHEDULER_Next(&tyEvent);
+      if (bEventPending == FALSE)
+         TIMER_Sleep();
+      MAP_IntMasterEnable();
+
+      if (bEventPending)
+         {
+         ulLatency = TIMER_WRAP(TIMER_GetMilliseconds() - tyEvent.ulPosted);
+         if (ulLatency > ulLocalMaxLatency)
+            ulLocalMaxLatency = ulLatency;
+
+         tyEvent.tyHandler(tyEvent.ulParameter);
+         }
+      }
+}
+
+
+/****************************************************************************
+     Function: SCHEDULER_Stop
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Makes SCHEDULER_Run return once the current event handler has
+               completed. Any pending events are left in the queues.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SCHEDULER_Stop(void)
+{
+   bLocalStopped = TRUE;
+}
+
+
+/****************************************************************************
+     Function: SCHEDULER_GetMaxLatency
+     Engineer: agent
+        Input: N/A
+       Output: Longest time in milliseconds between an event being posted and
+               being run.
+  Description: Returns the worst case event latency seen so far.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned long SCHEDULER_GetMaxLatency(void)
+{
+   return ulLocalMaxLatency;
+}
+
+
+/****************************************************************************
+     Function: SCHEDULER_GetDroppedEvents
+     Engineer: agent
+        Input: N/A
+       Output: Number of events which could not be posted.
+  Description: Returns the number of events lost because their queue was
+               full.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned long SCHEDULER_GetDroppedEvents(void)
+{
+   return ulLocalDroppedEvents;
+}
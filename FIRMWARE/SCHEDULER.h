@@ -0,0 +1,35 @@
+/****************************************************************************
+       Module: SCHEDULER.h
+     Engineer: agent
+  Description: Contains the types and function prototypes for the event
+               scheduler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+
+// Event priorities. Pending events are run highest priority first, and in
+// the order they were posted within a priority.
+typedef enum
+{
+   SCHEDULER_PRIORITY_HIGH   = 0,
+   SCHEDULER_PRIORITY_NORMAL = 1,
+   SCHEDULER_PRIORITY_LOW    = 2
+} TySchedulerPriority;
+
+#define SCHEDULER_PRIORITY_COUNT   3
+
+// Maximum number of pending events at each priority...
+#define SCHEDULER_QUEUE_SIZE       8
+
+// Event handler. This is run from SCHEDULER_Run (not from an interrupt
+// handler) and runs to completion before the next event is started.
+typedef void (*TyEventHandler)(unsigned long ulParameter);
+
+
+// Function prototypes from the SCHEDULER module...
+void SCHEDULER_Initialise(void);
+unsigned char SCHEDULER_Post(TySchedulerPriority tyPriority, TyEventHandler tyHandler, unsigned long ulParameter);
+void SCHEDULER_Run(void);
+void SCHEDULER_Stop(void);
+unsigned long SCHEDULER_GetMaxLatency(void);
+unsigned long SCHEDULER_GetDroppedEvents(void);
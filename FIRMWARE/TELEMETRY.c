@@ -0,0 +1,306 @@
+/****************************************************************************
+       Module: TELEMETRY.c
+     Engineer: agent
+  Description: Contains the binary telemetry frames sent on the console
+               UART. Samples are batched TELEMETRY_SAMPLES_PER_FRAME to a
+               frame, which is protected by a CRC and COBS encoded so that
+               a zero byte only ever appears between frames.
+
+               Frame (before encoding, multi byte fields little endian):
+                  Version        1 byte   TELEMETRY_FRAME_VERSION
+                  Sequence       2 bytes  Incremented for every frame
+                  Sample count   1 byte
+                  Samples        TELEMETRY_SAMPLE_SIZE bytes each
+                  CRC            2 bytes  CRC-16/CCITT of the above
+
+               Sample:
+                  Timestamp      4 bytes
+                  Temperature    2 bytes (signed)
+                  Humidity       2 bytes
+                  P1 low time    4 bytes
+                  P2 low time    4 bytes
+                  P1 hour        4 bytes  Low times over the last hour
+                  P2 hour        4 bytes
+                  PM2.5          4 bytes
+                  PM10           4 bytes
+                  Idle           1 byte
+                  Max latency    2 bytes
+                  Log failures   2 bytes  Flash log failures since boot
+
+               Each encoded frame is sent between zero bytes, so any text
+               written to the console between frames is discarded by the
+               decoder rather than corrupting the next frame.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Frames are sent through the UARTTX buffer.
+17-OCT-2026    agent       TELEMETRY_Crc is shared with the flash log.
+17-OCT-2026    agent       Added the hourly P1 / P2 low times.
+17-OCT-2026    agent       Added the flash log failures.
+****************************************************************************/
+#include "includes.h"
+
+#define TELEMETRY_HEADER_SIZE     4
+#define TELEMETRY_SAMPLE_SIZE     37
+#define TELEMETRY_CRC_SIZE        2
+
+#define TELEMETRY_FRAME_SIZE      (TELEMETRY_HEADER_SIZE + (TELEMETRY_SAMPLES_PER_FRAME * TELEMETRY_SAMPLE_SIZE) + TELEMETRY_CRC_SIZE)
+
+// COBS adds one byte per 254 bytes of data, plus one. There is also a
+// delimiter either side....
+#define TELEMETRY_ENCODED_SIZE    (TELEMETRY_FRAME_SIZE + (TELEMETRY_FRAME_SIZE / 254) + 1 + 2)
+
+#define TELEMETRY_CRC_POLYNOMIAL  0x1021
+#define TELEMETRY_CRC_INITIAL     0xFFFF
+
+static unsigned char  pucLocalFrame[TELEMETRY_FRAME_SIZE];
+static unsigned char  pucLocalEncoded[TELEMETRY_ENCODED_SIZE];
+static unsigned char  ucLocalSampleCount;
+static unsigned short usLocalSequence;
+static unsigned long  ulLocalFramesDropped;
+
+
+/****************************************************************************
+     Function: TELEMETRY_PutShort
+     Engineer: agent
+        Input: unsigned char *pucBuffer: Where to write the value.
+               unsigned short usValue: Value to write.
+       Output: unsigned char *: Position after the value.
+  Description: Writes a 16 bit value, little endian.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char *TELEMETRY_PutShort(unsigned char *pucBuffer, unsigned short usValue)
+{
+   pucBuffer[0] = (unsigned char)usValue;
+   pucBuffer[1] = (unsigned char)(usValue >> 8);
+
+   return pucBuffer + 2;
+}
+
+
+/****************************************************************************
+     Function: TELEMETRY_PutLong
+     Engineer: agent
+        Input: unsigned char *pucBuffer: Where to write the value.
+               unsigned long ulValue: Value to write.
+       Output: unsigned char *: Position after the value.
+  Description: Writes a 32 bit value, little endian.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char *TELEMETRY_PutLong(unsigned char *pucBuffer, unsigned long ulValue)
+{
+   pucBuffer[0] = (unsigned char)ulValue;
+   pucBuffer[1] = (unsigned char)(ulValue >> 8);
+   pucBuffer[2] = (unsigned char)(ulValue >> 16);
+   pucBuffer[3] = (unsigned char)(ulValue >> 24);
+
+   return pucBuffer + 4;
+}
+
+
+/****************************************************************************
+     Function: TELEMETRY_Crc
+     Engineer: agent
+        Input: const unsigned char *pucData: Data to check.
+               unsigned short usLength: Number of bytes.
+       Output: unsigned short: CRC-16/CCITT of the data.
+  Description: Works out the CRC bit by bit. A frame is only a hundred or so
+               bytes, so a lookup table is not worth the flash. Also checks
+               the pages of the flash log.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       No longer static.
+****************************************************************************/
+unsigned short TELEMETRY_Crc(const unsigned char *pucData, unsigned short usLength)
+{
+   unsigned short i, usCrc;
+   unsigned char ucBit;
+
+   usCrc = TELEMETRY_CRC_INITIAL;
+
+   for (i=0; i < usLength; i++)
+      {
+      usCrc ^= (unsigned short)pucData[i] << 8;
+
+      for (ucBit=0; ucBit < 8; ucBit++)
+         {
+         if (usCrc & 0x8000)
+            usCrc = (usCrc << 1) ^ TELEMETRY_CRC_POLYNOMIAL;
+         else
+            usCrc <<= 1;
+         }
+      }
+
+   return usCrc;
+}
+
+
+/****************************************************************************
+     Function: TELEMETRY_Encode
+     Engineer: agent
+        Input: const unsigned char *pucData: Data to encode.
+               unsigned short usLength: Number of bytes.
+               unsigned char *pucEncoded: Storage for the encoded data, at
+                  least usLength + (usLength / 254) + 1 bytes.
+       Output: unsigned short: Number of encoded bytes.
+  Description: COBS encodes the data, removing all the zero bytes. Each zero
+               is replaced by the distance to the next one, with a code
+               byte at the start of every run of up to 254 non zero bytes.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned short TELEMETRY_Encode(const unsigned char *pucData, unsigned short usLength, unsigned char *pucEncoded)
+{
+   unsigned short i, usCodeIndex, usWrite;
+   unsigned char ucCode;
+
+   usCodeIndex = 0;
+   usWrite     = 1;
+   ucCode      = 1;
+
+   for (i=0; i < usLength; i++)
+      {
+      if (pucData[i] == 0)
+         {
+         // End the run at the zero....
+         pucEncoded[usCodeIndex] = ucCode;
+         usCodeIndex = usWrite++;
+         ucCode = 1;
+         }
+      else
+         {
+         pucEncoded[usWrite++] = pucData[i];
+         ucCode++;
+
+         if (ucCode == 0xFF)
+            {
+            // Longest run, start another without an implied zero....
+            pucEncoded[usCodeIndex] = ucCode;
+            usCodeIndex = usWrite++;
+            ucCode = 1;
+            }
+         }
+      }
+
+   pucEncoded[usCodeIndex] = ucCode;
+
+   return usWrite;
+}
+
+
+/****************************************************************************
+     Function: TELEMETRY_Initialise
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Initialises the telemetry. UARTTX_Initialise must have been
+               called first.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Reset the dropped frame count.
+****************************************************************************/
+void TELEMETRY_Initialise(void)
+{
+   ucLocalSampleCount   = 0;
+   usLocalSequence      = 0;
+   ulLocalFramesDropped = 0;
+}
+
+
+/****************************************************************************
+     Function: TELEMETRY_AddSample
+     Engineer: agent
+        Input: const TyTelemetrySample *ptySample: Sample to send.
+       Output: N/A
+  Description: Adds a sample to the current frame, sending the frame once it
+               holds TELEMETRY_SAMPLES_PER_FRAME samples. Must not be called
+               from an interrupt handler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added the hourly P1 / P2 low times.
+17-OCT-2026    agent       Added the flash log failures.
+****************************************************************************/
+void TELEMETRY_AddSample(const TyTelemetrySample *ptySample)
+{
+   unsigned char *pucSample;
+
+   pucSample = &pucLocalFrame[TELEMETRY_HEADER_SIZE + (ucLocalSampleCount * TELEMETRY_SAMPLE_SIZE)];
+
+   pucSample = TELEMETRY_PutLong(pucSample, ptySample->ulTimestamp);
+   pucSample = TELEMETRY_PutShort(pucSample, (unsigned short)ptySample->sTemperature);
+   pucSample = TELEMETRY_PutShort(pucSample, ptySample->usHumidity);
+   pucSample = TELEMETRY_PutLong(pucSample, ptySample->ulP1LowTime);
+   pucSample = TELEMETRY_PutLong(pucSample, ptySample->ulP2LowTime);
+   pucSample = TELEMETRY_PutLong(pucSample, ptySample->ulP1HourLowTime);
+   pucSample = TELEMETRY_PutLong(pucSample, ptySample->ulP2HourLowTime);
+   pucSample = TELEMETRY_PutLong(pucSample, ptySample->ulPM25);
+   pucSample = TELEMETRY_PutLong(pucSample, ptySample->ulPM10);
+   *pucSample++ = ptySample->ucIdlePercentage;
+   pucSample = TELEMETRY_PutShort(pucSample, ptySample->usMaxLatency);
+   pucSample = TELEMETRY_PutShort(pucSample, ptySample->usFlashLogFailures);
+
+   ucLocalSampleCount++;
+
+   if (ucLocalSampleCount >= TELEMETRY_SAMPLES_PER_FRAME)
+      TELEMETRY_Flush();
+}
+
+
+/****************************************************************************
+     Function: TELEMETRY_Flush
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Sends the current frame, if it holds any samples. The frame
+               is buffered, so this does not wait for it to be sent. If the
+               buffer is full the frame is dropped, which the decoder sees
+               as a gap in the sequence numbers. Must not be called from an
+               interrupt handler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       The whole frame is buffered in one write.
+****************************************************************************/
+void TELEMETRY_Flush(void)
+{
+   unsigned short usLength, usCrc;
+
+   if (ucLocalSampleCount == 0)
+      return;
+
+   pucLocalFrame[0] = TELEMETRY_FRAME_VERSION;
+   TELEMETRY_PutShort(&pucLocalFrame[1], usLocalSequence);
+   pucLocalFrame[3] = ucLocalSampleCount;
+
+   usLength = TELEMETRY_HEADER_SIZE + (ucLocalSampleCount * TELEMETRY_SAMPLE_SIZE);
+   usCrc    = TELEMETRY_Crc(pucLocalFrame, usLength);
+   TELEMETRY_PutShort(&pucLocalFrame[usLength], usCrc);
+   usLength += TELEMETRY_CRC_SIZE;
+
+   // Encode the frame between delimiters....
+   usLength = TELEMETRY_Encode(pucLocalFrame, usLength, &pucLocalEncoded[1]);
+   pucLocalEncoded[0] = 0;
+   pucLocalEncoded[usLength + 1] = 0;
+
+   if (UARTTX_Write(pucLocalEncoded, usLength + 2) == FALSE)
+      ulLocalFramesDropped++;
+
+   usLocalSequence++;
+   ucLocalSampleCount = 0;
+}
+
+
+/****************************************************************************
+     Function: TELEMETRY_GetDroppedFrames
+     Engineer: agent
+        Input: N/A
+       Output: Number of frames dropped.
+  Description: Returns the number of frames which could not be buffered for
+               sending.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned long TELEMETRY_GetDroppedFrames(void)
+{
+   return ulLocalFramesDropped;
+}
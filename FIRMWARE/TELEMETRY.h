@@ -0,0 +1,51 @@
+/****************************************************************************
+       Module: TELEMETRY.h
+     Engineer: agent
+  Description: Contains the types and function prototypes for the binary
+               telemetry frames.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added TELEMETRY_GetDroppedFrames.
+17-OCT-2026    agent       Added TELEMETRY_Crc.
+17-OCT-2026    agent       Added the hourly P1 / P2 low times (version 2).
+17-OCT-2026    agent       Added the flash log failures (version 3).
+****************************************************************************/
+
+// Number of samples batched into each frame. This can be set for the build
+// (e.g. --define=TELEMETRY_SAMPLES_PER_FRAME=8).
+#ifndef TELEMETRY_SAMPLES_PER_FRAME
+#define TELEMETRY_SAMPLES_PER_FRAME   4
+#endif
+
+#if (TELEMETRY_SAMPLES_PER_FRAME < 1) || (TELEMETRY_SAMPLES_PER_FRAME > 255)
+#error TELEMETRY_SAMPLES_PER_FRAME must be 1 to 255.
+#endif
+
+// Frame format version, sent in the first byte of every frame....
+#define TELEMETRY_FRAME_VERSION       3
+
+// One sample, held in fixed point so that no floating point formatting is
+// needed to send it.
+typedef struct
+{
+   unsigned long  ulTimestamp;       // Seconds since monitoring started.
+   short          sTemperature;      // In 0.01 degree C units
+   unsigned short usHumidity;        // In 0.01 % units
+   unsigned long  ulP1LowTime;       // Mean P1 low time per second, 1 us units
+   unsigned long  ulP2LowTime;       // Mean P2 low time per second, 1 us units
+   unsigned long  ulP1HourLowTime;   // As ulP1LowTime, over the last hour (0 until measured)
+   unsigned long  ulP2HourLowTime;   // As ulP2LowTime, over the last hour (0 until measured)
+   unsigned long  ulPM25;            // In 0.01 ug/m3 units
+   unsigned long  ulPM10;            // In 0.01 ug/m3 units
+   unsigned char  ucIdlePercentage;  // CPU idle time, %
+   unsigned short usMaxLatency;      // Scheduler latency, milliseconds
+   unsigned short usFlashLogFailures; // Flash log failures since boot
+} TyTelemetrySample;
+
+
+// Function prototypes from the TELEMETRY module...
+void TELEMETRY_Initialise(void);
+void TELEMETRY_AddSample(const TyTelemetrySample *ptySample);
+void TELEMETRY_Flush(void);
+unsigned long TELEMETRY_GetDroppedFrames(void);
+unsigned short TELEMETRY_Crc(const unsigned char *pucData, unsigned short usLength);
@@ -4,6 +4,15 @@
   Description: Contains routines for accessing the TLC59116 LED driver
 Date           Initials    Description
 10-DEC-2016    MH          Initial
+17-OCT-2026    agent       Added non-blocking intensity updates using the I2C
+                           queue.
+17-OCT-2026    agent       Use auto-increment bursts for multiple registers.
+17-OCT-2026    agent       Added the shadow copy of the registers. Changes are
+                           written by TLC59116_Commit.
+17-OCT-2026    agent       Only a single clean register is bridged, as the
+                           gap limit says.
+17-OCT-2026    agent       TLC59116_SetRegister is safe to call from an
+                           interrupt handler.
 ****************************************************************************/
 #include "includes.h"
 
@@ -36,6 +45,14 @@ Date           Initials    Description
 #define TLC59116_LEDOUT2         0x16
 #define TLC59116_LEDOUT3         0x17
 
+// Number of registers from TLC59116_MODE1 to TLC59116_LEDOUT3...
+#define TLC59116_REGISTER_COUNT  0x18
+
+// Auto-increment flags for the control register (register pointer). With
+// all registers auto-incremented each data byte in a write goes to the next
+// register, so a block of registers is written in a single transfer.
+#define TLC59116_AUTO_INCREMENT_ALL  0x80
+
 // TLC59116 register values...
 #define TLC59116_MODE1_DEFAULT    0x00   // Default (no sub or all call) + OSC on
 #define TLC59116_MODE2_DEFAULT    0x20   // Default (output change on stop)
@@ -44,78 +61,268 @@ Date           Initials    Description
 
 #define TLC59116_BLINK_500MS_SEC_FREQ  12
 
+
+// Clean registers between two dirty runs that are shorter than this are
+// written anyway, as one burst costs less than a second transfer (device
+// address, register pointer, start and stop)...
+#define TLC59116_MAX_BRIDGED_GAP       2
+
+// Number of non-blocking register writes which may be queued at once...
+#define TLC59116_MAX_QUEUED_WRITES     8
+
+// A queued register write...
+typedef struct
+{
+   TyI2CTransaction    tyTransaction;
+   unsigned char       pucTxData[TLC59116_REGISTER_COUNT + 1];
+   TyTLC59116Callback  tyCallback;
+   volatile unsigned char bInUse;
+} TyTLC59116Write;
+
+static TyTLC59116Write ptyLocalWrites[TLC59116_MAX_QUEUED_WRITES];
+
+// Copy of the device registers, and a bit per register which is set when
+// the copy has been changed but not yet written to the device....
+static unsigned char          pucLocalShadow[TLC59116_REGISTER_COUNT];
+static volatile unsigned long ulLocalDirty;
+
+// State of the non-blocking commit in progress....
+static volatile unsigned char ucLocalCommitWritesOutstanding;
+static volatile unsigned char bLocalCommitFailed;
+static TyTLC59116Callback     tyLocalCommitCallback;
+
+
 /****************************************************************************
-     Function: TLC59116_Initialise
-     Engineer: Martin Hannon
-        Input: N/A
-       Output: TRUE: Success, FALSE: Failure.
-  Description: Initialises the TLC59116 LED controller
+     Function: TLC59116_MarkDirty
+     Engineer: agent
+        Input: unsigned char ucRegister: First register.
+               unsigned char ucCount: Number of registers.
+       Output: N/A
+  Description: Marks registers as needing to be written to the device. May
+               be called from an interrupt handler.
 Date           Initials    Description
-10-DEC-2016    MH          Initial
+17-OCT-2026    agent       Initial
 ****************************************************************************/
-unsigned char TLC59116_Initialise(void)
+static void TLC59116_MarkDirty(unsigned char ucRegister, unsigned char ucCount)
 {
-   unsigned char i;
-   unsigned char pucTxRxData[0x2];
+   tBoolean bInterruptsDisabled;
 
-   // Program the Mode 1 register....
-   pucTxRxData[0] =  TLC59116_MODE1;
-   pucTxRxData[1] =  TLC59116_MODE1_DEFAULT;
+   bInterruptsDisabled = MAP_IntMasterDisable();
+   ulLocalDirty |= ((1ul << ucCount) - 1) << ucRegister;
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+}
+
+
+/****************************************************************************
+     Function: TLC59116_SetRegister
+     Engineer: agent
+        Input: unsigned char ucRegister: Register to set.
+               unsigned char ucValue: New value.
+       Output: N/A
+  Description: Updates the copy of a register, marking it dirty only if the
+               value has changed. May be called from an interrupt handler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       The copy and its dirty bit are updated with
+                           interrupts disabled, so that a commit or a
+                           handler setting the same register cannot come
+                           in between them.
+****************************************************************************/
+static void TLC59116_SetRegister(unsigned char ucRegister, unsigned char ucValue)
+{
+   tBoolean bInterruptsDisabled;
 
-   if (I2C_IF_Write(TLC59116_DEVICE_ADDR,pucTxRxData,2,1) != SUCCESS)
+   bInterruptsDisabled = MAP_IntMasterDisable();
+   if (pucLocalShadow[ucRegister] != ucValue)
       {
-      return FALSE;
+      pucLocalShadow[ucRegister] = ucValue;
+      ulLocalDirty |= 1ul << ucRegister;
       }
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+}
 
-   // Program the Mode 2 register....
-   pucTxRxData[0] =  TLC59116_MODE2;
-   pucTxRxData[1] =  TLC59116_MODE2_DEFAULT;
 
-   if (I2C_IF_Write(TLC59116_DEVICE_ADDR,pucTxRxData,2,1) != SUCCESS)
+/****************************************************************************
+     Function: TLC59116_NextDirtyRun
+     Engineer: agent
+        Input: unsigned long ulDirty: Dirty register bits.
+               unsigned char ucStart: Register to search from.
+               unsigned char *pucCount: Storage for the length of the run.
+       Output: First register of the run, or TLC59116_REGISTER_COUNT if
+               there are no more dirty registers.
+  Description: Finds the next run of registers to write in one burst. Runs
+               separated by fewer than TLC59116_MAX_BRIDGED_GAP clean
+               registers (i.e. a single one) are merged.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Two clean registers were bridged.
+****************************************************************************/
+static unsigned char TLC59116_NextDirtyRun(unsigned long ulDirty, unsigned char ucStart, unsigned char *pucCount)
+{
+   unsigned char ucFirst, ucLast, ucRegister;
+
+   // Find the first dirty register...
+   for (ucFirst = ucStart; ucFirst < TLC59116_REGISTER_COUNT; ucFirst++)
       {
-      return FALSE;
+      if (ulDirty & (1ul << ucFirst))
+         break;
       }
 
-
-   // Set all PWM values to 0x00 (off)....
-   for (i=0; i < 16; i++)
+   if (ucFirst >= TLC59116_REGISTER_COUNT)
       {
-      pucTxRxData[0] =  TLC59116_PWM0 + i;
-      pucTxRxData[1] =  0;
+      *pucCount = 0;
+      return TLC59116_REGISTER_COUNT;
+      }
 
-      if (I2C_IF_Write(TLC59116_DEVICE_ADDR,pucTxRxData,2,1) != SUCCESS)
+   // Extend the run while the next dirty register is close enough...
+   ucLast = ucFirst;
+   for (ucRegister = ucFirst + 1; ucRegister < TLC59116_REGISTER_COUNT; ucRegister++)
+      {
+      if (ulDirty & (1ul << ucRegister))
          {
-         return FALSE;
+         ucLast = ucRegister;
+         }
+      else if ((ucRegister - ucLast) >= TLC59116_MAX_BRIDGED_GAP)
+         {
+         break;
          }
       }
 
-   // Set leds to PWM control....
-   for (i=0; i < 4; i++)
-      {
-      pucTxRxData[0] =  TLC59116_LEDOUT0 + i;
-      pucTxRxData[1] =  TLC59116_LEDOUT_PWM;
+   *pucCount = ucLast - ucFirst + 1;
+
+   return ucFirst;
+}
 
-      if (I2C_IF_Write(TLC59116_DEVICE_ADDR,pucTxRxData,2,1) != SUCCESS)
+
+/****************************************************************************
+     Function: TLC59116_WriteComplete
+     Engineer: agent
+        Input: TyI2CTransaction *ptyTransaction: Completed transaction.
+       Output: N/A
+  Description: I2C queue callback for a queued register write. Releases the
+               write and reports the result to the caller. The registers are
+               marked dirty again if the write failed.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void TLC59116_WriteComplete(TyI2CTransaction *ptyTransaction)
+{
+   TyTLC59116Write *ptyWrite;
+   TyTLC59116Callback tyCallback;
+   unsigned char bSuccess;
+
+   ptyWrite   = (TyTLC59116Write *)ptyTransaction->pvContext;
+   tyCallback = ptyWrite->tyCallback;
+   bSuccess   = (ptyTransaction->ucStatus == I2C_TRANSACTION_COMPLETE) ? TRUE : FALSE;
+
+   if (bSuccess == FALSE)
+      TLC59116_MarkDirty(ptyWrite->pucTxData[0] & ~TLC59116_AUTO_INCREMENT_ALL, ptyTransaction->ucTxLength - 1);
+
+   ptyWrite->bInUse = FALSE;
+
+   if (tyCallback != NULL)
+      tyCallback(bSuccess);
+}
+
+
+/****************************************************************************
+     Function: TLC59116_QueueWrite
+     Engineer: agent
+        Input: unsigned char ucRegister: First register to write.
+               unsigned char ucCount: Number of registers to write.
+               TyTLC59116Callback tyCallback: Invoked on completion (may be
+                  NULL).
+       Output: TRUE: Write queued, FALSE: Failure (no free writes).
+  Description: Queues a write of consecutive registers from the shadow copy,
+               as a single auto-increment burst, without waiting for it.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char TLC59116_QueueWrite(unsigned char ucRegister, unsigned char ucCount, TyTLC59116Callback tyCallback)
+{
+   unsigned char i;
+   tBoolean bInterruptsDisabled;
+   TyTLC59116Write *ptyWrite;
+
+   if ((ucCount == 0) || ((ucRegister + ucCount) > TLC59116_REGISTER_COUNT))
+      return FALSE;
+
+   // Find a free write...
+   ptyWrite = NULL;
+   bInterruptsDisabled = MAP_IntMasterDisable();
+   for (i=0; i < TLC59116_MAX_QUEUED_WRITES; i++)
+      {
+      if (ptyLocalWrites[i].bInUse == FALSE)
          {
-         return FALSE;
+         ptyWrite = &ptyLocalWrites[i];
+         ptyWrite->bInUse = TRUE;
+         break;
          }
       }
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
 
+   if (ptyWrite == NULL)
+      return FALSE;
 
-   // Set the default blink frequency....
-   pucTxRxData[0] =  TLC59116_GRPFREQ;
-   pucTxRxData[1] =  TLC59116_BLINK_500MS_SEC_FREQ;
+   ptyWrite->pucTxData[0] = ucRegister | TLC59116_AUTO_INCREMENT_ALL;
+   for (i=0; i < ucCount; i++)
+      {
+      ptyWrite->pucTxData[i + 1] = pucLocalShadow[ucRegister + i];
+      }
+   ptyWrite->tyCallback   = tyCallback;
 
-   if (I2C_IF_Write(TLC59116_DEVICE_ADDR,pucTxRxData,2,1) != SUCCESS)
+   ptyWrite->tyTransaction.ucDeviceAddress = TLC59116_DEVICE_ADDR;
+   ptyWrite->tyTransaction.pucTxData       = ptyWrite->pucTxData;
+   ptyWrite->tyTransaction.ucTxLength      = ucCount + 1;
+   ptyWrite->tyTransaction.pucRxData       = NULL;
+   ptyWrite->tyTransaction.ucRxLength      = 0;
+   ptyWrite->tyTransaction.tyCallback      = TLC59116_WriteComplete;
+   ptyWrite->tyTransaction.pvContext       = ptyWrite;
+
+   if (I2CQUEUE_Submit(&ptyWrite->tyTransaction) == FALSE)
       {
+      ptyWrite->bInUse = FALSE;
       return FALSE;
       }
 
-   // Set the default blink duty cycle....
-   pucTxRxData[0] =  TLC59116_GRPPWM;
-   pucTxRxData[1] =  TLC59116_BLINK_500MS_SEC_FREQ * 2;
+   return TRUE;
+}
+
 
-   if (I2C_IF_Write(TLC59116_DEVICE_ADDR,pucTxRxData,2,1) != SUCCESS)
+/****************************************************************************
+     Function: TLC59116_WriteRegisters
+     Engineer: agent
+        Input: unsigned char ucRegister: First register to write.
+               unsigned char ucCount: Number of registers to write.
+       Output: TRUE: Success, FALSE: Failure.
+  Description: Writes consecutive registers from the shadow copy in a single
+               auto-increment burst.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char TLC59116_WriteRegisters(unsigned char ucRegister, unsigned char ucCount)
+{
+   unsigned char i;
+   unsigned char pucTxRxData[TLC59116_REGISTER_COUNT + 1];
+
+   if ((ucCount == 0) || ((ucRegister + ucCount) > TLC59116_REGISTER_COUNT))
+      {
+      return FALSE;
+      }
+
+   // Make sure that the I2C queue is not using the peripheral....
+   I2CQUEUE_WaitForIdle();
+
+   pucTxRxData[0] =  ucRegister | TLC59116_AUTO_INCREMENT_ALL;
+   for (i=0; i < ucCount; i++)
+      {
+      pucTxRxData[i + 1] = pucLocalShadow[ucRegister + i];
+      }
+
+   if (I2C_IF_Write(TLC59116_DEVICE_ADDR,pucTxRxData,ucCount + 1,1) != SUCCESS)
       {
       return FALSE;
       }
@@ -123,6 +330,52 @@ unsigned char TLC59116_Initialise(void)
    return TRUE;
 }
 
+/****************************************************************************
+     Function: TLC59116_Initialise
+     Engineer: Martin Hannon
+        Input: N/A
+       Output: TRUE: Success, FALSE: Failure.
+  Description: Initialises the TLC59116 LED controller
+Date           Initials    Description
+10-DEC-2016    MH          Initial
+17-OCT-2026    agent       Write all of the registers in a single burst.
+17-OCT-2026    agent       Initialise the shadow copy of the registers.
+****************************************************************************/
+unsigned char TLC59116_Initialise(void)
+{
+   unsigned char i;
+
+   ulLocalDirty                   = 0;
+   ucLocalCommitWritesOutstanding = 0;
+
+   // Program the Mode 1 register....
+   pucLocalShadow[TLC59116_MODE1] = TLC59116_MODE1_DEFAULT;
+
+   // Program the Mode 2 register....
+   pucLocalShadow[TLC59116_MODE2] = TLC59116_MODE2_DEFAULT;
+
+   // Set all PWM values to 0x00 (off)....
+   for (i=0; i < 16; i++)
+      {
+      pucLocalShadow[TLC59116_PWM0 + i] = 0;
+      }
+
+   // Set the default blink duty cycle....
+   pucLocalShadow[TLC59116_GRPPWM]  = TLC59116_BLINK_500MS_SEC_FREQ * 2;
+
+   // Set the default blink frequency....
+   pucLocalShadow[TLC59116_GRPFREQ] = TLC59116_BLINK_500MS_SEC_FREQ;
+
+   // Set leds to PWM control....
+   for (i=0; i < 4; i++)
+      {
+      pucLocalShadow[TLC59116_LEDOUT0 + i] = TLC59116_LEDOUT_PWM;
+      }
+
+   // Write everything in one burst....
+   return TLC59116_WriteRegisters(TLC59116_MODE1, TLC59116_REGISTER_COUNT);
+}
+
 
 /****************************************************************************
      Function: TLC59116_LedColourIntensity
@@ -132,20 +385,48 @@ unsigned char TLC59116_Initialise(void)
                TyLedIntensity tyLedIntensity: 100%, 75%, 50%, 25% or 0%.
        Output: TRUE: Success, FALSE: Failure.
   Description: Configures the intensity of the specified LED colour in the 
-               specified bank.
+               specified bank. Takes effect on the next commit.
 Date           Initials    Description
 10-DEC-2016    MH          Initial
+17-OCT-2026    agent       Updates the shadow copy only.
 ****************************************************************************/
 unsigned char TLC59116_LedColourIntensity(TyLedBank tyLedBank, TyLedColour tyLedColour, TyLedIntensity tyLedIntensity)
 {
-   unsigned char pucTxRxData[0x2];
+   unsigned char ucRegister;
 
-   pucTxRxData[0]  = TLC59116_PWM0;
-   pucTxRxData[0] += ((unsigned char)tyLedBank * 4); // Bump the address by the bank number.
-   pucTxRxData[0] += (unsigned char)tyLedColour;     // Bump the address by the LED colour.
-   pucTxRxData[1] =  (unsigned char)tyLedIntensity;
+   if ((tyLedBank > LED_BANK_3) || (tyLedColour > LED_RED))
+      {
+      return FALSE;
+      }
+
+   ucRegister  = TLC59116_PWM0;
+   ucRegister += ((unsigned char)tyLedBank * 4); // Bump the address by the bank number.
+   ucRegister += (unsigned char)tyLedColour;     // Bump the address by the LED colour.
 
-   if (I2C_IF_Write(TLC59116_DEVICE_ADDR,pucTxRxData,2,1) != SUCCESS)
+   TLC59116_SetRegister(ucRegister, (unsigned char)tyLedIntensity);
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: TLC59116_LedBankIntensity
+     Engineer: agent
+        Input: TyLedBank tyLedBank: LED bank to control (0 to 3)
+               TyLedIntensity tyBlue: Intensity of the blue LED.
+               TyLedIntensity tyGreen: Intensity of the green LED.
+               TyLedIntensity tyRed: Intensity of the red LED.
+       Output: TRUE: Success, FALSE: Failure.
+  Description: Configures the intensity of every colour in the specified
+               bank. Takes effect on the next commit.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char TLC59116_LedBankIntensity(TyLedBank tyLedBank, TyLedIntensity tyBlue, TyLedIntensity tyGreen, TyLedIntensity tyRed)
+{
+   if ((TLC59116_LedColourIntensity(tyLedBank, LED_BLUE,  tyBlue)  == FALSE) ||
+       (TLC59116_LedColourIntensity(tyLedBank, LED_GREEN, tyGreen) == FALSE) ||
+       (TLC59116_LedColourIntensity(tyLedBank, LED_RED,   tyRed)   == FALSE))
       {
       return FALSE;
       }
@@ -162,29 +443,25 @@ unsigned char TLC59116_LedColourIntensity(TyLedBank tyLedBank, TyLedColour tyLed
                unsigned char bEnableBlinking: TRUE = Enable Blinking
        Output: TRUE: Success, FALSE: Failure.
   Description: Enables / disables blinking for the specified bank.
-               specified bank.
+               specified bank. Takes effect on the next commit.
 Date           Initials    Description
 10-DEC-2016    MH          Initial
+17-OCT-2026    agent       Updates the shadow copy only.
 ****************************************************************************/
 unsigned char TLC59116_LedBankBlinkControl(TyLedBank tyLedBank, unsigned char bEnableBlinking)
 {
-   unsigned char pucTxRxData[0x2];
-
-   pucTxRxData[0] =  TLC59116_LEDOUT0 + (unsigned char)tyLedBank;
+   if (tyLedBank > LED_BANK_3)
+      {
+      return FALSE;
+      }
 
    if (bEnableBlinking)
       {
-      pucTxRxData[1] =  TLC59116_LEDOUT_PWM_BLINK;
+      TLC59116_SetRegister(TLC59116_LEDOUT0 + (unsigned char)tyLedBank, TLC59116_LEDOUT_PWM_BLINK);
       }
    else
       {
-      pucTxRxData[1] =  TLC59116_LEDOUT_PWM;
-      }
-
-
-   if (I2C_IF_Write(TLC59116_DEVICE_ADDR,pucTxRxData,2,1) != SUCCESS)
-      {
-      return FALSE;
+      TLC59116_SetRegister(TLC59116_LEDOUT0 + (unsigned char)tyLedBank, TLC59116_LEDOUT_PWM);
       }
 
    return TRUE;
@@ -197,29 +474,161 @@ unsigned char TLC59116_LedBankBlinkControl(TyLedBank tyLedBank, unsigned char bE
         Input: unsigned char ucFrequency: 0 = 24Hz. 0xFF = 10.73 seconds
                unsigned char ucDutyCycle: 0 = 24Hz. 0xFF = 10.73 seconds
        Output: TRUE: Success, FALSE: Failure.
-  Description: Configures the blink rate used by all LED banks.
+  Description: Configures the blink rate used by all LED banks. Takes effect
+               on the next commit.
 Date           Initials    Description
 10-DEC-2016    MH          Initial
+17-OCT-2026    agent       Single burst write.
+17-OCT-2026    agent       Updates the shadow copy only.
 ****************************************************************************/
 unsigned char TLC59116_GlobalBlinkRate(unsigned char ucFrequency, unsigned char ucDutyCycle)
 {
-   unsigned char pucTxRxData[0x2];
+   TLC59116_SetRegister(TLC59116_GRPFREQ, ucFrequency);
+   TLC59116_SetRegister(TLC59116_GRPPWM,  ucDutyCycle);
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: TLC59116_Commit
+     Engineer: agent
+        Input: N/A
+       Output: TRUE: Success, FALSE: Failure.
+  Description: Writes the registers which have changed since the last commit
+               to the device, using as few bursts as possible.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char TLC59116_Commit(void)
+{
+   unsigned char ucRegister, ucCount;
+   unsigned long ulDirty;
+   tBoolean bInterruptsDisabled;
 
-   pucTxRxData[0] =  TLC59116_GRPFREQ;
-   pucTxRxData[1] =  ucFrequency;
+   // Make sure that any non-blocking commit has finished....
+   I2CQUEUE_WaitForIdle();
 
-   if (I2C_IF_Write(TLC59116_DEVICE_ADDR,pucTxRxData,2,1) != SUCCESS)
+   bInterruptsDisabled = MAP_IntMasterDisable();
+   ulDirty      = ulLocalDirty;
+   ulLocalDirty = 0;
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+
+   ucRegister = TLC59116_NextDirtyRun(ulDirty, 0, &ucCount);
+   while (ucRegister < TLC59116_REGISTER_COUNT)
       {
-      return FALSE;
+      if (TLC59116_WriteRegisters(ucRegister, ucCount) == FALSE)
+         {
+         // Write the registers that were not written on the next commit....
+         ulDirty &= ~((1ul << ucRegister) - 1);
+
+         bInterruptsDisabled = MAP_IntMasterDisable();
+         ulLocalDirty |= ulDirty;
+         if (!bInterruptsDisabled)
+            MAP_IntMasterEnable();
+
+         return FALSE;
+         }
+
+      ucRegister = TLC59116_NextDirtyRun(ulDirty, ucRegister + ucCount, &ucCount);
       }
 
-   pucTxRxData[0] =  TLC59116_GRPPWM;
-   pucTxRxData[1] =  ucDutyCycle;
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: TLC59116_CommitWriteComplete
+     Engineer: agent
+        Input: unsigned char bSuccess: TRUE if the write succeeded.
+       Output: N/A
+  Description: Completion callback for each write of a non-blocking commit.
+               Reports the result once all of the writes have completed.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void TLC59116_CommitWriteComplete(unsigned char bSuccess)
+{
+   TyTLC59116Callback tyCallback;
 
-   if (I2C_IF_Write(TLC59116_DEVICE_ADDR,pucTxRxData,2,1) != SUCCESS)
+   if (bSuccess == FALSE)
+      bLocalCommitFailed = TRUE;
+
+   ucLocalCommitWritesOutstanding--;
+
+   if (ucLocalCommitWritesOutstanding == 0)
       {
+      tyCallback = tyLocalCommitCallback;
+
+      if (tyCallback != NULL)
+         tyCallback((bLocalCommitFailed == FALSE) ? TRUE : FALSE);
+      }
+}
+
+
+/****************************************************************************
+     Function: TLC59116_CommitAsync
+     Engineer: agent
+        Input: TyTLC59116Callback tyCallback: Invoked when all of the writes
+                  have completed (may be NULL).
+       Output: TRUE: Commit started, FALSE: Failure (commit in progress).
+  Description: Non-blocking version of TLC59116_Commit. The callback is
+               invoked from the I2C interrupt handler, or straight away if
+               there is nothing to write. Registers whose write fails are
+               written again on the next commit.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char TLC59116_CommitAsync(TyTLC59116Callback tyCallback)
+{
+   unsigned char ucRegister, ucCount, ucWrites, bQueued;
+   unsigned long ulDirty;
+   tBoolean bInterruptsDisabled;
+
+   // Queue all of the writes with interrupts disabled, so that the commit
+   // cannot be reported as complete until all of them have been queued....
+   bInterruptsDisabled = MAP_IntMasterDisable();
+
+   if (ucLocalCommitWritesOutstanding != 0)
+      {
+      if (!bInterruptsDisabled)
+         MAP_IntMasterEnable();
       return FALSE;
       }
 
+   ulDirty      = ulLocalDirty;
+   ulLocalDirty = 0;
+
+   bLocalCommitFailed    = FALSE;
+   tyLocalCommitCallback = tyCallback;
+   bQueued               = TRUE;
+   ucWrites              = 0;
+
+   ucRegister = TLC59116_NextDirtyRun(ulDirty, 0, &ucCount);
+   while (ucRegister < TLC59116_REGISTER_COUNT)
+      {
+      if (TLC59116_QueueWrite(ucRegister, ucCount, TLC59116_CommitWriteComplete) == FALSE)
+         {
+         // Write the registers that were not queued on the next commit....
+         ulLocalDirty |= ulDirty & ~((1ul << ucRegister) - 1);
+         bLocalCommitFailed = TRUE;
+         bQueued = FALSE;
+         break;
+         }
+
+      ucLocalCommitWritesOutstanding++;
+      ucWrites++;
+
+      ucRegister = TLC59116_NextDirtyRun(ulDirty, ucRegister + ucCount, &ucCount);
+      }
+
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+
+   // Nothing was queued, so report the result now....
+   if ((ucWrites == 0) && (tyCallback != NULL))
+      tyCallback(bQueued);
+
    return TRUE;
 }
@@ -5,6 +5,9 @@
                LED driver.
 Date           Initials    Description
 10-DEC-2016    MH          Initial
+17-OCT-2026    agent       Added non-blocking intensity updates.
+17-OCT-2026    agent       Added the bank intensity bursts.
+17-OCT-2026    agent       Added TLC59116_Commit.
 ****************************************************************************/
 
 typedef enum
@@ -39,8 +42,18 @@ typedef enum
 
 } TyLedIntensity;
 
+// Callback for the non-blocking commit. bSuccess is FALSE if a write failed.
+// NOTE:- This is invoked from the I2C interrupt handler.
+typedef void (*TyTLC59116Callback)(unsigned char bSuccess);
 
+
+// NOTE:- The LED functions only update a copy of the device registers.
+// The changes are written to the device by TLC59116_Commit or
+// TLC59116_CommitAsync.
 unsigned char TLC59116_Initialise(void);
 unsigned char TLC59116_LedColourIntensity(TyLedBank tyLedBank, TyLedColour tyLedColour, TyLedIntensity tyLedIntensity);
+unsigned char TLC59116_LedBankIntensity(TyLedBank tyLedBank, TyLedIntensity tyBlue, TyLedIntensity tyGreen, TyLedIntensity tyRed);
 unsigned char TLC59116_LedBankBlinkControl(TyLedBank tyLedBank, unsigned char bEnableBlinking);
 unsigned char TLC59116_GlobalBlinkRate(unsigned char ucFrequency, unsigned char ucDutyCycle);
+unsigned char TLC59116_Commit(void);
+unsigned char TLC59116_CommitAsync(TyTLC59116Callback tyCallback);
@@ -0,0 +1,392 @@
+/****************************************************************************
+       Module: UARTTX.c
+     Engineer: agent
+  Description: Contains the buffered, interrupt driven transmit for the
+               console UART. Writes are copied into a ring buffer and return
+               straight away; the UART transmit interrupt then moves the
+               bytes into the 16 byte UART FIFO as it empties.
+
+               The ring buffer has a single producer (thread context) and a
+               single consumer (the interrupt). Only the producer writes
+               usLocalHead and, apart from dropping the oldest writes, only
+               the consumer writes usLocalTail. The indices run freely and
+               are masked.
+
+               The producer also keeps the end of each buffered write, so
+               that UARTTX_DROP_OLDEST can drop whole writes. The write
+               being sent is never dropped; if part of it has gone it is
+               moved up against the next write kept.
+
+               The UART is configured here too, rather than by the SDK's
+               InitTerm, as uart_if.obj also holds Report, which links in
+               the printf library and malloc and so needs a heap.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added UARTTX_Configure and UARTTX_WriteDirect in
+                           place of InitTerm and Message.
+17-OCT-2026    agent       UARTTX_DROP_OLDEST drops whole writes rather than
+                           bytes, which could cut a frame.
+****************************************************************************/
+#include "includes.h"
+#include "uart.h"
+
+static unsigned char           pucLocalBuffer[UARTTX_BUFFER_SIZE];
+static volatile unsigned short usLocalHead;
+static volatile unsigned short usLocalTail;
+static volatile unsigned long  ulLocalOverflows;
+static TyUartTxPolicy          tyLocalPolicy;
+
+// Buffered writes, oldest first. Only used by the producer....
+static unsigned short          pusLocalWriteEnd[UARTTX_MAX_WRITES];
+static unsigned char           ucLocalFirstWrite;
+static unsigned short          usLocalWriteCount;
+static unsigned short          usLocalFirstStart;  // Start of the oldest write.
+
+
+/****************************************************************************
+     Function: UARTTX_Fill
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Moves bytes from the ring buffer into the UART FIFO until the
+               FIFO is full or the ring buffer is empty. Called from the
+               interrupt, or with interrupts disabled.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void UARTTX_Fill(void)
+{
+   unsigned short usTail;
+
+   usTail = usLocalTail;
+
+   while ((usTail != usLocalHead) && MAP_UARTSpaceAvail(CONSOLE))
+      {
+      MAP_UARTCharPutNonBlocking(CONSOLE, pucLocalBuffer[usTail & (UARTTX_BUFFER_SIZE - 1)]);
+      usTail++;
+      }
+
+   usLocalTail = usTail;
+}
+
+
+/****************************************************************************
+     Function: UARTTX_Interrupt
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Interrupt handler for the console UART. Refills the FIFO
+               when it drops to the transmit level.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void UARTTX_Interrupt(void)
+{
+   MAP_UARTIntClear(CONSOLE, MAP_UARTIntStatus(CONSOLE, true));
+
+   UARTTX_Fill();
+}
+
+
+/****************************************************************************
+     Function: UARTTX_ForgetSent
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Forgets the buffered writes which have been sent in full.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void UARTTX_ForgetSent(void)
+{
+   unsigned short usHead, usEnd;
+
+   usHead = usLocalHead;
+
+   // A write has been sent once no more than the bytes after it are
+   // still buffered....
+   while (usLocalWriteCount > 0)
+      {
+      usEnd = pusLocalWriteEnd[ucLocalFirstWrite];
+
+      if ((unsigned short)(usHead - usEnd) < (unsigned short)(usHead - usLocalTail))
+         break;
+
+      usLocalFirstStart = usEnd;
+      ucLocalFirstWrite = (ucLocalFirstWrite + 1) & (UARTTX_MAX_WRITES - 1);
+      usLocalWriteCount--;
+      }
+}
+
+
+/****************************************************************************
+     Function: UARTTX_DropOldest
+     Engineer: agent
+        Input: unsigned short usLength: Length of the write to make room
+                  for.
+       Output: N/A
+  Description: Drops the oldest whole writes which have not started to be
+               sent, until usLength bytes and a write fit or there are none
+               left. If the oldest write has been partly sent, the rest of
+               it is moved up over the write dropped after it, so it is
+               still sent whole. Must be called with interrupts disabled.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void UARTTX_DropOldest(unsigned short usLength)
+{
+   unsigned short usFirstEnd, usDropped, i;
+
+   UARTTX_ForgetSent();
+
+   while ((usLocalWriteCount == UARTTX_MAX_WRITES) ||
+          (usLength > (UARTTX_BUFFER_SIZE - (unsigned short)(usLocalHead - usLocalTail))))
+      {
+      if (usLocalTail == usLocalFirstStart)
+         {
+         // None of the oldest write has gone, so drop it....
+         if (usLocalWriteCount == 0)
+            return;
+
+         usLocalTail       = pusLocalWriteEnd[ucLocalFirstWrite];
+         usLocalFirstStart = usLocalTail;
+         }
+      else
+         {
+         // Drop the write after the one being sent, and move the rest of
+         // the one being sent up against the write after that....
+         if (usLocalWriteCount < 2)
+            return;
+
+         usFirstEnd = pusLocalWriteEnd[ucLocalFirstWrite];
+         usDropped  = pusLocalWriteEnd[(ucLocalFirstWrite + 1) & (UARTTX_MAX_WRITES - 1)] - usFirstEnd;
+
+         for (i=usFirstEnd - usLocalTail; i > 0; i--)
+            {
+            pucLocalBuffer[(usLocalTail + usDropped + i - 1) & (UARTTX_BUFFER_SIZE - 1)] =
+               pucLocalBuffer[(usLocalTail + i - 1) & (UARTTX_BUFFER_SIZE - 1)];
+            }
+
+         // The write being sent now ends where the dropped write did....
+         usLocalTail       += usDropped;
+         usLocalFirstStart += usDropped;
+         }
+
+      ucLocalFirstWrite = (ucLocalFirstWrite + 1) & (UARTTX_MAX_WRITES - 1);
+      usLocalWriteCount--;
+      }
+}
+
+
+/****************************************************************************
+     Function: UARTTX_Configure
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Configures the console UART for 115200 baud, 8 data bits, no
+               parity and one stop bit.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void UARTTX_Configure(void)
+{
+   MAP_UARTConfigSetExpClk(CONSOLE, MAP_PRCMPeripheralClockGet(CONSOLE_PERIPH), UART_BAUD_RATE,
+                           (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE));
+}
+
+
+/****************************************************************************
+     Function: UARTTX_WriteDirect
+     Engineer: agent
+        Input: const char *pcString: Null terminated string to send.
+       Output: N/A
+  Description: Sends a string straight to the UART, waiting for room in the
+               FIFO. For the startup messages, before anything is buffered.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void UARTTX_WriteDirect(const char *pcString)
+{
+   while (*pcString != '\0')
+      {
+      MAP_UARTCharPut(CONSOLE, *pcString++);
+      }
+}
+
+
+/****************************************************************************
+     Function: UARTTX_Initialise
+     Engineer: agent
+        Input: TyUartTxPolicy tyPolicy: What to do when the buffer is full.
+       Output: N/A
+  Description: Initialises the buffered transmit. UARTTX_Configure must
+               have been called first. UARTTX_WriteDirect must not be used
+               once output has been buffered, as it would be mixed in with
+               it.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Follows UARTTX_Configure rather than InitTerm.
+****************************************************************************/
+void UARTTX_Initialise(TyUartTxPolicy tyPolicy)
+{
+   usLocalHead      = 0;
+   usLocalTail      = 0;
+   ulLocalOverflows = 0;
+   tyLocalPolicy    = tyPolicy;
+
+   ucLocalFirstWrite = 0;
+   usLocalWriteCount = 0;
+   usLocalFirstStart = 0;
+
+   // Interrupt when the FIFO is down to 2 bytes, which leaves 170 us at
+   // 115200 baud to refill it....
+   MAP_UARTFIFOLevelSet(CONSOLE, UART_FIFO_TX1_8, UART_FIFO_RX4_8);
+   MAP_UARTTxIntModeSet(CONSOLE, UART_TXINT_MODE_FIFO);
+   MAP_UARTIntRegister(CONSOLE, UARTTX_Interrupt);
+   MAP_UARTIntEnable(CONSOLE, UART_INT_TX);
+}
+
+
+/****************************************************************************
+     Function: UARTTX_Write
+     Engineer: agent
+        Input: const unsigned char *pucData: Data to send.
+               unsigned short usLength: Number of bytes.
+       Output: TRUE: Data buffered, FALSE: Data dropped (buffer full).
+  Description: Buffers data for sending and returns without waiting. If
+               there is not enough room the write is dropped or, with
+               UARTTX_DROP_OLDEST, the oldest whole writes not yet being
+               sent are dropped to make room. If that is not enough the
+               write is dropped anyway. Either way the overflow count is
+               incremented. Must not be called from an interrupt handler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Drops whole writes, and keeps their ends.
+****************************************************************************/
+unsigned char UARTTX_Write(const unsigned char *pucData, unsigned short usLength)
+{
+   unsigned short i, usHead, usFree;
+   tBoolean bInterruptsDisabled;
+
+   if (usLength > UARTTX_BUFFER_SIZE)
+      {
+      ulLocalOverflows++;
+      return FALSE;
+      }
+
+   UARTTX_ForgetSent();
+
+   usHead = usLocalHead;
+   usFree = UARTTX_BUFFER_SIZE - (unsigned short)(usHead - usLocalTail);
+
+   if ((usLength > usFree) || (usLocalWriteCount == UARTTX_MAX_WRITES))
+      {
+      ulLocalOverflows++;
+
+      if (tyLocalPolicy == UARTTX_DROP_NEWEST)
+         return FALSE;
+
+      // The interrupt also moves the tail, so this must not be
+      // interrupted....
+      bInterruptsDisabled = MAP_IntMasterDisable();
+      UARTTX_DropOldest(usLength);
+      usFree = UARTTX_BUFFER_SIZE - (unsigned short)(usHead - usLocalTail);
+      if (!bInterruptsDisabled)
+         MAP_IntMasterEnable();
+
+      if ((usLength > usFree) || (usLocalWriteCount == UARTTX_MAX_WRITES))
+         return FALSE;
+      }
+
+   // Copy the data in before making it visible to the interrupt....
+   for (i=0; i < usLength; i++)
+      pucLocalBuffer[(usHead + i) & (UARTTX_BUFFER_SIZE - 1)] = pucData[i];
+
+   pusLocalWriteEnd[(ucLocalFirstWrite + usLocalWriteCount) & (UARTTX_MAX_WRITES - 1)] = usHead + usLength;
+   usLocalWriteCount++;
+
+   usLocalHead = usHead + usLength;
+
+   // The transmit interrupt only occurs as the FIFO empties, so start the
+   // FIFO off here. If it is already sending this does nothing....
+   bInterruptsDisabled = MAP_IntMasterDisable();
+   UARTTX_Fill();
+   if (!bInterruptsDisabled)
+      MAP_IntMasterEnable();
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: UARTTX_WriteString
+     Engineer: agent
+        Input: const char *pcString: Null terminated string to send.
+       Output: TRUE: String buffered, FALSE: String dropped (buffer full).
+  Description: Buffers a string for sending. See UARTTX_Write.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char UARTTX_WriteString(const char *pcString)
+{
+   unsigned short usLength;
+
+   usLength = 0;
+   while (pcString[usLength] != '\0')
+      usLength++;
+
+   return UARTTX_Write((const unsigned char *)pcString, usLength);
+}
+
+
+/****************************************************************************
+     Function: UARTTX_IsIdle
+     Engineer: agent
+        Input: N/A
+       Output: TRUE: Nothing buffered, FALSE: Data still to be sent.
+  Description: Reports whether the ring buffer is empty. The last few bytes
+               may still be in the UART FIFO.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char UARTTX_IsIdle(void)
+{
+   return (usLocalHead == usLocalTail) ? TRUE : FALSE;
+}
+
+
+/****************************************************************************
+     Function: UARTTX_WaitForIdle
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Waits for all the buffered data to be sent. Must not be
+               called from an interrupt handler or with interrupts disabled.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Reads the UART on every pass, so that the wait
+                           also moves the simulation's clock on.
+****************************************************************************/
+void UARTTX_WaitForIdle(void)
+{
+   while (MAP_UARTBusy(CONSOLE) || (usLocalHead != usLocalTail))
+      {
+      ;;
+      }
+}
+
+
+/****************************************************************************
+     Function: UARTTX_GetOverflows
+     Engineer: agent
+        Input: N/A
+       Output: Number of writes which overflowed the buffer.
+  Description: Returns the number of writes which did not fit in the buffer,
+               whether the write or older data was dropped.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned long UARTTX_GetOverflows(void)
+{
+   return ulLocalOverflows;
+}
@@ -0,0 +1,49 @@
+/****************************************************************************
+       Module: UARTTX.h
+     Engineer: agent
+  Description: Contains the types and function prototypes for the buffered
+               console UART transmit.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added UARTTX_Configure and UARTTX_WriteDirect.
+17-OCT-2026    agent       UARTTX_DROP_OLDEST drops whole writes.
+****************************************************************************/
+
+// Size of the transmit ring buffer. Must be a power of 2, and can be set for
+// the build (e.g. --define=UARTTX_BUFFER_SIZE=1024).
+#ifndef UARTTX_BUFFER_SIZE
+#define UARTTX_BUFFER_SIZE    512
+#endif
+
+#if ((UARTTX_BUFFER_SIZE & (UARTTX_BUFFER_SIZE - 1)) != 0) || (UARTTX_BUFFER_SIZE > 32768)
+#error UARTTX_BUFFER_SIZE must be a power of 2, no larger than 32768.
+#endif
+
+// Most writes which can be buffered at once. Must be a power of 2....
+#ifndef UARTTX_MAX_WRITES
+#define UARTTX_MAX_WRITES     32
+#endif
+
+#if ((UARTTX_MAX_WRITES & (UARTTX_MAX_WRITES - 1)) != 0) || (UARTTX_MAX_WRITES < 2) || (UARTTX_MAX_WRITES > 256)
+#error UARTTX_MAX_WRITES must be a power of 2, from 2 to 256.
+#endif
+
+// What to do when a write does not fit in the buffer. Either way a write is
+// never split, so a telemetry frame is sent whole or not at all.
+typedef enum
+{
+   UARTTX_DROP_NEWEST = 0,    // Drop the write.
+   UARTTX_DROP_OLDEST = 1     // Drop the oldest whole writes which have not
+                              // started to be sent to make room.
+} TyUartTxPolicy;
+
+
+// Function prototypes from the UARTTX module...
+void UARTTX_Configure(void);
+void UARTTX_WriteDirect(const char *pcString);
+void UARTTX_Initialise(TyUartTxPolicy tyPolicy);
+unsigned char UARTTX_Write(const unsigned char *pucData, unsigned short usLength);
+unsigned char UARTTX_WriteString(const char *pcString);
+unsigned char UARTTX_IsIdle(void);
+void UARTTX_WaitForIdle(void);
+unsigned long UARTTX_GetOverflows(void);
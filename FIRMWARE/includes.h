@@ -4,6 +4,15 @@
   Description: Contains the various include files used by the project.
 Date           Initials    Description
 05-DEC-2016    MH          Initial
+17-OCT-2026    agent       Added I2CQUEUE.h
+17-OCT-2026    agent       Added LEDANIM.h
+17-OCT-2026    agent       Added SCHEDULER.h
+17-OCT-2026    agent       Added AGGREGATE.h
+17-OCT-2026    agent       AGGREGATE.h follows PPD42NJ.h
+17-OCT-2026    agent       Added TELEMETRY.h
+17-OCT-2026    agent       Added UARTTX.h
+17-OCT-2026    agent       Added PROFILE.h
+17-OCT-2026    agent       Added FLASHLOG.h
 ****************************************************************************/
 
 #include <stdlib.h>
@@ -19,6 +28,7 @@ Date           Initials    Description
 #include "timer.h"
 #include "utils.h"
 #include "gpio.h"
+#include "pin.h"
 
 
 //Common interface includes
@@ -39,6 +49,14 @@ Date           Initials    Description
 #endif
 
 #include "DELAY.h"
+#include "SCHEDULER.h"
+#include "I2CQUEUE.h"
 #include "HDC1080.h"
 #include "PPD42NJ.h"
+#include "AGGREGATE.h"
 #include "TLC59116.h"
+#include "LEDANIM.h"
+#include "UARTTX.h"
+#include "TELEMETRY.h"
+#include "FLASHLOG.h"
+#include "PROFILE.h"
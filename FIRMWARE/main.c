@@ -4,19 +4,92 @@
   Description: Contains the main high level function for the firmware.
 Date           Initials    Description
 05-DEC-2016    MH          Initial
+17-OCT-2026    agent       The application runs as tasks on the event
+                           scheduler.
+17-OCT-2026    agent       Measurements are reported in binary telemetry
+                           frames.
+17-OCT-2026    agent       Output from the tasks is buffered.
+17-OCT-2026    agent       Optional profiling of the interrupts and driver
+                           calls.
+17-OCT-2026    agent       The console is driven by UARTTX alone, so the
+                           printf library and the heap are not linked.
+17-OCT-2026    agent       The samples are also kept in the flash log.
+17-OCT-2026    agent       Reports the low times over the last hour.
+17-OCT-2026    agent       A flash log failure is counted and reported,
+                           rather than stopping the firmware.
+17-OCT-2026    agent       The LED ramp on Banks 0 to 2 is as it was before
+                           the animation engine.
+17-OCT-2026    agent       The HDC1080 reports in fixed point.
 ****************************************************************************/
 #include "includes.h"
 
 
-#define LED_INTENSITY_DELAY_STEP  300000  // 300000 microseconds
+//*****************************************************************************
+//                  LED animations
+//*****************************************************************************
+// Banks 0 to 2 ramp up in blue, green and red, a tenth of full every
+// 300 ms (3.3 seconds a ramp), then start again from off. Each level is
+// reached at once and held...
+#define LED_RAMP_STEP              300 // 300 milliseconds
+#define LED_RAMP_LEVEL(b, g, r)    {0, b, g, r}, {LED_RAMP_STEP, b, g, r}
+
+static const TyLedKeyframe ptyLocalBlueRampKeyframes[] =
+{
+   LED_RAMP_LEVEL(LED_0,   LED_0, LED_0), LED_RAMP_LEVEL(LED_10,  LED_0, LED_0),
+   LED_RAMP_LEVEL(LED_20,  LED_0, LED_0), LED_RAMP_LEVEL(LED_30,  LED_0, LED_0),
+   LED_RAMP_LEVEL(LED_40,  LED_0, LED_0), LED_RAMP_LEVEL(LED_50,  LED_0, LED_0),
+   LED_RAMP_LEVEL(LED_60,  LED_0, LED_0), LED_RAMP_LEVEL(LED_70,  LED_0, LED_0),
+   LED_RAMP_LEVEL(LED_80,  LED_0, LED_0), LED_RAMP_LEVEL(LED_90,  LED_0, LED_0),
+   LED_RAMP_LEVEL(LED_100, LED_0, LED_0)
+};
+static const TyLedAnimation tyLocalBlueRampAnimation = {ptyLocalBlueRampKeyframes, 22, TRUE};
+
+static const TyLedKeyframe ptyLocalGreenRampKeyframes[] =
+{
+   LED_RAMP_LEVEL(LED_0, LED_0,   LED_0), LED_RAMP_LEVEL(LED_0, LED_10,  LED_0),
+   LED_RAMP_LEVEL(LED_0, LED_20,  LED_0), LED_RAMP_LEVEL(LED_0, LED_30,  LED_0),
+   LED_RAMP_LEVEL(LED_0, LED_40,  LED_0), LED_RAMP_LEVEL(LED_0, LED_50,  LED_0),
+   LED_RAMP_LEVEL(LED_0, LED_60,  LED_0), LED_RAMP_LEVEL(LED_0, LED_70,  LED_0),
+   LED_RAMP_LEVEL(LED_0, LED_80,  LED_0), LED_RAMP_LEVEL(LED_0, LED_90,  LED_0),
+   LED_RAMP_LEVEL(LED_0, LED_100, LED_0)
+};
+static const TyLedAnimation tyLocalGreenRampAnimation = {ptyLocalGreenRampKeyframes, 22, TRUE};
+
+static const TyLedKeyframe ptyLocalRedRampKeyframes[] =
+{
+   LED_RAMP_LEVEL(LED_0, LED_0, LED_0),   LED_RAMP_LEVEL(LED_0, LED_0, LED_10),
+   LED_RAMP_LEVEL(LED_0, LED_0, LED_20),  LED_RAMP_LEVEL(LED_0, LED_0, LED_30),
+   LED_RAMP_LEVEL(LED_0, LED_0, LED_40),  LED_RAMP_LEVEL(LED_0, LED_0, LED_50),
+   LED_RAMP_LEVEL(LED_0, LED_0, LED_60),  LED_RAMP_LEVEL(LED_0, LED_0, LED_70),
+   LED_RAMP_LEVEL(LED_0, LED_0, LED_80),  LED_RAMP_LEVEL(LED_0, LED_0, LED_90),
+   LED_RAMP_LEVEL(LED_0, LED_0, LED_100)
+};
+static const TyLedAnimation tyLocalRedRampAnimation = {ptyLocalRedRampKeyframes, 22, TRUE};
 
 //*****************************************************************************
 //                  Local variables for the PPD42NJ sensor
 //*****************************************************************************
-static double        dLocalPPD42NJ_P1Accumulative;
-static double        dLocalPPD42NJ_P2Accumulative;
+static unsigned long ulLocalPPD42NJ_P1LowTime; // In 1 us units
+static unsigned long ulLocalPPD42NJ_P2LowTime; // In 1 us units
+static unsigned long ulLocalPPD42NJ_P1HourLowTime; // In 1 us units
+static unsigned long ulLocalPPD42NJ_P2HourLowTime; // In 1 us units
 static unsigned long ulLocalPPD42NJ_TimeStamp;
-static unsigned char bLocalPPD42NJ_DataAvailable;
+static TyParticleConcentration tyLocalPPD42NJ_Concentration;
+
+//*****************************************************************************
+//                  Local variables for the HDC1080 sensor
+//*****************************************************************************
+static short          sLocalHDC1080_Temperature; // In 0.01 degree C units
+static unsigned short usLocalHDC1080_Humidity;    // In 0.01 % units
+
+//*****************************************************************************
+//                  Local variables for the tasks
+//*****************************************************************************
+// Timer for the LED output task...
+static TySoftwareTimer tyLocalLedTimer;
+
+// Flash log failures since boot, reported in the telemetry...
+static unsigned long ulLocalFlashLogFailures;
 
 
 //*****************************************************************************
@@ -62,41 +135,179 @@ static void BoardInit(void)
 }
 
 
+/****************************************************************************
+     Function: ReportingTask
+     Engineer: agent
+        Input: unsigned long ulParameter: TRUE if the HDC1080 read succeeded.
+       Output: N/A
+  Description: Scheduler task which reports the latest measurements.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Reports the first sensor's PM2.5 / PM10.
+17-OCT-2026    agent       Adds a telemetry sample rather than printing.
+17-OCT-2026    agent       Logs the sample in the serial flash too.
+17-OCT-2026    agent       Reports the low times over the last hour.
+17-OCT-2026    agent       Counts a failed flash log write and carries on,
+                           as the log is only a backup of the console.
+****************************************************************************/
+static void ReportingTask(unsigned long ulParameter)
+{
+   unsigned long ulMaxLatency;
+   TyTelemetrySample tySample;
+
+   if (ulParameter == FALSE)
+      {
+      TELEMETRY_Flush();
+      UARTTX_WriteString("\n\rFailed to read temperature / humidity from the HDC1080\n\r");
+      SCHEDULER_Stop();
+      return;
+      }
+
+   ulMaxLatency = SCHEDULER_GetMaxLatency();
+   if (ulMaxLatency > 0xFFFF)
+      ulMaxLatency = 0xFFFF;
+
+   tySample.ulTimestamp      = ulLocalPPD42NJ_TimeStamp;
+   tySample.sTemperature     = sLocalHDC1080_Temperature;
+   tySample.usHumidity       = usLocalHDC1080_Humidity;
+   tySample.ulP1LowTime      = ulLocalPPD42NJ_P1LowTime;
+   tySample.ulP2LowTime      = ulLocalPPD42NJ_P2LowTime;
+   tySample.ulP1HourLowTime  = ulLocalPPD42NJ_P1HourLowTime;
+   tySample.ulP2HourLowTime  = ulLocalPPD42NJ_P2HourLowTime;
+   tySample.ulPM25           = tyLocalPPD42NJ_Concentration.pulPM25[0];
+   tySample.ulPM10           = tyLocalPPD42NJ_Concentration.pulPM10[0];
+   tySample.ucIdlePercentage = (unsigned char)TIMER_GetIdlePercentage();
+   tySample.usMaxLatency     = (unsigned short)ulMaxLatency;
+
+   // Keep the sample in case nothing is listening on the console....
+   if (FLASHLOG_Append(&tySample) == FALSE)
+      ulLocalFlashLogFailures++;
+
+   tySample.usFlashLogFailures = (ulLocalFlashLogFailures > 0xFFFF) ? 0xFFFF : (unsigned short)ulLocalFlashLogFailures;
+
+   TELEMETRY_AddSample(&tySample);
+}
+
+
+/****************************************************************************
+     Function: HDC1080Callback
+     Engineer: agent
+        Input: unsigned char bSuccess: TRUE if the read succeeded.
+               short sTemperature: Temperature in 0.01 degree C units.
+               unsigned short usHumidity: Humidity in 0.01 % units.
+       Output: N/A
+  Description: Callback function invoked when the non-blocking temperature
+               and humidity read completes.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Posts the reporting task.
+17-OCT-2026    agent       Keeps the values in fixed point.
+17-OCT-2026    agent       Given the values in fixed point, so that no
+                           floating point is needed.
+****************************************************************************/
+static void HDC1080Callback(unsigned char bSuccess, short sTemperature, unsigned short usHumidity)
+{
+   if (bSuccess)
+      {
+      sLocalHDC1080_Temperature = sTemperature;
+      usLocalHDC1080_Humidity   = usHumidity;
+      }
+
+   SCHEDULER_Post(SCHEDULER_PRIORITY_LOW, ReportingTask, bSuccess);
+}
+
+
 /****************************************************************************
      Function: PPD42NJNotificationCallback
      Engineer: Martin Hannon
         Input: N/A
        Output: N/A
   Description: Callback function invoked when MAXIMUM_HISTORY_IN_SECONDS of
-               data is available from the PPD42NJ device.
+               data is available from the PPD42NJ device. This is the sensing
+               task, run from the scheduler by the PPD42NJ module. Captures
+               the data and starts reading the HDC1080.
 Date           Initials    Description
 13-DEC-2016    MH          Initial
+17-OCT-2026    agent       Posts the sensing task.
+17-OCT-2026    agent       Runs in thread context, so does the sensing
+                           itself.
+17-OCT-2026    agent       Takes the particle concentration estimate.
+17-OCT-2026    agent       Takes the first sensor's totals.
+17-OCT-2026    agent       Mean low times worked out in integer maths.
+17-OCT-2026    agent       Buffered error message.
+17-OCT-2026    agent       Takes the low times over the last hour from the
+                           aggregates.
 ****************************************************************************/
 void PPD42NJNotificationCallback(void)
 {
-   unsigned char i;
-   TyAirQualityMeasurements tyAirQualityMeasurements;
+   const TyAirQualityMeasurements *ptyAirQualityMeasurements;
+
+   // Use the snapshot that has just been published rather than copying it...
+   ptyAirQualityMeasurements = PPD42NJ_GetAirQualityMeasurementsSnapshot();
+
+   // Take the totals over the whole history and divide by
+   // MAXIMUM_HISTORY_IN_SECONDS to get a PER second value....
+   ulLocalPPD42NJ_P1LowTime = ptyAirQualityMeasurements->pulTotals[PPD42NJ_P1_CHANNEL(0)] / MAXIMUM_HISTORY_IN_SECONDS;
+   ulLocalPPD42NJ_P2LowTime = ptyAirQualityMeasurements->pulTotals[PPD42NJ_P2_CHANNEL(0)] / MAXIMUM_HISTORY_IN_SECONDS;
 
-   dLocalPPD42NJ_P1Accumulative = 0;
-   dLocalPPD42NJ_P2Accumulative = 0;
+   // And over the last hour, from the last completed quarter hours....
+   if (AGGREGATE_GetMean(PPD42NJ_P1_CHANNEL(0), AGGREGATE_QUARTER_HOUR, AGGREGATE_QUARTER_HOURS, &ulLocalPPD42NJ_P1HourLowTime) == FALSE)
+      ulLocalPPD42NJ_P1HourLowTime = 0;
+   if (AGGREGATE_GetMean(PPD42NJ_P2_CHANNEL(0), AGGREGATE_QUARTER_HOUR, AGGREGATE_QUARTER_HOURS, &ulLocalPPD42NJ_P2HourLowTime) == FALSE)
+      ulLocalPPD42NJ_P2HourLowTime = 0;
 
-   if (PPD42NJ_GetAirQualityMeasurements(&tyAirQualityMeasurements) == TRUE)
+   ulLocalPPD42NJ_TimeStamp = ptyAirQualityMeasurements->ulSecondsElapsed;
+
+   // Take the particle concentration estimate....
+   tyLocalPPD42NJ_Concentration = ptyAirQualityMeasurements->tyConcentration;
+
+   // Start reading the temperature and humidity from the HDC1080. The
+   // report is posted when the read completes...
+   if (HDC1080_ReadTemperatureAndHumidityAsync(HDC1080Callback) == FALSE)
       {
-      for (i=0; i < MAXIMUM_HISTORY_IN_SECONDS; i++)
-         {
-         dLocalPPD42NJ_P1Accumulative += tyAirQualityMeasurements.pulP1Times[i];
-         dLocalPPD42NJ_P2Accumulative += tyAirQualityMeasurements.pulP2Times[i];
-         }
+      UARTTX_WriteString("\n\rFailed to start reading the HDC1080\n\r");
+      SCHEDULER_Stop();
+      }
+}
 
-      // Divide by MAXIMUM_HISTORY_IN_SECONDS to get a PER second value....
-      dLocalPPD42NJ_P1Accumulative /= MAXIMUM_HISTORY_IN_SECONDS;
-      dLocalPPD42NJ_P2Accumulative /= MAXIMUM_HISTORY_IN_SECONDS;
 
-      ulLocalPPD42NJ_TimeStamp = tyAirQualityMeasurements.ulSecondsElapsed;
+/****************************************************************************
+     Function: LedOutputTask
+     Engineer: agent
+        Input: unsigned long ulParameter: Not used.
+       Output: N/A
+  Description: Scheduler task which updates the LED animations.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Buffered error message.
+****************************************************************************/
+static void LedOutputTask(unsigned long ulParameter)
+{
+   LEDANIM_Update();
 
-      bLocalPPD42NJ_DataAvailable = TRUE;
+   if (LEDANIM_GetCommitFailures() != 0)
+      {
+      UARTTX_WriteString("\n\rFailed to set LED intensity level\n\r");
+      SCHEDULER_Stop();
       }
+}
 
+
+/****************************************************************************
+     Function: LedTimerCallback
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Timer callback invoked every LEDANIM_TICK_PERIOD. Posts the
+               LED output task. If the queue is full the update is skipped,
+               which does no harm as the animations catch up with the
+               actual time.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void LedTimerCallback(void)
+{
+   SCHEDULER_Post(SCHEDULER_PRIORITY_NORMAL, LedOutputTask, 0);
 }
 
 
@@ -108,62 +319,96 @@ void PPD42NJNotificationCallback(void)
   Description: Min firmware function.
 Date           Initials    Description
 05-DEC-2016    MH          Initial
+17-OCT-2026    agent       The LED and HDC1080 I2C accesses in the main loop
+                           are now non-blocking, so that they overlap.
+17-OCT-2026    agent       Start the millisecond time base.
+17-OCT-2026    agent       The LEDs are driven by the animation engine, so
+                           the main loop no longer blocks.
+17-OCT-2026    agent       Sleep between events and report the idle time.
+17-OCT-2026    agent       The main loop is replaced by the event scheduler.
+17-OCT-2026    agent       Start the telemetry. The messages are written
+                           without formatting.
+17-OCT-2026    agent       Start the buffered UART transmit.
+17-OCT-2026    agent       Start the optional profiling.
+17-OCT-2026    agent       UARTTX configures the UART and writes the startup
+                           messages in place of InitTerm and Message.
+17-OCT-2026    agent       Start the flash log, and write what it holds in
+                           RAM when the tasks stop.
+17-OCT-2026    agent       Carry on if the flash log does not start.
+17-OCT-2026    agent       Banks 0 to 2 run the stepped ramp again.
 ****************************************************************************/
 void main(void)
 {
-   unsigned char i, ucIntensity;
-   double dTemperature, dHumidity, dPPD42NJ_P1Accumulative, dPPD42NJ_P2Accumulative;
-
    // Global variable initialisation....
-   dLocalPPD42NJ_P1Accumulative = 0.0;
-   dLocalPPD42NJ_P2Accumulative = 0.0;
-   bLocalPPD42NJ_DataAvailable  = FALSE;
-
-   // Function variable initialisation....
-   dPPD42NJ_P1Accumulative = 0.0;
-   dPPD42NJ_P2Accumulative = 0.0;
+   ulLocalPPD42NJ_P1LowTime  = 0;
+   ulLocalPPD42NJ_P2LowTime  = 0;
+   ulLocalPPD42NJ_TimeStamp  = 0;
+   sLocalHDC1080_Temperature = 0;
+   usLocalHDC1080_Humidity   = 0;
+   ulLocalFlashLogFailures   = 0;
 
    // Initialize board configurations...
    BoardInit();
+
+   // Start the millisecond time base...
+   TIMER_Initialise();
+
+   // Initialise the event scheduler before anything can post to it...
+   SCHEDULER_Initialise();
    //
    // Pinmuxing...
    PinMuxConfig();
 
    // Configure the UART...
-   InitTerm();
+   UARTTX_Configure();
 
-   UART_PRINT("Firmware Startup.\n\r\n\r");
+   // Buffer the output from the tasks. Nothing is buffered until the tasks
+   // run, so the startup messages can still be written directly....
+   UARTTX_Initialise(UARTTX_DROP_NEWEST);
+   TELEMETRY_Initialise();
+
+   // Only does anything if the build defines PROFILE_ENABLED....
+   PROFILE_INITIALISE();
+
+   UARTTX_WriteDirect("Firmware Startup.\n\r\n\r");
 
    // I2C Init...
    I2C_IF_Open(I2C_MASTER_MODE_FST);
 
+   // Initialise the I2C transaction queue...
+   if (I2CQUEUE_Initialise() != TRUE)
+      {
+      UARTTX_WriteDirect("Failed to initialise the I2C queue\n\r");
+      return;
+      }
+
    // Initialise the HDC1080 device...
    if (HDC1080_Initialise() != TRUE)
       {
-	   UART_PRINT("Failed to initialise the HDC1080 device\n\r");
+	   UARTTX_WriteDirect("Failed to initialise the HDC1080 device\n\r");
       return;
       }
-   UART_PRINT("HDC1080 Device Initialised.\n\r");
+   UARTTX_WriteDirect("HDC1080 Device Initialised.\n\r");
 
    // Initialise the PPD42NJ device...
    if (PPD42NJ_Initialise() != TRUE)
       {
-	   UART_PRINT("Failed to initialise the PPD42NJ device\n\r");
+	   UARTTX_WriteDirect("Failed to initialise the PPD42NJ device\n\r");
       return;
       }
    // Configure the max history callback...
    if (PPD42NJ_SetupNotifications(NOTIFICATION_MAX_HISTORY_UPDATE, PPD42NJNotificationCallback) != TRUE)
       {
-	   UART_PRINT("Failed to initialise the PPD42NJ callback\n\r");
+	   UARTTX_WriteDirect("Failed to initialise the PPD42NJ callback\n\r");
       return;
       }
 
-   UART_PRINT("PPD42NJ Device Initialised.\n\r");
+   UARTTX_WriteDirect("PPD42NJ Device Initialised.\n\r");
 
    // Initialise the TLC59116 device...
    if (TLC59116_Initialise() != TRUE)
       {
-	   UART_PRINT("Failed to initialise the TLC59116 device\n\r");
+	   UARTTX_WriteDirect("Failed to initialise the TLC59116 device\n\r");
       return;
       }
 
@@ -173,111 +418,63 @@ void main(void)
        (TLC59116_LedBankBlinkControl(LED_BANK_2, FALSE) == FALSE) ||
        (TLC59116_LedBankBlinkControl(LED_BANK_3,  TRUE) == FALSE))
       {
-	   UART_PRINT("Failed to set the LED blink control.\n\r");
+	   UARTTX_WriteDirect("Failed to set the LED blink control.\n\r");
       return;
       }
 
    // Set the LED intensity for Bank 3 (Blue + Green + Red)....
-   if ((TLC59116_LedColourIntensity(LED_BANK_3, LED_BLUE , LED_50 ) == FALSE) ||
-       (TLC59116_LedColourIntensity(LED_BANK_3, LED_GREEN, LED_50) == FALSE) ||
-       (TLC59116_LedColourIntensity(LED_BANK_3, LED_RED  , LED_50  ) == FALSE))
+   if (TLC59116_LedBankIntensity(LED_BANK_3, LED_50, LED_50, LED_50) == FALSE)
+      {
+	   UARTTX_WriteDirect("\n\rFailed to set intensity level for Bank 3\n\r");
+      return;
+      }
+
+   // Write the changes to the device...
+   if (TLC59116_Commit() == FALSE)
       {
-	   UART_PRINT("\n\rFailed to set intensity level for Bank 3\n\r");
+      UARTTX_WriteDirect("\n\rFailed to write the TLC59116 registers\n\r");
       return;
       }
 
-   UART_PRINT("TLC59116 Device Initialised.\n\r");
-
-	while(1)
-	   {
-      for (i=0; i <= 10; i++)
-         {
-         switch (i)
-            {
-            case 0:
-               ucIntensity = LED_0;
-            break;
-            case 1:
-               ucIntensity = LED_10;
-            break;
-            case 2:
-               ucIntensity = LED_20;
-            break;
-            case 3:
-               ucIntensity = LED_30;
-            break;
-            case 4:
-               ucIntensity = LED_40;
-            break;
-            case 5:
-               ucIntensity = LED_50;
-            break;
-            case 6:
-               ucIntensity = LED_60;
-            break;
-            case 7:
-               ucIntensity = LED_70;
-            break;
-            case 8:
-               ucIntensity = LED_80;
-            break;
-            case 9:
-               ucIntensity = LED_90;
-            break;
-            case 10:
-               ucIntensity = LED_100;
-            break;
-            default:
-            break;
-            }
-
-         // Set the LED intensity for Bank 0 (Blue)....
-         if (TLC59116_LedColourIntensity(LED_BANK_0, LED_BLUE , (TyLedIntensity)ucIntensity ) == FALSE)
-            {
-	         UART_PRINT("\n\rFailed to set intensity level for Bank 0\n\r");
-            return;
-            }
-         // Set the LED intensity for Bank 1 (Green)....
-         if (TLC59116_LedColourIntensity(LED_BANK_1, LED_GREEN , (TyLedIntensity)ucIntensity ) == FALSE)
-            {
-	         UART_PRINT("\n\rFailed to set intensity level for Bank 1\n\r");
-            return;
-            }
-
-         // Set the LED intensity for Bank 2 (Red)....
-         if (TLC59116_LedColourIntensity(LED_BANK_2, LED_RED , (TyLedIntensity)ucIntensity ) == FALSE)
-            {
-	         UART_PRINT("\n\rFailed to set intensity level for Bank 2\n\r");
-            return;
-            }
-
-         TIMER_Delay(LED_INTENSITY_DELAY_STEP);
-         }
-
-      if (bLocalPPD42NJ_DataAvailable)
-         {
-         // Capture new data from the PPD42NJ...
-         dPPD42NJ_P1Accumulative = dLocalPPD42NJ_P1Accumulative;
-         dPPD42NJ_P2Accumulative = dLocalPPD42NJ_P2Accumulative;
-
-         // Read the current temperature from the HDC1080...
-         if (HDC1080_ReadTemperature(&dTemperature) == FALSE)
-            {
-	         UART_PRINT("\n\rFailed to read temperature from the HDC1080\n\r");
-            return;
-            }
-         // Read the current humidity from the HDC1080...
-         if (HDC1080_ReadHumidity(&dHumidity) == FALSE)
-            {
-	         UART_PRINT("\n\rFailed to read humidity from the HDC1080\n\r");
-            return;
-            }
-
-	      UART_PRINT("Temperature %.2f Humidity %.2f P1_Total %.2f P2_Total %.2f, Timestamp %ld", dTemperature, dHumidity, dPPD42NJ_P1Accumulative, dPPD42NJ_P2Accumulative, ulLocalPPD42NJ_TimeStamp);
-
-         bLocalPPD42NJ_DataAvailable = FALSE;
-         }
-	   }
+   UARTTX_WriteDirect("TLC59116 Device Initialised.\n\r");
+
+   // Recover the flash log. It is only a backup of the console output, so
+   // carry on without it (it tries again when it next writes)....
+   if (FLASHLOG_Initialise() != TRUE)
+      {
+      ulLocalFlashLogFailures++;
+      UARTTX_WriteDirect("Failed to initialise the flash log\n\r");
+      }
+   else
+      {
+      UARTTX_WriteDirect("Flash Log Initialised.\n\r");
+      }
+
+   // Start the LED ramps for Banks 0 to 2....
+   if ((LEDANIM_Initialise() == FALSE) ||
+       (LEDANIM_Start(LED_BANK_0, &tyLocalBlueRampAnimation)  == FALSE) ||
+       (LEDANIM_Start(LED_BANK_1, &tyLocalGreenRampAnimation) == FALSE) ||
+       (LEDANIM_Start(LED_BANK_2, &tyLocalRedRampAnimation)   == FALSE))
+      {
+      UARTTX_WriteDirect("Failed to start the LED animations\n\r");
+      return;
+      }
+
+   // Update the LEDs every LEDANIM_TICK_PERIOD....
+   if (TIMER_Start(&tyLocalLedTimer, LEDANIM_TICK_PERIOD, LEDANIM_TICK_PERIOD, LedTimerCallback) == FALSE)
+      {
+      UARTTX_WriteDirect("Failed to start the LED timer\n\r");
+      return;
+      }
+
+   // Run the tasks. This only returns if a task fails....
+   SCHEDULER_Run();
+
+   // Write the samples still held in RAM....
+   FLASHLOG_Close();
+
+   // Let the buffered output drain....
+   UARTTX_WaitForIdle();
 }
 
 
@@ -4,6 +4,7 @@
   Description: Contains PinMuxConfig routine for configuring the processor.
 Date           Initials    Description
 07-DEC-2016    MH          Initial
+17-OCT-2026    agent       Peripheral clocks are left running in sleep mode.
 ****************************************************************************/
 #include "pinmux.h"
 #include "hw_types.h"
@@ -28,16 +29,18 @@ void PinMuxConfig(void)
     PinModeSet(PIN_50, PIN_MODE_0);
     
     //
-    // Enable Peripheral Clocks 
-    //
-    PRCMPeripheralClkEnable(PRCM_TIMERA0, PRCM_RUN_MODE_CLK);
-    PRCMPeripheralClkEnable(PRCM_TIMERA1, PRCM_RUN_MODE_CLK);
-    PRCMPeripheralClkEnable(PRCM_GPIOA0, PRCM_RUN_MODE_CLK);
-    PRCMPeripheralClkEnable(PRCM_GPIOA1, PRCM_RUN_MODE_CLK);
-    PRCMPeripheralClkEnable(PRCM_GPIOA2, PRCM_RUN_MODE_CLK);
-    PRCMPeripheralClkEnable(PRCM_UARTA0, PRCM_RUN_MODE_CLK);
-    PRCMPeripheralClkEnable(PRCM_UARTA1, PRCM_RUN_MODE_CLK);
-    PRCMPeripheralClkEnable(PRCM_I2CA0, PRCM_RUN_MODE_CLK);
+    // Enable Peripheral Clocks. These are also enabled in sleep mode, so
+    // that the peripherals carry on running (and can wake the processor)
+    // in TIMER_Sleep.
+    //
+    PRCMPeripheralClkEnable(PRCM_TIMERA0, PRCM_RUN_MODE_CLK | PRCM_SLP_MODE_CLK);
+    PRCMPeripheralClkEnable(PRCM_TIMERA1, PRCM_RUN_MODE_CLK | PRCM_SLP_MODE_CLK);
+    PRCMPeripheralClkEnable(PRCM_GPIOA0, PRCM_RUN_MODE_CLK | PRCM_SLP_MODE_CLK);
+    PRCMPeripheralClkEnable(PRCM_GPIOA1, PRCM_RUN_MODE_CLK | PRCM_SLP_MODE_CLK);
+    PRCMPeripheralClkEnable(PRCM_GPIOA2, PRCM_RUN_MODE_CLK | PRCM_SLP_MODE_CLK);
+    PRCMPeripheralClkEnable(PRCM_UARTA0, PRCM_RUN_MODE_CLK | PRCM_SLP_MODE_CLK);
+    PRCMPeripheralClkEnable(PRCM_UARTA1, PRCM_RUN_MODE_CLK | PRCM_SLP_MODE_CLK);
+    PRCMPeripheralClkEnable(PRCM_I2CA0, PRCM_RUN_MODE_CLK | PRCM_SLP_MODE_CLK);
 
     //
     // Configure PIN_03 for GPIO input
@@ -0,0 +1,581 @@
+/****************************************************************************
+       Module: SIM.c
+     Engineer: agent
+  Description: Contains the virtual clock and interrupt controller for the
+               host simulation of the board.
+
+               The clock counts 80 MHz processor cycles. The firmware code
+               runs in no virtual time; the clock only moves on when the
+               firmware polls a register (SIM_Advance), takes an interrupt
+               or sleeps (SIM_Sleep), in which case it jumps straight to the
+               next event. Hours of operation therefore take seconds.
+
+               The simulated peripherals queue events at the virtual time
+               that something happens (a timer period ends, a byte has been
+               sent, an input changes, etc.), and raise their interrupts
+               from them. An interrupt is taken as soon as the firmware has
+               interrupts enabled and is not already in a handler, in
+               interrupt number order. Handlers do not nest.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added the handler run times, the count of each
+                           interrupt and the host time of chosen ones.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include "includes.h"
+#include "SIM.h"
+
+static TySimTime ullLocalNow;
+static TySimEvent *ptyLocalEvents;
+
+static TySimInterruptHandler ptyLocalHandlers[SIM_INTERRUPT_COUNT];
+static unsigned char pbLocalEnabled[SIM_INTERRUPT_COUNT];
+static unsigned char pbLocalPending[SIM_INTERRUPT_COUNT];
+static unsigned char pbLocalLineAsserted[SIM_INTERRUPT_COUNT];
+static unsigned long pulLocalHandlerCycles[SIM_INTERRUPT_COUNT];
+static unsigned char pbLocalMeasured[SIM_INTERRUPT_COUNT];
+
+static unsigned char bLocalInterruptsDisabled;
+static unsigned char bLocalInInterrupt;
+
+static TySimStatistics tyLocalStatistics;
+
+
+/****************************************************************************
+     Function: SIM_CheckInterrupt
+     Engineer: agent
+        Input: unsigned long ulInterrupt: Interrupt number.
+       Output: N/A
+  Description: Stops the simulation if the interrupt number is out of range.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIM_CheckInterrupt(unsigned long ulInterrupt)
+{
+   if (ulInterrupt >= SIM_INTERRUPT_COUNT)
+      SIM_Fatal("interrupt %lu is not simulated", ulInterrupt);
+}
+
+
+/****************************************************************************
+     Function: SIM_ProcessEvents
+     Engineer: agent
+        Input: TySimTime ullUntil: Virtual time to move on to.
+       Output: N/A
+  Description: Moves the clock on, handling each event that falls due on
+               the way at its own time.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIM_ProcessEvents(TySimTime ullUntil)
+{
+   TySimEvent *ptyEvent;
+
+   while ((ptyLocalEvents != NULL) && (ptyLocalEvents->ullTime <= ullUntil))
+      {
+      ptyEvent = ptyLocalEvents;
+      ptyLocalEvents = ptyEvent->ptyNext;
+
+      ptyEvent->ptyNext = NULL;
+      ptyEvent->bQueued = FALSE;
+
+      if (ptyEvent->ullTime > ullLocalNow)
+         ullLocalNow = ptyEvent->ullTime;
+
+      ptyEvent->tyHandler(ptyEvent);
+      }
+
+   if (ullUntil > ullLocalNow)
+      ullLocalNow = ullUntil;
+}
+
+
+/****************************************************************************
+     Function: SIM_NextInterrupt
+     Engineer: agent
+        Input: N/A
+       Output: long: Interrupt number, or -1 if none.
+  Description: Returns the pending, enabled interrupt with the lowest number
+               (the highest priority, as all are at the same level).
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static long SIM_NextInterrupt(void)
+{
+   long i;
+
+   for (i=0; i < SIM_INTERRUPT_COUNT; i++)
+      {
+      if (pbLocalPending[i] && pbLocalEnabled[i] && (ptyLocalHandlers[i] != NULL))
+         return i;
+      }
+
+   return -1;
+}
+
+
+/****************************************************************************
+     Function: SIM_Dispatch
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Runs the handlers of the pending interrupts, if interrupts
+               are enabled and a handler is not already running. As in the
+               NVIC, an interrupt whose line is still asserted when the
+               handler returns is pending again.
+
+               The handler sees the peripherals as they are when it is
+               entered, and the clock then moves on by its run time. Edges
+               and other events during that time are only seen by the next
+               run of the handler.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Takes the run time set for the handler, and
+                           measures the host time of the chosen handlers.
+****************************************************************************/
+static void SIM_Dispatch(void)
+{
+   long lInterrupt;
+   struct timespec tyStart, tyEnd;
+
+   if (bLocalInterruptsDisabled || bLocalInInterrupt)
+      return;
+
+   while ((lInterrupt = SIM_NextInterrupt()) >= 0)
+      {
+      pbLocalPending[lInterrupt] = FALSE;
+
+      bLocalInInterrupt = TRUE;
+      tyLocalStatistics.ulInterrupts++;
+      tyLocalStatistics.pulInterruptCounts[lInterrupt]++;
+
+      if (pbLocalMeasured[lInterrupt])
+         {
+         clock_gettime(CLOCK_MONOTONIC, &tyStart);
+         ptyLocalHandlers[lInterrupt]();
+         clock_gettime(CLOCK_MONOTONIC, &tyEnd);
+
+         tyLocalStatistics.pullInterruptNanoseconds[lInterrupt] += ((tyEnd.tv_sec - tyStart.tv_sec) * 1000000000ll) + (tyEnd.tv_nsec - tyStart.tv_nsec);
+         }
+      else
+         {
+         ptyLocalHandlers[lInterrupt]();
+         }
+
+      SIM_ProcessEvents(ullLocalNow + pulLocalHandlerCycles[lInterrupt]);
+      bLocalInInterrupt = FALSE;
+
+      if (pbLocalLineAsserted[lInterrupt])
+         pbLocalPending[lInterrupt] = TRUE;
+
+      // The handler may have disabled interrupts and not enabled them
+      // again (a firmware bug, but not one to hide)....
+      if (bLocalInterruptsDisabled)
+         break;
+      }
+}
+
+
+/****************************************************************************
+     Function: SIM_Initialise
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Initialises the clock and interrupt controller. Interrupts
+               start disabled, as after a reset the firmware enables them in
+               BoardInit.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Resets the handler run times and the counts, so
+                           that a program can make several runs.
+****************************************************************************/
+void SIM_Initialise(void)
+{
+   unsigned long i;
+
+   ullLocalNow    = 0;
+   ptyLocalEvents = NULL;
+
+   for (i=0; i < SIM_INTERRUPT_COUNT; i++)
+      {
+      ptyLocalHandlers[i]    = NULL;
+      pbLocalEnabled[i]      = FALSE;
+      pbLocalPending[i]      = FALSE;
+      pbLocalLineAsserted[i] = FALSE;
+      pulLocalHandlerCycles[i] = SIM_INTERRUPT_CYCLES;
+      pbLocalMeasured[i]       = FALSE;
+      }
+
+   bLocalInterruptsDisabled = TRUE;
+   bLocalInInterrupt        = FALSE;
+
+   memset(&tyLocalStatistics, 0, sizeof(tyLocalStatistics));
+}
+
+
+/****************************************************************************
+     Function: SIM_GetTime
+     Engineer: agent
+        Input: N/A
+       Output: TySimTime: Virtual time in processor cycles.
+  Description: Returns the virtual time.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+TySimTime SIM_GetTime(void)
+{
+   return ullLocalNow;
+}
+
+
+/****************************************************************************
+     Function: SIM_Schedule
+     Engineer: agent
+        Input: TySimEvent *ptyEvent: Event to queue.
+               TySimTime ullTime: Virtual time of the event.
+               TySimEventHandler tyHandler: Function to call at that time.
+       Output: N/A
+  Description: Queues an event, in time order. If the event is already
+               queued it is moved. Events due at the same time are handled
+               in the order they were queued.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIM_Schedule(TySimEvent *ptyEvent, TySimTime ullTime, TySimEventHandler tyHandler)
+{
+   TySimEvent **pptyLink;
+
+   if (ptyEvent->bQueued)
+      SIM_Cancel(ptyEvent);
+
+   if (ullTime < ullLocalNow)
+      ullTime = ullLocalNow;
+
+   ptyEvent->ullTime   = ullTime;
+   ptyEvent->tyHandler = tyHandler;
+   ptyEvent->bQueued   = TRUE;
+
+   pptyLink = &ptyLocalEvents;
+   while ((*pptyLink != NULL) && ((*pptyLink)->ullTime <= ullTime))
+      {
+      pptyLink = &(*pptyLink)->ptyNext;
+      }
+
+   ptyEvent->ptyNext = *pptyLink;
+   *pptyLink = ptyEvent;
+}
+
+
+/****************************************************************************
+     Function: SIM_Cancel
+     Engineer: agent
+        Input: TySimEvent *ptyEvent: Event to remove.
+       Output: N/A
+  Description: Removes an event from the queue, if it is queued.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIM_Cancel(TySimEvent *ptyEvent)
+{
+   TySimEvent **pptyLink;
+
+   pptyLink = &ptyLocalEvents;
+   while (*pptyLink != NULL)
+      {
+      if (*pptyLink == ptyEvent)
+         {
+         *pptyLink = ptyEvent->ptyNext;
+         break;
+         }
+      pptyLink = &(*pptyLink)->ptyNext;
+      }
+
+   ptyEvent->ptyNext = NULL;
+   ptyEvent->bQueued = FALSE;
+}
+
+
+/****************************************************************************
+     Function: SIM_Advance
+     Engineer: agent
+        Input: unsigned long ulCycles: Number of cycles.
+       Output: N/A
+  Description: Moves the clock on by the time the firmware has spent, e.g.
+               polling a register, and takes any interrupts that are now
+               pending.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIM_Advance(unsigned long ulCycles)
+{
+   SIM_ProcessEvents(ullLocalNow + ulCycles);
+
+   SIM_Dispatch();
+}
+
+
+/****************************************************************************
+     Function: SIM_Sleep
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Sleeps until an enabled interrupt is pending. As with the
+               WFI instruction this wakes whether or not interrupts are
+               disabled; the interrupt is only taken once they are enabled.
+               Each event is jumped to in turn, so a long sleep takes very
+               little real time.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIM_Sleep(void)
+{
+   TySimTime ullStart;
+
+   ullStart = ullLocalNow;
+
+   while (SIM_NextInterrupt() < 0)
+      {
+      if (ptyLocalEvents == NULL)
+         SIM_Fatal("the firmware is asleep with nothing to wake it");
+
+      SIM_ProcessEvents(ptyLocalEvents->ullTime);
+      }
+
+   tyLocalStatistics.ullSleepCycles += ullLocalNow - ullStart;
+
+   SIM_Dispatch();
+}
+
+
+/****************************************************************************
+     Function: SIM_RegisterInterrupt
+     Engineer: agent
+        Input: unsigned long ulInterrupt: Interrupt number.
+               TySimInterruptHandler tyHandler: Handler.
+       Output: N/A
+  Description: Registers the handler for an interrupt and enables it, as
+               the driverlib IntRegister functions do.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIM_RegisterInterrupt(unsigned long ulInterrupt, TySimInterruptHandler tyHandler)
+{
+   SIM_CheckInterrupt(ulInterrupt);
+
+   ptyLocalHandlers[ulInterrupt] = tyHandler;
+   pbLocalEnabled[ulInterrupt]   = TRUE;
+
+   SIM_Dispatch();
+}
+
+
+/****************************************************************************
+     Function: SIM_SetHandlerCycles
+     Engineer: agent
+        Input: unsigned long ulInterrupt: Interrupt number.
+               unsigned long ulCycles: Run time of the handler, including
+                  the entry and exit.
+       Output: N/A
+  Description: Sets how long the handler of an interrupt takes on the
+               target. The firmware code takes no virtual time, so this is
+               what limits how quickly the interrupt can be serviced.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIM_SetHandlerCycles(unsigned long ulInterrupt, unsigned long ulCycles)
+{
+   SIM_CheckInterrupt(ulInterrupt);
+
+   pulLocalHandlerCycles[ulInterrupt] = ulCycles;
+}
+
+
+/****************************************************************************
+     Function: SIM_MeasureInterrupt
+     Engineer: agent
+        Input: unsigned long ulInterrupt: Interrupt number.
+       Output: N/A
+  Description: Measures the host time taken by the handler of an interrupt,
+               for the statistics. Only chosen handlers are measured, as
+               reading the host clock costs more than most handlers.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIM_MeasureInterrupt(unsigned long ulInterrupt)
+{
+   SIM_CheckInterrupt(ulInterrupt);
+
+   pbLocalMeasured[ulInterrupt] = TRUE;
+}
+
+
+/****************************************************************************
+     Function: SIM_EnableInterrupt
+     Engineer: agent
+        Input: unsigned long ulInterrupt: Interrupt number.
+       Output: N/A
+  Description: Enables an interrupt in the interrupt controller.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIM_EnableInterrupt(unsigned long ulInterrupt)
+{
+   SIM_CheckInterrupt(ulInterrupt);
+
+   pbLocalEnabled[ulInterrupt] = TRUE;
+
+   SIM_Dispatch();
+}
+
+
+/****************************************************************************
+     Function: SIM_SetPending
+     Engineer: agent
+        Input: unsigned long ulInterrupt: Interrupt number.
+       Output: N/A
+  Description: Makes an interrupt pending, e.g. for an edge or the SysTick
+               count reaching zero.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIM_SetPending(unsigned long ulInterrupt)
+{
+   SIM_CheckInterrupt(ulInterrupt);
+
+   pbLocalPending[ulInterrupt] = TRUE;
+}
+
+
+/****************************************************************************
+     Function: SIM_IsPending
+     Engineer: agent
+        Input: unsigned long ulInterrupt: Interrupt number.
+       Output: TRUE: Pending, FALSE: Not pending.
+  Description: Reports whether an interrupt is pending.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char SIM_IsPending(unsigned long ulInterrupt)
+{
+   SIM_CheckInterrupt(ulInterrupt);
+
+   return pbLocalPending[ulInterrupt];
+}
+
+
+/****************************************************************************
+     Function: SIM_SetInterruptLine
+     Engineer: agent
+        Input: unsigned long ulInterrupt: Interrupt number.
+               unsigned char bAsserted: TRUE if the peripheral is requesting
+                  the interrupt.
+       Output: N/A
+  Description: Sets the level of a peripheral's interrupt line, which the
+               peripheral works out from its status and mask. Asserting the
+               line makes the interrupt pending. As in the NVIC, clearing
+               the line does not clear a pending interrupt.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIM_SetInterruptLine(unsigned long ulInterrupt, unsigned char bAsserted)
+{
+   SIM_CheckInterrupt(ulInterrupt);
+
+   pbLocalLineAsserted[ulInterrupt] = bAsserted;
+
+   if (bAsserted)
+      pbLocalPending[ulInterrupt] = TRUE;
+}
+
+
+/****************************************************************************
+     Function: SIM_MasterDisable
+     Engineer: agent
+        Input: N/A
+       Output: TRUE: Interrupts were already disabled, FALSE: They were
+                  enabled.
+  Description: Disables interrupts, as IntMasterDisable.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char SIM_MasterDisable(void)
+{
+   unsigned char bWasDisabled;
+
+   bWasDisabled = bLocalInterruptsDisabled;
+   bLocalInterruptsDisabled = TRUE;
+
+   return bWasDisabled;
+}
+
+
+/****************************************************************************
+     Function: SIM_MasterEnable
+     Engineer: agent
+        Input: N/A
+       Output: TRUE: Interrupts were disabled, FALSE: They were already
+                  enabled.
+  Description: Enables interrupts, as IntMasterEnable, and takes any that
+               are pending.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char SIM_MasterEnable(void)
+{
+   unsigned char bWasDisabled;
+
+   bWasDisabled = bLocalInterruptsDisabled;
+   bLocalInterruptsDisabled = FALSE;
+
+   SIM_Dispatch();
+
+   return bWasDisabled;
+}
+
+
+/****************************************************************************
+     Function: SIM_GetStatistics
+     Engineer: agent
+        Input: N/A
+       Output: TySimStatistics *: Counts for the run.
+  Description: Returns the counts kept by the simulation, for the simulated
+               peripherals and devices to update and for the summary at the
+               end of the run.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+TySimStatistics *SIM_GetStatistics(void)
+{
+   return &tyLocalStatistics;
+}
+
+
+/****************************************************************************
+     Function: SIM_Fatal
+     Engineer: agent
+        Input: const char *pcFormat: printf style message.
+       Output: N/A
+  Description: Reports something the simulation cannot carry on from (the
+               firmware using hardware which is not simulated, or hanging)
+               and exits.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIM_Fatal(const char *pcFormat, ...)
+{
+   va_list tyArguments;
+
+   fprintf(stderr, "sim: %.6f s: ", (double)ullLocalNow / SIM_CLOCK_HZ);
+
+   va_start(tyArguments, pcFormat);
+   vfprintf(stderr, pcFormat, tyArguments);
+   va_end(tyArguments);
+
+   fprintf(stderr, "\n");
+
+   exit(2);
+}
@@ -0,0 +1,192 @@
+/****************************************************************************
+       Module: SIM.h
+     Engineer: agent
+  Description: Contains the types and function prototypes for the host
+               simulation of the board: the virtual clock, the interrupt
+               controller and the simulated peripherals and devices.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added the pulse trains and the counts and host
+                           time of each interrupt.
+17-OCT-2026    agent       Added SIMHAL_ConsoleInput.
+17-OCT-2026    agent       Added the serial flash.
+17-OCT-2026    agent       Added the HDC1080 noise setting and
+                           SIMDEVICES_SetClimate.
+17-OCT-2026    agent       Added the TLC59116 byte count and
+                           SIMDEVICES_GetTLC59116Register.
+17-OCT-2026    agent       Added the missed edge counts, the truncation of
+                           the pulses and SIMPULSES_GetSecondTruncated.
+17-OCT-2026    agent       Added the network processor starts and on time.
+17-OCT-2026    agent       SIMFLASH_TearNextWrite is now SIMFLASH_TearWrite.
+****************************************************************************/
+
+// The virtual clock counts processor cycles at the 80 MHz system clock....
+#define SIM_CLOCK_HZ              80000000ull
+#define SIM_CYCLES_PER_MS         (SIM_CLOCK_HZ / 1000ull)
+
+// Time taken by a register read that the firmware polls (e.g. in a busy
+// wait), and by an interrupt handler unless set by SIM_SetHandlerCycles.
+// The firmware code itself runs in no virtual time.
+#define SIM_POLL_CYCLES           20
+#define SIM_INTERRUPT_CYCLES      24
+
+// Highest interrupt number handled (INT_UDMA is the highest used)....
+#define SIM_INTERRUPT_COUNT       64
+
+typedef unsigned long long TySimTime;
+
+typedef struct TySimEvent TySimEvent;
+
+typedef void (*TySimEventHandler)(TySimEvent *ptyEvent);
+typedef void (*TySimInterruptHandler)(void);
+
+// An event which occurs at a set virtual time. The storage is owned by the
+// caller, and an event is only ever queued once.
+struct TySimEvent
+{
+   TySimTime ullTime;
+   TySimEventHandler tyHandler;
+   void *pvContext;                  // For use by the owner.
+   unsigned char bQueued;
+   TySimEvent *ptyNext;
+};
+
+// An I2C device on the simulated bus. Start returns TRUE if the device
+// acknowledges its address and Write TRUE if it acknowledges the byte.
+typedef struct
+{
+   unsigned char ucAddress;
+   unsigned char (*Start)(unsigned char bRead);
+   unsigned char (*Write)(unsigned char ucData);
+   unsigned char (*Read)(void);
+   void (*Stop)(void);
+} TySimI2CDevice;
+
+// Settings for the simulated devices, from the command line....
+typedef struct
+{
+   unsigned long ulSeed;
+   double dP1Occupancy;              // Fraction of the time P1 is low.
+   double dP2Occupancy;              // Fraction of the time P2 is low.
+   double dTemperature;              // Degrees C.
+   double dHumidity;                 // %
+   unsigned char bNoise;             // TRUE for noise on the HDC1080 measurements.
+} TySimSettings;
+
+// PPD42NJ outputs, and the seconds of the pulse record that are kept....
+#define SIM_PULSES_CHANNELS       2
+#define SIM_PULSES_SECONDS        64
+
+// Pulse trains, see SIMPULSES.c....
+typedef enum
+{
+   SIM_PULSES_OCCUPANCY = 0,
+   SIM_PULSES_POISSON   = 1,
+   SIM_PULSES_FIXED     = 2,
+   SIM_PULSES_BOUNDARY  = 3,
+   SIM_PULSES_FILE      = 4
+} TySimPulseMode;
+
+typedef struct
+{
+   TySimPulseMode tyMode;
+   double dOccupancy;                // OCCUPANCY: fraction of the time low.
+   double dBurstRate;                // POISSON: mean bursts per second.
+   unsigned long ulBurstPulses;      // POISSON: mean pulses per burst.
+   unsigned long ulWidth;            // Pulse width (mean for POISSON) in us.
+   unsigned long ulGap;              // Gap between pulses (mean for POISSON) in us.
+} TySimPulseSettings;
+
+// Record of the pulses driven on a channel....
+typedef struct
+{
+   unsigned long ulPulses;
+   unsigned long ulEdges;
+   TySimTime ullLowCycles;
+   TySimTime ullShortestCycles;
+   TySimTime ullTruncatedCycles;     // Lost truncating each pulse to whole us.
+} TySimPulseTruth;
+
+// Counts reported at the end of a run....
+typedef struct
+{
+   unsigned long ulInterrupts;
+   unsigned long ulI2CTransfers;
+   unsigned long ulI2CNacks;
+   unsigned long ulHDC1080Conversions;
+   unsigned long ulTLC59116Writes;
+   unsigned long ulTLC59116Bytes;    // Including the control byte of each write.
+   unsigned long ulUartBytes;
+   TySimTime ullSleepCycles;
+   TySimTime pullLowCycles[0x2];     // Time P1, P2 were held low.
+   unsigned long pulMissedEdges[0x2]; // Edges on P1, P2 with the last still pending.
+   unsigned long pulInterruptCounts[SIM_INTERRUPT_COUNT];
+   unsigned long long pullInterruptNanoseconds[SIM_INTERRUPT_COUNT]; // Host time, see SIM_MeasureInterrupt.
+} TySimStatistics;
+
+// Counts of the serial flash file system commands, see SIMFLASH.c....
+typedef struct
+{
+   unsigned long ulCommands;
+   unsigned long ulOpens;
+   unsigned long ulReads;
+   unsigned long ulWrites;
+   unsigned long ulErases;           // 4 KB blocks erased.
+   unsigned long long ullBytesRead;
+   unsigned long long ullBytesWritten;
+   TySimTime ullCycles;              // Estimated target time of the commands.
+   unsigned long ulStarts;           // Network processor starts.
+   TySimTime ullOnCycles;            // Time the network processor was on.
+} TySimFlashStatistics;
+
+
+// Function prototypes from the SIM module...
+void SIM_Initialise(void);
+TySimTime SIM_GetTime(void);
+void SIM_Schedule(TySimEvent *ptyEvent, TySimTime ullTime, TySimEventHandler tyHandler);
+void SIM_Cancel(TySimEvent *ptyEvent);
+void SIM_Advance(unsigned long ulCycles);
+void SIM_Sleep(void);
+void SIM_RegisterInterrupt(unsigned long ulInterrupt, TySimInterruptHandler tyHandler);
+void SIM_SetHandlerCycles(unsigned long ulInterrupt, unsigned long ulCycles);
+void SIM_MeasureInterrupt(unsigned long ulInterrupt);
+void SIM_EnableInterrupt(unsigned long ulInterrupt);
+void SIM_SetPending(unsigned long ulInterrupt);
+unsigned char SIM_IsPending(unsigned long ulInterrupt);
+void SIM_SetInterruptLine(unsigned long ulInterrupt, unsigned char bAsserted);
+unsigned char SIM_MasterDisable(void);
+unsigned char SIM_MasterEnable(void);
+TySimStatistics *SIM_GetStatistics(void);
+void SIM_Fatal(const char *pcFormat, ...);
+
+// Function prototypes from the SIMHAL module...
+void SIMHAL_Initialise(FILE *ptyUartCapture);
+unsigned char SIMHAL_DriveInput(unsigned long ulPin, unsigned char ucLevel);
+void SIMHAL_AttachI2CDevice(const TySimI2CDevice *ptyDevice);
+TySimTime SIMHAL_GetTimerStart(unsigned long ulBase, unsigned long ulTimer);
+void SIMHAL_ConsoleInput(const char *pcText);
+
+// Function prototypes from the SIMDEVICES module...
+void SIMDEVICES_Initialise(const TySimSettings *ptySettings);
+void SIMDEVICES_PrintLeds(FILE *ptyOutput);
+void SIMDEVICES_SetClimate(double dTemperature, double dHumidity);
+unsigned char SIMDEVICES_GetTLC59116Register(unsigned char ucRegister);
+
+// Function prototypes from the SIMFLASH module...
+void SIMFLASH_Initialise(const char *pcImage);
+void SIMFLASH_TearWrite(unsigned long ulBytes);
+const TySimFlashStatistics *SIMFLASH_GetStatistics(void);
+void SIMFLASH_GetWear(unsigned long *pulBlocks, unsigned long *pulLeast, unsigned long *pulMost);
+
+// Function prototypes from the SIMPULSES module...
+void SIMPULSES_Initialise(unsigned long ulSeed);
+void SIMPULSES_Stop(void);
+void SIMPULSES_SetOrigin(TySimTime ullOrigin);
+unsigned char SIMPULSES_Load(const char *pcFile);
+void SIMPULSES_Start(unsigned char ucChannel, const TySimPulseSettings *ptySettings);
+const TySimPulseTruth *SIMPULSES_GetTruth(unsigned char ucChannel);
+TySimTime SIMPULSES_GetSecond(unsigned char ucChannel, unsigned long ulSecond);
+TySimTime SIMPULSES_GetSecondTruncated(unsigned char ucChannel, unsigned long ulSecond);
+
+// The firmware's main, renamed by the build....
+void FIRMWARE_Main(void);
@@ -0,0 +1,734 @@
+/****************************************************************************
+       Module: SIMBENCH.c
+     Engineer: agent
+  Description: Contains main for the PPD42NJ benchmark. Runs the PPD42NJ
+               module on its own against the simulated board, drives P1 and
+               P2 with pulse trains (see SIMPULSES.c) and checks the low
+               pulse time measured each second against what was driven.
+
+               usage: ppdbench [-w workload] [-d seconds] [-s seed]
+                               [-c cycles | -p report] [-e error %]
+                               [-f file] [-m] [-x]
+
+               With no -w or -m, each of the synthetic workloads is run,
+               then the file (with -f), then the highest edge rate is
+               found. The workloads are:
+
+                  occupancy    P1 / P2 as the real sensor at 5 % / 1 %.
+                  poisson      Bursts of short random pulses.
+                  short        Fixed 10 us (P1) and 3 us (P2) pulses.
+                  boundary     Pulses across the end of each second, where
+                               the PPD42NJ timer wraps.
+                  file         Pulses replayed from the -f file.
+
+               -m finds the highest edge rate on its own: both channels are
+               driven with pulses, and gaps twice as long. The width is
+               halved from 1 ms until a run fails, then every width below
+               the last one that passed is run in order, down to the first
+               failure. The results are not monotonic in the width, so the
+               rate found is the one above the first failure, not a proven
+               maximum.
+
+               The firmware truncates each pulse to whole us. The part of a
+               us lost from each pulse is reported on its own (Truncated),
+               and the error is against the driven time less it. An edge
+               that arrives while the interrupt for the last one on its
+               channel is still pending is never seen by the firmware, and
+               is reported as missed. A workload passes if every second was
+               reported, no more than the -e limit of the edges were missed,
+               and the error is within the -e limit of the driven time.
+
+               The port line build times each edge when its handler runs,
+               so pulses only a few handler runs wide are measured short
+               (see PPD42NJ_PortLineInterrupt). The short workload is a
+               known failure of that build: it is reported, but only fails
+               the benchmark with -x (make bench-strict).
+
+               The interrupt handlers take no virtual time when they run
+               (the firmware is host code), so the time each one takes on
+               the target has to be given, in 80 MHz cycles. Edges during
+               that time wait for the next run, as on the target. -p takes
+               it from a profile report captured from the board's console
+               (a PROFILE_ENABLED build of the same PPD42NJ options, see
+               PROFILE.h): the mean of the PPD42NJ edge point, which the
+               DWT cycle counter measures inside the handler, plus the
+               exception entry and exit. -c sets it directly. Without
+               either a figure assumed for the port line handler is used,
+               and the report says so. The host time of each handler is
+               also reported, but it is not the target time.
+
+               Returns 1 if any workload fails, other than a known
+               failure without -x.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       The truncation and the missed edges are reported,
+                           and the pass is judged on them.
+17-OCT-2026    agent       The handler time can be taken from a profile
+                           report measured on the board (-p), and where it
+                           is assumed the report says so.
+17-OCT-2026    agent       Known failures of the build only fail the
+                           benchmark with -x.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "includes.h"
+#include "SIM.h"
+
+// Default target time of a PPD42NJ interrupt, in cycles. This is an
+// estimate of the entry, the driverlib calls and the exit, not a
+// measurement; use -p with a profile report from the board for that....
+#define BENCH_HANDLER_CYCLES      200
+
+// Cortex-M4 exception entry and exit, which the profile point inside the
+// handler does not see....
+#define BENCH_EXCEPTION_CYCLES    (12 + 10)
+
+// Name of the edge interrupt point in the profile report (see PROFILE.c)....
+#define BENCH_PROFILE_POINT       "PPD42NJ edge"
+#define BENCH_PROFILE_LINE_SIZE   256
+
+#define BENCH_DEFAULT_SECONDS     60.0
+#define BENCH_DEFAULT_LIMIT       1.0
+
+// The edge rate search starts with 1 ms pulses, and runs each step for
+// a few seconds....
+#define BENCH_SWEEP_START_US      1000
+#define BENCH_SWEEP_SECONDS       5.0
+
+// The gaps are longer than the pulses. With equal pulses and gaps, a handler
+// that misses every other edge measures from the start of one pulse to the
+// end of a later one, which can add up to the right total....
+#define BENCH_SWEEP_GAP_RATIO     2
+
+// Results of a run....
+typedef struct
+{
+   unsigned long ulSeconds;                           // Seconds checked.
+   unsigned long ulSecondsLost;                       // Seconds not reported in time.
+   double pdTruth[SIM_PULSES_CHANNELS];               // In us.
+   double pdTruncated[SIM_PULSES_CHANNELS];           // Of pdTruth, in us.
+   double pdMeasured[SIM_PULSES_CHANNELS];            // In us.
+   double pdWorstSecond[SIM_PULSES_CHANNELS];         // In us, past the truncation.
+   unsigned long pulMissedEdges[SIM_PULSES_CHANNELS]; // Never seen by the firmware.
+   unsigned long ulRuns;                              // Handler runs.
+   unsigned long long ullNanoseconds;                 // Host time of the runs.
+} TyBenchResult;
+
+typedef struct
+{
+   const char *pcName;
+   TySimPulseSettings ptySettings[SIM_PULSES_CHANNELS];
+   unsigned char bPortLineFailure;                    // Known failure of the port line build.
+} TyBenchWorkload;
+
+// Interrupts that run the PPD42NJ edge handler....
+#if defined(PPD42NJ_TIMER_CAPTURE)
+static const unsigned long pulLocalInterrupts[] = {INT_TIMERA2A, INT_TIMERA1B};
+#else
+static const unsigned long pulLocalInterrupts[] = {INT_GPIOA1};
+#endif
+
+static const TyBenchWorkload ptyLocalWorkloads[] =
+{
+   {"occupancy", {{SIM_PULSES_OCCUPANCY, 0.05, 0.0, 0, 0, 0},
+                  {SIM_PULSES_OCCUPANCY, 0.01, 0.0, 0, 0, 0}}, FALSE},
+   {"poisson",   {{SIM_PULSES_POISSON, 0.0, 20.0, 8, 200, 300},
+                  {SIM_PULSES_POISSON, 0.0,  5.0, 4, 100, 300}}, FALSE},
+   {"short",     {{SIM_PULSES_FIXED, 0.0, 0.0, 0, 10, 90},
+                  {SIM_PULSES_FIXED, 0.0, 0.0, 0,  3, 47}}, TRUE},
+   {"boundary",  {{SIM_PULSES_BOUNDARY, 0.0, 0.0, 0, 20000, 0},
+                  {SIM_PULSES_BOUNDARY, 0.0, 0.0, 0,  2000, 0}}, FALSE}
+};
+
+static const TyBenchWorkload tyLocalFileWorkload =
+{
+   "file",       {{SIM_PULSES_FILE, 0.0, 0.0, 0, 0, 0},
+                  {SIM_PULSES_FILE, 0.0, 0.0, 0, 0, 0}}, FALSE
+};
+
+static unsigned long ulLocalSeed;
+static unsigned long ulLocalHandlerCycles;
+static const char *pcLocalHandlerSource;
+static const char *pcLocalFile;
+static TyBenchResult *ptyLocalResult;
+static unsigned long ulLocalNextSecond;
+static TySimEvent tyLocalEndEvent;
+
+
+/****************************************************************************
+     Function: SIMBENCH_Check
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Checks each second that the PPD42NJ has reported since the
+               last check against the pulses driven in it, less their
+               truncation to whole us. A second that has already left the
+               PPD42NJ history is counted as lost.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Allows for the truncation.
+****************************************************************************/
+static void SIMBENCH_Check(void)
+{
+   unsigned char ucChannel;
+   unsigned long ulElapsed, ulAge;
+   unsigned short usIndex;
+   double dTruth, dTruncated, dMeasured, dError;
+   const TyAirQualityMeasurements *ptyMeasurements;
+
+   ptyMeasurements = PPD42NJ_GetAirQualityMeasurementsSnapshot();
+   ulElapsed       = ptyMeasurements->ulSecondsElapsed;
+
+   for (; ulLocalNextSecond < ulElapsed; ulLocalNextSecond++)
+      {
+      // The newest entry is the one before usHead....
+      ulAge = ulElapsed - ulLocalNextSecond;
+      if ((ulAge > MAXIMUM_HISTORY_IN_SECONDS) || (ulAge > SIM_PULSES_SECONDS))
+         {
+         ptyLocalResult->ulSecondsLost++;
+         continue;
+         }
+      usIndex = (unsigned short)((ptyMeasurements->usHead + MAXIMUM_HISTORY_IN_SECONDS - ulAge) % MAXIMUM_HISTORY_IN_SECONDS);
+
+      for (ucChannel=0; ucChannel < SIM_PULSES_CHANNELS; ucChannel++)
+         {
+         dTruth     = (double)SIMPULSES_GetSecond(ucChannel, ulLocalNextSecond) / (SIM_CLOCK_HZ / 1000000ull);
+         dTruncated = (double)SIMPULSES_GetSecondTruncated(ucChannel, ulLocalNextSecond) / (SIM_CLOCK_HZ / 1000000ull);
+         dMeasured  = (double)ptyMeasurements->ppulTimes[PPD42NJ_P1_CHANNEL(0) + ucChannel][usIndex];
+         dError     = dMeasured - (dTruth - dTruncated);
+         if (dError < 0.0)
+            dError = -dError;
+
+         ptyLocalResult->pdTruth[ucChannel]     += dTruth;
+         ptyLocalResult->pdTruncated[ucChannel] += dTruncated;
+         ptyLocalResult->pdMeasured[ucChannel]  += dMeasured;
+         if (dError > ptyLocalResult->pdWorstSecond[ucChannel])
+            ptyLocalResult->pdWorstSecond[ucChannel] = dError;
+         }
+
+      ptyLocalResult->ulSeconds++;
+      }
+}
+
+
+/****************************************************************************
+     Function: SIMBENCH_End
+     Engineer: agent
+        Input: TySimEvent *ptyEvent: End event.
+       Output: N/A
+  Description: The run time is up, so the pulse trains and the scheduler
+               are stopped.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMBENCH_End(TySimEvent *ptyEvent)
+{
+   SIMPULSES_Stop();
+   SCHEDULER_Stop();
+}
+
+
+/****************************************************************************
+     Function: SIMBENCH_Run
+     Engineer: agent
+        Input: const TyBenchWorkload *ptyWorkload: Pulse trains.
+               double dSeconds: Seconds to check.
+               TyBenchResult *ptyResult: Where to put the results.
+       Output: unsigned char: TRUE: Success, FALSE: Failure (reported).
+  Description: Starts the PPD42NJ module on a freshly reset board, as the
+               firmware's main does, and runs the pulse trains from the start
+               of its first second.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Collects the missed edges.
+****************************************************************************/
+static unsigned char SIMBENCH_Run(const TyBenchWorkload *ptyWorkload, double dSeconds, TyBenchResult *ptyResult)
+{
+   unsigned char ucChannel;
+   unsigned long i;
+   TySimTime ullOrigin;
+   TySimStatistics *ptyStatistics;
+
+   memset(ptyResult, 0, sizeof(*ptyResult));
+   ptyLocalResult    = ptyResult;
+   ulLocalNextSecond = 0;
+
+   SIM_Initialise();
+   SIMHAL_Initialise(NULL);
+   SIMPULSES_Initialise(ulLocalSeed);
+
+   if ((ptyWorkload->ptySettings[0].tyMode == SIM_PULSES_FILE) && (SIMPULSES_Load(pcLocalFile) != TRUE))
+      return FALSE;
+
+   MAP_IntMasterEnable();
+   MAP_IntEnable(FAULT_SYSTICK);
+   TIMER_Initialise();
+   SCHEDULER_Initialise();
+   PinMuxConfig();
+
+   if ((PPD42NJ_Initialise() != TRUE) || (PPD42NJ_SetupNotifications(NOTIFICATION_1_SECOND_UPDATE, SIMBENCH_Check) != TRUE))
+      {
+      fprintf(stderr, "ppdbench: failed to initialise the PPD42NJ\n");
+      return FALSE;
+      }
+
+   for (i=0; i < sizeof(pulLocalInterrupts) / sizeof(pulLocalInterrupts[0]); i++)
+      {
+      SIM_SetHandlerCycles(pulLocalInterrupts[i], ulLocalHandlerCycles);
+      SIM_MeasureInterrupt(pulLocalInterrupts[i]);
+      }
+
+   // The seconds are counted from when the PPD42NJ timer was started....
+   ullOrigin = SIMHAL_GetTimerStart(TIMERA0_BASE, TIMER_A);
+   SIMPULSES_SetOrigin(ullOrigin);
+
+   for (ucChannel=0; ucChannel < SIM_PULSES_CHANNELS; ucChannel++)
+      SIMPULSES_Start(ucChannel, &ptyWorkload->ptySettings[ucChannel]);
+
+   // Stop half way through the second after the last one, so that the last
+   // one has been reported....
+   SIM_Schedule(&tyLocalEndEvent, ullOrigin + (TySimTime)((dSeconds + 0.5) * SIM_CLOCK_HZ), SIMBENCH_End);
+
+   SCHEDULER_Run();
+
+   // Pick up any seconds not yet notified....
+   SIMBENCH_Check();
+
+   ptyStatistics = SIM_GetStatistics();
+   for (i=0; i < sizeof(pulLocalInterrupts) / sizeof(pulLocalInterrupts[0]); i++)
+      {
+      ptyResult->ulRuns         += ptyStatistics->pulInterruptCounts[pulLocalInterrupts[i]];
+      ptyResult->ullNanoseconds += ptyStatistics->pullInterruptNanoseconds[pulLocalInterrupts[i]];
+      }
+   for (ucChannel=0; ucChannel < SIM_PULSES_CHANNELS; ucChannel++)
+      ptyResult->pulMissedEdges[ucChannel] = ptyStatistics->pulMissedEdges[ucChannel];
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: SIMBENCH_Error
+     Engineer: agent
+        Input: const TyBenchResult *ptyResult: Results of a run.
+               unsigned char ucChannel: Channel.
+       Output: double: Error in the total low time, in % of the time
+                  driven.
+  Description: Returns the error of a channel against the pulses driven,
+               less their truncation to whole us. A channel with no pulses
+               has no error unless some were measured.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Allows for the truncation.
+****************************************************************************/
+static double SIMBENCH_Error(const TyBenchResult *ptyResult, unsigned char ucChannel)
+{
+   double dExpected;
+
+   if (ptyResult->pdTruth[ucChannel] <= 0.0)
+      return (ptyResult->pdMeasured[ucChannel] > 0.0) ? 100.0 : 0.0;
+
+   dExpected = ptyResult->pdTruth[ucChannel] - ptyResult->pdTruncated[ucChannel];
+
+   return (100.0 * (ptyResult->pdMeasured[ucChannel] - dExpected)) / ptyResult->pdTruth[ucChannel];
+}
+
+
+/****************************************************************************
+     Function: SIMBENCH_Passed
+     Engineer: agent
+        Input: const TyBenchResult *ptyResult: Results of a run.
+               unsigned long ulSeconds: Seconds that should have been checked.
+               double dLimit: Largest error allowed, in %.
+       Output: unsigned char: TRUE if every second was reported and both
+                  channels are within the limit.
+  Description: Decides whether the PPD42NJ kept up with a run. Each channel
+               must have missed no more than the limit of its edges, and be
+               within the limit of the time driven once the truncation is
+               allowed for.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Judged on the missed edges and the error past the
+                           truncation, rather than allowing 1 us a pulse.
+****************************************************************************/
+static unsigned char SIMBENCH_Passed(const TyBenchResult *ptyResult, unsigned long ulSeconds, double dLimit)
+{
+   unsigned char ucChannel;
+   double dError;
+
+   if ((ptyResult->ulSeconds < ulSeconds) || (ptyResult->ulSecondsLost != 0))
+      return FALSE;
+
+   for (ucChannel=0; ucChannel < SIM_PULSES_CHANNELS; ucChannel++)
+      {
+      if ((100.0 * ptyResult->pulMissedEdges[ucChannel]) > (dLimit * SIMPULSES_GetTruth(ucChannel)->ulEdges))
+         return FALSE;
+
+      dError = SIMBENCH_Error(ptyResult, ucChannel);
+      if ((dError > dLimit) || (-dError > dLimit))
+         return FALSE;
+      }
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: SIMBENCH_Report
+     Engineer: agent
+        Input: const char *pcName: Workload name.
+               const TyBenchResult *ptyResult: Results of the run.
+               double dSeconds: Seconds run for.
+       Output: N/A
+  Description: Prints the results of a workload.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added the missed edges and the truncation.
+****************************************************************************/
+static void SIMBENCH_Report(const char *pcName, const TyBenchResult *ptyResult, double dSeconds)
+{
+   unsigned char ucChannel;
+   unsigned long ulEdges;
+   const TySimPulseTruth *ptyTruth;
+   static const char *ppcChannels[SIM_PULSES_CHANNELS] = {"P1", "P2"};
+
+   printf("%s: %lu seconds checked", pcName, ptyResult->ulSeconds);
+   if (ptyResult->ulSecondsLost != 0)
+      printf(", %lu seconds lost", ptyResult->ulSecondsLost);
+   printf("\n");
+   printf("   Channel  Pulses  Edges/s  Missed edges  Shortest (us)  Driven (us)  Truncated (us)  Measured (us)  Error (%%)  Worst second (us)\n");
+
+   ulEdges = 0;
+   for (ucChannel=0; ucChannel < SIM_PULSES_CHANNELS; ucChannel++)
+      {
+      ptyTruth = SIMPULSES_GetTruth(ucChannel);
+      ulEdges += ptyTruth->ulEdges;
+
+      printf("   %-7s  %6lu  %7.0f  %12lu  %13.3f  %11.0f  %14.0f  %13.0f  %9.3f  %17.0f\n",
+             ppcChannels[ucChannel],
+             ptyTruth->ulPulses,
+             ptyTruth->ulEdges / dSeconds,
+             ptyResult->pulMissedEdges[ucChannel],
+             (ptyTruth->ulPulses != 0) ? (double)ptyTruth->ullShortestCycles / (SIM_CLOCK_HZ / 1000000ull) : 0.0,
+             ptyResult->pdTruth[ucChannel],
+             ptyResult->pdTruncated[ucChannel],
+             ptyResult->pdMeasured[ucChannel],
+             SIMBENCH_Error(ptyResult, ucChannel),
+             ptyResult->pdWorstSecond[ucChannel]);
+      }
+
+   if ((ptyResult->ulRuns != 0) && (ulEdges != 0))
+      {
+      printf("   Handler: %lu runs, %.2f edges a run, %lu cycles a run (%.3f %% of the processor)\n",
+             ptyResult->ulRuns,
+             (double)ulEdges / ptyResult->ulRuns,
+             ulLocalHandlerCycles,
+             (100.0 * ptyResult->ulRuns * ulLocalHandlerCycles) / (dSeconds * SIM_CLOCK_HZ));
+      printf("   Host time: %.0f ns a run, %.0f ns an edge\n",
+             (double)ptyResult->ullNanoseconds / ptyResult->ulRuns,
+             (double)ptyResult->ullNanoseconds / ulEdges);
+      }
+
+   printf("\n");
+}
+
+
+/****************************************************************************
+     Function: SIMBENCH_SweepStep
+     Engineer: agent
+        Input: unsigned long ulWidth: Pulse width, in us.
+               double dLimit: Largest error allowed, in %.
+       Output: unsigned char: TRUE if the PPD42NJ kept up.
+  Description: Runs both channels with the same fixed pulses, edges
+               together, and prints the result.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Prints the missed edges.
+****************************************************************************/
+static unsigned char SIMBENCH_SweepStep(unsigned long ulWidth, double dLimit)
+{
+   unsigned char ucChannel, bPassed;
+   TyBenchWorkload tyWorkload;
+   TyBenchResult tyResult;
+
+   tyWorkload.pcName = "sweep";
+   for (ucChannel=0; ucChannel < SIM_PULSES_CHANNELS; ucChannel++)
+      {
+      memset(&tyWorkload.ptySettings[ucChannel], 0, sizeof(tyWorkload.ptySettings[ucChannel]));
+      tyWorkload.ptySettings[ucChannel].tyMode = SIM_PULSES_FIXED;
+      tyWorkload.ptySettings[ucChannel].ulWidth = ulWidth;
+      tyWorkload.ptySettings[ucChannel].ulGap = ulWidth * BENCH_SWEEP_GAP_RATIO;
+      }
+
+   if (SIMBENCH_Run(&tyWorkload, BENCH_SWEEP_SECONDS, &tyResult) != TRUE)
+      exit(1);
+
+   bPassed = SIMBENCH_Passed(&tyResult, (unsigned long)BENCH_SWEEP_SECONDS, dLimit);
+
+   printf("   %5lu us  %9.0f edges/s  P1 %8.3f %% %7lu missed  P2 %8.3f %% %7lu missed  %s\n",
+          ulWidth,
+          (SIM_PULSES_CHANNELS * 2000000.0) / (ulWidth * (1 + BENCH_SWEEP_GAP_RATIO)),
+          SIMBENCH_Error(&tyResult, 0),
+          tyResult.pulMissedEdges[0],
+          SIMBENCH_Error(&tyResult, 1),
+          tyResult.pulMissedEdges[1],
+          bPassed ? "kept up" : "fell behind");
+
+   return bPassed;
+}
+
+
+/****************************************************************************
+     Function: SIMBENCH_Sweep
+     Engineer: agent
+        Input: double dLimit: Largest error allowed, in %.
+       Output: N/A
+  Description: Finds the highest edge rate that the PPD42NJ keeps up with,
+               by halving the pulse width until it falls behind and then
+               running each width below the last pass in order, down to the
+               first failure.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Scans in order rather than bisecting, and says
+                           the rate is not a proven maximum.
+****************************************************************************/
+static void SIMBENCH_Sweep(double dLimit)
+{
+   unsigned long ulPass, ulFail, ulWidth;
+
+   printf("Edge rate search, %lu cycles a handler run (%s), %.1f %% limit:\n", ulLocalHandlerCycles, pcLocalHandlerSource, dLimit);
+
+   ulPass = 0;
+   ulFail = 0;
+   for (ulWidth=BENCH_SWEEP_START_US; ulWidth > 0; ulWidth /= 2)
+      {
+      if (SIMBENCH_SweepStep(ulWidth, dLimit) != TRUE)
+         {
+         ulFail = ulWidth;
+         break;
+         }
+      ulPass = ulWidth;
+      }
+
+   if (ulPass == 0)
+      {
+      printf("Highest edge rate: below %.0f edges/s\n\n", (SIM_PULSES_CHANNELS * 2000000.0) / (BENCH_SWEEP_START_US * (1 + BENCH_SWEEP_GAP_RATIO)));
+      return;
+      }
+
+   // The results are not monotonic in the width (the latency of the two
+   // edges of a pulse can cancel out), so rather than bisecting, scan down
+   // in order and stop at the first failure....
+   for (ulWidth=ulPass - 1; ulWidth > ulFail; ulWidth--)
+      {
+      if (SIMBENCH_SweepStep(ulWidth, dLimit) != TRUE)
+         {
+         ulFail = ulWidth;
+         break;
+         }
+      ulPass = ulWidth;
+      }
+
+   printf("Highest edge rate: %.0f edges/s (%lu us pulses, %lu us gaps on both channels)\n",
+          (SIM_PULSES_CHANNELS * 2000000.0) / (ulPass * (1 + BENCH_SWEEP_GAP_RATIO)), ulPass, ulPass * BENCH_SWEEP_GAP_RATIO);
+   if (ulFail != 0)
+      printf("Not a proven maximum: %lu us pulses fell behind, and only the widths above were run.\n", ulFail);
+   printf("\n");
+}
+
+
+/****************************************************************************
+     Function: SIMBENCH_ReadProfile
+     Engineer: agent
+        Input: const char *pcReport: Profile report captured from the
+                  board's console.
+       Output: unsigned char: TRUE if the handler time was read.
+  Description: Sets the handler time from the mean of the PPD42NJ edge point
+               in a profile report, plus the exception entry and exit. The
+               minimum and maximum are printed, as the mean hides how the
+               handler time varies with the edges handled in a run.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SIMBENCH_ReadProfile(const char *pcReport)
+{
+   FILE *pFile;
+   char pcLine[BENCH_PROFILE_LINE_SIZE];
+   char *pcPoint;
+   unsigned long ulCount, ulMinimum, ulMaximum, ulMean;
+
+   pFile = fopen(pcReport, "r");
+   if (pFile == NULL)
+      {
+      fprintf(stderr, "cannot open %s\n", pcReport);
+      return FALSE;
+      }
+
+   while (fgets(pcLine, sizeof(pcLine), pFile) != NULL)
+      {
+      pcPoint = strstr(pcLine, BENCH_PROFILE_POINT);
+      if (pcPoint == NULL)
+         continue;
+
+      fclose(pFile);
+
+      if ((sscanf(pcPoint + strlen(BENCH_PROFILE_POINT), "%lu %lu %lu %lu", &ulCount, &ulMinimum, &ulMaximum, &ulMean) != 4) || (ulCount == 0))
+         {
+         fprintf(stderr, "%s: no %s figures\n", pcReport, BENCH_PROFILE_POINT);
+         return FALSE;
+         }
+
+      printf("Profile report %s: %s %lu runs, %lu min %lu max %lu mean cycles\n",
+             pcReport, BENCH_PROFILE_POINT, ulCount, ulMinimum, ulMaximum, ulMean);
+
+      ulLocalHandlerCycles = ulMean + BENCH_EXCEPTION_CYCLES;
+      pcLocalHandlerSource = "measured";
+      return TRUE;
+      }
+
+   fclose(pFile);
+   fprintf(stderr, "%s: no %s point\n", pcReport, BENCH_PROFILE_POINT);
+   return FALSE;
+}
+
+
+/****************************************************************************
+     Function: SIMBENCH_Usage
+     Engineer: agent
+        Input: const char *pcName: Program name.
+       Output: N/A
+  Description: Prints the usage and exits.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMBENCH_Usage(const char *pcName)
+{
+   fprintf(stderr, "usage: %s [-w workload] [-d seconds] [-s seed] [-c cycles | -p report] [-e error %%] [-f file] [-m] [-x]\n", pcName);
+   fprintf(stderr, "  -w  occupancy, poisson, short, boundary or file (default all)\n");
+   fprintf(stderr, "  -d  seconds to run each workload for (default %.0f s)\n", BENCH_DEFAULT_SECONDS);
+   fprintf(stderr, "  -s  random number seed (default 1)\n");
+   fprintf(stderr, "  -c  target cycles of a PPD42NJ interrupt (default %d, assumed)\n", BENCH_HANDLER_CYCLES);
+   fprintf(stderr, "  -p  profile report from the board, for the measured cycles\n");
+   fprintf(stderr, "  -e  largest error allowed (default %.1f %%)\n", BENCH_DEFAULT_LIMIT);
+   fprintf(stderr, "  -f  recorded pulse file, lines of <channel 1|2> <start us> <width us>\n");
+   fprintf(stderr, "  -m  only find the highest edge rate\n");
+   fprintf(stderr, "  -x  fail on the known failures of the build too\n");
+   exit(1);
+}
+
+
+int main(int argc, char **argv)
+{
+   int iOption, iResult;
+   unsigned long i;
+   unsigned char bSweepOnly, bStrict, bKnownFailure;
+   double dSeconds, dLimit;
+   const char *pcWorkload, *pcReport;
+   const TyBenchWorkload *ptyWorkload;
+   TyBenchResult tyResult;
+
+   dSeconds             = BENCH_DEFAULT_SECONDS;
+   dLimit               = BENCH_DEFAULT_LIMIT;
+   pcWorkload           = NULL;
+   bSweepOnly           = FALSE;
+   bStrict              = FALSE;
+   ulLocalSeed          = 1;
+   ulLocalHandlerCycles = BENCH_HANDLER_CYCLES;
+   pcLocalHandlerSource = "assumed";
+   pcLocalFile          = NULL;
+   pcReport             = NULL;
+
+   while ((iOption = getopt(argc, argv, "w:d:s:c:p:e:f:mx")) != -1)
+      {
+      switch (iOption)
+         {
+         case 'w': pcWorkload           = optarg;                         break;
+         case 'd': dSeconds             = atof(optarg);                   break;
+         case 's': ulLocalSeed          = strtoul(optarg, NULL, 0);       break;
+         case 'c': ulLocalHandlerCycles = strtoul(optarg, NULL, 0);
+                   pcLocalHandlerSource = "set";                          break;
+         case 'p': pcReport             = optarg;                         break;
+         case 'e': dLimit               = atof(optarg);                   break;
+         case 'f': pcLocalFile          = optarg;                         break;
+         case 'm': bSweepOnly           = TRUE;                           break;
+         case 'x': bStrict              = TRUE;                           break;
+         default:  SIMBENCH_Usage(argv[0]);                               break;
+         }
+      }
+
+   if ((optind != argc) || (dSeconds < 1.0) || (dLimit <= 0.0) ||
+       ((pcWorkload != NULL) && (strcmp(pcWorkload, "file") == 0) && (pcLocalFile == NULL)))
+      SIMBENCH_Usage(argv[0]);
+
+   if ((pcWorkload != NULL) && (strcmp(pcWorkload, "file") != 0))
+      {
+      for (i=0; i < sizeof(ptyLocalWorkloads) / sizeof(ptyLocalWorkloads[0]); i++)
+         {
+         if (strcmp(pcWorkload, ptyLocalWorkloads[i].pcName) == 0)
+            break;
+         }
+      if (i == sizeof(ptyLocalWorkloads) / sizeof(ptyLocalWorkloads[0]))
+         SIMBENCH_Usage(argv[0]);
+      }
+
+   if ((pcReport != NULL) && (SIMBENCH_ReadProfile(pcReport) != TRUE))
+      return 1;
+
+   dSeconds = (double)(unsigned long)dSeconds;
+   iResult  = 0;
+
+   printf("PPD42NJ %s build, %lu cycles a handler run (%s)\n\n",
+#if defined(PPD42NJ_TIMER_CAPTURE)
+          "timer capture",
+#else
+          "port line interrupt",
+#endif
+          ulLocalHandlerCycles,
+          pcLocalHandlerSource);
+
+   if (bSweepOnly == FALSE)
+      {
+      for (i=0; i <= sizeof(ptyLocalWorkloads) / sizeof(ptyLocalWorkloads[0]); i++)
+         {
+         if (i < sizeof(ptyLocalWorkloads) / sizeof(ptyLocalWorkloads[0]))
+            ptyWorkload = &ptyLocalWorkloads[i];
+         else if ((pcLocalFile != NULL) && ((pcWorkload == NULL) || (strcmp(pcWorkload, "file") == 0)))
+            ptyWorkload = &tyLocalFileWorkload;
+         else
+            break;
+
+         if ((pcWorkload != NULL) && (strcmp(pcWorkload, ptyWorkload->pcName) != 0))
+            continue;
+
+         if (SIMBENCH_Run(ptyWorkload, dSeconds, &tyResult) != TRUE)
+            return 1;
+
+         SIMBENCH_Report(ptyWorkload->pcName, &tyResult, dSeconds);
+
+         if (SIMBENCH_Passed(&tyResult, (unsigned long)dSeconds, dLimit) != TRUE)
+            {
+#if defined(PPD42NJ_TIMER_CAPTURE)
+            bKnownFailure = FALSE;
+#else
+            bKnownFailure = ptyWorkload->bPortLineFailure;
+#endif
+            if (bKnownFailure && (bStrict == FALSE))
+               {
+               printf("%s: known failure of the port line build (edge latency, see PPD42NJ_PortLineInterrupt)\n\n", ptyWorkload->pcName);
+               }
+            else
+               {
+               printf("%s: FAILED\n\n", ptyWorkload->pcName);
+               iResult = 1;
+               }
+            }
+         }
+      }
+
+   if ((pcWorkload == NULL) || bSweepOnly)
+      SIMBENCH_Sweep(dLimit);
+
+   return iResult;
+}
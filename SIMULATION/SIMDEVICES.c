@@ -0,0 +1,500 @@
+/****************************************************************************
+       Module: SIMDEVICES.c
+     Engineer: agent
+  Description: Contains the models of the devices on the board for the host
+               simulation:
+
+                  HDC1080      Temperature / humidity sensor on the I2C bus.
+                               Conversions take the datasheet times, and a
+                               read is not acknowledged until it is done.
+                               The measurements have the configured
+                               resolution, with the unused low bits 0.
+                  TLC59116     LED driver on the I2C bus. The registers are
+                               kept so that the LED state can be reported.
+                  PPD42NJ      Particle sensor. The P1 and P2 outputs are
+                               driven by SIMPULSES, with pulses of 10 - 90
+                               ms and gaps set to give the required
+                               occupancy.
+
+               The random numbers come from a seeded generator, so a run
+               can be repeated exactly.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       The PPD42NJ outputs are driven by SIMPULSES.
+17-OCT-2026    agent       HDC1080 measurements at the configured resolution,
+                           optionally without noise. Added
+                           SIMDEVICES_SetClimate.
+17-OCT-2026    agent       Counts the bytes written to the TLC59116. Added
+                           SIMDEVICES_GetTLC59116Register.
+****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "includes.h"
+#include "SIM.h"
+
+#define SIM_HDC1080_ADDRESS       0x40
+#define SIM_HDC1080_TEMPERATURE   0x00
+#define SIM_HDC1080_HUMIDITY      0x01
+#define SIM_HDC1080_CONFIGURATION 0x02
+#define SIM_HDC1080_MANUFACTURER  0xFE
+#define SIM_HDC1080_DEVICE        0xFF
+
+#define SIM_HDC1080_CONFIG_RESET  0x8000
+#define SIM_HDC1080_CONFIG_MODE   0x1000
+#define SIM_HDC1080_CONFIG_TRES   0x0400
+#define SIM_HDC1080_CONFIG_HRES   0x0300
+#define SIM_HDC1080_CONFIG_DEFAULT 0x1000
+
+// Bits of the raw value kept at each resolution....
+#define SIM_HDC1080_14_BIT_MASK   0xFFFC
+#define SIM_HDC1080_11_BIT_MASK   0xFFE0
+#define SIM_HDC1080_8_BIT_MASK    0xFF00
+
+#define SIM_TLC59116_ADDRESS      0x60
+#define SIM_TLC59116_REGISTERS    0x20
+#define SIM_TLC59116_LAST         0x1B   // Last register that auto increment reaches.
+#define SIM_TLC59116_PWM0         0x02
+#define SIM_TLC59116_AI_ALL       0x80
+
+// Conversion times in us, from the HDC1080 datasheet....
+static const unsigned long pulLocalTemperatureTimes[] = {6350, 3650};          // 14, 11 bit.
+static const unsigned long pulLocalHumidityTimes[]    = {6500, 3850, 2500};    // 14, 11, 8 bit.
+
+static TySimSettings tyLocalSettings;
+static unsigned long ulLocalRandom;
+
+static unsigned short usLocalHDC1080Config;
+static unsigned char ucLocalHDC1080Pointer;
+static unsigned char ucLocalHDC1080Index;
+static unsigned char pucLocalHDC1080Data[0x4];
+static unsigned char ucLocalHDC1080Length;
+static TySimTime ullLocalHDC1080Ready;
+static unsigned char ucLocalHDC1080Written;
+
+static unsigned char pucLocalTLC59116Registers[SIM_TLC59116_REGISTERS];
+static unsigned char ucLocalTLC59116Pointer;
+static unsigned char ucLocalTLC59116Control;
+static unsigned char ucLocalTLC59116Written;
+
+
+/****************************************************************************
+     Function: SIMDEVICES_Random
+     Engineer: agent
+        Input: N/A
+       Output: double: Random number, 0 <= n < 1.
+  Description: 32 bit xorshift generator.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static double SIMDEVICES_Random(void)
+{
+   ulLocalRandom ^= (ulLocalRandom << 13) & 0xFFFFFFFFul;
+   ulLocalRandom ^= ulLocalRandom >> 17;
+   ulLocalRandom ^= (ulLocalRandom << 5) & 0xFFFFFFFFul;
+
+   return (double)ulLocalRandom / 4294967296.0;
+}
+
+
+/* ======================================================================== */
+/*  HDC1080                                                                 */
+/* ======================================================================== */
+
+/****************************************************************************
+     Function: SIMDEVICES_HDC1080Raw
+     Engineer: agent
+        Input: unsigned char *pucData: Where to put the raw value (MSB first).
+               double dValue: Value as a fraction of full scale.
+               unsigned long ulMask: SIM_HDC1080_x_BIT_MASK
+       Output: N/A
+  Description: Converts to the 16 bit raw value. The bits below the
+               resolution read as 0.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Takes the resolution.
+****************************************************************************/
+static void SIMDEVICES_HDC1080Raw(unsigned char *pucData, double dValue, unsigned long ulMask)
+{
+   unsigned long ulRaw;
+
+   if (dValue < 0.0)
+      dValue = 0.0;
+
+   ulRaw = (unsigned long)(dValue * 65536.0);
+   if (ulRaw > 0xFFFF)
+      ulRaw = 0xFFFF;
+   ulRaw &= ulMask;
+
+   pucData[0] = (unsigned char)(ulRaw >> 8);
+   pucData[1] = (unsigned char)ulRaw;
+}
+
+
+/****************************************************************************
+     Function: SIMDEVICES_HDC1080Measure
+     Engineer: agent
+        Input: unsigned char *pucData: Where to put the raw values.
+               unsigned char ucRegister: Measurement register.
+       Output: N/A
+  Description: Takes the measurement(s) at the configured resolution,
+               with a little noise unless the settings turn it off.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       At the configured resolution. The noise can be
+                           turned off.
+****************************************************************************/
+static void SIMDEVICES_HDC1080Measure(unsigned char *pucData, unsigned char ucRegister)
+{
+   double dTemperature, dHumidity;
+   unsigned long ulTemperatureMask, ulHumidityMask;
+
+   dTemperature = tyLocalSettings.dTemperature;
+   dHumidity    = tyLocalSettings.dHumidity;
+   if (tyLocalSettings.bNoise)
+      {
+      dTemperature += (SIMDEVICES_Random() - 0.5) * 0.2;
+      dHumidity    += (SIMDEVICES_Random() - 0.5) * 1.0;
+      }
+
+   ulTemperatureMask = (usLocalHDC1080Config & SIM_HDC1080_CONFIG_TRES) ? SIM_HDC1080_11_BIT_MASK : SIM_HDC1080_14_BIT_MASK;
+   switch (usLocalHDC1080Config & SIM_HDC1080_CONFIG_HRES)
+      {
+      case 0x0000: ulHumidityMask = SIM_HDC1080_14_BIT_MASK; break;
+      case 0x0100: ulHumidityMask = SIM_HDC1080_11_BIT_MASK; break;
+      default:     ulHumidityMask = SIM_HDC1080_8_BIT_MASK;  break;
+      }
+
+   if (ucRegister == SIM_HDC1080_HUMIDITY)
+      {
+      SIMDEVICES_HDC1080Raw(pucData, dHumidity / 100.0, ulHumidityMask);
+      return;
+      }
+
+   SIMDEVICES_HDC1080Raw(pucData, (dTemperature + 40.0) / 165.0, ulTemperatureMask);
+   SIMDEVICES_HDC1080Raw(&pucData[2], dHumidity / 100.0, ulHumidityMask);
+}
+
+
+/****************************************************************************
+     Function: SIMDEVICES_HDC1080Trigger
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Starts a conversion, following a write of the temperature or
+               humidity register address. In sequence mode a write of the
+               temperature address converts both.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMDEVICES_HDC1080Trigger(void)
+{
+   unsigned long ulMicroseconds;
+   unsigned char bTemperature, bHumidity;
+
+   bTemperature = (ucLocalHDC1080Pointer == SIM_HDC1080_TEMPERATURE);
+   bHumidity    = (ucLocalHDC1080Pointer == SIM_HDC1080_HUMIDITY) ||
+                  (bTemperature && (usLocalHDC1080Config & SIM_HDC1080_CONFIG_MODE));
+
+   ulMicroseconds = 0;
+   if (bTemperature)
+      ulMicroseconds += pulLocalTemperatureTimes[(usLocalHDC1080Config & SIM_HDC1080_CONFIG_TRES) ? 1 : 0];
+   if (bHumidity)
+      ulMicroseconds += pulLocalHumidityTimes[((usLocalHDC1080Config & SIM_HDC1080_CONFIG_HRES) >> 8) % 3];
+
+   ullLocalHDC1080Ready = SIM_GetTime() + ((TySimTime)ulMicroseconds * SIM_CYCLES_PER_MS) / 1000;
+
+   SIM_GetStatistics()->ulHDC1080Conversions++;
+}
+
+
+/****************************************************************************
+     Function: SIMDEVICES_HDC1080Start
+     Engineer: agent
+        Input: unsigned char bRead: TRUE for a read.
+       Output: unsigned char: TRUE if the address is acknowledged.
+  Description: Start of a transfer. A read of a measurement is not
+               acknowledged until the conversion is complete.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SIMDEVICES_HDC1080Start(unsigned char bRead)
+{
+   ucLocalHDC1080Index   = 0;
+   ucLocalHDC1080Written = 0;
+
+   if (bRead == FALSE)
+      return TRUE;
+
+   ucLocalHDC1080Length = 0x2;
+
+   switch (ucLocalHDC1080Pointer)
+      {
+      case SIM_HDC1080_TEMPERATURE:
+      case SIM_HDC1080_HUMIDITY:
+         if (SIM_GetTime() < ullLocalHDC1080Ready)
+            return FALSE;
+
+         SIMDEVICES_HDC1080Measure(pucLocalHDC1080Data, ucLocalHDC1080Pointer);
+         if ((ucLocalHDC1080Pointer == SIM_HDC1080_TEMPERATURE) && (usLocalHDC1080Config & SIM_HDC1080_CONFIG_MODE))
+            ucLocalHDC1080Length = 0x4;
+      break;
+
+      case SIM_HDC1080_CONFIGURATION:
+         pucLocalHDC1080Data[0] = (unsigned char)(usLocalHDC1080Config >> 8);
+         pucLocalHDC1080Data[1] = (unsigned char)usLocalHDC1080Config;
+      break;
+
+      case SIM_HDC1080_MANUFACTURER:
+         pucLocalHDC1080Data[0] = 0x54;
+         pucLocalHDC1080Data[1] = 0x49;
+      break;
+
+      case SIM_HDC1080_DEVICE:
+         pucLocalHDC1080Data[0] = 0x10;
+         pucLocalHDC1080Data[1] = 0x50;
+      break;
+
+      default:
+         pucLocalHDC1080Data[0] = 0xFF;
+         pucLocalHDC1080Data[1] = 0xFF;
+      break;
+      }
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: SIMDEVICES_HDC1080Write
+     Engineer: agent
+        Input: unsigned char ucData: Byte written.
+       Output: unsigned char: TRUE (always acknowledged).
+  Description: The first byte sets the register address; writing a
+               measurement address triggers a conversion. Two more bytes
+               write the configuration register.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SIMDEVICES_HDC1080Write(unsigned char ucData)
+{
+   if (ucLocalHDC1080Written == 0)
+      {
+      ucLocalHDC1080Pointer = ucData;
+      if ((ucData == SIM_HDC1080_TEMPERATURE) || (ucData == SIM_HDC1080_HUMIDITY))
+         SIMDEVICES_HDC1080Trigger();
+      }
+   else if (ucLocalHDC1080Pointer == SIM_HDC1080_CONFIGURATION)
+      {
+      if (ucLocalHDC1080Written == 1)
+         pucLocalHDC1080Data[0] = ucData;
+      else if (ucLocalHDC1080Written == 2)
+         {
+         usLocalHDC1080Config = (unsigned short)((pucLocalHDC1080Data[0] << 8) | ucData);
+         if (usLocalHDC1080Config & SIM_HDC1080_CONFIG_RESET)
+            usLocalHDC1080Config = SIM_HDC1080_CONFIG_DEFAULT;
+         }
+      }
+
+   ucLocalHDC1080Written++;
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: SIMDEVICES_HDC1080Read
+     Engineer: agent
+        Input: N/A
+       Output: unsigned char: Byte read.
+  Description: Returns the next byte of the register being read.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SIMDEVICES_HDC1080Read(void)
+{
+   if (ucLocalHDC1080Index >= ucLocalHDC1080Length)
+      return 0xFF;
+
+   return pucLocalHDC1080Data[ucLocalHDC1080Index++];
+}
+
+
+static void SIMDEVICES_HDC1080Stop(void)
+{
+}
+
+
+static const TySimI2CDevice tyLocalHDC1080 =
+{
+   SIM_HDC1080_ADDRESS,
+   SIMDEVICES_HDC1080Start,
+   SIMDEVICES_HDC1080Write,
+   SIMDEVICES_HDC1080Read,
+   SIMDEVICES_HDC1080Stop
+};
+
+
+/* ======================================================================== */
+/*  TLC59116                                                                */
+/* ======================================================================== */
+
+static unsigned char SIMDEVICES_TLC59116Start(unsigned char bRead)
+{
+   ucLocalTLC59116Written = 0;
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: SIMDEVICES_TLC59116Write
+     Engineer: agent
+        Input: unsigned char ucData: Byte written.
+       Output: unsigned char: TRUE (always acknowledged).
+  Description: The first byte is the control register (register address and
+               auto increment flags); the rest are written to the registers.
+               Only the auto increment of all registers, which the firmware
+               uses, rolls over from the last register back to 0.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Counts the bytes.
+****************************************************************************/
+static unsigned char SIMDEVICES_TLC59116Write(unsigned char ucData)
+{
+   SIM_GetStatistics()->ulTLC59116Bytes++;
+
+   if (ucLocalTLC59116Written++ == 0)
+      {
+      ucLocalTLC59116Control = ucData;
+      ucLocalTLC59116Pointer = ucData & (SIM_TLC59116_REGISTERS - 1);
+      return TRUE;
+      }
+
+   pucLocalTLC59116Registers[ucLocalTLC59116Pointer] = ucData;
+
+   if (ucLocalTLC59116Control & SIM_TLC59116_AI_ALL)
+      ucLocalTLC59116Pointer = (ucLocalTLC59116Pointer >= SIM_TLC59116_LAST) ? 0 : ucLocalTLC59116Pointer + 1;
+
+   return TRUE;
+}
+
+
+static unsigned char SIMDEVICES_TLC59116Read(void)
+{
+   return pucLocalTLC59116Registers[ucLocalTLC59116Pointer];
+}
+
+
+static void SIMDEVICES_TLC59116Stop(void)
+{
+   if (ucLocalTLC59116Written > 1)
+      SIM_GetStatistics()->ulTLC59116Writes++;
+}
+
+
+static const TySimI2CDevice tyLocalTLC59116 =
+{
+   SIM_TLC59116_ADDRESS,
+   SIMDEVICES_TLC59116Start,
+   SIMDEVICES_TLC59116Write,
+   SIMDEVICES_TLC59116Read,
+   SIMDEVICES_TLC59116Stop
+};
+
+
+/****************************************************************************
+     Function: SIMDEVICES_PrintLeds
+     Engineer: agent
+        Input: FILE *ptyOutput: Where to print.
+       Output: N/A
+  Description: Prints the PWM registers of the LED driver.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIMDEVICES_PrintLeds(FILE *ptyOutput)
+{
+   unsigned char i;
+
+   fprintf(ptyOutput, "LED PWM:");
+   for (i=0; i < 16; i++)
+      fprintf(ptyOutput, " %3u", pucLocalTLC59116Registers[SIM_TLC59116_PWM0 + i]);
+   fprintf(ptyOutput, "\n");
+}
+
+
+/****************************************************************************
+     Function: SIMDEVICES_GetTLC59116Register
+     Engineer: agent
+        Input: unsigned char ucRegister: Register address.
+       Output: unsigned char: Value last written to the register.
+  Description: Lets the tests check what reached the LED driver.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char SIMDEVICES_GetTLC59116Register(unsigned char ucRegister)
+{
+   return pucLocalTLC59116Registers[ucRegister & (SIM_TLC59116_REGISTERS - 1)];
+}
+
+
+/****************************************************************************
+     Function: SIMDEVICES_Initialise
+     Engineer: agent
+        Input: const TySimSettings *ptySettings: Device settings.
+       Output: N/A
+  Description: Puts the devices into their power on state, attaches the
+               I2C devices to the bus and starts the particle sensor.
+               Must follow SIMHAL_Initialise.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Starts the particle sensor pulse trains.
+****************************************************************************/
+void SIMDEVICES_Initialise(const TySimSettings *ptySettings)
+{
+   TySimPulseSettings tyPulses;
+
+   tyLocalSettings = *ptySettings;
+
+   ulLocalRandom = ptySettings->ulSeed & 0xFFFFFFFFul;
+   if (ulLocalRandom == 0)
+      ulLocalRandom = 1;
+
+   usLocalHDC1080Config  = SIM_HDC1080_CONFIG_DEFAULT;
+   ucLocalHDC1080Pointer = SIM_HDC1080_TEMPERATURE;
+   ullLocalHDC1080Ready  = 0;
+   SIMHAL_AttachI2CDevice(&tyLocalHDC1080);
+
+   memset(pucLocalTLC59116Registers, 0, sizeof(pucLocalTLC59116Registers));
+   ucLocalTLC59116Pointer = 0;
+   SIMHAL_AttachI2CDevice(&tyLocalTLC59116);
+
+   // The pulse trains have a generator of their own, so that they are not
+   // changed by the number of HDC1080 reads....
+   SIMPULSES_Initialise(ptySettings->ulSeed);
+
+   memset(&tyPulses, 0, sizeof(tyPulses));
+   tyPulses.tyMode = SIM_PULSES_OCCUPANCY;
+
+   tyPulses.dOccupancy = ptySettings->dP1Occupancy;
+   SIMPULSES_Start(0, &tyPulses);
+   tyPulses.dOccupancy = ptySettings->dP2Occupancy;
+   SIMPULSES_Start(1, &tyPulses);
+}
+
+
+/****************************************************************************
+     Function: SIMDEVICES_SetClimate
+     Engineer: agent
+        Input: double dTemperature: Degrees C.
+               double dHumidity: %
+       Output: N/A
+  Description: Changes the temperature and humidity that the HDC1080
+               measures from the next conversion.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIMDEVICES_SetClimate(double dTemperature, double dHumidity)
+{
+   tyLocalSettings.dTemperature = dTemperature;
+   tyLocalSettings.dHumidity    = dHumidity;
+}
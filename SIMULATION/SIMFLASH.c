@@ -0,0 +1,596 @@
+/****************************************************************************
+       Module: SIMFLASH.c
+     Engineer: agent
+  Description: Contains the simulated SimpleLink file system, over a 1 MB
+               serial flash held in a file (or in memory). It models what
+               the CC3200 file system does to the flash rather than how:
+
+                  Files are given whole 4 KB blocks when they are created,
+                  and keep them.
+                  Opening a file for writing erases its blocks.
+                  A write programs the flash, which can only clear bits, so
+                  writing a byte twice without an erase is an error.
+                  A read returns the bytes up to the end of those written.
+                  A file open for writing cannot be opened again.
+
+               The directory and the erase count of each block are kept
+               with the blocks, so that a log built up over several runs
+               can be recovered and its wear seen. The file system's own
+               bookkeeping writes are not modelled.
+
+               sl_Start stands for a reset of the network processor: any
+               open files are dropped, as they are when the power fails.
+               sl_Stop turns it off in the same way, and every command fails
+               until the next sl_Start. The time from each start to its stop
+               is counted, as the network processor draws far more than the
+               rest of the chip while it is on. SIMFLASH_TearWrite cuts
+               the power part way through a write.
+
+               Each command moves the virtual clock on by an estimate of
+               the time it takes on the target (SIMFLASH_x below), from the
+               usual SPI serial flash figures and a guess at the network
+               processor's own overhead. The counts are exact.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added sl_Stop, and the time of a start.
+17-OCT-2026    agent       A tear can be set for a later write.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "includes.h"
+#include "simplelink.h"
+#include "SIM.h"
+
+#define SIMFLASH_BLOCK_SIZE       4096
+#define SIMFLASH_BLOCKS           256
+#define SIMFLASH_PAGE_SIZE        256  // Programmed at a time.
+#define SIMFLASH_FILES            128
+#define SIMFLASH_NAME_SIZE        64
+#define SIMFLASH_HANDLES          8
+#define SIMFLASH_MAGIC            0x31464D53ul
+
+// Estimated target time of the commands, in us....
+#define SIMFLASH_COMMAND_US       100    // Host to network processor and back.
+#define SIMFLASH_BYTES_PER_US     2      // Host SPI at 20 MHz, with gaps.
+#define SIMFLASH_PROGRAM_US       700    // Program one flash page.
+#define SIMFLASH_ERASE_US         45000  // Erase one block.
+#define SIMFLASH_START_US         50000  // Network processor start.
+
+#define SIMFLASH_CYCLES_PER_US    (SIM_CLOCK_HZ / 1000000ull)
+
+#define SIMFLASH_ERROR            (-1)
+
+typedef struct
+{
+   char pcName[SIMFLASH_NAME_SIZE];
+   unsigned long ulFirstBlock;
+   unsigned long ulBlocks;           // 0 if the entry is free.
+   unsigned long ulLength;           // Up to the end of the bytes written.
+} TySimFlashFile;
+
+typedef struct
+{
+   unsigned long ulMagic;
+   TySimFlashFile ptyFiles[SIMFLASH_FILES];
+   unsigned long pulEraseCounts[SIMFLASH_BLOCKS];
+   unsigned char pucFlash[SIMFLASH_BLOCKS * SIMFLASH_BLOCK_SIZE];
+} TySimFlashImage;
+
+typedef struct
+{
+   unsigned char bOpen;
+   unsigned char bWrite;
+   unsigned long ulFile;
+} TySimFlashHandle;
+
+static TySimFlashImage *ptyLocalImage;
+static TySimFlashHandle ptyLocalHandles[SIMFLASH_HANDLES];
+static TySimFlashStatistics tyLocalStatistics;
+static unsigned char bLocalPowered;
+static TySimTime ullLocalStarted;        // When the network processor was last started.
+static unsigned char bLocalTear;
+static unsigned long ulLocalTearBytes;   // Still to be programmed before the tear.
+
+
+/****************************************************************************
+     Function: SIMFLASH_Spend
+     Engineer: agent
+        Input: unsigned long ulMicroseconds: Target time of the command.
+       Output: N/A
+  Description: Counts a command and moves the virtual clock on by its time.
+               Interrupts are taken meanwhile, as the firmware only waits
+               for the network processor.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMFLASH_Spend(unsigned long ulMicroseconds)
+{
+   unsigned long ulCycles;
+
+   ulCycles = (unsigned long)(ulMicroseconds * SIMFLASH_CYCLES_PER_US);
+
+   tyLocalStatistics.ulCommands++;
+   tyLocalStatistics.ullCycles += ulCycles;
+
+   SIM_Advance(ulCycles);
+}
+
+
+/****************************************************************************
+     Function: SIMFLASH_Erase
+     Engineer: agent
+        Input: const TySimFlashFile *ptyFile: File to erase.
+       Output: unsigned long: Target time taken, in us.
+  Description: Erases the blocks of a file.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned long SIMFLASH_Erase(const TySimFlashFile *ptyFile)
+{
+   unsigned long i;
+
+   for (i=ptyFile->ulFirstBlock; i < ptyFile->ulFirstBlock + ptyFile->ulBlocks; i++)
+      {
+      memset(&ptyLocalImage->pucFlash[i * SIMFLASH_BLOCK_SIZE], 0xFF, SIMFLASH_BLOCK_SIZE);
+      ptyLocalImage->pulEraseCounts[i]++;
+      tyLocalStatistics.ulErases++;
+      }
+
+   return ptyFile->ulBlocks * SIMFLASH_ERASE_US;
+}
+
+
+/****************************************************************************
+     Function: SIMFLASH_Find
+     Engineer: agent
+        Input: const _u8 *pucName: File name.
+       Output: long: Directory entry, or SIMFLASH_ERROR.
+  Description: Looks a file up.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static long SIMFLASH_Find(const _u8 *pucName)
+{
+   long i;
+
+   for (i=0; i < SIMFLASH_FILES; i++)
+      {
+      if ((ptyLocalImage->ptyFiles[i].ulBlocks != 0) && (strcmp(ptyLocalImage->ptyFiles[i].pcName, (const char *)pucName) == 0))
+         return i;
+      }
+
+   return SIMFLASH_ERROR;
+}
+
+
+/****************************************************************************
+     Function: SIMFLASH_Create
+     Engineer: agent
+        Input: const _u8 *pucName: File name.
+               unsigned long ulSize: Largest size of the file.
+       Output: long: Directory entry, or SIMFLASH_ERROR if there is no room.
+  Description: Adds a file, in the first run of free blocks that it fits.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static long SIMFLASH_Create(const _u8 *pucName, unsigned long ulSize)
+{
+   long lEntry, i;
+   unsigned long ulBlocks, ulFirst, ulBlock;
+   const TySimFlashFile *ptyFile;
+
+   ulBlocks = (ulSize + SIMFLASH_BLOCK_SIZE - 1) / SIMFLASH_BLOCK_SIZE;
+   if ((ulBlocks == 0) || (strlen((const char *)pucName) >= SIMFLASH_NAME_SIZE))
+      return SIMFLASH_ERROR;
+
+   lEntry = SIMFLASH_ERROR;
+   for (i=0; (i < SIMFLASH_FILES) && (lEntry == SIMFLASH_ERROR); i++)
+      {
+      if (ptyLocalImage->ptyFiles[i].ulBlocks == 0)
+         lEntry = i;
+      }
+   if (lEntry == SIMFLASH_ERROR)
+      return SIMFLASH_ERROR;
+
+   // Try each start, moving past any file in the way....
+   ulFirst = 0;
+   while (ulFirst + ulBlocks <= SIMFLASH_BLOCKS)
+      {
+      ulBlock = ulFirst;
+      for (i=0; i < SIMFLASH_FILES; i++)
+         {
+         ptyFile = &ptyLocalImage->ptyFiles[i];
+         if ((ptyFile->ulBlocks != 0) &&
+             (ptyFile->ulFirstBlock < ulFirst + ulBlocks) && (ptyFile->ulFirstBlock + ptyFile->ulBlocks > ulFirst))
+            ulBlock = ptyFile->ulFirstBlock + ptyFile->ulBlocks;
+         }
+
+      if (ulBlock == ulFirst)
+         {
+         strcpy(ptyLocalImage->ptyFiles[lEntry].pcName, (const char *)pucName);
+         ptyLocalImage->ptyFiles[lEntry].ulFirstBlock = ulFirst;
+         ptyLocalImage->ptyFiles[lEntry].ulBlocks     = ulBlocks;
+         ptyLocalImage->ptyFiles[lEntry].ulLength     = 0;
+         return lEntry;
+         }
+
+      ulFirst = ulBlock;
+      }
+
+   return SIMFLASH_ERROR;
+}
+
+
+/****************************************************************************
+     Function: SIMFLASH_Handle
+     Engineer: agent
+        Input: _i32 lHandle: Handle from sl_FsOpen.
+       Output: TySimFlashHandle *: The open file.
+  Description: Checks a handle passed by the firmware. Using a handle that is
+               not open is a bug in the firmware, so stops the simulation.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static TySimFlashHandle *SIMFLASH_Handle(_i32 lHandle)
+{
+   if ((lHandle < 0) || (lHandle >= SIMFLASH_HANDLES) || (ptyLocalHandles[lHandle].bOpen == FALSE))
+      SIM_Fatal("file handle %ld is not open", (long)lHandle);
+
+   return &ptyLocalHandles[lHandle];
+}
+
+
+/****************************************************************************
+     Function: SIMFLASH_Initialise
+     Engineer: agent
+        Input: const char *pcImage: File holding the flash, created erased if
+                  it does not exist. NULL for an erased flash in memory.
+       Output: N/A
+  Description: Initialises the simulated serial flash.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIMFLASH_Initialise(const char *pcImage)
+{
+   int iFile;
+   struct stat tyStat;
+   unsigned char bFormat;
+
+   if (pcImage == NULL)
+      {
+      ptyLocalImage = malloc(sizeof(TySimFlashImage));
+      if (ptyLocalImage == NULL)
+         SIM_Fatal("out of memory for the flash");
+      bFormat = TRUE;
+      }
+   else
+      {
+      iFile = open(pcImage, O_RDWR | O_CREAT, 0644);
+      if ((iFile < 0) || (fstat(iFile, &tyStat) != 0))
+         SIM_Fatal("cannot open the flash image %s", pcImage);
+
+      bFormat = (tyStat.st_size == 0);
+      if (bFormat && (ftruncate(iFile, sizeof(TySimFlashImage)) != 0))
+         SIM_Fatal("cannot size the flash image %s", pcImage);
+      if ((bFormat == FALSE) && (tyStat.st_size != sizeof(TySimFlashImage)))
+         SIM_Fatal("%s is not a flash image", pcImage);
+
+      ptyLocalImage = mmap(NULL, sizeof(TySimFlashImage), PROT_READ | PROT_WRITE, MAP_SHARED, iFile, 0);
+      close(iFile);
+      if (ptyLocalImage == MAP_FAILED)
+         SIM_Fatal("cannot map the flash image %s", pcImage);
+      if ((bFormat == FALSE) && (ptyLocalImage->ulMagic != SIMFLASH_MAGIC))
+         SIM_Fatal("%s is not a flash image", pcImage);
+      }
+
+   if (bFormat)
+      {
+      memset(ptyLocalImage, 0, sizeof(TySimFlashImage) - sizeof(ptyLocalImage->pucFlash));
+      memset(ptyLocalImage->pucFlash, 0xFF, sizeof(ptyLocalImage->pucFlash));
+      ptyLocalImage->ulMagic = SIMFLASH_MAGIC;
+      }
+
+   memset(ptyLocalHandles, 0, sizeof(ptyLocalHandles));
+   memset(&tyLocalStatistics, 0, sizeof(tyLocalStatistics));
+   bLocalPowered = FALSE;
+   bLocalTear    = FALSE;
+}
+
+
+/****************************************************************************
+     Function: SIMFLASH_TearWrite
+     Engineer: agent
+        Input: unsigned long ulBytes: Bytes programmed before the power
+                  fails.
+       Output: N/A
+  Description: Cuts the power once the bytes given have been programmed, by
+               the next write or those after it, which may follow an
+               sl_Start. The write the power fails in fails, and so does
+               every command until the next sl_Start.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       No longer cancelled by sl_Start.
+17-OCT-2026    agent       Counts the bytes over several writes, so that a
+                           later write can be torn.
+****************************************************************************/
+void SIMFLASH_TearWrite(unsigned long ulBytes)
+{
+   bLocalTear       = TRUE;
+   ulLocalTearBytes = ulBytes;
+}
+
+
+/****************************************************************************
+     Function: SIMFLASH_GetStatistics
+     Engineer: agent
+        Input: N/A
+       Output: const TySimFlashStatistics *: Counts since the start.
+  Description: Returns the counts of the file system commands. The on time
+               includes the network processor being on now.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Brings the on time up to date.
+****************************************************************************/
+const TySimFlashStatistics *SIMFLASH_GetStatistics(void)
+{
+   if (bLocalPowered)
+      {
+      tyLocalStatistics.ullOnCycles += SIM_GetTime() - ullLocalStarted;
+      ullLocalStarted = SIM_GetTime();
+      }
+
+   return &tyLocalStatistics;
+}
+
+
+/****************************************************************************
+     Function: SIMFLASH_GetWear
+     Engineer: agent
+        Input: unsigned long *pulBlocks: Set to the blocks held by files.
+               unsigned long *pulLeast: Set to the fewest erases of them.
+               unsigned long *pulMost: Set to the most erases of them.
+       Output: N/A
+  Description: Returns the spread of the erase counts over the blocks in
+               use, since the image was created.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIMFLASH_GetWear(unsigned long *pulBlocks, unsigned long *pulLeast, unsigned long *pulMost)
+{
+   unsigned long i, ulBlock, ulCount;
+   const TySimFlashFile *ptyFile;
+
+   *pulBlocks = 0;
+   *pulLeast  = 0;
+   *pulMost   = 0;
+
+   for (i=0; i < SIMFLASH_FILES; i++)
+      {
+      ptyFile = &ptyLocalImage->ptyFiles[i];
+
+      for (ulBlock=ptyFile->ulFirstBlock; ulBlock < ptyFile->ulFirstBlock + ptyFile->ulBlocks; ulBlock++)
+         {
+         ulCount = ptyLocalImage->pulEraseCounts[ulBlock];
+
+         if ((*pulBlocks == 0) || (ulCount < *pulLeast))
+            *pulLeast = ulCount;
+         if (ulCount > *pulMost)
+            *pulMost = ulCount;
+
+         (*pulBlocks)++;
+         }
+      }
+}
+
+
+_i16 sl_Start(const void *pIfHdl, _i8 *pDevName, const P_INIT_CALLBACK pInitCallBack)
+{
+   // A start while on is a reset, so the time so far is counted....
+   SIMFLASH_GetStatistics();
+
+   memset(ptyLocalHandles, 0, sizeof(ptyLocalHandles));
+   bLocalPowered   = TRUE;
+   ullLocalStarted = SIM_GetTime();
+
+   tyLocalStatistics.ulStarts++;
+   SIMFLASH_Spend(SIMFLASH_START_US);
+
+   return 0;
+}
+
+
+_i16 sl_Stop(const _u16 timeout)
+{
+   if (bLocalPowered == FALSE)
+      return 0;
+
+   SIMFLASH_Spend(SIMFLASH_COMMAND_US);
+   SIMFLASH_GetStatistics();
+
+   memset(ptyLocalHandles, 0, sizeof(ptyLocalHandles));
+   bLocalPowered = FALSE;
+
+   return 0;
+}
+
+
+_i32 sl_FsOpen(const _u8 *pFileName, const _u32 AccessModeAndMaxSize, _u32 *pToken, _i32 *pFileHandle)
+{
+   long lEntry, i;
+   unsigned long ulMicroseconds;
+   unsigned char bWrite;
+
+   ulMicroseconds = SIMFLASH_COMMAND_US;
+   *pFileHandle   = SIMFLASH_ERROR;
+
+   if (bLocalPowered == FALSE)
+      return SIMFLASH_ERROR;
+
+   tyLocalStatistics.ulOpens++;
+
+   lEntry = SIMFLASH_Find(pFileName);
+
+   switch (FS_MODE_ACCESS(AccessModeAndMaxSize))
+      {
+      case FS_MODE_ACCESS(FS_MODE_OPEN_READ):
+         bWrite = FALSE;
+         break;
+      case FS_MODE_ACCESS(FS_MODE_OPEN_WRITE):
+         bWrite = TRUE;
+         break;
+      default:
+         bWrite = TRUE;
+         if (lEntry != SIMFLASH_ERROR)
+            lEntry = SIMFLASH_ERROR;
+         else
+            lEntry = SIMFLASH_Create(pFileName, FS_MODE_SIZE(AccessModeAndMaxSize));
+         break;
+      }
+
+   if (lEntry == SIMFLASH_ERROR)
+      {
+      SIMFLASH_Spend(ulMicroseconds);
+      return SIMFLASH_ERROR;
+      }
+
+   // A file being written cannot be opened again....
+   for (i=0; i < SIMFLASH_HANDLES; i++)
+      {
+      if (ptyLocalHandles[i].bOpen && (ptyLocalHandles[i].ulFile == (unsigned long)lEntry) &&
+          (bWrite || ptyLocalHandles[i].bWrite))
+         {
+         SIMFLASH_Spend(ulMicroseconds);
+         return SIMFLASH_ERROR;
+         }
+      }
+
+   for (i=0; (i < SIMFLASH_HANDLES) && ptyLocalHandles[i].bOpen; i++)
+      {
+      ;;
+      }
+   if (i == SIMFLASH_HANDLES)
+      {
+      SIMFLASH_Spend(ulMicroseconds);
+      return SIMFLASH_ERROR;
+      }
+
+   if (bWrite)
+      {
+      ulMicroseconds += SIMFLASH_Erase(&ptyLocalImage->ptyFiles[lEntry]);
+      ptyLocalImage->ptyFiles[lEntry].ulLength = 0;
+      }
+
+   ptyLocalHandles[i].bOpen  = TRUE;
+   ptyLocalHandles[i].bWrite = bWrite;
+   ptyLocalHandles[i].ulFile = (unsigned long)lEntry;
+   *pFileHandle = (_i32)i;
+
+   SIMFLASH_Spend(ulMicroseconds);
+
+   return 0;
+}
+
+
+_i16 sl_FsClose(const _i32 FileHdl, const _u8 *pCeritificateFileName, const _u8 *pSignature, const _u32 SignatureLen)
+{
+   if (bLocalPowered == FALSE)
+      return SIMFLASH_ERROR;
+
+   SIMFLASH_Handle(FileHdl)->bOpen = FALSE;
+
+   SIMFLASH_Spend(SIMFLASH_COMMAND_US);
+
+   return 0;
+}
+
+
+_i32 sl_FsRead(const _i32 FileHdl, _u32 Offset, _u8 *pData, _u32 Len)
+{
+   const TySimFlashFile *ptyFile;
+   unsigned long ulLength;
+
+   if (bLocalPowered == FALSE)
+      return SIMFLASH_ERROR;
+
+   ptyFile = &ptyLocalImage->ptyFiles[SIMFLASH_Handle(FileHdl)->ulFile];
+
+   ulLength = 0;
+   if (Offset < ptyFile->ulLength)
+      {
+      ulLength = ptyFile->ulLength - Offset;
+      if (ulLength > Len)
+         ulLength = Len;
+
+      memcpy(pData, &ptyLocalImage->pucFlash[(ptyFile->ulFirstBlock * SIMFLASH_BLOCK_SIZE) + Offset], ulLength);
+      }
+
+   tyLocalStatistics.ulReads++;
+   tyLocalStatistics.ullBytesRead += ulLength;
+   SIMFLASH_Spend(SIMFLASH_COMMAND_US + (ulLength / SIMFLASH_BYTES_PER_US));
+
+   return (_i32)ulLength;
+}
+
+
+_i32 sl_FsWrite(const _i32 FileHdl, _u32 Offset, _u8 *pData, _u32 Len)
+{
+   TySimFlashHandle *ptyHandle;
+   TySimFlashFile *ptyFile;
+   unsigned char *pucFlash;
+   unsigned long i, ulLength, ulPages;
+
+   if (bLocalPowered == FALSE)
+      return SIMFLASH_ERROR;
+
+   ptyHandle = SIMFLASH_Handle(FileHdl);
+   ptyFile   = &ptyLocalImage->ptyFiles[ptyHandle->ulFile];
+
+   if ((ptyHandle->bWrite == FALSE) || (Offset + Len > ptyFile->ulBlocks * SIMFLASH_BLOCK_SIZE))
+      {
+      SIMFLASH_Spend(SIMFLASH_COMMAND_US);
+      return SIMFLASH_ERROR;
+      }
+
+   ulLength = Len;
+   if (bLocalTear && (ulLocalTearBytes < ulLength))
+      ulLength = ulLocalTearBytes;
+   if (bLocalTear)
+      ulLocalTearBytes -= ulLength;
+
+   pucFlash = &ptyLocalImage->pucFlash[(ptyFile->ulFirstBlock * SIMFLASH_BLOCK_SIZE) + Offset];
+   for (i=0; i < ulLength; i++)
+      {
+      if ((pucFlash[i] & pData[i]) != pData[i])
+         SIM_Fatal("%s written twice at %lu without an erase", ptyFile->pcName, (unsigned long)(Offset + i));
+
+      pucFlash[i] &= pData[i];
+      }
+
+   if (Offset + ulLength > ptyFile->ulLength)
+      ptyFile->ulLength = Offset + ulLength;
+
+   ulPages = 0;
+   if (ulLength != 0)
+      ulPages = ((Offset + ulLength - 1) / SIMFLASH_PAGE_SIZE) - (Offset / SIMFLASH_PAGE_SIZE) + 1;
+
+   tyLocalStatistics.ulWrites++;
+   tyLocalStatistics.ullBytesWritten += ulLength;
+   SIMFLASH_Spend(SIMFLASH_COMMAND_US + (ulLength / SIMFLASH_BYTES_PER_US) + (ulPages * SIMFLASH_PROGRAM_US));
+
+   if (bLocalTear && (ulLocalTearBytes == 0))
+      {
+      // The power has gone....
+      SIMFLASH_GetStatistics();
+      bLocalTear    = FALSE;
+      bLocalPowered = FALSE;
+      memset(ptyLocalHandles, 0, sizeof(ptyLocalHandles));
+      return SIMFLASH_ERROR;
+      }
+
+   return (_i32)ulLength;
+}
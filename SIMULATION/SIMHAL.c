@@ -0,0 +1,1871 @@
+/****************************************************************************
+       Module: SIMHAL.c
+     Engineer: agent
+  Description: Contains the simulated driverlib and common interface (the
+               *_IF) functions used by the firmware, and the peripherals
+               behind them:
+
+                  SysTick      24 bit down counter, as DELAY.c programs it
+                               (including writes to NVIC_ST_CURRENT).
+                  Timers       Periodic (TIMERA0, for Timer_IF) and edge
+                               time capture (PPD42NJ_TIMER_CAPTURE builds).
+                  GPIO         Edge interrupts on the inputs.
+                  UART         Console transmit through a 16 byte FIFO at
+                               115200 baud, captured to a file. Console
+                               input through a 16 byte receive FIFO, fed
+                               by SIMHAL_ConsoleInput.
+                  I2C          Master, at 100 or 400 kHz, talking to the
+                               device models attached to the bus.
+
+               The firmware's inputs are driven by SIMHAL_DriveInput, which
+               routes each edge to the GPIO port or capture timer the pin is
+               muxed to.
+
+               Registers that the firmware polls cost SIM_POLL_CYCLES a read,
+               so that busy waits move the virtual clock on.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added SIMHAL_GetTimerStart. The inputs start high.
+17-OCT-2026    agent       Added the DWT cycle counter and the console input.
+17-OCT-2026    agent       UARTConfigSetExpClk in place of the uart_if
+                           functions, which the firmware no longer uses.
+17-OCT-2026    agent       GPIO reads follow a pin muxed to a capture timer.
+17-OCT-2026    agent       SIMHAL_DriveInput reports an edge that is lost.
+****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "includes.h"
+#include "systick.h"
+#include "hw_nvic.h"
+#include "i2c.h"
+#include "uart.h"
+#include "SIM.h"
+
+#define SIM_PIN_COUNT             64
+
+#define SIM_GPIO_PORT_COUNT       4
+#define SIM_GPIO_PORT_SPACING     (GPIOA1_BASE - GPIOA0_BASE)
+
+#define SIM_TIMER_COUNT           4
+#define SIM_TIMER_SPACING         (TIMERA1_BASE - TIMERA0_BASE)
+
+// Timer configuration, in the 8 bits for each half of the timer....
+#define SIM_TIMER_MODE_MASK       0x0F
+#define SIM_TIMER_MODE_ONE_SHOT   0x01
+#define SIM_TIMER_MODE_PERIODIC   0x02
+#define SIM_TIMER_MODE_CAP_TIME   0x07
+#define SIM_TIMER_COUNT_UP        0x10
+
+// Edge selection, in the 8 bits for each half of TimerControlEvent....
+#define SIM_TIMER_EDGE_MASK       0x0C
+#define SIM_TIMER_EDGE_POSITIVE   0x00
+#define SIM_TIMER_EDGE_NEGATIVE   0x04
+
+#define SIM_UART_FIFO_SIZE        16
+#define SIM_UART_RX_FIFO_SIZE     16
+#define SIM_UART_BYTE_CYCLES      ((SIM_CLOCK_HZ * 10) / UART_BAUD_RATE) // Start, 8 data, stop.
+
+#define SIM_I2C_BITS_PER_BYTE     9 // 8 data bits and the acknowledge.
+#define SIM_I2C_CMD_RUN           0x01
+#define SIM_I2C_CMD_START         0x02
+#define SIM_I2C_CMD_STOP          0x04
+#define SIM_I2C_CMD_ACK           0x08
+#define SIM_I2C_MAX_DEVICES       4
+
+// The value read back from NVIC_ST_CURRENT until the firmware writes to it....
+#define SIM_REGISTER_UNWRITTEN    0xA5A5A5A5ul
+
+// Cortex-M4 debug registers used by PROFILE.c....
+#define SIM_DEMCR                 0xE000EDFC
+#define SIM_DWT_CTRL              0xE0001000
+#define SIM_DWT_CYCCNT            0xE0001004
+
+// One half of a general purpose timer....
+typedef struct
+{
+   unsigned long ulConfig;           // SIM_TIMER_MODE_x | SIM_TIMER_COUNT_UP
+   unsigned long ulLoad;
+   unsigned long ulPrescale;
+   unsigned long ulEdge;             // SIM_TIMER_EDGE_x
+   unsigned char bEnabled;
+   TySimTime ullStart;
+   unsigned long ulCaptured;
+   TySimEvent tyTimeout;
+} TySimTimerHalf;
+
+typedef struct
+{
+   TySimTimerHalf ptyHalves[0x2];    // TIMER_A, TIMER_B
+   unsigned long ulIntMask;
+   unsigned long ulIntStatus;
+} TySimTimer;
+
+typedef struct
+{
+   unsigned char ucLevels;
+   unsigned char ucIntMask;
+   unsigned char ucIntStatus;
+   unsigned long pulIntType[0x8];
+} TySimGpioPort;
+
+// An input pin, and where its edges go depending on how it is muxed....
+typedef struct
+{
+   unsigned long ulPin;
+   unsigned long ulGpioBase;
+   unsigned char ucGpioPin;
+   unsigned long ulTimerBase;
+   unsigned long ulTimer;
+} TySimInputPin;
+
+static const TySimInputPin ptyLocalInputPins[] =
+{
+   {PIN_03, GPIOA1_BASE, GPIO_INT_PIN_4, TIMERA1_BASE, TIMER_B},   // GPIO12, GT_CCP03
+   {PIN_04, GPIOA1_BASE, GPIO_INT_PIN_5, TIMERA2_BASE, TIMER_A}    // GPIO13, GT_CCP04
+};
+
+static const unsigned long pulLocalTimerInterrupts[SIM_TIMER_COUNT][0x2] =
+{
+   {INT_TIMERA0A, INT_TIMERA0B},
+   {INT_TIMERA1A, INT_TIMERA1B},
+   {INT_TIMERA2A, INT_TIMERA2B},
+   {INT_TIMERA3A, INT_TIMERA3B}
+};
+
+static const unsigned char pucLocalUartTxLevels[] = {2, 4, 8, 12, 14};
+
+static unsigned char pucLocalPinModes[SIM_PIN_COUNT];
+
+static unsigned long ulLocalSysTickLoad;
+static unsigned long ulLocalSysTickLoaded;
+static TySimTime ullLocalSysTickReload;
+static unsigned char bLocalSysTickEnabled;
+static unsigned char bLocalSysTickIntEnabled;
+static TySimEvent tyLocalSysTickEvent;
+
+static volatile unsigned long ulLocalCurrentRegister;
+static volatile unsigned long ulLocalIntCtrlRegister;
+static volatile unsigned long ulLocalDemcrRegister;
+static volatile unsigned long ulLocalDwtCtrlRegister;
+static volatile unsigned long ulLocalCycleCountRegister;
+
+static TySimTimer ptyLocalTimers[SIM_TIMER_COUNT];
+static TySimGpioPort ptyLocalGpioPorts[SIM_GPIO_PORT_COUNT];
+
+static FILE *ptyLocalUartCapture;
+static unsigned char pucLocalUartFifo[SIM_UART_FIFO_SIZE];
+static unsigned char ucLocalUartFifoHead;
+static unsigned char ucLocalUartFifoCount;
+static unsigned char ucLocalUartShift;
+static unsigned char bLocalUartShifting;
+static unsigned char ucLocalUartTxLevel;
+static unsigned char bLocalUartEndOfTransmission;
+static unsigned long ulLocalUartIntMask;
+static unsigned long ulLocalUartIntStatus;
+static TySimEvent tyLocalUartEvent;
+static unsigned char pucLocalUartRxFifo[SIM_UART_RX_FIFO_SIZE];
+static unsigned char ucLocalUartRxFifoHead;
+static unsigned char ucLocalUartRxFifoCount;
+
+static const TySimI2CDevice *pptyLocalI2CDevices[SIM_I2C_MAX_DEVICES];
+static unsigned char ucLocalI2CDeviceCount;
+static const TySimI2CDevice *ptyLocalI2CSelected;
+static unsigned char ucLocalI2CAddress;
+static unsigned char bLocalI2CReceive;
+static unsigned char ucLocalI2CTxData;
+static unsigned char ucLocalI2CRxData;
+static unsigned char bLocalI2CBusy;
+static unsigned long ulLocalI2CCommand;
+static unsigned long ulLocalI2CError;
+static unsigned long ulLocalI2CIntMask;
+static unsigned long ulLocalI2CIntStatus;
+static unsigned long ulLocalI2CBitCycles;
+static TySimEvent tyLocalI2CEvent;
+
+
+/****************************************************************************
+     Function: SIMHAL_Half
+     Engineer: agent
+        Input: unsigned long ulTimer: TIMER_A or TIMER_B.
+       Output: unsigned char: 0 for TIMER_A, 1 for TIMER_B.
+  Description: Returns the index of a timer half.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SIMHAL_Half(unsigned long ulTimer)
+{
+   return (ulTimer == TIMER_B) ? 1 : 0;
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_Timer
+     Engineer: agent
+        Input: unsigned long ulBase: Timer base address.
+       Output: unsigned char: Timer index.
+  Description: Returns the index of a timer from its base address.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SIMHAL_Timer(unsigned long ulBase)
+{
+   unsigned long ulIndex;
+
+   ulIndex = (ulBase - TIMERA0_BASE) / SIM_TIMER_SPACING;
+
+   if ((ulBase < TIMERA0_BASE) || (ulIndex >= SIM_TIMER_COUNT) || ((ulBase - TIMERA0_BASE) % SIM_TIMER_SPACING))
+      SIM_Fatal("timer 0x%08lx is not simulated", ulBase);
+
+   return (unsigned char)ulIndex;
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_Port
+     Engineer: agent
+        Input: unsigned long ulBase: GPIO port base address.
+       Output: unsigned char: Port index.
+  Description: Returns the index of a GPIO port from its base address.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SIMHAL_Port(unsigned long ulBase)
+{
+   unsigned long ulIndex;
+
+   ulIndex = (ulBase - GPIOA0_BASE) / SIM_GPIO_PORT_SPACING;
+
+   if ((ulBase < GPIOA0_BASE) || (ulIndex >= SIM_GPIO_PORT_COUNT) || ((ulBase - GPIOA0_BASE) % SIM_GPIO_PORT_SPACING))
+      SIM_Fatal("GPIO port 0x%08lx is not simulated", ulBase);
+
+   return (unsigned char)ulIndex;
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_CheckUart
+     Engineer: agent
+        Input: unsigned long ulBase: UART base address.
+       Output: N/A
+  Description: Only the console UART is simulated.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMHAL_CheckUart(unsigned long ulBase)
+{
+   if (ulBase != CONSOLE)
+      SIM_Fatal("UART 0x%08lx is not simulated", ulBase);
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_CheckI2C
+     Engineer: agent
+        Input: unsigned long ulBase: I2C base address.
+       Output: N/A
+  Description: There is only the one I2C peripheral.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMHAL_CheckI2C(unsigned long ulBase)
+{
+   if (ulBase != I2CA0_BASE)
+      SIM_Fatal("I2C 0x%08lx is not simulated", ulBase);
+}
+
+
+/* ======================================================================== */
+/*  SysTick                                                                 */
+/* ======================================================================== */
+
+static void SIMHAL_SysTickReload(TySimEvent *ptyEvent);
+
+/****************************************************************************
+     Function: SIMHAL_SysTickZero
+     Engineer: agent
+        Input: TySimEvent *ptyEvent: SysTick event.
+       Output: N/A
+  Description: The count has reached zero. The interrupt is raised, and the
+               counter reloads on the next cycle.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMHAL_SysTickZero(TySimEvent *ptyEvent)
+{
+   if (bLocalSysTickIntEnabled)
+      SIM_SetPending(FAULT_SYSTICK);
+
+   SIM_Schedule(ptyEvent, SIM_GetTime() + 1, SIMHAL_SysTickReload);
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_SysTickReload
+     Engineer: agent
+        Input: TySimEvent *ptyEvent: SysTick event.
+       Output: N/A
+  Description: The counter reloads from the reload register, as it is at
+               the time, and counts down to zero again.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMHAL_SysTickReload(TySimEvent *ptyEvent)
+{
+   ullLocalSysTickReload = SIM_GetTime();
+   ulLocalSysTickLoaded  = ulLocalSysTickLoad;
+
+   if (ulLocalSysTickLoaded == 0)
+      SIM_Schedule(ptyEvent, ullLocalSysTickReload + 1, SIMHAL_SysTickReload);
+   else
+      SIM_Schedule(ptyEvent, ullLocalSysTickReload + ulLocalSysTickLoaded, SIMHAL_SysTickZero);
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_SysTickClear
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Clears the counter to zero, without raising the interrupt.
+               It reloads on the next cycle.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMHAL_SysTickClear(void)
+{
+   ullLocalSysTickReload = SIM_GetTime();
+   ulLocalSysTickLoaded  = 0;
+
+   if (bLocalSysTickEnabled)
+      SIM_Schedule(&tyLocalSysTickEvent, ullLocalSysTickReload + 1, SIMHAL_SysTickReload);
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_CheckRegisterWrites
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Handles a write by the firmware to NVIC_ST_CURRENT. HWREG
+               gives the firmware the address of a variable, so the write
+               is only seen on the next SysTick access; DELAY.c always reads
+               the count straight after writing it.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMHAL_CheckRegisterWrites(void)
+{
+   if (ulLocalCurrentRegister != SIM_REGISTER_UNWRITTEN)
+      {
+      ulLocalCurrentRegister = SIM_REGISTER_UNWRITTEN;
+      SIMHAL_SysTickClear();
+      }
+}
+
+
+/****************************************************************************
+     Function: SIM_Register
+     Engineer: agent
+        Input: unsigned long ulAddress: Register address.
+       Output: volatile unsigned long *: Where to read or write it.
+  Description: Simulates the registers that the firmware accesses directly
+               with HWREG: the SysTick current value (written to clear it),
+               the interrupt control and state register (read for the
+               SysTick pending bit) and the DWT cycle counter and its enables.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added the DWT cycle counter. It reads the virtual
+                           clock, as wide as an unsigned long on the host.
+17-OCT-2026    agent       The DWT cycle counter is 32 bits, as on the
+                           target.
+****************************************************************************/
+volatile unsigned long *SIM_Register(unsigned long ulAddress)
+{
+   SIMHAL_CheckRegisterWrites();
+
+   switch (ulAddress)
+      {
+      case NVIC_ST_CURRENT:
+         return &ulLocalCurrentRegister;
+
+      case NVIC_INT_CTRL:
+         ulLocalIntCtrlRegister = SIM_IsPending(FAULT_SYSTICK) ? NVIC_INT_CTRL_PEND_SYST : 0;
+         return &ulLocalIntCtrlRegister;
+
+      case SIM_DEMCR:
+         return &ulLocalDemcrRegister;
+
+      case SIM_DWT_CTRL:
+         return &ulLocalDwtCtrlRegister;
+
+      case SIM_DWT_CYCCNT:
+         ulLocalCycleCountRegister = (unsigned long)(SIM_GetTime() & 0xFFFFFFFFull);
+         return &ulLocalCycleCountRegister;
+
+      default:
+         SIM_Fatal("register 0x%08lx is not simulated", ulAddress);
+      break;
+      }
+
+   return NULL;
+}
+
+
+void SysTickEnable(void)
+{
+   SIMHAL_CheckRegisterWrites();
+
+   bLocalSysTickEnabled = TRUE;
+   SIMHAL_SysTickClear();
+}
+
+
+void SysTickDisable(void)
+{
+   bLocalSysTickEnabled = FALSE;
+   SIM_Cancel(&tyLocalSysTickEvent);
+}
+
+
+void SysTickIntRegister(void (*pfnHandler)(void))
+{
+   SIM_RegisterInterrupt(FAULT_SYSTICK, pfnHandler);
+}
+
+
+void SysTickIntEnable(void)
+{
+   bLocalSysTickIntEnabled = TRUE;
+}
+
+
+void SysTickIntDisable(void)
+{
+   bLocalSysTickIntEnabled = FALSE;
+}
+
+
+void SysTickPeriodSet(unsigned long ulPeriod)
+{
+   SIMHAL_CheckRegisterWrites();
+
+   if ((ulPeriod < 1) || (ulPeriod > 0x01000000))
+      SIM_Fatal("SysTick period %lu is out of range", ulPeriod);
+
+   // Takes effect at the next reload....
+   ulLocalSysTickLoad = ulPeriod - 1;
+}
+
+
+unsigned long SysTickPeriodGet(void)
+{
+   return ulLocalSysTickLoad + 1;
+}
+
+
+unsigned long SysTickValueGet(void)
+{
+   unsigned long ulValue;
+   TySimTime ullElapsed;
+
+   // The count is read a cycle into the poll, so that a read straight after
+   // clearing the count sees the reload (DELAY.c relies on this with the
+   // shortest period, 2, when a fixed poll time could always see 0)....
+   SIMHAL_CheckRegisterWrites();
+   SIM_Advance(1);
+
+   ulValue = 0;
+   if (bLocalSysTickEnabled)
+      {
+      ullElapsed = SIM_GetTime() - ullLocalSysTickReload;
+      if (ullElapsed < ulLocalSysTickLoaded)
+         ulValue = ulLocalSysTickLoaded - (unsigned long)ullElapsed;
+      }
+
+   SIM_Advance(SIM_POLL_CYCLES - 1);
+
+   return ulValue;
+}
+
+
+/* ======================================================================== */
+/*  Interrupt controller, power and pin mux                                 */
+/* ======================================================================== */
+
+tBoolean IntMasterEnable(void)
+{
+   return SIM_MasterEnable();
+}
+
+
+tBoolean IntMasterDisable(void)
+{
+   return SIM_MasterDisable();
+}
+
+
+void IntVTableBaseSet(unsigned long ulVtableBase)
+{
+}
+
+
+void IntRegister(unsigned long ulInterrupt, void (*pfnHandler)(void))
+{
+   SIM_RegisterInterrupt(ulInterrupt, pfnHandler);
+}
+
+
+void IntEnable(unsigned long ulInterrupt)
+{
+   SIM_EnableInterrupt(ulInterrupt);
+}
+
+
+void IntPendSet(unsigned long ulInterrupt)
+{
+   SIM_SetPending(ulInterrupt);
+   SIM_Advance(0);
+}
+
+
+void IntPrioritySet(unsigned long ulInterrupt, unsigned char ucPriority)
+{
+}
+
+
+void PRCMCC3200MCUInit(void)
+{
+}
+
+
+void PRCMPeripheralClkEnable(unsigned long ulPeripheral, unsigned long ulClkFlags)
+{
+}
+
+
+void PRCMPeripheralClkDisable(unsigned long ulPeripheral, unsigned long ulClkFlags)
+{
+}
+
+
+void PRCMPeripheralReset(unsigned long ulPeripheral)
+{
+}
+
+
+unsigned long PRCMPeripheralClockGet(unsigned long ulPeripheral)
+{
+   return (unsigned long)SIM_CLOCK_HZ;
+}
+
+
+void PRCMSleepEnter(void)
+{
+   SIMHAL_CheckRegisterWrites();
+   SIM_Sleep();
+}
+
+
+void UtilsDelay(unsigned long ulCount)
+{
+   // Three cycles a loop....
+   SIM_Advance(ulCount * 3);
+}
+
+
+void PinModeSet(unsigned long ulPin, unsigned long ulPinMode)
+{
+   if (ulPin < SIM_PIN_COUNT)
+      pucLocalPinModes[ulPin] = (unsigned char)ulPinMode;
+}
+
+
+void PinTypeGPIO(unsigned long ulPin, unsigned long ulPinMode, tBoolean bOpenDrain)
+{
+   PinModeSet(ulPin, ulPinMode);
+}
+
+
+void PinTypeUART(unsigned long ulPin, unsigned long ulPinMode)
+{
+   PinModeSet(ulPin, ulPinMode);
+}
+
+
+void PinTypeI2C(unsigned long ulPin, unsigned long ulPinMode)
+{
+   PinModeSet(ulPin, ulPinMode);
+}
+
+
+void PinTypeTimer(unsigned long ulPin, unsigned long ulPinMode)
+{
+   PinModeSet(ulPin, ulPinMode);
+}
+
+
+/* ======================================================================== */
+/*  Timers                                                                  */
+/* ======================================================================== */
+
+/****************************************************************************
+     Function: SIMHAL_TimerUpdateLines
+     Engineer: agent
+        Input: unsigned char ucTimer: Timer index.
+       Output: N/A
+  Description: Sets the interrupt lines of both halves of a timer from its
+               status and mask.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMHAL_TimerUpdateLines(unsigned char ucTimer)
+{
+   unsigned long ulActive;
+
+   ulActive = ptyLocalTimers[ucTimer].ulIntStatus & ptyLocalTimers[ucTimer].ulIntMask;
+
+   SIM_SetInterruptLine(pulLocalTimerInterrupts[ucTimer][0], (ulActive & TIMER_A) ? TRUE : FALSE);
+   SIM_SetInterruptLine(pulLocalTimerInterrupts[ucTimer][1], (ulActive & TIMER_B) ? TRUE : FALSE);
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_TimerPeriod
+     Engineer: agent
+        Input: const TySimTimerHalf *ptyHalf: Timer half.
+       Output: unsigned long: Cycles in one period of the count.
+  Description: Returns the length of the count. Capture mode uses the
+               prescaler as an 8 bit extension of the count.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned long SIMHAL_TimerPeriod(const TySimTimerHalf *ptyHalf)
+{
+   if ((ptyHalf->ulConfig & SIM_TIMER_MODE_MASK) == SIM_TIMER_MODE_CAP_TIME)
+      return (((ptyHalf->ulPrescale & 0xFF) << 16) | (ptyHalf->ulLoad & 0xFFFF)) + 1;
+
+   return (ptyHalf->ulLoad == 0) ? 1 : ptyHalf->ulLoad;
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_TimerCount
+     Engineer: agent
+        Input: const TySimTimerHalf *ptyHalf: Timer half.
+       Output: unsigned long: Current count.
+  Description: Works out the free running count from the time the timer
+               was enabled.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned long SIMHAL_TimerCount(const TySimTimerHalf *ptyHalf)
+{
+   unsigned long ulPeriod, ulTicks;
+
+   if (ptyHalf->bEnabled == FALSE)
+      return 0;
+
+   ulPeriod = SIMHAL_TimerPeriod(ptyHalf);
+   ulTicks  = (unsigned long)((SIM_GetTime() - ptyHalf->ullStart) % ulPeriod);
+
+   if (ptyHalf->ulConfig & SIM_TIMER_COUNT_UP)
+      return ulTicks;
+
+   return (ulPeriod - 1) - ulTicks;
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_TimerTimeout
+     Engineer: agent
+        Input: TySimEvent *ptyEvent: Timeout event of the timer half.
+       Output: N/A
+  Description: The end of a period of a periodic or one shot timer.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMHAL_TimerTimeout(TySimEvent *ptyEvent)
+{
+   unsigned char ucTimer, ucHalf;
+   TySimTimerHalf *ptyHalf;
+
+   ucTimer = (unsigned char)(((unsigned long)(uintptr_t)ptyEvent->pvContext) >> 1);
+   ucHalf  = (unsigned char)(((unsigned long)(uintptr_t)ptyEvent->pvContext) & 1);
+   ptyHalf = &ptyLocalTimers[ucTimer].ptyHalves[ucHalf];
+
+   ptyLocalTimers[ucTimer].ulIntStatus |= ucHalf ? TIMER_TIMB_TIMEOUT : TIMER_TIMA_TIMEOUT;
+   SIMHAL_TimerUpdateLines(ucTimer);
+
+   if ((ptyHalf->ulConfig & SIM_TIMER_MODE_MASK) == SIM_TIMER_MODE_PERIODIC)
+      SIM_Schedule(ptyEvent, ptyEvent->ullTime + SIMHAL_TimerPeriod(ptyHalf), SIMHAL_TimerTimeout);
+   else
+      ptyHalf->bEnabled = FALSE;
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_TimerEdge
+     Engineer: agent
+        Input: unsigned long ulBase: Timer base address.
+               unsigned long ulTimer: TIMER_A or TIMER_B.
+               unsigned char ucLevel: New level of the capture input.
+       Output: N/A
+       Output: unsigned char: FALSE if the edge was lost, as the capture
+                  event of the last one had not been cleared.
+  Description: An edge on a capture input. If the timer half is capturing
+               that edge the count is latched and the capture event raised.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Reports a lost edge.
+****************************************************************************/
+static unsigned char SIMHAL_TimerEdge(unsigned long ulBase, unsigned long ulTimer, unsigned char ucLevel)
+{
+   unsigned char ucTimer, ucHalf, bTaken;
+   unsigned long ulEvent;
+   TySimTimerHalf *ptyHalf;
+
+   ucTimer = SIMHAL_Timer(ulBase);
+   ucHalf  = SIMHAL_Half(ulTimer);
+   ptyHalf = &ptyLocalTimers[ucTimer].ptyHalves[ucHalf];
+   ulEvent = ucHalf ? TIMER_CAPB_EVENT : TIMER_CAPA_EVENT;
+
+   if ((ptyHalf->bEnabled == FALSE) || ((ptyHalf->ulConfig & SIM_TIMER_MODE_MASK) != SIM_TIMER_MODE_CAP_TIME))
+      return TRUE;
+
+   if (((ptyHalf->ulEdge == SIM_TIMER_EDGE_POSITIVE) && (ucLevel == 0)) ||
+       ((ptyHalf->ulEdge == SIM_TIMER_EDGE_NEGATIVE) && (ucLevel != 0)))
+      {
+      return TRUE;
+      }
+
+   // The new count overwrites the one latched on the last edge....
+   bTaken = (ptyLocalTimers[ucTimer].ulIntStatus & ulEvent) ? FALSE : TRUE;
+   ptyHalf->ulCaptured = SIMHAL_TimerCount(ptyHalf);
+
+   ptyLocalTimers[ucTimer].ulIntStatus |= ulEvent;
+   SIMHAL_TimerUpdateLines(ucTimer);
+
+   return bTaken;
+}
+
+
+void TimerConfigure(unsigned long ulBase, unsigned long ulConfig)
+{
+   unsigned char ucTimer;
+   TySimTimer *ptyTimer;
+
+   ucTimer  = SIMHAL_Timer(ulBase);
+   ptyTimer = &ptyLocalTimers[ucTimer];
+
+   // Configuring a timer stops both halves....
+   TimerDisable(ulBase, TIMER_BOTH);
+
+   ptyTimer->ptyHalves[0].ulConfig = ulConfig & 0xFF;
+   if (ulConfig & TIMER_CFG_SPLIT_PAIR)
+      ptyTimer->ptyHalves[1].ulConfig = (ulConfig >> 8) & 0xFF;
+   else
+      ptyTimer->ptyHalves[1].ulConfig = 0;
+}
+
+
+void TimerEnable(unsigned long ulBase, unsigned long ulTimer)
+{
+   unsigned char ucTimer, ucHalf, ucMode;
+   TySimTimerHalf *ptyHalf;
+
+   ucTimer = SIMHAL_Timer(ulBase);
+
+   for (ucHalf=0; ucHalf < 0x2; ucHalf++)
+      {
+      if ((ulTimer & (ucHalf ? TIMER_B : TIMER_A)) == 0)
+         continue;
+
+      ptyHalf = &ptyLocalTimers[ucTimer].ptyHalves[ucHalf];
+      ptyHalf->bEnabled = TRUE;
+      ptyHalf->ullStart = SIM_GetTime();
+
+      ptyHalf->tyTimeout.pvContext = (void *)(uintptr_t)((ucTimer << 1) | ucHalf);
+
+      ucMode = (unsigned char)(ptyHalf->ulConfig & SIM_TIMER_MODE_MASK);
+      if ((ucMode == SIM_TIMER_MODE_PERIODIC) || (ucMode == SIM_TIMER_MODE_ONE_SHOT))
+         SIM_Schedule(&ptyHalf->tyTimeout, ptyHalf->ullStart + SIMHAL_TimerPeriod(ptyHalf), SIMHAL_TimerTimeout);
+      }
+}
+
+
+void TimerDisable(unsigned long ulBase, unsigned long ulTimer)
+{
+   unsigned char ucTimer, ucHalf;
+   TySimTimerHalf *ptyHalf;
+
+   ucTimer = SIMHAL_Timer(ulBase);
+
+   for (ucHalf=0; ucHalf < 0x2; ucHalf++)
+      {
+      if ((ulTimer & (ucHalf ? TIMER_B : TIMER_A)) == 0)
+         continue;
+
+      ptyHalf = &ptyLocalTimers[ucTimer].ptyHalves[ucHalf];
+      ptyHalf->bEnabled = FALSE;
+      SIM_Cancel(&ptyHalf->tyTimeout);
+      }
+}
+
+
+void TimerControlEvent(unsigned long ulBase, unsigned long ulTimer, unsigned long ulEvent)
+{
+   unsigned char ucTimer;
+
+   ucTimer = SIMHAL_Timer(ulBase);
+
+   if (ulTimer & TIMER_A)
+      ptyLocalTimers[ucTimer].ptyHalves[0].ulEdge = ulEvent & SIM_TIMER_EDGE_MASK;
+   if (ulTimer & TIMER_B)
+      ptyLocalTimers[ucTimer].ptyHalves[1].ulEdge = (ulEvent >> 8) & SIM_TIMER_EDGE_MASK;
+}
+
+
+void TimerPrescaleSet(unsigned long ulBase, unsigned long ulTimer, unsigned long ulValue)
+{
+   unsigned char ucTimer;
+
+   ucTimer = SIMHAL_Timer(ulBase);
+
+   if (ulTimer & TIMER_A)
+      ptyLocalTimers[ucTimer].ptyHalves[0].ulPrescale = ulValue;
+   if (ulTimer & TIMER_B)
+      ptyLocalTimers[ucTimer].ptyHalves[1].ulPrescale = ulValue;
+}
+
+
+void TimerLoadSet(unsigned long ulBase, unsigned long ulTimer, unsigned long ulValue)
+{
+   unsigned char ucTimer;
+
+   ucTimer = SIMHAL_Timer(ulBase);
+
+   if (ulTimer & TIMER_A)
+      ptyLocalTimers[ucTimer].ptyHalves[0].ulLoad = ulValue;
+   if (ulTimer & TIMER_B)
+      ptyLocalTimers[ucTimer].ptyHalves[1].ulLoad = ulValue;
+}
+
+
+unsigned long TimerValueGet(unsigned long ulBase, unsigned long ulTimer)
+{
+   TySimTimerHalf *ptyHalf;
+
+   ptyHalf = &ptyLocalTimers[SIMHAL_Timer(ulBase)].ptyHalves[SIMHAL_Half(ulTimer)];
+
+   // In edge time mode the register holds the count latched on the edge....
+   if ((ptyHalf->ulConfig & SIM_TIMER_MODE_MASK) == SIM_TIMER_MODE_CAP_TIME)
+      return ptyHalf->ulCaptured;
+
+   return SIMHAL_TimerCount(ptyHalf);
+}
+
+
+void TimerIntRegister(unsigned long ulBase, unsigned long ulTimer, void (*pfnHandler)(void))
+{
+   unsigned char ucTimer;
+
+   ucTimer = SIMHAL_Timer(ulBase);
+
+   if (ulTimer & TIMER_A)
+      SIM_RegisterInterrupt(pulLocalTimerInterrupts[ucTimer][0], pfnHandler);
+   if (ulTimer & TIMER_B)
+      SIM_RegisterInterrupt(pulLocalTimerInterrupts[ucTimer][1], pfnHandler);
+}
+
+
+void TimerIntEnable(unsigned long ulBase, unsigned long ulIntFlags)
+{
+   unsigned char ucTimer;
+
+   ucTimer = SIMHAL_Timer(ulBase);
+
+   ptyLocalTimers[ucTimer].ulIntMask |= ulIntFlags;
+   SIMHAL_TimerUpdateLines(ucTimer);
+}
+
+
+void TimerIntDisable(unsigned long ulBase, unsigned long ulIntFlags)
+{
+   unsigned char ucTimer;
+
+   ucTimer = SIMHAL_Timer(ulBase);
+
+   ptyLocalTimers[ucTimer].ulIntMask &= ~ulIntFlags;
+   SIMHAL_TimerUpdateLines(ucTimer);
+}
+
+
+unsigned long TimerIntStatus(unsigned long ulBase, tBoolean bMasked)
+{
+   TySimTimer *ptyTimer;
+
+   ptyTimer = &ptyLocalTimers[SIMHAL_Timer(ulBase)];
+
+   return bMasked ? (ptyTimer->ulIntStatus & ptyTimer->ulIntMask) : ptyTimer->ulIntStatus;
+}
+
+
+void TimerIntClear(unsigned long ulBase, unsigned long ulIntFlags)
+{
+   unsigned char ucTimer;
+
+   ucTimer = SIMHAL_Timer(ulBase);
+
+   ptyLocalTimers[ucTimer].ulIntStatus &= ~ulIntFlags;
+   SIMHAL_TimerUpdateLines(ucTimer);
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_GetTimerStart
+     Engineer: agent
+        Input: unsigned long ulBase: Timer base address.
+               unsigned long ulTimer: TIMER_A or TIMER_B.
+       Output: TySimTime: Time the timer was last enabled.
+  Description: Returns when a timer was started, i.e. the start of its first
+               period.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+TySimTime SIMHAL_GetTimerStart(unsigned long ulBase, unsigned long ulTimer)
+{
+   return ptyLocalTimers[SIMHAL_Timer(ulBase)].ptyHalves[SIMHAL_Half(ulTimer)].ullStart;
+}
+
+
+void Timer_IF_Init(unsigned long ePeripheral, unsigned long ulBase, unsigned long ulConfig, unsigned long ulTimer, unsigned long ulValue)
+{
+   MAP_PRCMPeripheralClkEnable(ePeripheral, PRCM_RUN_MODE_CLK);
+   MAP_PRCMPeripheralReset(ePeripheral);
+   MAP_TimerConfigure(ulBase, ulConfig);
+   MAP_TimerPrescaleSet(ulBase, ulTimer, ulValue);
+}
+
+
+void Timer_IF_IntSetup(unsigned long ulBase, unsigned long ulTimer, void (*TimerBaseIntHandler)(void))
+{
+   MAP_TimerIntRegister(ulBase, ulTimer, TimerBaseIntHandler);
+   MAP_TimerIntEnable(ulBase, (ulTimer == TIMER_B) ? TIMER_TIMB_TIMEOUT : TIMER_TIMA_TIMEOUT);
+}
+
+
+void Timer_IF_InterruptClear(unsigned long ulBase)
+{
+   MAP_TimerIntClear(ulBase, MAP_TimerIntStatus(ulBase, true));
+}
+
+
+void Timer_IF_Start(unsigned long ulBase, unsigned long ulTimer, unsigned long ulValue)
+{
+   MAP_TimerLoadSet(ulBase, ulTimer, MILLISECONDS_TO_TICKS(ulValue));
+   MAP_TimerEnable(ulBase, ulTimer);
+}
+
+
+void Timer_IF_Stop(unsigned long ulBase, unsigned long ulTimer)
+{
+   MAP_TimerDisable(ulBase, ulTimer);
+}
+
+
+/* ======================================================================== */
+/*  GPIO                                                                    */
+/* ======================================================================== */
+
+/****************************************************************************
+     Function: SIMHAL_GpioUpdateLine
+     Engineer: agent
+        Input: unsigned char ucPort: Port index.
+       Output: N/A
+  Description: Sets the interrupt line of a port from its status and mask.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMHAL_GpioUpdateLine(unsigned char ucPort)
+{
+   TySimGpioPort *ptyPort;
+
+   ptyPort = &ptyLocalGpioPorts[ucPort];
+
+   SIM_SetInterruptLine(INT_GPIOA0 + ucPort, (ptyPort->ucIntStatus & ptyPort->ucIntMask) ? TRUE : FALSE);
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_GpioEdge
+     Engineer: agent
+        Input: unsigned long ulBase: GPIO port base address.
+               unsigned char ucPin: GPIO_INT_PIN_x
+               unsigned char ucLevel: New level of the pin.
+       Output: unsigned char: FALSE if the edge was lost, as the interrupt
+                  for the last one had not been cleared.
+  Description: Changes the level of an input, raising the edge interrupt
+               if it has been configured for that edge.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Reports a lost edge.
+****************************************************************************/
+static unsigned char SIMHAL_GpioEdge(unsigned long ulBase, unsigned char ucPin, unsigned char ucLevel)
+{
+   unsigned char ucPort, ucBit, bRising, bEdge, bTaken;
+   unsigned long ulType;
+   TySimGpioPort *ptyPort;
+
+   ucPort  = SIMHAL_Port(ulBase);
+   ptyPort = &ptyLocalGpioPorts[ucPort];
+
+   if (((ptyPort->ucLevels & ucPin) != 0) == (ucLevel != 0))
+      return TRUE;
+
+   if (ucLevel)
+      ptyPort->ucLevels |= ucPin;
+   else
+      ptyPort->ucLevels &= ~ucPin;
+
+   for (ucBit=0; (ucPin & (1 << ucBit)) == 0; ucBit++)
+      {
+      ;;
+      }
+
+   bRising = (ucLevel != 0);
+   ulType  = ptyPort->pulIntType[ucBit];
+   bEdge   = (ulType == GPIO_BOTH_EDGES) ||
+             ((ulType == GPIO_RISING_EDGE) && bRising) ||
+             ((ulType == GPIO_FALLING_EDGE) && !bRising);
+
+   if (bEdge == FALSE)
+      return TRUE;
+
+   bTaken = (ptyPort->ucIntStatus & ucPin) ? FALSE : TRUE;
+
+   ptyPort->ucIntStatus |= ucPin;
+   SIMHAL_GpioUpdateLine(ucPort);
+
+   return bTaken;
+}
+
+
+void GPIODirModeSet(unsigned long ulPort, unsigned char ucPins, unsigned long ulPinIO)
+{
+   SIMHAL_Port(ulPort);
+}
+
+
+void GPIOIntTypeSet(unsigned long ulPort, unsigned char ucPins, unsigned long ulIntType)
+{
+   unsigned char ucBit;
+   TySimGpioPort *ptyPort;
+
+   ptyPort = &ptyLocalGpioPorts[SIMHAL_Port(ulPort)];
+
+   if ((ulIntType == GPIO_LOW_LEVEL) || (ulIntType == GPIO_HIGH_LEVEL))
+      SIM_Fatal("level GPIO interrupts are not simulated");
+
+   for (ucBit=0; ucBit < 0x8; ucBit++)
+      {
+      if (ucPins & (1 << ucBit))
+         ptyPort->pulIntType[ucBit] = ulIntType;
+      }
+}
+
+
+long GPIOPinRead(unsigned long ulPort, unsigned char ucPins)
+{
+   return ptyLocalGpioPorts[SIMHAL_Port(ulPort)].ucLevels & ucPins;
+}
+
+
+void GPIOPinWrite(unsigned long ulPort, unsigned char ucPins, unsigned char ucVal)
+{
+   TySimGpioPort *ptyPort;
+
+   ptyPort = &ptyLocalGpioPorts[SIMHAL_Port(ulPort)];
+
+   ptyPort->ucLevels = (ptyPort->ucLevels & ~ucPins) | (ucVal & ucPins);
+}
+
+
+void GPIOIntEnable(unsigned long ulPort, unsigned long ulIntFlags)
+{
+   unsigned char ucPort;
+
+   ucPort = SIMHAL_Port(ulPort);
+
+   ptyLocalGpioPorts[ucPort].ucIntMask |= (unsigned char)ulIntFlags;
+   SIMHAL_GpioUpdateLine(ucPort);
+}
+
+
+void GPIOIntDisable(unsigned long ulPort, unsigned long ulIntFlags)
+{
+   unsigned char ucPort;
+
+   ucPort = SIMHAL_Port(ulPort);
+
+   ptyLocalGpioPorts[ucPort].ucIntMask &= (unsigned char)~ulIntFlags;
+   SIMHAL_GpioUpdateLine(ucPort);
+}
+
+
+long GPIOIntStatus(unsigned long ulPort, tBoolean bMasked)
+{
+   TySimGpioPort *ptyPort;
+
+   ptyPort = &ptyLocalGpioPorts[SIMHAL_Port(ulPort)];
+
+   return bMasked ? (ptyPort->ucIntStatus & ptyPort->ucIntMask) : ptyPort->ucIntStatus;
+}
+
+
+void GPIOIntClear(unsigned long ulPort, unsigned long ulIntFlags)
+{
+   unsigned char ucPort;
+
+   ucPort = SIMHAL_Port(ulPort);
+
+   ptyLocalGpioPorts[ucPort].ucIntStatus &= (unsigned char)~ulIntFlags;
+   SIMHAL_GpioUpdateLine(ucPort);
+}
+
+
+void GPIOIntRegister(unsigned long ulPort, void (*pfnIntHandler)(void))
+{
+   SIM_RegisterInterrupt(INT_GPIOA0 + SIMHAL_Port(ulPort), pfnIntHandler);
+}
+
+
+void GPIO_IF_ConfigureNIntEnable(unsigned int uiGPIOPort, unsigned char ucGPIOPin, unsigned int uiIntType, void (*pfnIntHandler)(void))
+{
+   MAP_GPIOIntTypeSet(uiGPIOPort, ucGPIOPin, uiIntType);
+   MAP_GPIOIntRegister(uiGPIOPort, pfnIntHandler);
+   MAP_GPIOIntClear(uiGPIOPort, ucGPIOPin);
+   MAP_GPIOIntEnable(uiGPIOPort, ucGPIOPin);
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_DriveInput
+     Engineer: agent
+        Input: unsigned long ulPin: Package pin (PIN_xx).
+               unsigned char ucLevel: Level to drive.
+       Output: unsigned char: FALSE if the edge was lost, the interrupt for
+                  the last edge on the input still pending. The firmware
+                  never sees a lost edge.
+  Description: Drives one of the firmware's inputs. The edge goes to the
+               GPIO port or, if the pin is muxed to a timer, the capture
+               timer. The GPIO data register follows the pin either way.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       The level can be read while muxed to a timer.
+17-OCT-2026    agent       Reports a lost edge.
+****************************************************************************/
+unsigned char SIMHAL_DriveInput(unsigned long ulPin, unsigned char ucLevel)
+{
+   unsigned char i;
+   const TySimInputPin *ptyInput;
+   TySimGpioPort *ptyPort;
+
+   for (i=0; i < (sizeof(ptyLocalInputPins) / sizeof(ptyLocalInputPins[0])); i++)
+      {
+      ptyInput = &ptyLocalInputPins[i];
+      if (ptyInput->ulPin != ulPin)
+         continue;
+
+      if (pucLocalPinModes[ulPin] == PIN_MODE_12)
+         {
+         ptyPort = &ptyLocalGpioPorts[SIMHAL_Port(ptyInput->ulGpioBase)];
+         if (ucLevel)
+            ptyPort->ucLevels |= ptyInput->ucGpioPin;
+         else
+            ptyPort->ucLevels &= ~ptyInput->ucGpioPin;
+
+         return SIMHAL_TimerEdge(ptyInput->ulTimerBase, ptyInput->ulTimer, ucLevel);
+         }
+
+      return SIMHAL_GpioEdge(ptyInput->ulGpioBase, ptyInput->ucGpioPin, ucLevel);
+      }
+
+   SIM_Fatal("pin %lu is not a simulated input", ulPin + 1);
+   return FALSE;
+}
+
+
+/* ======================================================================== */
+/*  UART                                                                    */
+/* ======================================================================== */
+
+/****************************************************************************
+     Function: SIMHAL_UartUpdateLine
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Sets the UART interrupt line from its status and mask.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMHAL_UartUpdateLine(void)
+{
+   SIM_SetInterruptLine(INT_UARTA0, (ulLocalUartIntStatus & ulLocalUartIntMask) ? TRUE : FALSE);
+}
+
+
+static void SIMHAL_UartByteSent(TySimEvent *ptyEvent);
+
+/****************************************************************************
+     Function: SIMHAL_UartStartNext
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Moves the next byte from the FIFO into the shift register, if
+               the shift register is free. The transmit interrupt is raised
+               as the FIFO drops through the trigger level.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMHAL_UartStartNext(void)
+{
+   if (bLocalUartShifting || (ucLocalUartFifoCount == 0))
+      return;
+
+   ucLocalUartShift    = pucLocalUartFifo[ucLocalUartFifoHead];
+   ucLocalUartFifoHead = (ucLocalUartFifoHead + 1) % SIM_UART_FIFO_SIZE;
+   ucLocalUartFifoCount--;
+   bLocalUartShifting  = TRUE;
+
+   if ((bLocalUartEndOfTransmission == FALSE) && (ucLocalUartFifoCount == ucLocalUartTxLevel))
+      {
+      ulLocalUartIntStatus |= UART_INT_TX;
+      SIMHAL_UartUpdateLine();
+      }
+
+   SIM_Schedule(&tyLocalUartEvent, SIM_GetTime() + SIM_UART_BYTE_CYCLES, SIMHAL_UartByteSent);
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_UartByteSent
+     Engineer: agent
+        Input: TySimEvent *ptyEvent: UART event.
+       Output: N/A
+  Description: The byte in the shift register has been sent. It is written
+               to the capture file.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMHAL_UartByteSent(TySimEvent *ptyEvent)
+{
+   if (ptyLocalUartCapture != NULL)
+      fputc(ucLocalUartShift, ptyLocalUartCapture);
+   SIM_GetStatistics()->ulUartBytes++;
+
+   bLocalUartShifting = FALSE;
+   SIMHAL_UartStartNext();
+
+   if (bLocalUartEndOfTransmission && (bLocalUartShifting == FALSE))
+      {
+      ulLocalUartIntStatus |= UART_INT_TX;
+      SIMHAL_UartUpdateLine();
+      }
+}
+
+
+tBoolean UARTCharPutNonBlocking(unsigned long ulBase, unsigned char ucData)
+{
+   SIMHAL_CheckUart(ulBase);
+
+   if (ucLocalUartFifoCount >= SIM_UART_FIFO_SIZE)
+      return false;
+
+   pucLocalUartFifo[(ucLocalUartFifoHead + ucLocalUartFifoCount) % SIM_UART_FIFO_SIZE] = ucData;
+   ucLocalUartFifoCount++;
+
+   SIMHAL_UartStartNext();
+
+   return true;
+}
+
+
+void UARTCharPut(unsigned long ulBase, unsigned char ucData)
+{
+   while (UARTCharPutNonBlocking(ulBase, ucData) == false)
+      {
+      SIM_Advance(SIM_POLL_CYCLES);
+      }
+}
+
+
+tBoolean UARTSpaceAvail(unsigned long ulBase)
+{
+   SIMHAL_CheckUart(ulBase);
+
+   return (ucLocalUartFifoCount < SIM_UART_FIFO_SIZE) ? true : false;
+}
+
+
+tBoolean UARTBusy(unsigned long ulBase)
+{
+   SIMHAL_CheckUart(ulBase);
+   SIM_Advance(SIM_POLL_CYCLES);
+
+   return (bLocalUartShifting || (ucLocalUartFifoCount != 0)) ? true : false;
+}
+
+
+tBoolean UARTCharsAvail(unsigned long ulBase)
+{
+   SIMHAL_CheckUart(ulBase);
+
+   return (ucLocalUartRxFifoCount != 0) ? true : false;
+}
+
+
+long UARTCharGetNonBlocking(unsigned long ulBase)
+{
+   unsigned char ucData;
+
+   SIMHAL_CheckUart(ulBase);
+
+   if (ucLocalUartRxFifoCount == 0)
+      return -1;
+
+   ucData = pucLocalUartRxFifo[ucLocalUartRxFifoHead];
+   ucLocalUartRxFifoHead = (ucLocalUartRxFifoHead + 1) % SIM_UART_RX_FIFO_SIZE;
+   ucLocalUartRxFifoCount--;
+
+   return ucData;
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_ConsoleInput
+     Engineer: agent
+        Input: const char *pcText: Characters typed on the console.
+       Output: N/A
+  Description: Puts characters into the console receive FIFO. Characters
+               that do not fit are lost, as in a receive overrun.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIMHAL_ConsoleInput(const char *pcText)
+{
+   while ((*pcText != '\0') && (ucLocalUartRxFifoCount < SIM_UART_RX_FIFO_SIZE))
+      {
+      pucLocalUartRxFifo[(ucLocalUartRxFifoHead + ucLocalUartRxFifoCount) % SIM_UART_RX_FIFO_SIZE] = (unsigned char)*pcText++;
+      ucLocalUartRxFifoCount++;
+      }
+}
+
+
+void UARTIntRegister(unsigned long ulBase, void (*pfnHandler)(void))
+{
+   SIMHAL_CheckUart(ulBase);
+   SIM_RegisterInterrupt(INT_UARTA0, pfnHandler);
+}
+
+
+void UARTIntEnable(unsigned long ulBase, unsigned long ulIntFlags)
+{
+   SIMHAL_CheckUart(ulBase);
+
+   ulLocalUartIntMask |= ulIntFlags;
+   SIMHAL_UartUpdateLine();
+}
+
+
+void UARTIntDisable(unsigned long ulBase, unsigned long ulIntFlags)
+{
+   SIMHAL_CheckUart(ulBase);
+
+   ulLocalUartIntMask &= ~ulIntFlags;
+   SIMHAL_UartUpdateLine();
+}
+
+
+unsigned long UARTIntStatus(unsigned long ulBase, tBoolean bMasked)
+{
+   SIMHAL_CheckUart(ulBase);
+
+   return bMasked ? (ulLocalUartIntStatus & ulLocalUartIntMask) : ulLocalUartIntStatus;
+}
+
+
+void UARTIntClear(unsigned long ulBase, unsigned long ulIntFlags)
+{
+   SIMHAL_CheckUart(ulBase);
+
+   ulLocalUartIntStatus &= ~ulIntFlags;
+   SIMHAL_UartUpdateLine();
+}
+
+
+void UARTFIFOLevelSet(unsigned long ulBase, unsigned long ulTxLevel, unsigned long ulRxLevel)
+{
+   SIMHAL_CheckUart(ulBase);
+
+   if (ulTxLevel >= sizeof(pucLocalUartTxLevels))
+      SIM_Fatal("UART transmit FIFO level %lu is not valid", ulTxLevel);
+
+   ucLocalUartTxLevel = pucLocalUartTxLevels[ulTxLevel];
+}
+
+
+void UARTFIFOEnable(unsigned long ulBase)
+{
+   SIMHAL_CheckUart(ulBase);
+}
+
+
+void UARTTxIntModeSet(unsigned long ulBase, unsigned long ulMode)
+{
+   SIMHAL_CheckUart(ulBase);
+
+   bLocalUartEndOfTransmission = (ulMode == UART_TXINT_MODE_EOT) ? TRUE : FALSE;
+}
+
+
+void UARTConfigSetExpClk(unsigned long ulBase, unsigned long ulUARTClk, unsigned long ulBaud, unsigned long ulConfig)
+{
+   SIMHAL_CheckUart(ulBase);
+
+   // The byte time is fixed at the console settings....
+   if ((ulBaud != UART_BAUD_RATE) || (ulConfig != (UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE)))
+      SIM_Fatal("UART configured for %lu baud, config 0x%lx", ulBaud, ulConfig);
+
+   ucLocalUartTxLevel = pucLocalUartTxLevels[UART_FIFO_TX4_8];
+}
+
+
+/* ======================================================================== */
+/*  I2C                                                                     */
+/* ======================================================================== */
+
+/****************************************************************************
+     Function: SIMHAL_I2CUpdateLine
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Sets the I2C interrupt line from the status and mask.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMHAL_I2CUpdateLine(void)
+{
+   SIM_SetInterruptLine(INT_I2CA0, (ulLocalI2CIntStatus & ulLocalI2CIntMask) ? TRUE : FALSE);
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_I2CFindDevice
+     Engineer: agent
+        Input: unsigned char ucAddress: 7 bit device address.
+       Output: const TySimI2CDevice *: Device, or NULL if none answers.
+  Description: Finds the device model at an address.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static const TySimI2CDevice *SIMHAL_I2CFindDevice(unsigned char ucAddress)
+{
+   unsigned char i;
+
+   for (i=0; i < ucLocalI2CDeviceCount; i++)
+      {
+      if (pptyLocalI2CDevices[i]->ucAddress == ucAddress)
+         return pptyLocalI2CDevices[i];
+      }
+
+   return NULL;
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_I2CComplete
+     Engineer: agent
+        Input: TySimEvent *ptyEvent: I2C event.
+       Output: N/A
+  Description: The end of a master command: the address (after a start)
+               and one data byte have been clocked. The device model sees
+               the transfer now, so that it answers as it would at that
+               time (e.g. the HDC1080 not acknowledging a read while it is
+               converting).
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMHAL_I2CComplete(TySimEvent *ptyEvent)
+{
+   TySimStatistics *ptyStatistics;
+
+   ptyStatistics = SIM_GetStatistics();
+   ptyStatistics->ulI2CTransfers++;
+
+   bLocalI2CBusy = FALSE;
+
+   if (ulLocalI2CCommand & SIM_I2C_CMD_START)
+      {
+      ptyLocalI2CSelected = SIMHAL_I2CFindDevice(ucLocalI2CAddress);
+      if ((ptyLocalI2CSelected == NULL) || (ptyLocalI2CSelected->Start(bLocalI2CReceive) == FALSE))
+         {
+         ptyLocalI2CSelected = NULL;
+         ulLocalI2CError = I2C_MASTER_ERR_ADDR_ACK;
+         }
+      }
+   else if (ptyLocalI2CSelected == NULL)
+      {
+      ulLocalI2CError = I2C_MASTER_ERR_ADDR_ACK;
+      }
+
+   if (ulLocalI2CError == I2C_MASTER_ERR_NONE)
+      {
+      if (bLocalI2CReceive)
+         ucLocalI2CRxData = ptyLocalI2CSelected->Read();
+      else if (ptyLocalI2CSelected->Write(ucLocalI2CTxData) == FALSE)
+         ulLocalI2CError = I2C_MASTER_ERR_DATA_ACK;
+      }
+
+   if ((ulLocalI2CError == I2C_MASTER_ERR_NONE) && (ulLocalI2CCommand & SIM_I2C_CMD_STOP))
+      {
+      ptyLocalI2CSelected->Stop();
+      ptyLocalI2CSelected = NULL;
+      }
+
+   if (ulLocalI2CError != I2C_MASTER_ERR_NONE)
+      {
+      ptyStatistics->ulI2CNacks++;
+      ulLocalI2CIntStatus |= I2C_MASTER_INT_NACK;
+      }
+
+   ulLocalI2CIntStatus |= I2C_MASTER_INT_DATA;
+   SIMHAL_I2CUpdateLine();
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_AttachI2CDevice
+     Engineer: agent
+        Input: const TySimI2CDevice *ptyDevice: Device model.
+       Output: N/A
+  Description: Attaches a device model to the I2C bus.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIMHAL_AttachI2CDevice(const TySimI2CDevice *ptyDevice)
+{
+   if (ucLocalI2CDeviceCount >= SIM_I2C_MAX_DEVICES)
+      SIM_Fatal("too many I2C devices");
+
+   pptyLocalI2CDevices[ucLocalI2CDeviceCount++] = ptyDevice;
+}
+
+
+void I2CIntRegister(unsigned long ulBase, void (*pfnHandler)(void))
+{
+   SIMHAL_CheckI2C(ulBase);
+   SIM_RegisterInterrupt(INT_I2CA0, pfnHandler);
+}
+
+
+void I2CMasterIntEnableEx(unsigned long ulBase, unsigned long ulIntFlags)
+{
+   SIMHAL_CheckI2C(ulBase);
+
+   ulLocalI2CIntMask |= ulIntFlags;
+   SIMHAL_I2CUpdateLine();
+}
+
+
+void I2CMasterIntDisableEx(unsigned long ulBase, unsigned long ulIntFlags)
+{
+   SIMHAL_CheckI2C(ulBase);
+
+   ulLocalI2CIntMask &= ~ulIntFlags;
+   SIMHAL_I2CUpdateLine();
+}
+
+
+unsigned long I2CMasterIntStatusEx(unsigned long ulBase, tBoolean bMasked)
+{
+   SIMHAL_CheckI2C(ulBase);
+   SIM_Advance(SIM_POLL_CYCLES);
+
+   return bMasked ? (ulLocalI2CIntStatus & ulLocalI2CIntMask) : ulLocalI2CIntStatus;
+}
+
+
+void I2CMasterIntClearEx(unsigned long ulBase, unsigned long ulIntFlags)
+{
+   SIMHAL_CheckI2C(ulBase);
+
+   ulLocalI2CIntStatus &= ~ulIntFlags;
+   SIMHAL_I2CUpdateLine();
+}
+
+
+void I2CMasterSlaveAddrSet(unsigned long ulBase, unsigned char ucSlaveAddr, tBoolean bReceive)
+{
+   SIMHAL_CheckI2C(ulBase);
+
+   ucLocalI2CAddress = ucSlaveAddr;
+   bLocalI2CReceive  = bReceive ? TRUE : FALSE;
+}
+
+
+/****************************************************************************
+     Function: I2CMasterControl
+     Engineer: agent
+        Input: unsigned long ulBase: I2C base address.
+               unsigned long ulCmd: I2C_MASTER_CMD_x
+       Output: N/A
+  Description: Starts a master command. A stop on its own ends the transfer
+               straight away. After an error (the error stop) there is no
+               interrupt for it; otherwise it raises the interrupt as the
+               SDK's I2C_IF routines expect.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void I2CMasterControl(unsigned long ulBase, unsigned long ulCmd)
+{
+   unsigned long ulBytes;
+
+   SIMHAL_CheckI2C(ulBase);
+
+   if (bLocalI2CBusy)
+      SIM_Fatal("I2C command 0x%02lx while the master is busy", ulCmd);
+
+   if ((ulCmd & SIM_I2C_CMD_RUN) == 0)
+      {
+      if (ptyLocalI2CSelected != NULL)
+         ptyLocalI2CSelected->Stop();
+      ptyLocalI2CSelected = NULL;
+
+      if (ulLocalI2CError == I2C_MASTER_ERR_NONE)
+         {
+         ulLocalI2CIntStatus |= I2C_MASTER_INT_DATA;
+         SIMHAL_I2CUpdateLine();
+         }
+      ulLocalI2CError = I2C_MASTER_ERR_NONE;
+      return;
+      }
+
+   ulLocalI2CCommand = ulCmd;
+   ulLocalI2CError   = I2C_MASTER_ERR_NONE;
+   bLocalI2CBusy     = TRUE;
+
+   ulBytes = (ulCmd & SIM_I2C_CMD_START) ? 2 : 1;
+   SIM_Schedule(&tyLocalI2CEvent, SIM_GetTime() + (ulBytes * SIM_I2C_BITS_PER_BYTE * ulLocalI2CBitCycles), SIMHAL_I2CComplete);
+}
+
+
+unsigned long I2CMasterErr(unsigned long ulBase)
+{
+   SIMHAL_CheckI2C(ulBase);
+
+   if (bLocalI2CBusy)
+      return I2C_MASTER_ERR_NONE;
+
+   return ulLocalI2CError;
+}
+
+
+void I2CMasterDataPut(unsigned long ulBase, unsigned char ucData)
+{
+   SIMHAL_CheckI2C(ulBase);
+
+   ucLocalI2CTxData = ucData;
+}
+
+
+unsigned long I2CMasterDataGet(unsigned long ulBase)
+{
+   SIMHAL_CheckI2C(ulBase);
+
+   return ucLocalI2CRxData;
+}
+
+
+tBoolean I2CMasterBusy(unsigned long ulBase)
+{
+   SIMHAL_CheckI2C(ulBase);
+   SIM_Advance(SIM_POLL_CYCLES);
+
+   return bLocalI2CBusy ? true : false;
+}
+
+
+void I2CMasterTimeoutSet(unsigned long ulBase, unsigned long ulValue)
+{
+   SIMHAL_CheckI2C(ulBase);
+}
+
+
+/****************************************************************************
+     Function: I2C_IF_Transact
+     Engineer: agent
+        Input: unsigned long ulCmd: I2C_MASTER_CMD_x
+       Output: SUCCESS or FAILURE.
+  Description: Runs one master command and waits for it, as the SDK does,
+               ending the transfer if it fails.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static int I2C_IF_Transact(unsigned long ulCmd)
+{
+   MAP_I2CMasterIntClearEx(I2CA0_BASE, MAP_I2CMasterIntStatusEx(I2CA0_BASE, false));
+
+   MAP_I2CMasterControl(I2CA0_BASE, ulCmd);
+
+   while ((MAP_I2CMasterIntStatusEx(I2CA0_BASE, false) & (I2C_MASTER_INT_DATA | I2C_MASTER_INT_TIMEOUT)) == 0)
+      {
+      ;;
+      }
+
+   if (MAP_I2CMasterErr(I2CA0_BASE) != I2C_MASTER_ERR_NONE)
+      {
+      if (bLocalI2CReceive)
+         MAP_I2CMasterControl(I2CA0_BASE, I2C_MASTER_CMD_BURST_RECEIVE_ERROR_STOP);
+      else
+         MAP_I2CMasterControl(I2CA0_BASE, I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+
+      return FAILURE;
+      }
+
+   return SUCCESS;
+}
+
+
+int I2C_IF_Open(unsigned long ulMode)
+{
+   ulLocalI2CBitCycles = (unsigned long)(SIM_CLOCK_HZ / ((ulMode == I2C_MASTER_MODE_FST) ? 400000 : 100000));
+
+   return SUCCESS;
+}
+
+
+int I2C_IF_Close(void)
+{
+   return SUCCESS;
+}
+
+
+int I2C_IF_Write(unsigned char ucDevAddr, unsigned char *pucData, unsigned char ucLen, unsigned char ucStop)
+{
+   if ((pucData == NULL) || (ucLen == 0))
+      return FAILURE;
+
+   MAP_I2CMasterSlaveAddrSet(I2CA0_BASE, ucDevAddr, false);
+
+   MAP_I2CMasterDataPut(I2CA0_BASE, *pucData++);
+   if (I2C_IF_Transact(I2C_MASTER_CMD_BURST_SEND_START) != SUCCESS)
+      return FAILURE;
+   ucLen--;
+
+   while (ucLen)
+      {
+      MAP_I2CMasterDataPut(I2CA0_BASE, *pucData++);
+      if (I2C_IF_Transact(I2C_MASTER_CMD_BURST_SEND_CONT) != SUCCESS)
+         return FAILURE;
+      ucLen--;
+      }
+
+   if (ucStop)
+      {
+      if (I2C_IF_Transact(I2C_MASTER_CMD_BURST_SEND_STOP) != SUCCESS)
+         return FAILURE;
+      }
+
+   return SUCCESS;
+}
+
+
+int I2C_IF_Read(unsigned char ucDevAddr, unsigned char *pucData, unsigned char ucLen)
+{
+   if ((pucData == NULL) || (ucLen == 0))
+      return FAILURE;
+
+   MAP_I2CMasterSlaveAddrSet(I2CA0_BASE, ucDevAddr, true);
+
+   if (I2C_IF_Transact((ucLen == 1) ? I2C_MASTER_CMD_SINGLE_RECEIVE : I2C_MASTER_CMD_BURST_RECEIVE_START) != SUCCESS)
+      return FAILURE;
+   ucLen--;
+
+   while (ucLen)
+      {
+      *pucData++ = (unsigned char)MAP_I2CMasterDataGet(I2CA0_BASE);
+      ucLen--;
+
+      if (I2C_IF_Transact(ucLen ? I2C_MASTER_CMD_BURST_RECEIVE_CONT : I2C_MASTER_CMD_BURST_RECEIVE_FINISH) != SUCCESS)
+         return FAILURE;
+      }
+
+   *pucData = (unsigned char)MAP_I2CMasterDataGet(I2CA0_BASE);
+
+   return SUCCESS;
+}
+
+
+int I2C_IF_ReadFrom(unsigned char ucDevAddr, unsigned char *pucWrDataBuf, unsigned char ucWrLen, unsigned char *pucRdDataBuf, unsigned char ucRdLen)
+{
+   if (I2C_IF_Write(ucDevAddr, pucWrDataBuf, ucWrLen, 0) != SUCCESS)
+      return FAILURE;
+
+   return I2C_IF_Read(ucDevAddr, pucRdDataBuf, ucRdLen);
+}
+
+
+/****************************************************************************
+     Function: SIMHAL_Initialise
+     Engineer: agent
+        Input: FILE *ptyUartCapture: File for the console output, or NULL.
+       Output: N/A
+  Description: Puts the simulated peripherals into their reset state.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       The inputs start high.
+17-OCT-2026    agent       Resets the debug registers and the receive FIFO.
+****************************************************************************/
+void SIMHAL_Initialise(FILE *ptyUartCapture)
+{
+   unsigned long i;
+
+   for (i=0; i < SIM_PIN_COUNT; i++)
+      pucLocalPinModes[i] = PIN_MODE_0;
+
+   ulLocalSysTickLoad      = 0;
+   ulLocalSysTickLoaded    = 0;
+   ullLocalSysTickReload   = 0;
+   bLocalSysTickEnabled    = FALSE;
+   bLocalSysTickIntEnabled = FALSE;
+   ulLocalCurrentRegister  = SIM_REGISTER_UNWRITTEN;
+   ulLocalDemcrRegister    = 0;
+   ulLocalDwtCtrlRegister  = 0;
+
+   memset(ptyLocalTimers, 0, sizeof(ptyLocalTimers));
+   memset(ptyLocalGpioPorts, 0, sizeof(ptyLocalGpioPorts));
+
+   // The inputs idle high, as the PPD42NJ outputs do, so that the first
+   // falling edge is seen....
+   for (i=0; i < (sizeof(ptyLocalInputPins) / sizeof(ptyLocalInputPins[0])); i++)
+      ptyLocalGpioPorts[SIMHAL_Port(ptyLocalInputPins[i].ulGpioBase)].ucLevels |= ptyLocalInputPins[i].ucGpioPin;
+
+   ptyLocalUartCapture         = ptyUartCapture;
+   ucLocalUartFifoHead         = 0;
+   ucLocalUartFifoCount        = 0;
+   bLocalUartShifting          = FALSE;
+   ucLocalUartTxLevel          = pucLocalUartTxLevels[UART_FIFO_TX4_8];
+   bLocalUartEndOfTransmission = FALSE;
+   ulLocalUartIntMask          = 0;
+   ulLocalUartIntStatus        = 0;
+   ucLocalUartRxFifoHead       = 0;
+   ucLocalUartRxFifoCount      = 0;
+
+   ucLocalI2CDeviceCount = 0;
+   ptyLocalI2CSelected   = NULL;
+   bLocalI2CBusy         = FALSE;
+   ulLocalI2CError       = I2C_MASTER_ERR_NONE;
+   ulLocalI2CIntMask     = 0;
+   ulLocalI2CIntStatus   = 0;
+   I2C_IF_Open(I2C_MASTER_MODE_STD);
+}
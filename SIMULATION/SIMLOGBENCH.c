@@ -0,0 +1,554 @@
+/****************************************************************************
+       Module: SIMLOGBENCH.c
+     Engineer: agent
+  Description: Contains main for the flash log benchmark. Runs the FLASHLOG
+               module on its own against the simulated serial flash (see
+               SIMFLASH.c), appending samples and cutting the power at
+               random, and reports:
+
+                  Write amplification   Bytes of flash programmed and
+                                        erased for each byte of records.
+                  Wear                  Spread of the erase counts over the
+                                        blocks of the log.
+                  Network processor     Starts and estimated on time to
+                                        write the log.
+                  Recovery              Reads and estimated target time to
+                                        find the ends of the log at boot,
+                                        against reading every page.
+
+               usage: logbench [-n samples] [-c cuts] [-t torn %] [-s seed]
+                               [-f image]
+
+               After every boot the log is read back and checked against
+               the samples that should have survived it: those in pages
+               staged before the power was cut. A cut drops the samples
+               held in RAM or, for the -t share of the cuts, tears the next
+               page write part way through. When that page is the last of
+               its segment the tear may instead fall in the copy of the
+               segment which follows, keeping the page.
+
+               With -f the flash is kept in the file, so a run carries on
+               from the last one. The log found at the first boot is then
+               taken as the starting point.
+
+               Returns 1 if the log read back is ever wrong.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       The log is written a segment at a time. Added the
+                           network processor starts and on time.
+17-OCT-2026    agent       The log is written a page at a time again, each
+                           page staged until its segment is copied.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "includes.h"
+#include "simplelink.h"
+#include "SIM.h"
+
+#define BENCH_DEFAULT_SAMPLES     20000
+#define BENCH_DEFAULT_CUTS        50
+#define BENCH_DEFAULT_TORN        50.0
+
+// Most records the log can hold: the segments, and the pages staged for the
+// next....
+#define BENCH_LOG_RECORDS         (((FLASHLOG_SEGMENTS + 1) * FLASHLOG_PAGES_PER_SEGMENT - 1) * FLASHLOG_RECORDS_PER_PAGE)
+
+// Segment file names, as FLASHLOG.c has them, for the full scan....
+#define BENCH_SEGMENT_NAME        "/sensorweb/log%02u"
+
+// Recovery figures over the boots....
+typedef struct
+{
+   unsigned long ulBoots;
+   unsigned long ulReads;
+   unsigned long ulMostReads;
+   unsigned long long ullBytesRead;
+   TySimTime ullCycles;
+   TySimTime ullMostCycles;
+   unsigned long long ullNanoseconds;                 // Host time.
+} TyBenchRecovery;
+
+static unsigned long ulLocalRandom;
+
+// Records which should be in the log, oldest first, and those waiting in
+// RAM for their page to be written. A boot starts a new segment, so the
+// pages written since give the place in it....
+static TyFlashLogRecord *ptyLocalKept;
+static unsigned long ulLocalKept;
+static TyFlashLogRecord ptyLocalPending[FLASHLOG_RECORDS_PER_PAGE];
+static unsigned short usLocalPending;
+static unsigned long ulLocalPages;
+
+// Network processor use to write the log, leaving out the boots and the
+// checks....
+static unsigned long ulLocalWriteStarts;
+static TySimTime ullLocalWriteOnCycles;
+
+static TyFlashLogRecord ptyLocalRead[BENCH_LOG_RECORDS + FLASHLOG_RECORDS_PER_PAGE];
+
+
+/****************************************************************************
+     Function: SIMLOGBENCH_Random
+     Engineer: agent
+        Input: N/A
+       Output: double: Random number, 0 <= n < 1.
+  Description: 32 bit xorshift generator.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static double SIMLOGBENCH_Random(void)
+{
+   ulLocalRandom ^= (ulLocalRandom << 13) & 0xFFFFFFFFul;
+   ulLocalRandom ^= ulLocalRandom >> 17;
+   ulLocalRandom ^= (ulLocalRandom << 5) & 0xFFFFFFFFul;
+
+   return (double)ulLocalRandom / 4294967296.0;
+}
+
+
+/****************************************************************************
+     Function: SIMLOGBENCH_Same
+     Engineer: agent
+        Input: const TyFlashLogRecord *ptyA, *ptyB: Records to compare.
+       Output: unsigned char: TRUE if they hold the same sample.
+  Description: Compares two records. The boot number is not compared, as
+               it is given by the log.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SIMLOGBENCH_Same(const TyFlashLogRecord *ptyA, const TyFlashLogRecord *ptyB)
+{
+   return ((ptyA->ulTimestamp  == ptyB->ulTimestamp)  &&
+           (ptyA->sTemperature == ptyB->sTemperature) &&
+           (ptyA->usHumidity   == ptyB->usHumidity)   &&
+           (ptyA->ulP1LowTime  == ptyB->ulP1LowTime)  &&
+           (ptyA->ulP2LowTime  == ptyB->ulP2LowTime));
+}
+
+
+/****************************************************************************
+     Function: SIMLOGBENCH_Boot
+     Engineer: agent
+        Input: TyBenchRecovery *ptyRecovery: Recovery figures to add to.
+       Output: N/A
+  Description: Boots the log, as after a reset, and measures the recovery.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMLOGBENCH_Boot(TyBenchRecovery *ptyRecovery)
+{
+   TySimFlashStatistics tyBefore;
+   const TySimFlashStatistics *ptyAfter;
+   struct timespec tyStart, tyEnd;
+   unsigned long ulReads;
+   TySimTime ullCycles;
+
+   tyBefore = *SIMFLASH_GetStatistics();
+   clock_gettime(CLOCK_MONOTONIC, &tyStart);
+
+   if (FLASHLOG_Initialise() != TRUE)
+      SIM_Fatal("the flash log did not initialise");
+
+   clock_gettime(CLOCK_MONOTONIC, &tyEnd);
+   ptyAfter = SIMFLASH_GetStatistics();
+
+   ulReads   = ptyAfter->ulReads - tyBefore.ulReads;
+   ullCycles = ptyAfter->ullCycles - tyBefore.ullCycles;
+
+   ptyRecovery->ulBoots++;
+   ptyRecovery->ulReads        += ulReads;
+   ptyRecovery->ullBytesRead   += ptyAfter->ullBytesRead - tyBefore.ullBytesRead;
+   ptyRecovery->ullCycles      += ullCycles;
+   ptyRecovery->ullNanoseconds += (tyEnd.tv_sec - tyStart.tv_sec) * 1000000000ull + (tyEnd.tv_nsec - tyStart.tv_nsec);
+
+   if (ulReads > ptyRecovery->ulMostReads)
+      ptyRecovery->ulMostReads = ulReads;
+   if (ullCycles > ptyRecovery->ullMostCycles)
+      ptyRecovery->ullMostCycles = ullCycles;
+
+   usLocalPending = 0;
+   ulLocalPages   = 0;
+}
+
+
+/****************************************************************************
+     Function: SIMLOGBENCH_Check
+     Engineer: agent
+        Input: unsigned char bFirst: TRUE at the first boot, when the log
+                  read back is taken as the starting point.
+       Output: unsigned char: TRUE if the log is right.
+  Description: Reads the whole log back. It must be the newest of the
+               records that should have been kept, in order, with none
+               missing.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SIMLOGBENCH_Check(unsigned char bFirst)
+{
+   unsigned long ulSequence, ulRead, i;
+   unsigned char ucCount;
+
+   ulSequence = FLASHLOG_GetOldest();
+   ulRead     = 0;
+
+   while (FLASHLOG_ReadPage(&ulSequence, &ptyLocalRead[ulRead], &ucCount))
+      {
+      ulRead += ucCount;
+      if (ulRead > BENCH_LOG_RECORDS)
+         {
+         printf("The log holds more records than it has room for\n");
+         return FALSE;
+         }
+      }
+
+   if (bFirst)
+      {
+      memcpy(ptyLocalKept, ptyLocalRead, ulRead * sizeof(TyFlashLogRecord));
+      ulLocalKept = ulRead;
+      return TRUE;
+      }
+
+   if (ulRead > ulLocalKept)
+      {
+      printf("The log holds %lu records, only %lu were kept\n", ulRead, ulLocalKept);
+      return FALSE;
+      }
+
+   if ((ulRead == 0) && (ulLocalKept != 0))
+      {
+      printf("The log is empty, %lu records were kept\n", ulLocalKept);
+      return FALSE;
+      }
+
+   for (i=0; i < ulRead; i++)
+      {
+      if (SIMLOGBENCH_Same(&ptyLocalRead[i], &ptyLocalKept[ulLocalKept - ulRead + i]) == FALSE)
+         {
+         printf("Record %lu of %lu read back is wrong\n", i, ulRead);
+         return FALSE;
+         }
+
+      if ((i != 0) && (ptyLocalRead[i].usBoot < ptyLocalRead[i - 1].usBoot))
+         {
+         printf("Record %lu of %lu read back is from an earlier boot\n", i, ulRead);
+         return FALSE;
+         }
+      }
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: SIMLOGBENCH_CountWrite
+     Engineer: agent
+        Input: const TySimFlashStatistics *ptyBefore: Counts before the
+                  write.
+       Output: N/A
+  Description: Adds the network processor starts and on time since the
+               counts given to those of the writes.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMLOGBENCH_CountWrite(const TySimFlashStatistics *ptyBefore)
+{
+   const TySimFlashStatistics *ptyAfter;
+
+   ptyAfter = SIMFLASH_GetStatistics();
+
+   ulLocalWriteStarts    += ptyAfter->ulStarts - ptyBefore->ulStarts;
+   ullLocalWriteOnCycles += ptyAfter->ullOnCycles - ptyBefore->ullOnCycles;
+}
+
+
+/****************************************************************************
+     Function: SIMLOGBENCH_Append
+     Engineer: agent
+        Input: unsigned long ulTimestamp: Seconds since the boot.
+       Output: unsigned char: The result of FLASHLOG_Append.
+  Description: Makes up a sample and appends it to the log. Once its
+               page is written the samples in it are counted as kept.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Waits for the segment, and counts the network
+                           processor use.
+17-OCT-2026    agent       Waits for the page.
+****************************************************************************/
+static unsigned char SIMLOGBENCH_Append(unsigned long ulTimestamp)
+{
+   unsigned char bSuccess;
+   TyTelemetrySample tySample;
+   TyFlashLogRecord *ptyRecord;
+   TySimFlashStatistics tyBefore;
+
+   memset(&tySample, 0, sizeof(tySample));
+   tySample.ulTimestamp  = ulTimestamp;
+   tySample.sTemperature = (short)(2150 + (SIMLOGBENCH_Random() - 0.5) * 200.0);
+   tySample.usHumidity   = (unsigned short)(4500 + SIMLOGBENCH_Random() * 500.0);
+   tySample.ulP1LowTime  = (unsigned long)(SIMLOGBENCH_Random() * 100000.0);
+   tySample.ulP2LowTime  = (unsigned long)(SIMLOGBENCH_Random() * 20000.0);
+
+   ptyRecord = &ptyLocalPending[usLocalPending++];
+   ptyRecord->ulTimestamp  = tySample.ulTimestamp;
+   ptyRecord->sTemperature = tySample.sTemperature;
+   ptyRecord->usHumidity   = tySample.usHumidity;
+   ptyRecord->ulP1LowTime  = tySample.ulP1LowTime;
+   ptyRecord->ulP2LowTime  = tySample.ulP2LowTime;
+
+   tyBefore = *SIMFLASH_GetStatistics();
+   bSuccess = FLASHLOG_Append(&tySample);
+   SIMLOGBENCH_CountWrite(&tyBefore);
+
+   // The page has been written, or lost....
+   if (FLASHLOG_GetBuffered() == 0)
+      {
+      if (bSuccess)
+         {
+         memcpy(&ptyLocalKept[ulLocalKept], ptyLocalPending, usLocalPending * sizeof(TyFlashLogRecord));
+         ulLocalKept += usLocalPending;
+         }
+      usLocalPending = 0;
+      ulLocalPages++;
+      }
+
+   return bSuccess;
+}
+
+
+/****************************************************************************
+     Function: SIMLOGBENCH_Scan
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Reads every page of every segment, as a recovery without the
+               binary searches would, and prints what it took.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Starts the network processor, as FLASHLOG
+                           leaves it stopped.
+****************************************************************************/
+static void SIMLOGBENCH_Scan(void)
+{
+   unsigned int uiSegment, uiPage;
+   char pcName[32];
+   _u8 pucPage[FLASHLOG_PAGE_SIZE];
+   _i32 lFile;
+   TySimFlashStatistics tyBefore;
+   const TySimFlashStatistics *ptyAfter;
+
+   tyBefore = *SIMFLASH_GetStatistics();
+   sl_Start(NULL, NULL, NULL);
+
+   for (uiSegment=0; uiSegment < FLASHLOG_SEGMENTS; uiSegment++)
+      {
+      sprintf(pcName, BENCH_SEGMENT_NAME, uiSegment);
+
+      if (sl_FsOpen((const _u8 *)pcName, FS_MODE_OPEN_READ, NULL, &lFile) < 0)
+         continue;
+
+      for (uiPage=0; uiPage < FLASHLOG_PAGES_PER_SEGMENT; uiPage++)
+         sl_FsRead(lFile, uiPage * FLASHLOG_PAGE_SIZE, pucPage, FLASHLOG_PAGE_SIZE);
+
+      sl_FsClose(lFile, NULL, NULL, 0);
+      }
+
+   sl_Stop(0);
+   ptyAfter = SIMFLASH_GetStatistics();
+
+   printf("Full scan:           %lu reads, %llu bytes, %.1f ms\n",
+          ptyAfter->ulReads - tyBefore.ulReads,
+          ptyAfter->ullBytesRead - tyBefore.ullBytesRead,
+          (double)(ptyAfter->ullCycles - tyBefore.ullCycles) / SIM_CYCLES_PER_MS);
+}
+
+
+/****************************************************************************
+     Function: SIMLOGBENCH_Usage
+     Engineer: agent
+        Input: const char *pcName: Program name.
+       Output: N/A
+  Description: Prints the usage and exits.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMLOGBENCH_Usage(const char *pcName)
+{
+   fprintf(stderr, "usage: %s [-n samples] [-c cuts] [-t torn %%] [-s seed] [-f image]\n", pcName);
+   fprintf(stderr, "  -n  samples to append (default %d)\n", BENCH_DEFAULT_SAMPLES);
+   fprintf(stderr, "  -c  power cuts, at random (default %d)\n", BENCH_DEFAULT_CUTS);
+   fprintf(stderr, "  -t  share of the cuts that tear a page write (default %.0f %%)\n", BENCH_DEFAULT_TORN);
+   fprintf(stderr, "  -s  random number seed (default 1)\n");
+   fprintf(stderr, "  -f  file holding the serial flash (default an erased flash)\n");
+   exit(1);
+}
+
+
+int main(int argc, char **argv)
+{
+   int iOption, iResult;
+   unsigned long ulSamples, ulCuts, ulAppended, ulRun, ulSinceBoot, ulTorn, ulTearBytes, ulWrite;
+   unsigned long ulBlocks, ulLeast, ulMost;
+   double dTorn, dRecordBytes;
+   const char *pcImage;
+   const TySimFlashStatistics *ptyFlash;
+   TySimFlashStatistics tyBefore;
+   TyBenchRecovery tyRecovery;
+   unsigned char bSuccess;
+
+   ulSamples     = BENCH_DEFAULT_SAMPLES;
+   ulCuts        = BENCH_DEFAULT_CUTS;
+   dTorn         = BENCH_DEFAULT_TORN;
+   ulLocalRandom = 1;
+   pcImage       = NULL;
+
+   while ((iOption = getopt(argc, argv, "n:c:t:s:f:")) != -1)
+      {
+      switch (iOption)
+         {
+         case 'n': ulSamples     = strtoul(optarg, NULL, 0);                 break;
+         case 'c': ulCuts        = strtoul(optarg, NULL, 0);                 break;
+         case 't': dTorn         = atof(optarg);                             break;
+         case 's': ulLocalRandom = strtoul(optarg, NULL, 0) & 0xFFFFFFFFul;  break;
+         case 'f': pcImage       = optarg;                                   break;
+         default:  SIMLOGBENCH_Usage(argv[0]);                               break;
+         }
+      }
+
+   if ((optind != argc) || (ulSamples == 0) || (dTorn < 0.0) || (dTorn > 100.0))
+      SIMLOGBENCH_Usage(argv[0]);
+
+   if (ulLocalRandom == 0)
+      ulLocalRandom = 1;
+
+   ptyLocalKept = malloc((ulSamples + BENCH_LOG_RECORDS) * sizeof(TyFlashLogRecord));
+   if (ptyLocalKept == NULL)
+      SIM_Fatal("out of memory for %lu samples", ulSamples);
+
+   SIM_Initialise();
+   SIMFLASH_Initialise(pcImage);
+
+   printf("Flash log of %d segments, %d pages of %d records each (%d samples)\n\n",
+          FLASHLOG_SEGMENTS, FLASHLOG_PAGES_PER_SEGMENT, FLASHLOG_RECORDS_PER_PAGE, BENCH_LOG_RECORDS);
+
+   memset(&tyRecovery, 0, sizeof(tyRecovery));
+   ulLocalKept = 0;
+   ulAppended  = 0;
+   ulTorn      = 0;
+   iResult     = 0;
+
+   ulLocalWriteStarts    = 0;
+   ullLocalWriteOnCycles = 0;
+
+   SIMLOGBENCH_Boot(&tyRecovery);
+   SIMLOGBENCH_Check(TRUE);
+
+   // The recovery of the starting log is not counted....
+   memset(&tyRecovery, 0, sizeof(tyRecovery));
+
+   while (ulAppended < ulSamples)
+      {
+      // Run for a random time, cutting the power at the end (other than
+      // at the end of the last run)....
+      ulRun = 1 + (unsigned long)(SIMLOGBENCH_Random() * (2.0 * ulSamples) / (ulCuts + 1));
+      if ((ulRun > ulSamples - ulAppended) || (tyRecovery.ulBoots >= ulCuts))
+         ulRun = ulSamples - ulAppended;
+
+      for (ulSinceBoot=0; ulSinceBoot < ulRun; ulSinceBoot++)
+         {
+         if (SIMLOGBENCH_Append((ulSinceBoot + 1) * MAXIMUM_HISTORY_IN_SECONDS) != TRUE)
+            {
+            printf("A page write failed with the power on\n");
+            iResult = 1;
+            }
+         }
+      ulAppended += ulRun;
+
+      if (ulAppended >= ulSamples)
+         {
+         tyBefore = *SIMFLASH_GetStatistics();
+         bSuccess = FLASHLOG_Close();
+         SIMLOGBENCH_CountWrite(&tyBefore);
+
+         if (bSuccess != TRUE)
+            {
+            printf("The last page could not be written\n");
+            iResult = 1;
+            }
+         else
+            {
+            memcpy(&ptyLocalKept[ulLocalKept], ptyLocalPending, usLocalPending * sizeof(TyFlashLogRecord));
+            ulLocalKept += usLocalPending;
+            }
+         }
+      else if ((SIMLOGBENCH_Random() * 100.0) < dTorn)
+         {
+         // Carry on to the next page write, and cut the power part way
+         // through it, or through the copy of the segment after the last
+         // page of a segment....
+         while ((FLASHLOG_GetBuffered() != FLASHLOG_RECORDS_PER_PAGE - 1) && (ulAppended < ulSamples))
+            {
+            SIMLOGBENCH_Append((++ulSinceBoot) * MAXIMUM_HISTORY_IN_SECONDS);
+            ulAppended++;
+            }
+
+         if (ulAppended < ulSamples)
+            {
+            ulWrite = FLASHLOG_PAGE_SIZE;
+            if ((ulLocalPages % FLASHLOG_PAGES_PER_SEGMENT) == (FLASHLOG_PAGES_PER_SEGMENT - 1))
+               ulWrite += FLASHLOG_SEGMENT_SIZE;
+
+            ulTearBytes = (unsigned long)(SIMLOGBENCH_Random() * ulWrite);
+            SIMFLASH_TearWrite(ulTearBytes);
+
+            SIMLOGBENCH_Append((++ulSinceBoot) * MAXIMUM_HISTORY_IN_SECONDS);
+            ulAppended++;
+            ulTorn++;
+
+            // The write failed, but the page is kept if it was staged in
+            // full before the tear....
+            if (ulTearBytes >= FLASHLOG_PAGE_SIZE)
+               {
+               memcpy(&ptyLocalKept[ulLocalKept], ptyLocalPending, FLASHLOG_RECORDS_PER_PAGE * sizeof(TyFlashLogRecord));
+               ulLocalKept += FLASHLOG_RECORDS_PER_PAGE;
+               }
+            }
+         }
+
+      SIMLOGBENCH_Boot(&tyRecovery);
+      if (SIMLOGBENCH_Check(FALSE) != TRUE)
+         iResult = 1;
+      }
+
+   ptyFlash     = SIMFLASH_GetStatistics();
+   dRecordBytes = (double)ulAppended * FLASHLOG_RECORD_SIZE;
+   SIMFLASH_GetWear(&ulBlocks, &ulLeast, &ulMost);
+
+   printf("Samples:             %lu appended, %lu lost at the power cuts\n",
+          ulAppended, ulAppended - (ulLocalKept < ulAppended ? ulLocalKept : ulAppended));
+   printf("Boots:               %lu (%lu with a torn write)\n", tyRecovery.ulBoots, ulTorn);
+   printf("Flash writes:        %lu (%.3f a sample)\n", ptyFlash->ulWrites, (double)ptyFlash->ulWrites / ulAppended);
+   printf("Network processor:   %lu starts to write, on %.1f ms each (%.2f ms a sample)\n",
+          ulLocalWriteStarts,
+          (ulLocalWriteStarts != 0) ? (double)ullLocalWriteOnCycles / ulLocalWriteStarts / SIM_CYCLES_PER_MS : 0.0,
+          (double)ullLocalWriteOnCycles / ulAppended / SIM_CYCLES_PER_MS);
+   printf("Write amplification: %.2f programmed, %.2f erased (flash bytes a record byte)\n",
+          ptyFlash->ullBytesWritten / dRecordBytes,
+          (ptyFlash->ulErases * 4096.0) / dRecordBytes);
+   printf("Wear:                %lu blocks, erased %lu to %lu times\n", ulBlocks, ulLeast, ulMost);
+   printf("Recovery:            %.1f reads (%lu most), %.0f bytes, %.1f ms (%.1f ms most), %.1f us host time\n",
+          (double)tyRecovery.ulReads / tyRecovery.ulBoots,
+          tyRecovery.ulMostReads,
+          (double)tyRecovery.ullBytesRead / tyRecovery.ulBoots,
+          (double)tyRecovery.ullCycles / tyRecovery.ulBoots / SIM_CYCLES_PER_MS,
+          (double)tyRecovery.ullMostCycles / SIM_CYCLES_PER_MS,
+          (double)tyRecovery.ullNanoseconds / tyRecovery.ulBoots / 1000.0);
+
+   SIMLOGBENCH_Scan();
+
+   printf("\n%s\n", (iResult == 0) ? "Log read back correctly after every boot" : "Log read back wrongly");
+
+   return iResult;
+}
@@ -0,0 +1,282 @@
+/****************************************************************************
+       Module: SIMMAIN.c
+     Engineer: agent
+  Description: Contains main for the host simulation. Sets up the simulated
+               board from the command line, runs the firmware for the
+               required virtual time and reports what happened.
+
+               usage: sim [-d seconds] [-s seed] [-1 P1 %] [-2 P2 %]
+                          [-t temperature] [-r humidity] [-o file]
+                          [-i input] [-l image]
+
+               The console output of the firmware is written to the file
+               (uart.bin by default), which can be decoded with
+               TOOLS/telemetry_decode.py. The input is typed on the console
+               a second before the end of the run, e.g. -i p for the profile
+               of a PROFILE_ENABLED build.
+
+               The serial flash starts erased, unless it is kept in an image
+               file with -l, in which case the flash log carries on from the
+               last run.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added the console input.
+17-OCT-2026    agent       Added the serial flash image.
+17-OCT-2026    agent       The HDC1080 measurements have noise, which the
+                           tests turn off.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "includes.h"
+#include "SIM.h"
+
+// Real time, in seconds, that the virtual clock may stand still before the
+// firmware is taken to be stuck (e.g. polling a register that is not
+// simulated as changing)....
+#define SIM_STALL_SECONDS         2
+
+// Time before the end of the run that the console input is typed....
+#define SIM_INPUT_LEAD_SECONDS    1.0
+
+static TySimEvent tyLocalEndEvent;
+static TySimEvent tyLocalInputEvent;
+static const char *pcLocalConsoleInput;
+static volatile TySimTime ullLocalWatchdogTime;
+
+
+/****************************************************************************
+     Function: SIMMAIN_End
+     Engineer: agent
+        Input: TySimEvent *ptyEvent: End event.
+       Output: N/A
+  Description: The run time is up, so the scheduler is stopped. The firmware
+               then sends what it has buffered and returns.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMMAIN_End(TySimEvent *ptyEvent)
+{
+   SCHEDULER_Stop();
+}
+
+
+/****************************************************************************
+     Function: SIMMAIN_Input
+     Engineer: agent
+        Input: TySimEvent *ptyEvent: Input event.
+       Output: N/A
+  Description: Types the console input given on the command line.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMMAIN_Input(TySimEvent *ptyEvent)
+{
+   SIMHAL_ConsoleInput(pcLocalConsoleInput);
+}
+
+
+/****************************************************************************
+     Function: SIMMAIN_Watchdog
+     Engineer: agent
+        Input: int iSignal: SIGALRM.
+       Output: N/A
+  Description: Stops the simulation if the virtual clock has not moved on
+               since the last time.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMMAIN_Watchdog(int iSignal)
+{
+   static const char pcMessage[] = "sim: the virtual clock has stopped, the firmware is stuck\n";
+   TySimTime ullNow;
+
+   ullNow = SIM_GetTime();
+
+   if (ullNow == ullLocalWatchdogTime)
+      {
+      if (write(STDERR_FILENO, pcMessage, sizeof(pcMessage) - 1) < 0)
+         {
+         ;;
+         }
+      _exit(2);
+      }
+
+   ullLocalWatchdogTime = ullNow;
+}
+
+
+/****************************************************************************
+     Function: SIMMAIN_Usage
+     Engineer: agent
+        Input: const char *pcName: Program name.
+       Output: N/A
+  Description: Prints the usage and exits.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added -i.
+17-OCT-2026    agent       Added -l.
+****************************************************************************/
+static void SIMMAIN_Usage(const char *pcName)
+{
+   fprintf(stderr, "usage: %s [-d seconds] [-s seed] [-1 P1 %%] [-2 P2 %%] [-t temperature] [-r humidity] [-o file] [-i input] [-l image]\n", pcName);
+   fprintf(stderr, "  -d  virtual time to run for (default 3600 s)\n");
+   fprintf(stderr, "  -s  random number seed (default 1)\n");
+   fprintf(stderr, "  -1  P1 low pulse occupancy (default 5 %%)\n");
+   fprintf(stderr, "  -2  P2 low pulse occupancy (default 1 %%)\n");
+   fprintf(stderr, "  -t  temperature (default 21.5 C)\n");
+   fprintf(stderr, "  -r  relative humidity (default 45 %%)\n");
+   fprintf(stderr, "  -o  file for the console output (default uart.bin)\n");
+   fprintf(stderr, "  -i  console input, typed 1 s before the end of the run\n");
+   fprintf(stderr, "  -l  file holding the serial flash (default an erased flash)\n");
+   exit(1);
+}
+
+
+/****************************************************************************
+     Function: SIMMAIN_PrintSummary
+     Engineer: agent
+        Input: double dSeconds: Virtual time the firmware ran for.
+               double dRealSeconds: Real time taken.
+       Output: N/A
+  Description: Prints the counts from the run.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added the serial flash.
+17-OCT-2026    agent       Added the TLC59116 bytes.
+17-OCT-2026    agent       Added the missed edges.
+17-OCT-2026    agent       Added the network processor on time.
+****************************************************************************/
+static void SIMMAIN_PrintSummary(double dSeconds, double dRealSeconds)
+{
+   TySimStatistics *ptyStatistics;
+   const TySimFlashStatistics *ptyFlash;
+   TySimTime ullNow;
+
+   ptyStatistics = SIM_GetStatistics();
+   ptyFlash      = SIMFLASH_GetStatistics();
+   ullNow        = SIM_GetTime();
+
+   fprintf(stderr, "Simulated %.3f s in %.3f s", dSeconds, dRealSeconds);
+   if (dRealSeconds > 0.0)
+      fprintf(stderr, " (%.0f times real time)", dSeconds / dRealSeconds);
+   fprintf(stderr, "\n");
+
+   fprintf(stderr, "UART bytes sent:      %lu\n", ptyStatistics->ulUartBytes);
+   fprintf(stderr, "Interrupts:           %lu\n", ptyStatistics->ulInterrupts);
+   fprintf(stderr, "I2C transfers:        %lu (%lu not acknowledged)\n", ptyStatistics->ulI2CTransfers, ptyStatistics->ulI2CNacks);
+   fprintf(stderr, "HDC1080 conversions:  %lu\n", ptyStatistics->ulHDC1080Conversions);
+   fprintf(stderr, "TLC59116 writes:      %lu (%lu bytes)\n", ptyStatistics->ulTLC59116Writes, ptyStatistics->ulTLC59116Bytes);
+   fprintf(stderr, "Flash writes:         %lu (%llu bytes, %lu blocks erased)\n",
+           ptyFlash->ulWrites, ptyFlash->ullBytesWritten, ptyFlash->ulErases);
+
+   if (ullNow > 0)
+      {
+      fprintf(stderr, "Asleep:               %.2f %%\n", (100.0 * ptyStatistics->ullSleepCycles) / ullNow);
+      fprintf(stderr, "Network processor on: %.3f %% (%.1f ms, %lu starts)\n",
+              (100.0 * ptyFlash->ullOnCycles) / ullNow, (double)ptyFlash->ullOnCycles / SIM_CYCLES_PER_MS, ptyFlash->ulStarts);
+      fprintf(stderr, "P1 occupancy:         %.2f %%\n", (100.0 * ptyStatistics->pullLowCycles[0]) / ullNow);
+      fprintf(stderr, "P2 occupancy:         %.2f %%\n", (100.0 * ptyStatistics->pullLowCycles[1]) / ullNow);
+      }
+   fprintf(stderr, "Missed edges:         P1 %lu, P2 %lu\n", ptyStatistics->pulMissedEdges[0], ptyStatistics->pulMissedEdges[1]);
+
+   SIMDEVICES_PrintLeds(stderr);
+}
+
+
+int main(int argc, char **argv)
+{
+   int iOption;
+   double dDuration, dRealSeconds;
+   const char *pcCaptureFile, *pcFlashImage;
+   FILE *ptyCapture;
+   TySimSettings tySettings;
+   struct itimerval tyTimer;
+   struct timespec tyStart, tyEnd;
+
+   dDuration                = 3600.0;
+   pcCaptureFile            = "uart.bin";
+   tySettings.ulSeed        = 1;
+   tySettings.dP1Occupancy  = 0.05;
+   tySettings.dP2Occupancy  = 0.01;
+   tySettings.dTemperature  = 21.5;
+   tySettings.dHumidity     = 45.0;
+   tySettings.bNoise        = TRUE;
+   pcLocalConsoleInput      = NULL;
+   pcFlashImage             = NULL;
+
+   while ((iOption = getopt(argc, argv, "d:s:1:2:t:r:o:i:l:")) != -1)
+      {
+      switch (iOption)
+         {
+         case 'd': dDuration               = atof(optarg);                 break;
+         case 's': tySettings.ulSeed       = strtoul(optarg, NULL, 0);     break;
+         case '1': tySettings.dP1Occupancy = atof(optarg) / 100.0;         break;
+         case '2': tySettings.dP2Occupancy = atof(optarg) / 100.0;         break;
+         case 't': tySettings.dTemperature = atof(optarg);                 break;
+         case 'r': tySettings.dHumidity    = atof(optarg);                 break;
+         case 'o': pcCaptureFile           = optarg;                       break;
+         case 'i': pcLocalConsoleInput     = optarg;                       break;
+         case 'l': pcFlashImage            = optarg;                       break;
+         default:  SIMMAIN_Usage(argv[0]);                                 break;
+         }
+      }
+
+   if ((optind != argc) || (dDuration <= 0.0))
+      SIMMAIN_Usage(argv[0]);
+
+   ptyCapture = fopen(pcCaptureFile, "wb");
+   if (ptyCapture == NULL)
+      {
+      perror(pcCaptureFile);
+      return 1;
+      }
+
+   SIM_Initialise();
+   SIMHAL_Initialise(ptyCapture);
+   SIMDEVICES_Initialise(&tySettings);
+   SIMFLASH_Initialise(pcFlashImage);
+
+   SIM_Schedule(&tyLocalEndEvent, (TySimTime)(dDuration * SIM_CLOCK_HZ), SIMMAIN_End);
+
+   if (pcLocalConsoleInput != NULL)
+      {
+      if (dDuration > SIM_INPUT_LEAD_SECONDS)
+         SIM_Schedule(&tyLocalInputEvent, (TySimTime)((dDuration - SIM_INPUT_LEAD_SECONDS) * SIM_CLOCK_HZ), SIMMAIN_Input);
+      else
+         SIM_Schedule(&tyLocalInputEvent, 0, SIMMAIN_Input);
+      }
+
+   signal(SIGALRM, SIMMAIN_Watchdog);
+   tyTimer.it_interval.tv_sec  = SIM_STALL_SECONDS;
+   tyTimer.it_interval.tv_usec = 0;
+   tyTimer.it_value            = tyTimer.it_interval;
+   setitimer(ITIMER_REAL, &tyTimer, NULL);
+
+   clock_gettime(CLOCK_MONOTONIC, &tyStart);
+
+   FIRMWARE_Main();
+
+   clock_gettime(CLOCK_MONOTONIC, &tyEnd);
+
+   tyTimer.it_value.tv_sec = 0;
+   setitimer(ITIMER_REAL, &tyTimer, NULL);
+
+   fclose(ptyCapture);
+
+   dRealSeconds = (tyEnd.tv_sec - tyStart.tv_sec) + (tyEnd.tv_nsec - tyStart.tv_nsec) / 1e9;
+
+   if (tyLocalEndEvent.bQueued)
+      {
+      fprintf(stderr, "sim: the firmware returned at %.6f s, before the end of the run\n", (double)SIM_GetTime() / SIM_CLOCK_HZ);
+      SIMMAIN_PrintSummary((double)SIM_GetTime() / SIM_CLOCK_HZ, dRealSeconds);
+      return 1;
+      }
+
+   SIMMAIN_PrintSummary((double)SIM_GetTime() / SIM_CLOCK_HZ, dRealSeconds);
+
+   return 0;
+}
@@ -0,0 +1,557 @@
+/****************************************************************************
+       Module: SIMPULSES.c
+     Engineer: agent
+  Description: Contains the pulse trains driven onto the PPD42NJ outputs (P1
+               and P2) in the host simulation, and the exact record of them
+               that the firmware's measurements are checked against:
+
+                  OCCUPANCY    Random 10 - 90 ms pulses, with random gaps
+                               averaging the length that gives the required
+                               occupancy (as the real sensor).
+                  POISSON      Bursts of short pulses starting at random
+                               (Poisson) times. The widths and gaps in a
+                               burst are also random (exponential).
+                  FIXED        Pulses of a fixed width and gap, used to find
+                               the highest edge rate that is handled.
+                  BOUNDARY     One pulse across each one second boundary of
+                               the PPD42NJ timer, at a random point in it.
+                  FILE         Pulses recorded from a sensor and replayed.
+
+               A recorded file has one pulse a line: the channel (1 for P1,
+               2 for P2), the start time and the width, both in us and
+               separated by spaces. The start times are from the origin
+               (normally the start of the first second of the PPD42NJ
+               timer) and must be in order for each channel. Lines starting
+               with # are ignored.
+
+               Each pulse is recorded against the second in which it ends,
+               as that is the second the firmware adds it to. So is the part
+               of a us that the firmware loses truncating it to whole us,
+               and the edges that are lost because the interrupt for the
+               last one is still pending are counted.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Records the truncation and the lost edges.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "includes.h"
+#include "SIM.h"
+
+#define SIM_PULSES_CYCLES_PER_US  (SIM_CLOCK_HZ / 1000000ull)
+#define SIM_PULSES_CYCLES_PER_S   SIM_CLOCK_HZ
+
+// OCCUPANCY low pulse lengths, in ms....
+#define SIM_PULSES_MIN_MS         10
+#define SIM_PULSES_MAX_MS         90
+
+// Occupancy above this leaves too little gap between the pulses....
+#define SIM_PULSES_MAX_OCCUPANCY  0.95
+
+// Recorded pulses, from the file....
+typedef struct
+{
+   TySimTime ullStart;
+   TySimTime ullWidth;
+} TySimRecordedPulse;
+
+typedef struct
+{
+   TySimPulseSettings tySettings;
+   TySimEvent tyEvent;
+   unsigned char ucLevel;
+   TySimTime ullFall;
+   TySimTime ullWidth;
+   double dMeanGapCycles;             // OCCUPANCY
+   unsigned long ulBurstLeft;         // POISSON: pulses left in the burst.
+   unsigned long ulNextRecorded;      // FILE: index of the next pulse.
+   TySimRecordedPulse *ptyRecorded;   // FILE
+   unsigned long ulRecordedCount;     // FILE
+   TySimPulseTruth tyTruth;
+   TySimTime pullSecondCycles[SIM_PULSES_SECONDS];
+   TySimTime pullSecondTruncated[SIM_PULSES_SECONDS];
+   unsigned long pulSecondTags[SIM_PULSES_SECONDS];
+} TySimPulseChannel;
+
+// Input pin driven by each channel (P1, P2), as in pinmux.c....
+static const unsigned long pulLocalPins[SIM_PULSES_CHANNELS] = {PIN_04, PIN_03};
+
+static TySimPulseChannel ptyLocalChannels[SIM_PULSES_CHANNELS];
+static TySimTime ullLocalOrigin;
+static unsigned long ulLocalRandom;
+
+
+/****************************************************************************
+     Function: SIMPULSES_Random
+     Engineer: agent
+        Input: N/A
+       Output: double: Random number, 0 <= n < 1.
+  Description: 32 bit xorshift generator.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static double SIMPULSES_Random(void)
+{
+   ulLocalRandom ^= (ulLocalRandom << 13) & 0xFFFFFFFFul;
+   ulLocalRandom ^= ulLocalRandom >> 17;
+   ulLocalRandom ^= (ulLocalRandom << 5) & 0xFFFFFFFFul;
+
+   return (double)ulLocalRandom / 4294967296.0;
+}
+
+
+/****************************************************************************
+     Function: SIMPULSES_Exponential
+     Engineer: agent
+        Input: double dMean: Mean, in cycles.
+       Output: TySimTime: Random time, at least one cycle.
+  Description: Returns an exponentially distributed time, i.e. the time to
+               the next event of a Poisson process.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static TySimTime SIMPULSES_Exponential(double dMean)
+{
+   TySimTime ullCycles;
+
+   ullCycles = (TySimTime)(-dMean * log(1.0 - SIMPULSES_Random()));
+
+   return (ullCycles == 0) ? 1 : ullCycles;
+}
+
+
+/****************************************************************************
+     Function: SIMPULSES_Next
+     Engineer: agent
+        Input: TySimPulseChannel *ptyChannel: Channel.
+               TySimTime *pullStart: Where to put the start of the pulse.
+               TySimTime *pullWidth: Where to put the width of the pulse.
+       Output: unsigned char: TRUE if there is another pulse.
+  Description: Works out the next pulse of a channel. The output is high,
+               and the pulse starts after the current time.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SIMPULSES_Next(TySimPulseChannel *ptyChannel, TySimTime *pullStart, TySimTime *pullWidth)
+{
+   TySimTime ullNow, ullWidth, ullSecond;
+   const TySimPulseSettings *ptySettings;
+   const TySimRecordedPulse *ptyRecorded;
+
+   ullNow      = SIM_GetTime();
+   ptySettings = &ptyChannel->tySettings;
+   ullWidth    = (TySimTime)ptySettings->ulWidth * SIM_PULSES_CYCLES_PER_US;
+
+   switch (ptySettings->tyMode)
+      {
+      case SIM_PULSES_OCCUPANCY:
+         *pullStart = ullNow + (TySimTime)(ptyChannel->dMeanGapCycles * (0.5 + SIMPULSES_Random())) + 1;
+         *pullWidth = (TySimTime)((SIM_PULSES_MIN_MS + SIMPULSES_Random() * (SIM_PULSES_MAX_MS - SIM_PULSES_MIN_MS)) * SIM_CYCLES_PER_MS);
+      break;
+
+      case SIM_PULSES_POISSON:
+         if (ptyChannel->ulBurstLeft == 0)
+            {
+            // Start a new burst of 1 to (2 x mean - 1) pulses....
+            *pullStart = ullNow + SIMPULSES_Exponential(SIM_PULSES_CYCLES_PER_S / ptySettings->dBurstRate);
+            ptyChannel->ulBurstLeft = 1 + (unsigned long)(SIMPULSES_Random() * ((2 * ptySettings->ulBurstPulses) - 1));
+            }
+         else
+            {
+            *pullStart = ullNow + SIMPULSES_Exponential((double)ptySettings->ulGap * SIM_PULSES_CYCLES_PER_US);
+            }
+         ptyChannel->ulBurstLeft--;
+
+         *pullWidth = SIMPULSES_Exponential((double)ullWidth);
+      break;
+
+      case SIM_PULSES_FIXED:
+         *pullStart = ullNow + ((TySimTime)ptySettings->ulGap * SIM_PULSES_CYCLES_PER_US);
+         *pullWidth = ullWidth;
+      break;
+
+      case SIM_PULSES_BOUNDARY:
+         // The first boundary that a pulse can still be started across....
+         ullSecond = ullLocalOrigin;
+         if (ullNow + ullWidth >= ullLocalOrigin)
+            ullSecond += (((ullNow + ullWidth - ullLocalOrigin) / SIM_PULSES_CYCLES_PER_S) + 1) * SIM_PULSES_CYCLES_PER_S;
+
+         *pullStart = ullSecond - 1 - (TySimTime)(SIMPULSES_Random() * (ullWidth - 1));
+         *pullWidth = ullWidth;
+      break;
+
+      case SIM_PULSES_FILE:
+         if (ptyChannel->ulNextRecorded >= ptyChannel->ulRecordedCount)
+            return FALSE;
+
+         ptyRecorded = &ptyChannel->ptyRecorded[ptyChannel->ulNextRecorded++];
+         if (ullLocalOrigin + ptyRecorded->ullStart <= ullNow)
+            SIM_Fatal("recorded pulse %lu overlaps the one before it", ptyChannel->ulNextRecorded);
+
+         *pullStart = ullLocalOrigin + ptyRecorded->ullStart;
+         *pullWidth = ptyRecorded->ullWidth;
+      break;
+
+      default:
+         return FALSE;
+      }
+
+   if (*pullWidth == 0)
+      *pullWidth = 1;
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: SIMPULSES_Record
+     Engineer: agent
+        Input: TySimPulseChannel *ptyChannel: Channel.
+               unsigned char ucChannel: Channel number.
+       Output: N/A
+  Description: Records a pulse that has just ended, against the second that
+               it ended in.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Records the truncation.
+****************************************************************************/
+static void SIMPULSES_Record(TySimPulseChannel *ptyChannel, unsigned char ucChannel)
+{
+   unsigned long ulSecond, ulSlot;
+   TySimTime ullNow, ullTruncated;
+
+   ullNow       = SIM_GetTime();
+   ullTruncated = ptyChannel->ullWidth % SIM_PULSES_CYCLES_PER_US;
+
+   ptyChannel->tyTruth.ulPulses++;
+   ptyChannel->tyTruth.ullLowCycles += ptyChannel->ullWidth;
+   ptyChannel->tyTruth.ullTruncatedCycles += ullTruncated;
+   if (ptyChannel->ullWidth < ptyChannel->tyTruth.ullShortestCycles)
+      ptyChannel->tyTruth.ullShortestCycles = ptyChannel->ullWidth;
+
+   SIM_GetStatistics()->pullLowCycles[ucChannel] += ptyChannel->ullWidth;
+
+   if (ullNow < ullLocalOrigin)
+      return;
+
+   ulSecond = (unsigned long)((ullNow - ullLocalOrigin) / SIM_PULSES_CYCLES_PER_S);
+   ulSlot   = ulSecond % SIM_PULSES_SECONDS;
+
+   if (ptyChannel->pulSecondTags[ulSlot] != ulSecond)
+      {
+      ptyChannel->pulSecondTags[ulSlot]       = ulSecond;
+      ptyChannel->pullSecondCycles[ulSlot]    = 0;
+      ptyChannel->pullSecondTruncated[ulSlot] = 0;
+      }
+   ptyChannel->pullSecondCycles[ulSlot]    += ptyChannel->ullWidth;
+   ptyChannel->pullSecondTruncated[ulSlot] += ullTruncated;
+}
+
+
+/****************************************************************************
+     Function: SIMPULSES_Edge
+     Engineer: agent
+        Input: TySimEvent *ptyEvent: Event of the channel.
+       Output: N/A
+  Description: Drives the next edge of a channel, and schedules the one
+               after it.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Counts the lost edges.
+****************************************************************************/
+static void SIMPULSES_Edge(TySimEvent *ptyEvent)
+{
+   unsigned char ucChannel;
+   TySimTime ullStart, ullWidth;
+   TySimPulseChannel *ptyChannel;
+
+   ucChannel  = (unsigned char)(uintptr_t)ptyEvent->pvContext;
+   ptyChannel = &ptyLocalChannels[ucChannel];
+
+   if (ptyChannel->ucLevel)
+      {
+      // Start of the pulse....
+      ptyChannel->ucLevel = 0;
+      ptyChannel->ullFall = SIM_GetTime();
+      ptyChannel->tyTruth.ulEdges++;
+      if (SIMHAL_DriveInput(pulLocalPins[ucChannel], 0) != TRUE)
+         SIM_GetStatistics()->pulMissedEdges[ucChannel]++;
+
+      SIM_Schedule(ptyEvent, ptyChannel->ullFall + ptyChannel->ullWidth, SIMPULSES_Edge);
+      return;
+      }
+
+   // End of the pulse....
+   ptyChannel->ucLevel = 1;
+   ptyChannel->tyTruth.ulEdges++;
+   if (SIMHAL_DriveInput(pulLocalPins[ucChannel], 1) != TRUE)
+      SIM_GetStatistics()->pulMissedEdges[ucChannel]++;
+   SIMPULSES_Record(ptyChannel, ucChannel);
+
+   if (SIMPULSES_Next(ptyChannel, &ullStart, &ullWidth))
+      {
+      ptyChannel->ullWidth = ullWidth;
+      SIM_Schedule(ptyEvent, ullStart, SIMPULSES_Edge);
+      }
+}
+
+
+/****************************************************************************
+     Function: SIMPULSES_Initialise
+     Engineer: agent
+        Input: unsigned long ulSeed: Random number seed.
+       Output: N/A
+  Description: Stops all the channels, with their outputs high, and clears
+               the records. The origin is set to time 0.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIMPULSES_Initialise(unsigned long ulSeed)
+{
+   unsigned char ucChannel;
+   unsigned long i;
+
+   for (ucChannel=0; ucChannel < SIM_PULSES_CHANNELS; ucChannel++)
+      {
+      SIM_Cancel(&ptyLocalChannels[ucChannel].tyEvent);
+      free(ptyLocalChannels[ucChannel].ptyRecorded);
+
+      memset(&ptyLocalChannels[ucChannel], 0, sizeof(ptyLocalChannels[ucChannel]));
+      ptyLocalChannels[ucChannel].ucLevel = 1;
+      ptyLocalChannels[ucChannel].tyEvent.pvContext = (void *)(uintptr_t)ucChannel;
+      ptyLocalChannels[ucChannel].tyTruth.ullShortestCycles = ~0ull;
+
+      for (i=0; i < SIM_PULSES_SECONDS; i++)
+         ptyLocalChannels[ucChannel].pulSecondTags[i] = ~0ul;
+      }
+
+   ullLocalOrigin = 0;
+
+   ulLocalRandom = ulSeed & 0xFFFFFFFFul;
+   if (ulLocalRandom == 0)
+      ulLocalRandom = 1;
+}
+
+
+/****************************************************************************
+     Function: SIMPULSES_Stop
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Stops all the channels where they are, keeping the records.
+               A pulse that has started is left low and is not recorded.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIMPULSES_Stop(void)
+{
+   unsigned char ucChannel;
+
+   for (ucChannel=0; ucChannel < SIM_PULSES_CHANNELS; ucChannel++)
+      SIM_Cancel(&ptyLocalChannels[ucChannel].tyEvent);
+}
+
+
+/****************************************************************************
+     Function: SIMPULSES_SetOrigin
+     Engineer: agent
+        Input: TySimTime ullOrigin: Start of the first second.
+       Output: N/A
+  Description: Sets the time that the seconds are counted from, and that the
+               BOUNDARY pulses and recorded pulses are placed against. This
+               is normally when the PPD42NJ timer was started.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIMPULSES_SetOrigin(TySimTime ullOrigin)
+{
+   ullLocalOrigin = ullOrigin;
+}
+
+
+/****************************************************************************
+     Function: SIMPULSES_Load
+     Engineer: agent
+        Input: const char *pcFile: Recorded pulse file.
+       Output: unsigned char: TRUE: Success, FALSE: Failure (reported).
+  Description: Reads a recorded pulse file, for the FILE pulse trains.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+unsigned char SIMPULSES_Load(const char *pcFile)
+{
+   FILE *ptyFile;
+   char pcLine[256];
+   unsigned long ulLine, ulChannel;
+   double dStart, dWidth;
+   TySimPulseChannel *ptyChannel;
+   TySimRecordedPulse *ptyPulses;
+
+   ptyFile = fopen(pcFile, "r");
+   if (ptyFile == NULL)
+      {
+      perror(pcFile);
+      return FALSE;
+      }
+
+   ulLine = 0;
+   while (fgets(pcLine, sizeof(pcLine), ptyFile) != NULL)
+      {
+      ulLine++;
+
+      if ((pcLine[0] == '#') || (pcLine[strspn(pcLine, " \t\r\n")] == '\0'))
+         continue;
+
+      if ((sscanf(pcLine, "%lu %lf %lf", &ulChannel, &dStart, &dWidth) != 3) ||
+          (ulChannel < 1) || (ulChannel > SIM_PULSES_CHANNELS) || (dStart < 0.0) || (dWidth <= 0.0))
+         {
+         fprintf(stderr, "%s:%lu: expected <channel> <start us> <width us>\n", pcFile, ulLine);
+         fclose(ptyFile);
+         return FALSE;
+         }
+
+      ptyChannel = &ptyLocalChannels[ulChannel - 1];
+
+      ptyPulses = realloc(ptyChannel->ptyRecorded, (ptyChannel->ulRecordedCount + 1) * sizeof(TySimRecordedPulse));
+      if (ptyPulses == NULL)
+         SIM_Fatal("out of memory reading %s", pcFile);
+
+      ptyPulses[ptyChannel->ulRecordedCount].ullStart = (TySimTime)(dStart * SIM_PULSES_CYCLES_PER_US);
+      ptyPulses[ptyChannel->ulRecordedCount].ullWidth = (TySimTime)(dWidth * SIM_PULSES_CYCLES_PER_US);
+
+      ptyChannel->ptyRecorded = ptyPulses;
+      ptyChannel->ulRecordedCount++;
+      }
+
+   fclose(ptyFile);
+
+   return TRUE;
+}
+
+
+/****************************************************************************
+     Function: SIMPULSES_Start
+     Engineer: agent
+        Input: unsigned char ucChannel: Channel (0 for P1, 1 for P2).
+               const TySimPulseSettings *ptySettings: Pulse train.
+       Output: N/A
+  Description: Starts the pulse train of a channel. A FILE train needs the
+               file loaded by SIMPULSES_Load first.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+void SIMPULSES_Start(unsigned char ucChannel, const TySimPulseSettings *ptySettings)
+{
+   double dOccupancy, dMeanPulse;
+   TySimTime ullStart, ullWidth;
+   TySimPulseChannel *ptyChannel;
+
+   ptyChannel = &ptyLocalChannels[ucChannel];
+   ptyChannel->tySettings = *ptySettings;
+
+   switch (ptySettings->tyMode)
+      {
+      case SIM_PULSES_OCCUPANCY:
+         dOccupancy = ptySettings->dOccupancy;
+         if (dOccupancy <= 0.0)
+            return;
+         if (dOccupancy > SIM_PULSES_MAX_OCCUPANCY)
+            dOccupancy = SIM_PULSES_MAX_OCCUPANCY;
+
+         dMeanPulse = ((SIM_PULSES_MIN_MS + SIM_PULSES_MAX_MS) / 2.0) * SIM_CYCLES_PER_MS;
+         ptyChannel->dMeanGapCycles = dMeanPulse * (1.0 - dOccupancy) / dOccupancy;
+      break;
+
+      case SIM_PULSES_POISSON:
+         if ((ptySettings->dBurstRate <= 0.0) || (ptySettings->ulBurstPulses == 0))
+            return;
+      break;
+
+      case SIM_PULSES_FIXED:
+      case SIM_PULSES_BOUNDARY:
+         if (ptySettings->ulWidth == 0)
+            return;
+      break;
+
+      default:
+      break;
+      }
+
+   if (SIMPULSES_Next(ptyChannel, &ullStart, &ullWidth))
+      {
+      ptyChannel->ullWidth = ullWidth;
+      SIM_Schedule(&ptyChannel->tyEvent, ullStart, SIMPULSES_Edge);
+      }
+}
+
+
+/****************************************************************************
+     Function: SIMPULSES_GetTruth
+     Engineer: agent
+        Input: unsigned char ucChannel: Channel (0 for P1, 1 for P2).
+       Output: const TySimPulseTruth *: Record of the pulses driven.
+  Description: Returns the record of the pulses that have ended so far.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+const TySimPulseTruth *SIMPULSES_GetTruth(unsigned char ucChannel)
+{
+   return &ptyLocalChannels[ucChannel].tyTruth;
+}
+
+
+/****************************************************************************
+     Function: SIMPULSES_GetSecond
+     Engineer: agent
+        Input: unsigned char ucChannel: Channel (0 for P1, 1 for P2).
+               unsigned long ulSecond: Second from the origin.
+       Output: TySimTime: Low time, in cycles, of the pulses that ended in
+                  the second.
+  Description: Returns the low time recorded against a second. Only the
+               last SIM_PULSES_SECONDS seconds are kept.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+TySimTime SIMPULSES_GetSecond(unsigned char ucChannel, unsigned long ulSecond)
+{
+   unsigned long ulSlot;
+   TySimPulseChannel *ptyChannel;
+
+   ptyChannel = &ptyLocalChannels[ucChannel];
+   ulSlot     = ulSecond % SIM_PULSES_SECONDS;
+
+   if (ptyChannel->pulSecondTags[ulSlot] != ulSecond)
+      return 0;
+
+   return ptyChannel->pullSecondCycles[ulSlot];
+}
+
+
+/****************************************************************************
+     Function: SIMPULSES_GetSecondTruncated
+     Engineer: agent
+        Input: unsigned char ucChannel: Channel (0 for P1, 1 for P2).
+               unsigned long ulSecond: Second from the origin.
+       Output: TySimTime: Cycles lost truncating each of the pulses that
+                  ended in the second to whole us.
+  Description: Returns the part of the low time recorded against a second
+               that the firmware is not expected to measure. Only the last
+               SIM_PULSES_SECONDS seconds are kept.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+TySimTime SIMPULSES_GetSecondTruncated(unsigned char ucChannel, unsigned long ulSecond)
+{
+   unsigned long ulSlot;
+   TySimPulseChannel *ptyChannel;
+
+   ptyChannel = &ptyLocalChannels[ucChannel];
+   ulSlot     = ulSecond % SIM_PULSES_SECONDS;
+
+   if (ptyChannel->pulSecondTags[ulSlot] != ulSecond)
+      return 0;
+
+   return ptyChannel->pullSecondTruncated[ulSlot];
+}
@@ -0,0 +1,1651 @@
+/****************************************************************************
+       Module: SIMTEST.c
+     Engineer: agent
+  Description: Contains main for the host tests. Each test runs firmware
+               modules against the simulated board (see SIMDEVICES.c) and
+               checks the results against reference values worked out here,
+               not by the firmware.
+
+               usage: simtest [-t test] [-v]
+
+               With no -t every test is run. The tests are:
+
+                  hdc1080      Raw to physical conversion of the
+                               temperature and humidity at each
+                               resolution, in 0.01 units for the
+                               non-blocking reads.
+                  tlc59116     Transfers and bytes written to the LED
+                               driver by each commit.
+                  ledanim      LED colours of a stepped ramp, a breathing
+                               and a colour blend after each update,
+                               against their keyframes, with late
+                               updates.
+                  ppd42nj      Particle concentration curve and mass
+                               estimates, against the floating point
+                               formula, for full and partly filled windows
+                               and after the window is changed.
+                  pulsewidth   Integer low pulse width against the
+                               floating point maths it replaced, for every
+                               width and every timer value at the edges,
+                               with and without the timer wrapping.
+                  aggregate    Minute, quarter hour and hour roll-ups and
+                               the rings of completed buckets, either side
+                               of each boundary and once the rings have
+                               wrapped.
+                  wrap         Software timers, the idle time and the
+                               PPD42NJ second counter across the wrap of
+                               their 32 bit counts.
+                  uarttx       Console writes overflowing the transmit
+                               buffer with UARTTX_DROP_OLDEST arrive whole
+                               and in order, with the newest kept.
+
+               -v prints every check, not only those that fail.
+
+               Returns 1 if any check fails.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added the TLC59116 test.
+17-OCT-2026    agent       Added the PPD42NJ test.
+17-OCT-2026    agent       Added the aggregate test.
+17-OCT-2026    agent       Added the pulse width test.
+17-OCT-2026    agent       Added the LED animation test.
+17-OCT-2026    agent       Added the UARTTX test.
+17-OCT-2026    agent       Added the wrap test. The LED animation runs
+                           across the wrap of the millisecond count.
+17-OCT-2026    agent       The HDC1080 non-blocking reads are checked in
+                           0.01 units.
+****************************************************************************/
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "includes.h"
+#include "SIM.h"
+
+// Longest wait for a driver to call back, in virtual milliseconds....
+#define SIMTEST_TIMEOUT_MS        1000
+
+// Step used to run the board for long periods (10 us)....
+#define SIMTEST_STEP_CYCLES       (SIM_CYCLES_PER_MS / 100)
+
+typedef struct
+{
+   const char *pcName;
+   void (*Run)(void);
+} TyTest;
+
+static unsigned long ulLocalChecks;
+static unsigned long ulLocalFailures;
+static unsigned char bLocalVerbose;
+
+// TLC59116 registers used by the tests, from the datasheet....
+#define SIMTEST_TLC59116_PWM0     0x02
+#define SIMTEST_TLC59116_GRPPWM   0x12
+#define SIMTEST_TLC59116_GRPFREQ  0x13
+#define SIMTEST_TLC59116_LEDOUT0  0x14
+#define SIMTEST_TLC59116_COUNT    0x18
+
+// Results of the HDC1080 reads....
+static volatile unsigned char bLocalDone;
+static unsigned char bLocalSuccess;
+static long plLocalValues[0x2];    // In 0.01 units.
+
+// Particle concentration curve and the particle masses, from the comments in
+// PPD42NJ.c, worked out here in floating point....
+#define SIMTEST_CURVE(r)          ((((1.1 * (r)) - 3.8) * (r) + 520.0) * (r) + 0.62)
+#define SIMTEST_DENSITY           1.65e12      // ug/m3
+#define SIMTEST_PM25_RADIUS       0.44e-6      // m
+#define SIMTEST_PM10_RADIUS       2.6e-6       // m
+#define SIMTEST_CUBIC_FOOT        2.83168e-2   // m3
+
+// TIMERA0 counts up from 0 to the end of its one second period, in 80 MHz
+// ticks....
+#define SIMTEST_TIMER_PERIOD      80000000ul
+
+// The aggregate test runs for a day and an hour, plus a minute, so that
+// every ring has wrapped....
+#define SIMTEST_AGGREGATE_SECONDS ((AGGREGATE_HOURS + 1ul) * 3600ul + 60ul)
+
+// Registers the LED driver should hold....
+static unsigned char pucLocalTLC59116[SIMTEST_TLC59116_COUNT];
+
+// Samples given to the aggregates, by channel and second....
+static unsigned long ppulLocalSamples[AGGREGATE_CHANNEL_COUNT][SIMTEST_AGGREGATE_SECONDS];
+
+// Software timers of the wrap test: a one shot due before the millisecond
+// count wraps, one due after it, and a periodic one....
+#define SIMTEST_WRAP_BEFORE       0
+#define SIMTEST_WRAP_AFTER        1
+#define SIMTEST_WRAP_PERIODIC     2
+#define SIMTEST_WRAP_TIMERS       3
+static TySoftwareTimer ptyLocalWrapTimers[SIMTEST_WRAP_TIMERS];
+static unsigned long pulLocalWrapFired[SIMTEST_WRAP_TIMERS];   // Times fired.
+static TySimTime pullLocalWrapTimes[SIMTEST_WRAP_TIMERS];      // Last fired.
+static unsigned long ulLocalWrapPeriodError;                   // Cycles.
+static unsigned long ulLocalWrapHistory;                       // Notifications.
+
+// Console writes made by the UARTTX test....
+#define SIMTEST_UARTTX_WRITES     400
+
+// Where SIMTEST_Boot sends the console output, if anywhere....
+static FILE *ptyLocalUartCapture;
+
+
+/****************************************************************************
+     Function: SIMTEST_Check
+     Engineer: agent
+        Input: unsigned char bPassed: Result of the check.
+               const char *pcFormat, ...: Description of the check.
+       Output: unsigned char: bPassed.
+  Description: Counts a check, and prints it if it failed (or with -v).
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SIMTEST_Check(unsigned char bPassed, const char *pcFormat, ...)
+{
+   va_list tyArguments;
+
+   ulLocalChecks++;
+   if (bPassed == FALSE)
+      ulLocalFailures++;
+
+   if ((bPassed == FALSE) || bLocalVerbose)
+      {
+      printf("   %s  ", bPassed ? "ok  " : "FAIL");
+      va_start(tyArguments, pcFormat);
+      vprintf(pcFormat, tyArguments);
+      va_end(tyArguments);
+      printf("\n");
+      }
+
+   return bPassed;
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_Boot
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Resets the board, with noiseless devices, and starts the
+               firmware's time base, scheduler and I2C bus as its main does.
+               The console output goes to ptyLocalUartCapture.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Captures the console output.
+****************************************************************************/
+static void SIMTEST_Boot(void)
+{
+   TySimSettings tySettings;
+
+   memset(&tySettings, 0, sizeof(tySettings));
+   tySettings.ulSeed       = 1;
+   tySettings.dTemperature = 21.5;
+   tySettings.dHumidity    = 45.0;
+   tySettings.bNoise       = FALSE;
+
+   SIM_Initialise();
+   SIMHAL_Initialise(ptyLocalUartCapture);
+   SIMDEVICES_Initialise(&tySettings);
+
+   MAP_IntMasterEnable();
+   MAP_IntEnable(FAULT_SYSTICK);
+   TIMER_Initialise();
+   SCHEDULER_Initialise();
+   PinMuxConfig();
+   I2C_IF_Open(I2C_MASTER_MODE_FST);
+
+   if (I2CQUEUE_Initialise() != TRUE)
+      SIM_Fatal("the I2C queue did not initialise");
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_Wait
+     Engineer: agent
+        Input: N/A
+       Output: unsigned char: TRUE if bLocalDone was set in time.
+  Description: Runs the board, a millisecond at a time, until a callback
+               sets bLocalDone or SIMTEST_TIMEOUT_MS passes.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SIMTEST_Wait(void)
+{
+   unsigned long ulMilliseconds;
+
+   for (ulMilliseconds=0; (bLocalDone == FALSE) && (ulMilliseconds < SIMTEST_TIMEOUT_MS); ulMilliseconds++)
+      SIM_Advance(SIM_CYCLES_PER_MS);
+
+   return bLocalDone;
+}
+
+
+/* ======================================================================== */
+/*  HDC1080                                                                 */
+/* ======================================================================== */
+
+/****************************************************************************
+     Function: SIMTEST_HDC1080Read
+     Engineer: agent
+        Input: unsigned char bSuccess: TRUE if the read succeeded.
+               short sValue: Temperature or humidity, in 0.01 units.
+       Output: N/A
+  Description: Callback for the single channel HDC1080 reads.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Given 0.01 units.
+****************************************************************************/
+static void SIMTEST_HDC1080Read(unsigned char bSuccess, short sValue)
+{
+   bLocalSuccess    = bSuccess;
+   plLocalValues[0] = sValue;
+   bLocalDone       = TRUE;
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_HDC1080ReadBoth
+     Engineer: agent
+        Input: unsigned char bSuccess: TRUE if the read succeeded.
+               short sTemperature: Temperature in 0.01 degree C units.
+               unsigned short usHumidity: Humidity in 0.01 % units.
+       Output: N/A
+  Description: Callback for the combined HDC1080 read.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Given 0.01 units.
+****************************************************************************/
+static void SIMTEST_HDC1080ReadBoth(unsigned char bSuccess, short sTemperature, unsigned short usHumidity)
+{
+   bLocalSuccess    = bSuccess;
+   plLocalValues[0] = sTemperature;
+   plLocalValues[1] = usHumidity;
+   bLocalDone       = TRUE;
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_HDC1080Measure
+     Engineer: agent
+        Input: TyHDC1080Channel tyChannel: Channel(s) to read.
+               double dTemperature, dHumidity: Climate to measure.
+       Output: unsigned char: TRUE if the read succeeded (checked).
+  Description: Reads the HDC1080 through the driver's non-blocking read, as
+               the firmware does, into plLocalValues.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SIMTEST_HDC1080Measure(TyHDC1080Channel tyChannel, double dTemperature, double dHumidity)
+{
+   unsigned char bStarted;
+
+   SIMDEVICES_SetClimate(dTemperature, dHumidity);
+   bLocalDone = FALSE;
+
+   switch (tyChannel)
+      {
+      case HDC1080_TEMPERATURE:
+         bStarted = HDC1080_ReadTemperatureAsync(SIMTEST_HDC1080Read);
+      break;
+      case HDC1080_HUMIDITY:
+         bStarted = HDC1080_ReadHumidityAsync(SIMTEST_HDC1080Read);
+      break;
+      default:
+         bStarted = HDC1080_ReadTemperatureAndHumidityAsync(SIMTEST_HDC1080ReadBoth);
+      break;
+      }
+
+   return SIMTEST_Check(bStarted && SIMTEST_Wait() && bLocalSuccess, "HDC1080 read of channel %u", tyChannel);
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_HDC1080Step
+     Engineer: agent
+        Input: unsigned char ucBits: Resolution.
+               double dOffset, dSpan: Value of a raw 0, and of full scale
+                  above it, from the datasheet.
+               double dTruth: Value measured.
+       Output: double: Step of the resolution at or below dTruth.
+  Description: Works out the value the device measures.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static double SIMTEST_HDC1080Step(unsigned char ucBits, double dOffset, double dSpan, double dTruth)
+{
+   double dStep;
+
+   dStep = dSpan / (double)(1ul << ucBits);
+
+   return dOffset + floor(((dTruth - dOffset) / dStep) + 1e-9) * dStep;
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_HDC1080Reading
+     Engineer: agent
+        Input: const char *pcName: Quantity read.
+               unsigned char ucBits: Resolution.
+               double dOffset, dSpan: Value of a raw 0, and of full scale
+                  above it, from the datasheet.
+               double dTruth: Value measured.
+               long lRead: Value returned by the driver, in 0.01 units.
+       Output: N/A
+  Description: Checks a reading of a non-blocking read. It must be the
+               step of the resolution at or below dTruth, rounded down to
+               0.01.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Checks 0.01 units.
+****************************************************************************/
+static void SIMTEST_HDC1080Reading(const char *pcName, unsigned char ucBits, double dOffset, double dSpan, double dTruth, long lRead)
+{
+   double dExpected;
+   long lExpected;
+
+   dExpected = SIMTEST_HDC1080Step(ucBits, dOffset, dSpan, dTruth);
+   lExpected = (long)floor((dExpected * 100.0) + 1e-6);
+
+   SIMTEST_Check(lRead == lExpected, "%s %2u bit: %9.4f read as %ld, expected %ld (%9.4f)", pcName, ucBits, dTruth, lRead, lExpected, dExpected);
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_HDC1080
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Reads known temperatures and humidities through the HDC1080
+               driver and model at each resolution. The device only has 14 and 11 bit
+               temperatures, so 8 bits must be refused. Each measurement must
+               be read once, at the end of its conversion, so the device never
+               NACKs a read, and the blocking read must sleep meanwhile.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Checks for NACKed reads and the blocking read.
+****************************************************************************/
+static void SIMTEST_HDC1080(void)
+{
+   static const double pdTemperatures[] = {-40.0, -12.345, 0.0, 21.5, 37.77, 124.99};
+   static const double pdHumidities[]   = {0.0, 12.34, 45.0, 67.891, 99.99};
+   static const unsigned char pucBits[] = {14, 11, 8}; // By TyHDC1080Resolution.
+   unsigned char ucResolution, i;
+   unsigned long ulNacks;
+   TySimTime ullSleepCycles;
+   double dTemperature, dHumidity, dExpected;
+
+   SIMTEST_Boot();
+
+   if (SIMTEST_Check(HDC1080_Initialise(), "HDC1080_Initialise") == FALSE)
+      return;
+
+   ulNacks = SIM_GetStatistics()->ulI2CNacks;
+
+   SIMTEST_Check(HDC1080_SetResolution(HDC1080_RESOLUTION_8_BIT, HDC1080_RESOLUTION_14_BIT) == FALSE, "8 bit temperature refused");
+
+   for (ucResolution=HDC1080_RESOLUTION_14_BIT; ucResolution <= HDC1080_RESOLUTION_11_BIT; ucResolution++)
+      {
+      SIMTEST_Check(HDC1080_SetResolution((TyHDC1080Resolution)ucResolution, HDC1080_RESOLUTION_14_BIT), "%u bit temperature set", pucBits[ucResolution]);
+
+      for (i=0; i < sizeof(pdTemperatures) / sizeof(pdTemperatures[0]); i++)
+         {
+         if (SIMTEST_HDC1080Measure(HDC1080_TEMPERATURE, pdTemperatures[i], 45.0))
+            SIMTEST_HDC1080Reading("temperature", pucBits[ucResolution], -40.0, 165.0, pdTemperatures[i], plLocalValues[0]);
+         }
+      }
+
+   for (ucResolution=HDC1080_RESOLUTION_14_BIT; ucResolution <= HDC1080_RESOLUTION_8_BIT; ucResolution++)
+      {
+      SIMTEST_Check(HDC1080_SetResolution(HDC1080_RESOLUTION_14_BIT, (TyHDC1080Resolution)ucResolution), "%u bit humidity set", pucBits[ucResolution]);
+
+      for (i=0; i < sizeof(pdHumidities) / sizeof(pdHumidities[0]); i++)
+         {
+         if (SIMTEST_HDC1080Measure(HDC1080_HUMIDITY, 21.5, pdHumidities[i]))
+            SIMTEST_HDC1080Reading("humidity", pucBits[ucResolution], 0.0, 100.0, pdHumidities[i], plLocalValues[0]);
+         }
+      }
+
+   // Both in one conversion, each at its own resolution....
+   SIMTEST_Check(HDC1080_SetResolution(HDC1080_RESOLUTION_11_BIT, HDC1080_RESOLUTION_8_BIT), "11 bit temperature, 8 bit humidity set");
+   if (SIMTEST_HDC1080Measure(HDC1080_TEMPERATURE_AND_HUMIDITY, pdTemperatures[4], pdHumidities[3]))
+      {
+      SIMTEST_HDC1080Reading("temperature", 11, -40.0, 165.0, pdTemperatures[4], plLocalValues[0]);
+      SIMTEST_HDC1080Reading("humidity", 8, 0.0, 100.0, pdHumidities[3], plLocalValues[1]);
+      }
+
+   // The blocking read, which is still in floating point....
+   SIMDEVICES_SetClimate(pdTemperatures[1], pdHumidities[1]);
+   ullSleepCycles = SIM_GetStatistics()->ullSleepCycles;
+   if (SIMTEST_Check(HDC1080_ReadTemperatureAndHumidity(&dTemperature, &dHumidity), "HDC1080 blocking read"))
+      {
+      dExpected = SIMTEST_HDC1080Step(11, -40.0, 165.0, pdTemperatures[1]);
+      SIMTEST_Check(fabs(dTemperature - dExpected) < 1e-9, "blocking temperature read as %9.4f, expected %9.4f", dTemperature, dExpected);
+      dExpected = SIMTEST_HDC1080Step(8, 0.0, 100.0, pdHumidities[1]);
+      SIMTEST_Check(fabs(dHumidity - dExpected) < 1e-9, "blocking humidity read as %9.4f, expected %9.4f", dHumidity, dExpected);
+      }
+   SIMTEST_Check(SIM_GetStatistics()->ullSleepCycles > ullSleepCycles, "HDC1080 blocking read sleeps");
+
+   SIMTEST_Check(SIM_GetStatistics()->ulI2CNacks == ulNacks, "HDC1080 reads NACKed: %lu", SIM_GetStatistics()->ulI2CNacks - ulNacks);
+}
+
+
+/* ======================================================================== */
+/*  TLC59116                                                                */
+/* ======================================================================== */
+
+/****************************************************************************
+     Function: SIMTEST_TLC59116Commit
+     Engineer: agent
+        Input: const char *pcCase: What was changed.
+               unsigned long ulWrites: Transfers the commit should make.
+               unsigned long ulBytes: Bytes it should write, including the
+                  control byte of each transfer (not the device address).
+       Output: N/A
+  Description: Commits the changes and checks the transfers and bytes
+               written, and that every register of the device then holds
+               the value in pucLocalTLC59116.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_TLC59116Commit(const char *pcCase, unsigned long ulWrites, unsigned long ulBytes)
+{
+   TySimStatistics *ptyStatistics;
+   unsigned long ulWritesBefore, ulBytesBefore;
+   unsigned char ucRegister, ucValue;
+
+   ptyStatistics  = SIM_GetStatistics();
+   ulWritesBefore = ptyStatistics->ulTLC59116Writes;
+   ulBytesBefore  = ptyStatistics->ulTLC59116Bytes;
+
+   SIMTEST_Check(TLC59116_Commit(), "%s: commit", pcCase);
+
+   ulWritesBefore = ptyStatistics->ulTLC59116Writes - ulWritesBefore;
+   ulBytesBefore  = ptyStatistics->ulTLC59116Bytes  - ulBytesBefore;
+   SIMTEST_Check((ulWritesBefore == ulWrites) && (ulBytesBefore == ulBytes),
+                 "%s: %lu writes of %lu bytes, expected %lu of %lu", pcCase, ulWritesBefore, ulBytesBefore, ulWrites, ulBytes);
+
+   for (ucRegister=0; ucRegister < SIMTEST_TLC59116_COUNT; ucRegister++)
+      {
+      ucValue = SIMDEVICES_GetTLC59116Register(ucRegister);
+      if (ucValue != pucLocalTLC59116[ucRegister])
+         SIMTEST_Check(FALSE, "%s: register 0x%02X is %u, expected %u", pcCase, ucRegister, ucValue, pucLocalTLC59116[ucRegister]);
+      }
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_TLC59116Colour
+     Engineer: agent
+        Input: TyLedBank tyLedBank, TyLedColour tyLedColour: LED to set.
+               TyLedIntensity tyLedIntensity: Intensity.
+       Output: N/A
+  Description: Sets an LED, and the register the device should then hold.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_TLC59116Colour(TyLedBank tyLedBank, TyLedColour tyLedColour, TyLedIntensity tyLedIntensity)
+{
+   TLC59116_LedColourIntensity(tyLedBank, tyLedColour, tyLedIntensity);
+   pucLocalTLC59116[SIMTEST_TLC59116_PWM0 + (tyLedBank * 4) + tyLedColour] = (unsigned char)tyLedIntensity;
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_TLC59116
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Changes the LED registers in known patterns and counts what
+               each commit writes. A run is a single burst of a control byte
+               and a byte per register; runs with a single clean register
+               between them are written as one, those with two or more are
+               not.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_TLC59116(void)
+{
+   unsigned char i;
+
+   SIMTEST_Boot();
+
+   // Power on state, as TLC59116_Initialise writes it....
+   memset(pucLocalTLC59116, 0, sizeof(pucLocalTLC59116));
+   pucLocalTLC59116[1] = 0x20;
+   pucLocalTLC59116[SIMTEST_TLC59116_GRPPWM]  = 24;
+   pucLocalTLC59116[SIMTEST_TLC59116_GRPFREQ] = 12;
+   for (i=0; i < 4; i++)
+      pucLocalTLC59116[SIMTEST_TLC59116_LEDOUT0 + i] = 0xAA;
+
+   if (SIMTEST_Check(TLC59116_Initialise(), "TLC59116_Initialise") == FALSE)
+      return;
+   SIMTEST_Check(SIM_GetStatistics()->ulTLC59116Bytes == SIMTEST_TLC59116_COUNT + 1, "initialise: %lu bytes, expected %u",
+                 SIM_GetStatistics()->ulTLC59116Bytes, SIMTEST_TLC59116_COUNT + 1);
+
+   SIMTEST_TLC59116Commit("nothing dirty", 0, 0);
+
+   // Setting a register to the value it has is not a change....
+   SIMTEST_TLC59116Colour(LED_BANK_0, LED_GREEN, LED_0);
+   SIMTEST_TLC59116Commit("unchanged value", 0, 0);
+
+   SIMTEST_TLC59116Colour(LED_BANK_1, LED_GREEN, LED_50);
+   SIMTEST_TLC59116Commit("single register", 1, 2);
+
+   TLC59116_LedBankIntensity(LED_BANK_2, LED_10, LED_20, LED_30);
+   pucLocalTLC59116[SIMTEST_TLC59116_PWM0 + 8 + LED_BLUE]  = LED_10;
+   pucLocalTLC59116[SIMTEST_TLC59116_PWM0 + 8 + LED_GREEN] = LED_20;
+   pucLocalTLC59116[SIMTEST_TLC59116_PWM0 + 8 + LED_RED]   = LED_30;
+   SIMTEST_TLC59116Commit("bank", 1, 4);
+
+   // Blue and red of a bank, with green clean between them....
+   SIMTEST_TLC59116Colour(LED_BANK_0, LED_BLUE, LED_100);
+   SIMTEST_TLC59116Colour(LED_BANK_0, LED_RED,  LED_100);
+   SIMTEST_TLC59116Commit("gap of one bridged", 1, 4);
+
+   // Red of bank 0 and green of bank 1, with two clean between them....
+   SIMTEST_TLC59116Colour(LED_BANK_0, LED_RED,   LED_70);
+   SIMTEST_TLC59116Colour(LED_BANK_1, LED_GREEN, LED_90);
+   SIMTEST_TLC59116Commit("gap of two not bridged", 2, 4);
+
+   TLC59116_GlobalBlinkRate(5, 10);
+   pucLocalTLC59116[SIMTEST_TLC59116_GRPFREQ] = 5;
+   pucLocalTLC59116[SIMTEST_TLC59116_GRPPWM]  = 10;
+   SIMTEST_TLC59116Commit("blink rate", 1, 3);
+
+   // Red of bank 3 and the blink of bank 0, three clean between them....
+   SIMTEST_TLC59116Colour(LED_BANK_3, LED_RED, LED_40);
+   TLC59116_LedBankBlinkControl(LED_BANK_0, TRUE);
+   pucLocalTLC59116[SIMTEST_TLC59116_LEDOUT0] = 0xFF;
+   SIMTEST_TLC59116Commit("far apart", 2, 4);
+
+   SIMTEST_TLC59116Commit("nothing dirty after changes", 0, 0);
+}
+
+
+/* ======================================================================== */
+/*  LEDANIM                                                                 */
+/* ======================================================================== */
+
+/****************************************************************************
+     Function: SIMTEST_LedExpected
+     Engineer: agent
+        Input: const TyLedAnimation *ptyAnimation: Repeating animation.
+               unsigned long ulTime: Milliseconds since it started.
+               unsigned char ucColour: LED_BLUE, LED_GREEN or LED_RED.
+       Output: double: Intensity the LED should have.
+  Description: Works out an animation's colour at a time from its keyframes,
+               in floating point.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static double SIMTEST_LedExpected(const TyLedAnimation *ptyAnimation, unsigned long ulTime, unsigned char ucColour)
+{
+   const TyLedKeyframe *ptyKeyframes;
+   unsigned long ulCycle, ulStart;
+   double dFrom, dTo;
+   unsigned char i;
+
+   ptyKeyframes = ptyAnimation->ptyKeyframes;
+
+   ulCycle = 0;
+   for (i=1; i < ptyAnimation->ucKeyframeCount; i++)
+      ulCycle += ptyKeyframes[i].usDuration;
+
+   ulTime %= ulCycle;
+   ulStart = 0;
+
+   for (i=1; ulTime >= ulStart + ptyKeyframes[i].usDuration; i++)
+      ulStart += ptyKeyframes[i].usDuration;
+
+   switch (ucColour)
+      {
+      case LED_BLUE:  dFrom = ptyKeyframes[i - 1].ucBlue;  dTo = ptyKeyframes[i].ucBlue;  break;
+      case LED_GREEN: dFrom = ptyKeyframes[i - 1].ucGreen; dTo = ptyKeyframes[i].ucGreen; break;
+      default:        dFrom = ptyKeyframes[i - 1].ucRed;   dTo = ptyKeyframes[i].ucRed;   break;
+      }
+
+   return dFrom + ((dTo - dFrom) * (ulTime - ulStart)) / ptyKeyframes[i].usDuration;
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_LedAnimation
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Runs a stepped ramp, the breathing and the colour blend on
+               Banks 0 to 2, with an update every LEDANIM_TICK_PERIOD and
+               now and then a late one, for two and a half times the
+               longest animation. After each update the LED driver's
+               registers must be within one of the colour worked out here
+               for the time of the update.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_LedAnimation(void)
+{
+   // Stepped ramp, as main runs, a level reached at once and held....
+   static const TyLedKeyframe ptyRampKeyframes[] =
+   {
+      {  0, LED_0,   LED_0, LED_0}, {300, LED_0,   LED_0, LED_0},
+      {  0, LED_50,  LED_0, LED_0}, {300, LED_50,  LED_0, LED_0},
+      {  0, LED_100, LED_0, LED_0}, {300, LED_100, LED_0, LED_0}
+   };
+   // Green breathing, 4 seconds per breath....
+   static const TyLedKeyframe ptyBreatheKeyframes[] =
+   {
+      {   0, LED_0, LED_0,  LED_0},
+      {1500, LED_0, LED_80, LED_0},
+      { 500, LED_0, LED_80, LED_0},
+      {1500, LED_0, LED_0,  LED_0},
+      { 500, LED_0, LED_0,  LED_0}
+   };
+   // Colour blend, red -> green -> blue -> red....
+   static const TyLedKeyframe ptyBlendKeyframes[] =
+   {
+      {   0, LED_0,  LED_0,  LED_60},
+      {2000, LED_0,  LED_60, LED_0},
+      {2000, LED_60, LED_0,  LED_0},
+      {2000, LED_0,  LED_0,  LED_60}
+   };
+   static const TyLedAnimation ptyAnimations[3] =
+   {
+      {ptyRampKeyframes,    6, TRUE},
+      {ptyBreatheKeyframes, 5, TRUE},
+      {ptyBlendKeyframes,   4, TRUE}
+   };
+   static const char *ppcNames[3] = {"ramp", "breathe", "blend"};
+   unsigned long ulStart, ulTime, ulTick, ulMilliseconds, ulCycles, ulWrong[3];
+   unsigned char ucBank, ucColour, ucValue;
+   double dExpected;
+
+   SIMTEST_Boot();
+
+   // Start 5 s before the millisecond count wraps, so that the animations
+   // run across it....
+   while (TIMER_DIFF(0, TIMER_GetMilliseconds()) > 5000)
+      SIM_Advance(SIM_CYCLES_PER_MS);
+
+   if ((SIMTEST_Check(TLC59116_Initialise(), "TLC59116_Initialise") == FALSE) ||
+       (SIMTEST_Check(LEDANIM_Initialise(), "LEDANIM_Initialise") == FALSE))
+      return;
+
+   ulStart = TIMER_GetMilliseconds();
+
+   for (ucBank=0; ucBank < 3; ucBank++)
+      {
+      SIMTEST_Check(LEDANIM_Start((TyLedBank)ucBank, &ptyAnimations[ucBank]), "%s: start", ppcNames[ucBank]);
+      ulWrong[ucBank] = 0;
+      }
+
+   for (ulTick=1; TIMER_WRAP(TIMER_GetMilliseconds() - ulStart) < 15000; ulTick++)
+      {
+      // Every 37th update is late, by more than a keyframe can last. The
+      // board is run a millisecond at a time, so that no SysTick is
+      // missed....
+      for (ulMilliseconds=((ulTick % 37) == 0) ? 2300 : LEDANIM_TICK_PERIOD - 1; ulMilliseconds > 0; ulMilliseconds--)
+         SIM_Advance(SIM_CYCLES_PER_MS);
+
+      ulTime = TIMER_WRAP(TIMER_GetMilliseconds() - ulStart);
+      LEDANIM_Update();
+
+      // Let the commit finish, taking each interrupt of the transfer....
+      for (ulCycles=0; ulCycles < SIM_CYCLES_PER_MS; ulCycles += SIMTEST_STEP_CYCLES)
+         SIM_Advance(SIMTEST_STEP_CYCLES);
+
+      for (ucBank=0; ucBank < 3; ucBank++)
+         {
+         for (ucColour=LED_BLUE; ucColour <= LED_RED; ucColour++)
+            {
+            dExpected = SIMTEST_LedExpected(&ptyAnimations[ucBank], ulTime, ucColour);
+            ucValue   = SIMDEVICES_GetTLC59116Register(SIMTEST_TLC59116_PWM0 + (ucBank * 4) + ucColour);
+
+            if (fabs(ucValue - dExpected) > 1.0)
+               {
+               if (ulWrong[ucBank]++ == 0)
+                  SIMTEST_Check(FALSE, "%s: colour %u at %lu ms is %u, expected %.1f", ppcNames[ucBank], ucColour, ulTime, ucValue, dExpected);
+               }
+            }
+         }
+      }
+
+   for (ucBank=0; ucBank < 3; ucBank++)
+      {
+      SIMTEST_Check(ulWrong[ucBank] == 0, "%s: %lu of %lu colours wrong", ppcNames[ucBank], ulWrong[ucBank], (ulTick - 1) * 3);
+      SIMTEST_Check(LEDANIM_IsRunning((TyLedBank)ucBank), "%s: still running", ppcNames[ucBank]);
+      }
+
+   SIMTEST_Check(LEDANIM_GetCommitFailures() == 0, "%lu commits failed", LEDANIM_GetCommitFailures());
+}
+
+
+/* ======================================================================== */
+/*  PPD42NJ                                                                 */
+/* ======================================================================== */
+
+/****************************************************************************
+     Function: SIMTEST_ParticleMass
+     Engineer: agent
+        Input: double dRadius: Particle radius in m.
+       Output: double: Mass concentration of one particle per 0.01 cf, in
+                  ug/m3.
+  Description: Mass of a spherical particle of SIMTEST_DENSITY, spread over
+               0.01 cf.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static double SIMTEST_ParticleMass(double dRadius)
+{
+   return (SIMTEST_DENSITY * (4.0 / 3.0) * M_PI * dRadius * dRadius * dRadius) / (SIMTEST_CUBIC_FOOT / 100.0);
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_PPD42NJEstimate
+     Engineer: agent
+        Input: const char *pcCase: Description of the measurements.
+               const TyParticleConcentration *ptyConcentration: The 
+                  firmware's estimate.
+               unsigned short usSeconds: Seconds the estimate should be over.
+               const unsigned long *pulTotals: Low pulse time of each channel
+                  over those seconds (1 us units).
+       Output: N/A
+  Description: Checks an estimate against the floating point formula. The
+               ratio is truncated to 0.001 %, and the curve and the masses
+               are then worked out from the truncated ratio, so that only
+               the fixed point maths is checked. The curve is truncated to
+               0.01 pcs. Each mass may be off by the truncation of the
+               curves it is worked out from and of its own 0.01 ug/m3, and
+               by the rounding of its factor to a millionth.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Takes the estimate rather than the buffer.
+****************************************************************************/
+static void SIMTEST_PPD42NJEstimate(const char *pcCase, const TyParticleConcentration *ptyConcentration, unsigned short usSeconds, const unsigned long *pulTotals)
+{
+   unsigned char ucChannel, ucSensor;
+   double dRatio, dCurve, dSmall, dLarge, dPM25, dPM10, dPM25Factor, dPM10Factor;
+   double pdCurves[PPD42NJ_CHANNEL_COUNT];
+
+   dPM25Factor      = SIMTEST_ParticleMass(SIMTEST_PM25_RADIUS);
+   dPM10Factor      = SIMTEST_ParticleMass(SIMTEST_PM10_RADIUS);
+
+   // With no seconds there is no estimate....
+   if ((SIMTEST_Check(ptyConcentration->usWindowSeconds == usSeconds, "%s: over %u s, expected %u s", pcCase, ptyConcentration->usWindowSeconds, usSeconds) == FALSE) ||
+       (usSeconds == 0))
+      return;
+
+   for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
+      {
+      dRatio = floor(((pulTotals[ucChannel] * 100.0) / (usSeconds * 1e6)) * 1000.0 + 1e-9);
+      SIMTEST_Check(ptyConcentration->pulRatio[ucChannel] == (unsigned long)dRatio, "%s: channel %u ratio %lu, expected %.0f",
+                    pcCase, ucChannel, ptyConcentration->pulRatio[ucChannel], dRatio);
+
+      dCurve = SIMTEST_CURVE(ptyConcentration->pulRatio[ucChannel] / 1000.0) * 100.0;
+      pdCurves[ucChannel] = dCurve;
+      SIMTEST_Check((ptyConcentration->pulConcentration[ucChannel] <= dCurve + 1e-6) && (ptyConcentration->pulConcentration[ucChannel] > dCurve - 1.0),
+                    "%s: channel %u at %.3f %% is %lu, expected %.2f", pcCase, ucChannel, ptyConcentration->pulRatio[ucChannel] / 1000.0,
+                    ptyConcentration->pulConcentration[ucChannel], dCurve);
+      }
+
+   for (ucSensor=0; ucSensor < PPD42NJ_SENSOR_COUNT; ucSensor++)
+      {
+      dLarge = pdCurves[PPD42NJ_P2_CHANNEL(ucSensor)];
+      dSmall = pdCurves[PPD42NJ_P1_CHANNEL(ucSensor)] - dLarge;
+      if (dSmall < 0.0)
+         dSmall = 0.0;
+
+      dPM25 = dSmall * dPM25Factor;
+      dPM10 = dLarge * dPM10Factor;
+
+      SIMTEST_Check(fabs(ptyConcentration->pulPM25[ucSensor] - dPM25) <= 1.0 + (2.0 * dPM25Factor) + (dSmall * 5e-7),
+                    "%s: sensor %u PM2.5 %lu, expected %.2f", pcCase, ucSensor, ptyConcentration->pulPM25[ucSensor], dPM25);
+      SIMTEST_Check(fabs(ptyConcentration->pulPM10[ucSensor] - dPM10) <= 1.0 + dPM10Factor + (dLarge * 5e-7),
+                    "%s: sensor %u PM10 %lu, expected %.2f", pcCase, ucSensor, ptyConcentration->pulPM10[ucSensor], dPM10);
+      }
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_PPD42NJCalculate
+     Engineer: agent
+        Input: const char *pcCase: Description of the measurements.
+               unsigned long ulP1Ratio, ulP2Ratio: Occupancy of P1 and P2 in
+                  0.001 % units.
+               unsigned long ulSecondsElapsed: Seconds measured so far.
+       Output: N/A
+  Description: Works out the window totals for the occupancies over the
+               default window, or the seconds measured if fewer, and checks
+               PPD42NJ_CalculateConcentration's estimate. Every sensor gets
+               the same occupancies.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Passes the totals rather than a buffer.
+****************************************************************************/
+static void SIMTEST_PPD42NJCalculate(const char *pcCase, unsigned long ulP1Ratio, unsigned long ulP2Ratio, unsigned long ulSecondsElapsed)
+{
+   TyParticleConcentration tyConcentration;
+   unsigned char ucSensor;
+   unsigned short usSeconds;
+   unsigned long pulTotals[PPD42NJ_CHANNEL_COUNT];
+
+   memset(&tyConcentration, 0, sizeof(tyConcentration));
+
+   usSeconds = PPD42NJ_DEFAULT_WINDOW_IN_SECONDS;
+   if (ulSecondsElapsed < usSeconds)
+      usSeconds = (unsigned short)ulSecondsElapsed;
+
+   for (ucSensor=0; ucSensor < PPD42NJ_SENSOR_COUNT; ucSensor++)
+      {
+      pulTotals[PPD42NJ_P1_CHANNEL(ucSensor)] = ulP1Ratio * 10ul * usSeconds;
+      pulTotals[PPD42NJ_P2_CHANNEL(ucSensor)] = ulP2Ratio * 10ul * usSeconds;
+      }
+
+   PPD42NJ_CalculateConcentration(pulTotals, PPD42NJ_DEFAULT_WINDOW_IN_SECONDS, ulSecondsElapsed, &tyConcentration);
+
+   SIMTEST_PPD42NJEstimate(pcCase, &tyConcentration, usSeconds, pulTotals);
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_PPD42NJSnapshot
+     Engineer: agent
+        Input: const char *pcCase: Description of the measurements.
+               unsigned short usWindow: Window set.
+       Output: N/A
+  Description: Checks the estimate in the published measurements against
+               totals summed here from the newest seconds of their history,
+               and that it was worked out for their second.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Checks the second of the estimate.
+****************************************************************************/
+static void SIMTEST_PPD42NJSnapshot(const char *pcCase, unsigned short usWindow)
+{
+   const TyAirQualityMeasurements *ptyMeasurements;
+   unsigned char ucChannel;
+   unsigned short usSeconds, usIndex, i;
+   unsigned long pulTotals[PPD42NJ_CHANNEL_COUNT];
+
+   ptyMeasurements = PPD42NJ_GetAirQualityMeasurementsSnapshot();
+
+   usSeconds = usWindow;
+   if (ptyMeasurements->ulSecondsElapsed < usSeconds)
+      usSeconds = (unsigned short)ptyMeasurements->ulSecondsElapsed;
+
+   for (ucChannel=0; ucChannel < PPD42NJ_CHANNEL_COUNT; ucChannel++)
+      {
+      pulTotals[ucChannel] = 0;
+      usIndex = ptyMeasurements->usHead;
+      for (i=0; i < usSeconds; i++)
+         {
+         usIndex = (usIndex + MAXIMUM_HISTORY_IN_SECONDS - 1) % MAXIMUM_HISTORY_IN_SECONDS;
+         pulTotals[ucChannel] += ptyMeasurements->ppulTimes[ucChannel][usIndex];
+         }
+      }
+
+   SIMTEST_Check(ptyMeasurements->tyConcentration.ulSecondsElapsed == ptyMeasurements->ulSecondsElapsed, "%s: estimate for second %lu, expected %lu",
+                 pcCase, ptyMeasurements->tyConcentration.ulSecondsElapsed, ptyMeasurements->ulSecondsElapsed);
+   SIMTEST_PPD42NJEstimate(pcCase, &ptyMeasurements->tyConcentration, usSeconds, pulTotals);
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_PPD42NJRun
+     Engineer: agent
+        Input: TySimTime ullOrigin: Start of the first second of the
+                  PPD42NJ timer.
+               unsigned long ulSeconds: Seconds measured.
+       Output: N/A
+  Description: Runs the board to half way through the second after
+               ulSeconds, when that many have been added. Interrupts are
+               only taken at the end of each SIM_Advance, so the board is run
+               in steps of SIMTEST_STEP_CYCLES to keep the edges timed. The
+               scheduler is not run, so the processing that works out the
+               estimate is polled each step.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Polls the processing.
+****************************************************************************/
+static void SIMTEST_PPD42NJRun(TySimTime ullOrigin, unsigned long ulSeconds)
+{
+   TySimTime ullEnd;
+
+   ullEnd = ullOrigin + (ulSeconds * SIM_CLOCK_HZ) + (SIM_CLOCK_HZ / 2);
+   while (SIM_GetTime() < ullEnd)
+      {
+      SIM_Advance(SIMTEST_STEP_CYCLES);
+      PPD42NJ_ProcessNotifications();
+      }
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_PPD42NJ
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Checks the concentration curve, and the estimates worked out
+               from set window totals, at occupancies from 0 to 100 %. Then
+               drives random pulses into the sensor inputs and checks the
+               published estimates while the window fills, once it is
+               full, and after it is shortened and lengthened again.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_PPD42NJ(void)
+{
+   static const unsigned long pulRatios[] = {0, 500, 1000, 10000, 100000}; // 0.001 % units
+   TySimPulseSettings tyPulses;
+   TySimTime ullOrigin;
+   unsigned long i;
+   double dCurve;
+   char pcCase[0x40];
+
+   for (i=0; i < sizeof(pulRatios) / sizeof(pulRatios[0]); i++)
+      {
+      dCurve = SIMTEST_CURVE(pulRatios[i] / 1000.0) * 100.0;
+      SIMTEST_Check((PPD42NJ_Concentration(pulRatios[i]) <= dCurve + 1e-6) && (PPD42NJ_Concentration(pulRatios[i]) > dCurve - 1.0),
+                    "curve at %.3f %% is %lu, expected %.2f", pulRatios[i] / 1000.0, PPD42NJ_Concentration(pulRatios[i]), dCurve);
+      }
+
+   for (i=0; i < sizeof(pulRatios) / sizeof(pulRatios[0]); i++)
+      {
+      snprintf(pcCase, sizeof(pcCase), "P1 %.3f %%, P2 a quarter", pulRatios[i] / 1000.0);
+      SIMTEST_PPD42NJCalculate(pcCase, pulRatios[i], pulRatios[i] / 4, 1000);
+      }
+   SIMTEST_PPD42NJCalculate("P2 above P1", 1000, 10000, 1000);
+   SIMTEST_PPD42NJCalculate("partly filled window", 10000, 500, 7);
+   SIMTEST_PPD42NJCalculate("nothing measured", 10000, 500, 0);
+
+   SIMTEST_Boot();
+
+   if (SIMTEST_Check(PPD42NJ_Initialise(), "PPD42NJ_Initialise") == FALSE)
+      return;
+
+   ullOrigin = SIMHAL_GetTimerStart(TIMERA0_BASE, TIMER_A);
+   SIMPULSES_SetOrigin(ullOrigin);
+
+   memset(&tyPulses, 0, sizeof(tyPulses));
+   tyPulses.tyMode     = SIM_PULSES_OCCUPANCY;
+   tyPulses.dOccupancy = 0.12;
+   SIMPULSES_Start(0, &tyPulses);
+   tyPulses.dOccupancy = 0.03;
+   SIMPULSES_Start(1, &tyPulses);
+
+   SIMTEST_PPD42NJRun(ullOrigin, 5);
+   SIMTEST_PPD42NJSnapshot("after 5 s", PPD42NJ_DEFAULT_WINDOW_IN_SECONDS);
+
+   SIMTEST_PPD42NJRun(ullOrigin, MAXIMUM_HISTORY_IN_SECONDS + 7);
+   SIMTEST_PPD42NJSnapshot("full window", PPD42NJ_DEFAULT_WINDOW_IN_SECONDS);
+
+   // A new window is picked up on the next second....
+   SIMTEST_Check(PPD42NJ_SetConcentrationWindow(10), "window set to 10 s");
+   SIMTEST_PPD42NJRun(ullOrigin, MAXIMUM_HISTORY_IN_SECONDS + 8);
+   SIMTEST_PPD42NJSnapshot("window shortened", 10);
+   SIMTEST_PPD42NJRun(ullOrigin, MAXIMUM_HISTORY_IN_SECONDS + 13);
+   SIMTEST_PPD42NJSnapshot("shortened window moved on", 10);
+
+   SIMTEST_Check(PPD42NJ_SetConcentrationWindow(MAXIMUM_HISTORY_IN_SECONDS), "window set to %u s", MAXIMUM_HISTORY_IN_SECONDS);
+   SIMTEST_PPD42NJRun(ullOrigin, MAXIMUM_HISTORY_IN_SECONDS + 14);
+   SIMTEST_PPD42NJSnapshot("window lengthened", MAXIMUM_HISTORY_IN_SECONDS);
+   SIMTEST_PPD42NJRun(ullOrigin, MAXIMUM_HISTORY_IN_SECONDS + 20);
+   SIMTEST_PPD42NJSnapshot("lengthened window moved on", MAXIMUM_HISTORY_IN_SECONDS);
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_DoubleLowPulseWidth
+     Engineer: agent
+        Input: unsigned long ulFallTime: TIMERA0 value at the falling edge.
+               unsigned long ulRiseTime: TIMERA0 value at the rising edge.
+       Output: unsigned long: Low pulse width in 1 us units.
+  Description: The low pulse width as the port line interrupt worked it out
+               before the integer maths, in double precision floating point.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned long SIMTEST_DoubleLowPulseWidth(unsigned long ulFallTime, unsigned long ulRiseTime)
+{
+   double dDownTime;
+
+   if (ulRiseTime < ulFallTime)
+      {
+      dDownTime = SIMTEST_TIMER_PERIOD;
+      dDownTime -= ulFallTime;
+      dDownTime += ulRiseTime;
+      }
+   else
+      {
+      dDownTime = ulRiseTime - ulFallTime;
+      }
+
+   dDownTime /= 80;
+
+   return (unsigned long)dDownTime;
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_PulseWidthSweep
+     Engineer: agent
+        Input: const char *pcCase: Description of the sweep.
+               unsigned long ulFallStep: Falling edge time step.
+               unsigned long ulFallStart: Falling edge time of the first
+                  pulse.
+               unsigned long ulWidthStep: Width step, in ticks.
+               unsigned long ulWidthStart: Width of the first pulse, in
+                  ticks.
+       Output: N/A
+  Description: Compares the integer and floating point widths of
+               SIMTEST_TIMER_PERIOD pulses, the falling edge and the width
+               of each moving on by their steps (modulo the period) from
+               the last. A step of 1 or one prime to the period covers
+               every value. The rising edge is where the timer is at the end
+               of the pulse, i.e. before the falling edge if it wrapped.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_PulseWidthSweep(const char *pcCase, unsigned long ulFallStep, unsigned long ulFallStart, unsigned long ulWidthStep, unsigned long ulWidthStart)
+{
+   unsigned long i, ulFall, ulWidth, ulRise, ulWrapped, ulMismatches;
+   unsigned long ulFirstFall, ulFirstRise;
+
+   ulFall       = ulFallStart;
+   ulWidth      = ulWidthStart;
+   ulWrapped    = 0;
+   ulMismatches = 0;
+   ulFirstFall  = 0;
+   ulFirstRise  = 0;
+
+   for (i=0; i < SIMTEST_TIMER_PERIOD; i++)
+      {
+      ulRise = (ulFall + ulWidth) % SIMTEST_TIMER_PERIOD;
+      if (ulRise < ulFall)
+         ulWrapped++;
+
+      if (PPD42NJ_LowPulseWidth(ulFall, ulRise) != SIMTEST_DoubleLowPulseWidth(ulFall, ulRise))
+         {
+         if (ulMismatches == 0)
+            {
+            ulFirstFall = ulFall;
+            ulFirstRise = ulRise;
+            }
+         ulMismatches++;
+         }
+
+      ulFall  = (ulFall + ulFallStep) % SIMTEST_TIMER_PERIOD;
+      ulWidth = (ulWidth + ulWidthStep) % SIMTEST_TIMER_PERIOD;
+      }
+
+   if (ulMismatches == 0)
+      SIMTEST_Check(TRUE, "%s: %lu pulses (%lu wrapped) match", pcCase, SIMTEST_TIMER_PERIOD, ulWrapped);
+   else
+      SIMTEST_Check(FALSE, "%s: %lu of %lu pulses differ, first fall %lu rise %lu is %lu us, expected %lu us",
+                    pcCase, ulMismatches, SIMTEST_TIMER_PERIOD, ulFirstFall, ulFirstRise,
+                    PPD42NJ_LowPulseWidth(ulFirstFall, ulFirstRise), SIMTEST_DoubleLowPulseWidth(ulFirstFall, ulFirstRise));
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_PulseWidth
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Checks the integer low pulse width against the floating
+               point maths over the whole timer range: every width from a
+               falling edge at the start and at the end of the period (so
+               every width both without and with the timer wrapping), and
+               every falling edge time with the narrowest and widest pulses
+               and with widths spread over the period.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_PulseWidth(void)
+{
+   SIMTEST_PulseWidthSweep("every width, falling at 0", 0, 0, 1, 0);
+   SIMTEST_PulseWidthSweep("every width, falling at the end", 0, SIMTEST_TIMER_PERIOD - 1, 1, 0);
+   SIMTEST_PulseWidthSweep("every fall, 0 ticks wide", 1, 0, 0, 0);
+   SIMTEST_PulseWidthSweep("every fall, 79 ticks wide", 1, 0, 0, 79);
+   SIMTEST_PulseWidthSweep("every fall, a period less a tick wide", 1, 0, 0, SIMTEST_TIMER_PERIOD - 1);
+   // 1000003 is prime, so the widths also cover the period....
+   SIMTEST_PulseWidthSweep("every fall, spread widths", 1, 0, 1000003, 12345);
+}
+
+
+/* ======================================================================== */
+/*  AGGREGATE                                                               */
+/* ======================================================================== */
+
+/****************************************************************************
+     Function: SIMTEST_AggregateSample
+     Engineer: agent
+        Input: unsigned char ucChannel: Channel.
+               unsigned long ulSecond: Second of the sample.
+       Output: unsigned long: Sample, 0 to 1000000 us.
+  Description: Makes up the samples: a scrambled sequence over the full range
+               on one channel and a slow saw tooth on the other.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned long SIMTEST_AggregateSample(unsigned char ucChannel, unsigned long ulSecond)
+{
+   if ((ucChannel & 1) == 0)
+      return (unsigned long)(((unsigned long long)ulSecond * 7919ull + 13ull) % 1000001ull);
+
+   return (ulSecond % 997ul) * 1000ul;
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_AggregateExpected
+     Engineer: agent
+        Input: unsigned char ucChannel: Channel.
+               unsigned long ulFirst: First second.
+               unsigned long ulCount: Number of seconds.
+               TyAggregateBucket *ptyBucket: Storage for the bucket.
+       Output: N/A
+  Description: Works out a bucket from the samples themselves.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_AggregateExpected(unsigned char ucChannel, unsigned long ulFirst, unsigned long ulCount, TyAggregateBucket *ptyBucket)
+{
+   unsigned long i, ulValue;
+
+   ptyBucket->ulMinimum = 0xFFFFFFFF;
+   ptyBucket->ulMaximum = 0;
+   ptyBucket->ulSum     = 0;
+   ptyBucket->ulCount   = ulCount;
+
+   for (i=ulFirst; i < ulFirst + ulCount; i++)
+      {
+      ulValue = ppulLocalSamples[ucChannel][i];
+      if (ulValue < ptyBucket->ulMinimum)
+         ptyBucket->ulMinimum = ulValue;
+      if (ulValue > ptyBucket->ulMaximum)
+         ptyBucket->ulMaximum = ulValue;
+      ptyBucket->ulSum += ulValue;
+      }
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_AggregateMatches
+     Engineer: agent
+        Input: const TyAggregateBucket *ptyBucket: Bucket returned.
+               const TyAggregateBucket *ptyExpected: Bucket expected.
+       Output: unsigned char: TRUE if they are the same.
+  Description: Compares two buckets.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static unsigned char SIMTEST_AggregateMatches(const TyAggregateBucket *ptyBucket, const TyAggregateBucket *ptyExpected)
+{
+   return ((ptyBucket->ulMinimum == ptyExpected->ulMinimum) && (ptyBucket->ulMaximum == ptyExpected->ulMaximum) &&
+           (ptyBucket->ulSum == ptyExpected->ulSum) && (ptyBucket->ulCount == ptyExpected->ulCount)) ? TRUE : FALSE;
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_AggregateCheck
+     Engineer: agent
+        Input: unsigned long ulSeconds: Samples added so far.
+       Output: N/A
+  Description: Checks every level of every channel after ulSeconds samples:
+               the number of completed buckets held, each of them, the
+               bucket being filled and the mean over the held buckets.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_AggregateCheck(unsigned long ulSeconds)
+{
+   static const unsigned long pulSpan[AGGREGATE_LEVEL_COUNT] = {1, 60, 900, 3600};   // Seconds in a bucket.
+   static const unsigned long pulRing[AGGREGATE_LEVEL_COUNT] = {AGGREGATE_SECONDS, AGGREGATE_MINUTES, AGGREGATE_QUARTER_HOURS, AGGREGATE_HOURS};
+   static const char *ppcLevel[AGGREGATE_LEVEL_COUNT] = {"second", "minute", "quarter hour", "hour"};
+   unsigned char ucChannel, ucLevel, bMatches;
+   unsigned long ulCompleted, ulHeld, ulAge, ulFirst, ulMean;
+   unsigned long long ullSum;
+   TyAggregateBucket tyBucket, tyExpected;
+
+   for (ucChannel=0; ucChannel < AGGREGATE_CHANNEL_COUNT; ucChannel++)
+      {
+      for (ucLevel=0; ucLevel < AGGREGATE_LEVEL_COUNT; ucLevel++)
+         {
+         ulCompleted = ulSeconds / pulSpan[ucLevel];
+         ulHeld      = (ulCompleted < pulRing[ucLevel]) ? ulCompleted : pulRing[ucLevel];
+
+         // Each completed bucket held, newest first, and no more....
+         bMatches = TRUE;
+         ullSum   = 0;
+         for (ulAge=0; ulAge < ulHeld; ulAge++)
+            {
+            ulFirst = (ulCompleted - 1 - ulAge) * pulSpan[ucLevel];
+            SIMTEST_AggregateExpected(ucChannel, ulFirst, pulSpan[ucLevel], &tyExpected);
+            ullSum += tyExpected.ulSum;
+
+            if ((AGGREGATE_GetCompleted(ucChannel, (TyAggregateLevel)ucLevel, (unsigned char)ulAge, &tyBucket) == FALSE) ||
+                (SIMTEST_AggregateMatches(&tyBucket, &tyExpected) == FALSE))
+               bMatches = FALSE;
+            }
+         if (AGGREGATE_GetCompleted(ucChannel, (TyAggregateLevel)ucLevel, (unsigned char)ulHeld, &tyBucket))
+            bMatches = FALSE;
+
+         SIMTEST_Check(bMatches, "%lu s: channel %u, %lu completed %s buckets held", ulSeconds, ucChannel, ulHeld, ppcLevel[ucLevel]);
+
+         // The bucket being filled holds the whole buckets of the level
+         // below since the last one completed....
+         if (ucLevel != AGGREGATE_SECOND)
+            {
+            ulFirst = ulCompleted * pulSpan[ucLevel];
+            SIMTEST_AggregateExpected(ucChannel, ulFirst, ((ulSeconds / pulSpan[ucLevel - 1]) * pulSpan[ucLevel - 1]) - ulFirst, &tyExpected);
+
+            if (tyExpected.ulCount == 0)
+               bMatches = (AGGREGATE_GetCurrent(ucChannel, (TyAggregateLevel)ucLevel, &tyBucket) == FALSE) ? TRUE : FALSE;
+            else
+               bMatches = (AGGREGATE_GetCurrent(ucChannel, (TyAggregateLevel)ucLevel, &tyBucket) && SIMTEST_AggregateMatches(&tyBucket, &tyExpected)) ? TRUE : FALSE;
+
+            SIMTEST_Check(bMatches, "%lu s: channel %u, current %s of %lu s", ulSeconds, ucChannel, ppcLevel[ucLevel], tyExpected.ulCount);
+            }
+
+         // The mean over all of the buckets held, and no more....
+         if (ulHeld > 0)
+            {
+            ulMean   = 0;
+            bMatches = AGGREGATE_GetMean(ucChannel, (TyAggregateLevel)ucLevel, (unsigned char)ulHeld, &ulMean);
+            SIMTEST_Check(bMatches && (ulMean == (unsigned long)(ullSum / (ulHeld * pulSpan[ucLevel]))),
+                          "%lu s: channel %u, mean of %lu %s buckets %lu, expected %lu", ulSeconds, ucChannel, ulHeld, ppcLevel[ucLevel],
+                          ulMean, (unsigned long)(ullSum / (ulHeld * pulSpan[ucLevel])));
+            }
+         if (ulHeld < 255)
+            SIMTEST_Check(AGGREGATE_GetMean(ucChannel, (TyAggregateLevel)ucLevel, (unsigned char)(ulHeld + 1), &ulMean) == FALSE,
+                          "%lu s: channel %u, no mean of %lu %s buckets", ulSeconds, ucChannel, ulHeld + 1, ppcLevel[ucLevel]);
+         }
+      }
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_Aggregate
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Adds a day and an hour of samples to the aggregates, checking
+               them either side of each roll-up boundary and once each ring
+               has wrapped.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_Aggregate(void)
+{
+   // In order....
+   static const unsigned long pulChecks[] =
+   {
+      0, 1, 59, 60, 61, 119, 120, 899, 900, 901, (AGGREGATE_MINUTES + 1) * 60ul,
+      3599, 3600, 3601, 4500, 5 * 3600ul, AGGREGATE_HOURS * 3600ul - 1,
+      AGGREGATE_HOURS * 3600ul, (AGGREGATE_HOURS + 1) * 3600ul, SIMTEST_AGGREGATE_SECONDS
+   };
+   unsigned char ucChannel;
+   unsigned long ulSecond, ulCheck;
+
+   SIMTEST_Boot();
+   AGGREGATE_Initialise();
+
+   ulCheck = 0;
+   for (ulSecond=0; ulSecond <= SIMTEST_AGGREGATE_SECONDS; ulSecond++)
+      {
+      while ((ulCheck < sizeof(pulChecks) / sizeof(pulChecks[0])) && (pulChecks[ulCheck] == ulSecond))
+         {
+         SIMTEST_AggregateCheck(ulSecond);
+         ulCheck++;
+         }
+
+      if (ulSecond == SIMTEST_AGGREGATE_SECONDS)
+         break;
+
+      for (ucChannel=0; ucChannel < AGGREGATE_CHANNEL_COUNT; ucChannel++)
+         {
+         ppulLocalSamples[ucChannel][ulSecond] = SIMTEST_AggregateSample(ucChannel, ulSecond);
+         AGGREGATE_AddSample(ucChannel, ppulLocalSamples[ucChannel][ulSecond]);
+         }
+      }
+
+   SIMTEST_Check(ulCheck == sizeof(pulChecks) / sizeof(pulChecks[0]), "all %lu points checked", ulCheck);
+}
+
+
+/* ======================================================================== */
+/*  Wrap                                                                    */
+/* ======================================================================== */
+
+/****************************************************************************
+     Function: SIMTEST_WrapFired
+     Engineer: agent
+        Input: unsigned char ucTimer: Timer which expired.
+       Output: N/A
+  Description: Records a wrap test timer expiring. For the periodic timer
+               the largest error in its period is kept.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_WrapFired(unsigned char ucTimer)
+{
+   TySimTime ullPeriod;
+
+   if ((ucTimer == SIMTEST_WRAP_PERIODIC) && (pulLocalWrapFired[ucTimer] > 0))
+      {
+      ullPeriod = SIM_GetTime() - pullLocalWrapTimes[ucTimer];
+      ullPeriod = (ullPeriod > 1000ull * SIM_CYCLES_PER_MS) ? ullPeriod - (1000ull * SIM_CYCLES_PER_MS) : (1000ull * SIM_CYCLES_PER_MS) - ullPeriod;
+      if (ullPeriod > ulLocalWrapPeriodError)
+         ulLocalWrapPeriodError = (unsigned long)ullPeriod;
+      }
+
+   pulLocalWrapFired[ucTimer]++;
+   pullLocalWrapTimes[ucTimer] = SIM_GetTime();
+}
+
+static void SIMTEST_WrapBefore(void)   { SIMTEST_WrapFired(SIMTEST_WRAP_BEFORE); }
+static void SIMTEST_WrapAfter(void)    { SIMTEST_WrapFired(SIMTEST_WRAP_AFTER); }
+static void SIMTEST_WrapPeriodic(void) { SIMTEST_WrapFired(SIMTEST_WRAP_PERIODIC); }
+static void SIMTEST_WrapHistory(void)  { ulLocalWrapHistory++; }
+
+
+/****************************************************************************
+     Function: SIMTEST_WrapPPD42NJ
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Runs the PPD42NJ across the wrap of its second counter,
+               which starts 16 s before it. Each second's measurements must
+               be copied consistently, and the history notification must
+               still come every MAXIMUM_HISTORY_IN_SECONDS.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_WrapPPD42NJ(void)
+{
+   TyAirQualityMeasurements tyMeasurements;
+   TySimTime ullOrigin;
+   unsigned long ulSecond, ulBad;
+
+   SIMTEST_Boot();
+
+   if ((SIMTEST_Check(PPD42NJ_Initialise(), "PPD42NJ_Initialise") == FALSE) ||
+       (SIMTEST_Check(PPD42NJ_SetupNotifications(NOTIFICATION_MAX_HISTORY_UPDATE, SIMTEST_WrapHistory), "history notification set up") == FALSE))
+      return;
+
+   ullOrigin          = SIMHAL_GetTimerStart(TIMERA0_BASE, TIMER_A);
+   ulLocalWrapHistory = 0;
+   ulBad              = 0;
+
+   for (ulSecond=1; ulSecond <= 2 * MAXIMUM_HISTORY_IN_SECONDS; ulSecond++)
+      {
+      SIMTEST_PPD42NJRun(ullOrigin, ulSecond);
+
+      if ((PPD42NJ_GetAirQualityMeasurements(&tyMeasurements) == FALSE) || (tyMeasurements.ulSecondsElapsed != ulSecond))
+         ulBad++;
+      }
+
+   SIMTEST_Check(ulBad == 0, "PPD42NJ measurements across the second counter wrap: %lu of %lu bad", ulBad, ulSecond - 1);
+   SIMTEST_Check(ulLocalWrapHistory == 2, "PPD42NJ history notifications in %u s: %lu", 2 * MAXIMUM_HISTORY_IN_SECONDS, ulLocalWrapHistory);
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_Wrap
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Checks the 32 bit count arithmetic at the edges, then sleeps
+               through the wrap of the millisecond count, which starts a
+               minute before it, with software timers due either side of
+               it and a periodic one running. Each must expire on time and
+               in order, and the idle time must be measured across it.
+               The host has 64 bit longs, so this fails if a count is not
+               masked.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_Wrap(void)
+{
+   static const unsigned long pulDelays[SIMTEST_WRAP_TIMERS] = {59000, 60500, 1000}; // ms
+   static const TyTimerCallback ptyCallbacks[SIMTEST_WRAP_TIMERS] = {SIMTEST_WrapBefore, SIMTEST_WrapAfter, SIMTEST_WrapPeriodic};
+   TySimTime ullStart, ullExpected;
+   unsigned long ulMilliseconds, ulSleeps;
+   unsigned char i;
+
+   SIMTEST_Check(TIMER_WRAP(0xFFFFFFFFul + 1ul) == 0, "TIMER_WRAP(0xFFFFFFFF + 1) is 0");
+   SIMTEST_Check(TIMER_DIFF(5ul, 0xFFFFFFFBul) == 10, "TIMER_DIFF across the wrap is 10: %ld", TIMER_DIFF(5ul, 0xFFFFFFFBul));
+   SIMTEST_Check(TIMER_DIFF(0xFFFFFFFBul, 5ul) == -10, "TIMER_DIFF back across the wrap is -10: %ld", TIMER_DIFF(0xFFFFFFFBul, 5ul));
+   SIMTEST_Check(TIMER_DIFF(0x7FFFFFFFul, 0ul) == 0x7FFFFFFFl, "TIMER_DIFF largest positive");
+   SIMTEST_Check(TIMER_DIFF(0x80000000ul, 0ul) < 0, "TIMER_DIFF half way round is negative");
+
+   SIMTEST_Boot();
+   TIMER_GetIdlePercentage();
+
+   ulMilliseconds = TIMER_GetMilliseconds();
+   SIMTEST_Check(ulMilliseconds == TIMER_INITIAL_MILLISECONDS, "millisecond count starts at 0x%08lx: 0x%08lx", TIMER_INITIAL_MILLISECONDS, ulMilliseconds);
+
+   // Started in the same millisecond, so each is due in its delay plus
+   // one, less the part of the millisecond already gone. The wake from the
+   // tickless sleep may add a little....
+   ullStart = SIM_GetTime();
+   ulLocalWrapPeriodError = 0;
+   for (i=0; i < SIMTEST_WRAP_TIMERS; i++)
+      {
+      pulLocalWrapFired[i] = 0;
+      SIMTEST_Check(TIMER_Start(&ptyLocalWrapTimers[i], pulDelays[i], (i == SIMTEST_WRAP_PERIODIC) ? pulDelays[i] : 0, ptyCallbacks[i]), "timer %u started", i);
+      }
+
+   // Sleep as the scheduler does, until the timer after the wrap....
+   for (ulSleeps=0; (pulLocalWrapFired[SIMTEST_WRAP_AFTER] == 0) && (ulSleeps < 1000); ulSleeps++)
+      {
+      MAP_IntMasterDisable();
+      TIMER_Sleep();
+      MAP_IntMasterEnable();
+      }
+
+   for (i=SIMTEST_WRAP_BEFORE; i <= SIMTEST_WRAP_AFTER; i++)
+      {
+      ullExpected = ullStart + ((pulDelays[i] + 1) * SIM_CYCLES_PER_MS);
+      SIMTEST_Check((pulLocalWrapFired[i] == 1) && (pullLocalWrapTimes[i] >= ullExpected - SIM_CYCLES_PER_MS) && (pullLocalWrapTimes[i] <= ullExpected + (SIM_CYCLES_PER_MS / 10)),
+                    "timer due %lu ms on fired %lu times, last at %.3f ms", pulDelays[i], pulLocalWrapFired[i], (double)(pullLocalWrapTimes[i] - ullStart) / SIM_CYCLES_PER_MS);
+      }
+
+   SIMTEST_Check(pulLocalWrapFired[SIMTEST_WRAP_PERIODIC] == pulDelays[SIMTEST_WRAP_AFTER] / pulDelays[SIMTEST_WRAP_PERIODIC],
+                 "periodic timer fired %lu times", pulLocalWrapFired[SIMTEST_WRAP_PERIODIC]);
+   SIMTEST_Check(ulLocalWrapPeriodError < SIM_CYCLES_PER_MS, "periodic timer period out by %lu cycles", ulLocalWrapPeriodError);
+
+   ulMilliseconds = TIMER_WRAP(TIMER_INITIAL_MILLISECONDS + (unsigned long)((SIM_GetTime() - ullStart) / SIM_CYCLES_PER_MS));
+   SIMTEST_Check(TIMER_GetMilliseconds() == ulMilliseconds, "millisecond count wrapped to %lu: %lu", ulMilliseconds, TIMER_GetMilliseconds());
+   SIMTEST_Check(TIMER_GetIdlePercentage() >= 99, "idle across the wrap");
+
+   for (i=0; i < SIMTEST_WRAP_TIMERS; i++)
+      TIMER_Stop(&ptyLocalWrapTimers[i]);
+
+   SIMTEST_WrapPPD42NJ();
+}
+
+
+/* ======================================================================== */
+/*  UARTTX                                                                  */
+/* ======================================================================== */
+
+/****************************************************************************
+     Function: SIMTEST_UartTxFrame
+     Engineer: agent
+        Input: unsigned long ulWrite: Number of the write.
+               char *pcFrame: Filled with the write, null terminated.
+       Output: N/A
+  Description: Makes the text of a UARTTX test write. The writes vary in
+               length, and each ends in a newline.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_UartTxFrame(unsigned long ulWrite, char *pcFrame)
+{
+   unsigned long ulLength;
+
+   ulLength = sprintf(pcFrame, "<%03lu:", ulWrite);
+   memset(&pcFrame[ulLength], 'a' + (ulWrite % 26), 5 + ((ulWrite * 7) % 41));
+   ulLength += 5 + ((ulWrite * 7) % 41);
+   strcpy(&pcFrame[ulLength], ">\n");
+}
+
+
+/****************************************************************************
+     Function: SIMTEST_UartTx
+     Engineer: agent
+        Input: N/A
+       Output: N/A
+  Description: Writes to the console far faster than the UART can send,
+               with UARTTX_DROP_OLDEST, and checks that each write that
+               arrives is whole and that they arrive in order. The first
+               write, which is being sent when the buffer first fills, and
+               the last must both arrive.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_UartTx(void)
+{
+   char pcFrame[64], pcLine[128];
+   unsigned long ulWrite, ulLines, ulWhole;
+   long lLast, lWrite;
+
+   ptyLocalUartCapture = tmpfile();
+   if (SIMTEST_Check(ptyLocalUartCapture != NULL, "console capture file") == FALSE)
+      return;
+
+   SIMTEST_Boot();
+   UARTTX_Configure();
+   UARTTX_Initialise(UARTTX_DROP_OLDEST);
+
+   // A byte takes 87 us to send, so this overflows the buffer throughout....
+   for (ulWrite=0; ulWrite < SIMTEST_UARTTX_WRITES; ulWrite++)
+      {
+      SIMTEST_UartTxFrame(ulWrite, pcFrame);
+      UARTTX_WriteString(pcFrame);
+      SIM_Advance(SIMTEST_STEP_CYCLES * (ulWrite % 7));
+      }
+
+   UARTTX_WaitForIdle();
+   SIMTEST_Check(UARTTX_GetOverflows() > 0, "UARTTX overflows: %lu", UARTTX_GetOverflows());
+
+   rewind(ptyLocalUartCapture);
+   ulLines = 0;
+   ulWhole = 0;
+   lLast   = -1;
+   while (fgets(pcLine, sizeof(pcLine), ptyLocalUartCapture) != NULL)
+      {
+      ulLines++;
+
+      if ((sscanf(pcLine, "<%ld:", &lWrite) != 1) || (lWrite <= lLast) || (lWrite >= SIMTEST_UARTTX_WRITES))
+         {
+         SIMTEST_Check(FALSE, "UARTTX line %lu out of order: %s", ulLines, pcLine);
+         continue;
+         }
+
+      SIMTEST_UartTxFrame(lWrite, pcFrame);
+      if (strcmp(pcLine, pcFrame) == 0)
+         ulWhole++;
+      else
+         SIMTEST_Check(FALSE, "UARTTX write %ld cut: %s", lWrite, pcLine);
+
+      if (ulLines == 1)
+         SIMTEST_Check(lWrite == 0, "UARTTX first write arrived");
+      lLast = lWrite;
+      }
+
+   SIMTEST_Check((ulLines > 0) && (ulWhole == ulLines), "UARTTX %lu of %lu lines whole", ulWhole, ulLines);
+   SIMTEST_Check(lLast == SIMTEST_UARTTX_WRITES - 1, "UARTTX last write arrived");
+   SIMTEST_Check(ulLines < SIMTEST_UARTTX_WRITES, "UARTTX dropped %lu writes", SIMTEST_UARTTX_WRITES - ulLines);
+
+   fclose(ptyLocalUartCapture);
+   ptyLocalUartCapture = NULL;
+}
+
+
+static const TyTest ptyLocalTests[] =
+{
+   {"hdc1080",  SIMTEST_HDC1080},
+   {"tlc59116", SIMTEST_TLC59116},
+   {"ledanim",  SIMTEST_LedAnimation},
+   {"ppd42nj",  SIMTEST_PPD42NJ},
+   {"pulsewidth", SIMTEST_PulseWidth},
+   {"aggregate", SIMTEST_Aggregate},
+   {"wrap",     SIMTEST_Wrap},
+   {"uarttx",   SIMTEST_UartTx}
+};
+
+
+/****************************************************************************
+     Function: SIMTEST_Usage
+     Engineer: agent
+        Input: const char *pcName: Program name.
+       Output: N/A
+  Description: Prints the usage and exits.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+static void SIMTEST_Usage(const char *pcName)
+{
+   unsigned long i;
+
+   fprintf(stderr, "usage: %s [-t test] [-v]\n", pcName);
+   fprintf(stderr, "  -t ");
+   for (i=0; i < sizeof(ptyLocalTests) / sizeof(ptyLocalTests[0]); i++)
+      fprintf(stderr, "%s%s", (i == 0) ? " " : ", ", ptyLocalTests[i].pcName);
+   fprintf(stderr, " (default all)\n");
+   fprintf(stderr, "  -v  print every check\n");
+   exit(1);
+}
+
+
+int main(int argc, char **argv)
+{
+   int iOption;
+   unsigned long i, ulRun, ulChecks, ulFailures;
+   const char *pcTest;
+
+   pcTest        = NULL;
+   bLocalVerbose = FALSE;
+
+   while ((iOption = getopt(argc, argv, "t:v")) != -1)
+      {
+      switch (iOption)
+         {
+         case 't': pcTest        = optarg;                                   break;
+         case 'v': bLocalVerbose = TRUE;                                     break;
+         default:  SIMTEST_Usage(argv[0]);                                   break;
+         }
+      }
+
+   if (optind != argc)
+      SIMTEST_Usage(argv[0]);
+
+   ulRun = 0;
+   for (i=0; i < sizeof(ptyLocalTests) / sizeof(ptyLocalTests[0]); i++)
+      {
+      if ((pcTest != NULL) && (strcmp(pcTest, ptyLocalTests[i].pcName) != 0))
+         continue;
+
+      printf("%s:\n", ptyLocalTests[i].pcName);
+
+      ulChecks   = ulLocalChecks;
+      ulFailures = ulLocalFailures;
+      ptyLocalTests[i].Run();
+
+      printf("   %lu checks, %lu failed\n", ulLocalChecks - ulChecks, ulLocalFailures - ulFailures);
+      ulRun++;
+      }
+
+   if (ulRun == 0)
+      SIMTEST_Usage(argv[0]);
+
+   printf("\n%lu checks, %lu failed\n", ulLocalChecks, ulLocalFailures);
+
+   return (ulLocalFailures == 0) ? 0 : 1;
+}
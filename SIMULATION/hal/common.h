@@ -0,0 +1,14 @@
+/****************************************************************************
+       Module: common.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __COMMON__H__
+#define __COMMON__H__
+#define SUCCESS 0
+#define FAILURE -1
+#endif
@@ -0,0 +1,37 @@
+/****************************************************************************
+       Module: gpio.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __GPIO_H__
+#define __GPIO_H__
+#include "hw_types.h"
+#define GPIO_DIR_MODE_IN 0x00000000
+#define GPIO_DIR_MODE_OUT 0x00000001
+#define GPIO_FALLING_EDGE 0x00000000
+#define GPIO_RISING_EDGE 0x00000004
+#define GPIO_BOTH_EDGES 0x00000001
+#define GPIO_LOW_LEVEL 0x00000002
+#define GPIO_HIGH_LEVEL 0x00000006
+#define GPIO_INT_PIN_0 0x00000001
+#define GPIO_INT_PIN_1 0x00000002
+#define GPIO_INT_PIN_2 0x00000004
+#define GPIO_INT_PIN_3 0x00000008
+#define GPIO_INT_PIN_4 0x00000010
+#define GPIO_INT_PIN_5 0x00000020
+#define GPIO_INT_PIN_6 0x00000040
+#define GPIO_INT_PIN_7 0x00000080
+void GPIODirModeSet(unsigned long ulPort, unsigned char ucPins, unsigned long ulPinIO);
+void GPIOIntTypeSet(unsigned long ulPort, unsigned char ucPins, unsigned long ulIntType);
+long GPIOPinRead(unsigned long ulPort, unsigned char ucPins);
+void GPIOPinWrite(unsigned long ulPort, unsigned char ucPins, unsigned char ucVal);
+void GPIOIntEnable(unsigned long ulPort, unsigned long ulIntFlags);
+void GPIOIntDisable(unsigned long ulPort, unsigned long ulIntFlags);
+long GPIOIntStatus(unsigned long ulPort, tBoolean bMasked);
+void GPIOIntClear(unsigned long ulPort, unsigned long ulIntFlags);
+void GPIOIntRegister(unsigned long ulPort, void (*pfnIntHandler)(void));
+#endif
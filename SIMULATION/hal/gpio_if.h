@@ -0,0 +1,15 @@
+/****************************************************************************
+       Module: gpio_if.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __GPIOIF_H__
+#define __GPIOIF_H__
+void GPIO_IF_ConfigureNIntEnable(unsigned int uiGPIOPort, unsigned char ucGPIOPin, unsigned int uiIntType, void (*pfnIntHandler)(void));
+void GPIO_IF_Set(unsigned char ucPin, unsigned int uiGPIOPort, unsigned char ucGPIOPin, unsigned char ucGPIOValue);
+unsigned char GPIO_IF_Get(unsigned char ucPin, unsigned int uiGPIOPort, unsigned char ucGPIOPin);
+#endif
@@ -0,0 +1,9 @@
+/****************************************************************************
+       Module: hw_gpio.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
@@ -0,0 +1,29 @@
+/****************************************************************************
+       Module: hw_ints.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __HW_INTS_H__
+#define __HW_INTS_H__
+#define FAULT_SYSTICK 15
+#define INT_GPIOA0 16
+#define INT_GPIOA1 17
+#define INT_GPIOA2 18
+#define INT_GPIOA3 19
+#define INT_UARTA0 21
+#define INT_UARTA1 22
+#define INT_I2CA0 24
+#define INT_TIMERA0A 35
+#define INT_TIMERA0B 36
+#define INT_TIMERA1A 37
+#define INT_TIMERA1B 38
+#define INT_TIMERA2A 39
+#define INT_TIMERA2B 40
+#define INT_TIMERA3A 51
+#define INT_TIMERA3B 52
+#define INT_UDMA 62
+#endif
@@ -0,0 +1,17 @@
+/****************************************************************************
+       Module: hw_nvic.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __HW_NVIC_H__
+#define __HW_NVIC_H__
+#define NVIC_ST_CTRL 0xE000E010
+#define NVIC_ST_RELOAD 0xE000E014
+#define NVIC_ST_CURRENT 0xE000E018
+#define NVIC_INT_CTRL 0xE000ED04
+#define NVIC_INT_CTRL_PEND_SYST 0x04000000
+#endif
@@ -0,0 +1,19 @@
+/****************************************************************************
+       Module: hw_types.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __HW_TYPES_H__
+#define __HW_TYPES_H__
+#include <stdbool.h>
+#include <stdint.h>
+typedef unsigned char tBoolean;
+// Register accesses go through the simulation, which models the few
+// registers that the firmware accesses directly (see SIM_Register)....
+volatile unsigned long *SIM_Register(unsigned long ulAddress);
+#define HWREG(x) (*SIM_Register(x))
+#endif
@@ -0,0 +1,52 @@
+/****************************************************************************
+       Module: i2c.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __I2C_H__
+#define __I2C_H__
+#include "hw_types.h"
+#define I2C_MASTER_CMD_SINGLE_SEND 0x00000007
+#define I2C_MASTER_CMD_SINGLE_RECEIVE 0x00000007
+#define I2C_MASTER_CMD_BURST_SEND_START 0x00000003
+#define I2C_MASTER_CMD_BURST_SEND_CONT 0x00000001
+#define I2C_MASTER_CMD_BURST_SEND_FINISH 0x00000005
+#define I2C_MASTER_CMD_BURST_SEND_STOP 0x00000004
+#define I2C_MASTER_CMD_BURST_SEND_ERROR_STOP 0x00000004
+#define I2C_MASTER_CMD_BURST_RECEIVE_START 0x0000000b
+#define I2C_MASTER_CMD_BURST_RECEIVE_CONT 0x00000009
+#define I2C_MASTER_CMD_BURST_RECEIVE_FINISH 0x00000005
+#define I2C_MASTER_CMD_BURST_RECEIVE_ERROR_STOP 0x00000004
+#define I2C_MASTER_ERR_NONE 0
+#define I2C_MASTER_ERR_ADDR_ACK 0x00000004
+#define I2C_MASTER_ERR_DATA_ACK 0x00000008
+#define I2C_MASTER_ERR_ARB_LOST 0x00000010
+#define I2C_MASTER_INT_RX_FIFO_FULL 0x00000800
+#define I2C_MASTER_INT_TX_FIFO_EMPTY 0x00000400
+#define I2C_MASTER_INT_RX_FIFO_REQ 0x00000200
+#define I2C_MASTER_INT_TX_FIFO_REQ 0x00000100
+#define I2C_MASTER_INT_ARB_LOST 0x00000080
+#define I2C_MASTER_INT_STOP 0x00000040
+#define I2C_MASTER_INT_START 0x00000020
+#define I2C_MASTER_INT_NACK 0x00000010
+#define I2C_MASTER_INT_TX_DMA_DONE 0x00000008
+#define I2C_MASTER_INT_RX_DMA_DONE 0x00000004
+#define I2C_MASTER_INT_TIMEOUT 0x00000002
+#define I2C_MASTER_INT_DATA 0x00000001
+void I2CIntRegister(unsigned long ulBase, void (*pfnHandler)(void));
+void I2CMasterIntEnableEx(unsigned long ulBase, unsigned long ulIntFlags);
+void I2CMasterIntDisableEx(unsigned long ulBase, unsigned long ulIntFlags);
+unsigned long I2CMasterIntStatusEx(unsigned long ulBase, tBoolean bMasked);
+void I2CMasterIntClearEx(unsigned long ulBase, unsigned long ulIntFlags);
+void I2CMasterSlaveAddrSet(unsigned long ulBase, unsigned char ucSlaveAddr, tBoolean bReceive);
+void I2CMasterControl(unsigned long ulBase, unsigned long ulCmd);
+unsigned long I2CMasterErr(unsigned long ulBase);
+void I2CMasterDataPut(unsigned long ulBase, unsigned char ucData);
+unsigned long I2CMasterDataGet(unsigned long ulBase);
+tBoolean I2CMasterBusy(unsigned long ulBase);
+void I2CMasterTimeoutSet(unsigned long ulBase, unsigned long ulValue);
+#endif
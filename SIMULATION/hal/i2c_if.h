@@ -0,0 +1,19 @@
+/****************************************************************************
+       Module: i2c_if.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __I2C_IF_H__
+#define __I2C_IF_H__
+#define I2C_MASTER_MODE_STD 0
+#define I2C_MASTER_MODE_FST 1
+int I2C_IF_Open(unsigned long ulMode);
+int I2C_IF_Close(void);
+int I2C_IF_Write(unsigned char ucDevAddr, unsigned char *pucData, unsigned char ucLen, unsigned char ucStop);
+int I2C_IF_Read(unsigned char ucDevAddr, unsigned char *pucData, unsigned char ucLen);
+int I2C_IF_ReadFrom(unsigned char ucDevAddr, unsigned char *pucWrDataBuf, unsigned char ucWrLen, unsigned char *pucRdDataBuf, unsigned char ucRdLen);
+#endif
@@ -0,0 +1,26 @@
+/****************************************************************************
+       Module: interrupt.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __INTERRUPT_H__
+#define __INTERRUPT_H__
+#include "hw_types.h"
+tBoolean IntMasterEnable(void);
+tBoolean IntMasterDisable(void);
+void IntVTableBaseSet(unsigned long ulVtableBase);
+void IntRegister(unsigned long ulInterrupt, void (*pfnHandler)(void));
+void IntUnregister(unsigned long ulInterrupt);
+void IntEnable(unsigned long ulInterrupt);
+void IntDisable(unsigned long ulInterrupt);
+void IntPendSet(unsigned long ulInterrupt);
+void IntPrioritySet(unsigned long ulInterrupt, unsigned char ucPriority);
+#define INT_PRIORITY_LVL_0 0x00
+#define INT_PRIORITY_LVL_1 0x20
+#define INT_PRIORITY_LVL_2 0x40
+#define INT_PRIORITY_LVL_3 0x60
+#endif
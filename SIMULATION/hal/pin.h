@@ -0,0 +1,45 @@
+/****************************************************************************
+       Module: pin.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __PIN_H__
+#define __PIN_H__
+#include "hw_types.h"
+#define PIN_01 0x00000000
+#define PIN_02 0x00000001
+#define PIN_03 0x00000002
+#define PIN_04 0x00000003
+#define PIN_05 0x00000004
+#define PIN_06 0x00000005
+#define PIN_07 0x00000006
+#define PIN_08 0x00000007
+#define PIN_15 0x0000000E
+#define PIN_18 0x00000011
+#define PIN_21 0x00000014
+#define PIN_50 0x00000031
+#define PIN_53 0x00000034
+#define PIN_55 0x00000036
+#define PIN_57 0x00000038
+#define PIN_58 0x00000039
+#define PIN_59 0x0000003A
+#define PIN_60 0x0000003B
+#define PIN_61 0x0000003C
+#define PIN_62 0x0000003D
+#define PIN_63 0x0000003E
+#define PIN_64 0x0000003F
+#define PIN_MODE_0 0x00000000
+#define PIN_MODE_1 0x00000001
+#define PIN_MODE_3 0x00000003
+#define PIN_MODE_6 0x00000006
+#define PIN_MODE_12 0x0000000C
+void PinModeSet(unsigned long ulPin, unsigned long ulPinMode);
+void PinTypeGPIO(unsigned long ulPin, unsigned long ulPinMode, tBoolean bOpenDrain);
+void PinTypeUART(unsigned long ulPin, unsigned long ulPinMode);
+void PinTypeI2C(unsigned long ulPin, unsigned long ulPinMode);
+void PinTypeTimer(unsigned long ulPin, unsigned long ulPinMode);
+#endif
@@ -0,0 +1,33 @@
+/****************************************************************************
+       Module: prcm.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __PRCM_H__
+#define __PRCM_H__
+#define PRCM_RUN_MODE_CLK 0x00000001
+#define PRCM_SLP_MODE_CLK 0x00000100
+#define PRCM_DSLP_MODE_CLK 0x00010000
+#define PRCM_UARTA0 0x00000002
+#define PRCM_UARTA1 0x00000003
+#define PRCM_TIMERA0 0x00000004
+#define PRCM_TIMERA1 0x00000005
+#define PRCM_TIMERA2 0x00000006
+#define PRCM_TIMERA3 0x00000007
+#define PRCM_GPIOA0 0x00000008
+#define PRCM_GPIOA1 0x00000009
+#define PRCM_GPIOA2 0x0000000A
+#define PRCM_GPIOA3 0x0000000B
+#define PRCM_I2CA0 0x00000011
+#define PRCM_UDMA 0x00000013
+void PRCMCC3200MCUInit(void);
+void PRCMPeripheralClkEnable(unsigned long ulPeripheral, unsigned long ulClkFlags);
+void PRCMPeripheralClkDisable(unsigned long ulPeripheral, unsigned long ulClkFlags);
+void PRCMPeripheralReset(unsigned long ulPeripheral);
+unsigned long PRCMPeripheralClockGet(unsigned long ulPeripheral);
+void PRCMSleepEnter(void);
+#endif
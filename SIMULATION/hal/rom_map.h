@@ -0,0 +1,85 @@
+/****************************************************************************
+       Module: rom_map.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __ROM_MAP_H__
+#define __ROM_MAP_H__
+#define MAP_IntMasterEnable IntMasterEnable
+#define MAP_SysTickEnable SysTickEnable
+#define MAP_SysTickDisable SysTickDisable
+#define MAP_SysTickIntRegister SysTickIntRegister
+#define MAP_SysTickIntEnable SysTickIntEnable
+#define MAP_SysTickIntDisable SysTickIntDisable
+#define MAP_SysTickPeriodSet SysTickPeriodSet
+#define MAP_SysTickPeriodGet SysTickPeriodGet
+#define MAP_SysTickValueGet SysTickValueGet
+#define MAP_IntMasterDisable IntMasterDisable
+#define MAP_IntVTableBaseSet IntVTableBaseSet
+#define MAP_IntRegister IntRegister
+#define MAP_IntEnable IntEnable
+#define MAP_IntDisable IntDisable
+#define MAP_IntPendSet IntPendSet
+#define MAP_IntPrioritySet IntPrioritySet
+#define MAP_PRCMPeripheralClkEnable PRCMPeripheralClkEnable
+#define MAP_PRCMPeripheralClkDisable PRCMPeripheralClkDisable
+#define MAP_PRCMPeripheralReset PRCMPeripheralReset
+#define MAP_PRCMPeripheralClockGet PRCMPeripheralClockGet
+#define MAP_PRCMSleepEnter PRCMSleepEnter
+#define MAP_TimerEnable TimerEnable
+#define MAP_TimerDisable TimerDisable
+#define MAP_TimerConfigure TimerConfigure
+#define MAP_TimerControlEvent TimerControlEvent
+#define MAP_TimerControlStall TimerControlStall
+#define MAP_TimerPrescaleSet TimerPrescaleSet
+#define MAP_TimerLoadSet TimerLoadSet
+#define MAP_TimerLoadGet TimerLoadGet
+#define MAP_TimerValueGet TimerValueGet
+#define MAP_TimerMatchSet TimerMatchSet
+#define MAP_TimerIntRegister TimerIntRegister
+#define MAP_TimerIntEnable TimerIntEnable
+#define MAP_TimerIntDisable TimerIntDisable
+#define MAP_TimerIntStatus TimerIntStatus
+#define MAP_TimerIntClear TimerIntClear
+#define MAP_GPIODirModeSet GPIODirModeSet
+#define MAP_GPIOIntTypeSet GPIOIntTypeSet
+#define MAP_GPIOPinRead GPIOPinRead
+#define MAP_GPIOPinWrite GPIOPinWrite
+#define MAP_GPIOIntEnable GPIOIntEnable
+#define MAP_GPIOIntDisable GPIOIntDisable
+#define MAP_GPIOIntStatus GPIOIntStatus
+#define MAP_GPIOIntClear GPIOIntClear
+#define MAP_GPIOIntRegister GPIOIntRegister
+#define MAP_PinTypeTimer PinTypeTimer
+#define MAP_PinTypeGPIO PinTypeGPIO
+#define MAP_I2CIntRegister I2CIntRegister
+#define MAP_I2CMasterIntEnableEx I2CMasterIntEnableEx
+#define MAP_I2CMasterIntDisableEx I2CMasterIntDisableEx
+#define MAP_I2CMasterIntStatusEx I2CMasterIntStatusEx
+#define MAP_I2CMasterIntClearEx I2CMasterIntClearEx
+#define MAP_I2CMasterSlaveAddrSet I2CMasterSlaveAddrSet
+#define MAP_I2CMasterControl I2CMasterControl
+#define MAP_I2CMasterErr I2CMasterErr
+#define MAP_I2CMasterDataPut I2CMasterDataPut
+#define MAP_I2CMasterDataGet I2CMasterDataGet
+#define MAP_I2CMasterTimeoutSet I2CMasterTimeoutSet
+#define MAP_UARTConfigSetExpClk UARTConfigSetExpClk
+#define MAP_UARTCharPut UARTCharPut
+#define MAP_UARTCharPutNonBlocking UARTCharPutNonBlocking
+#define MAP_UARTSpaceAvail UARTSpaceAvail
+#define MAP_UARTIntRegister UARTIntRegister
+#define MAP_UARTIntEnable UARTIntEnable
+#define MAP_UARTIntDisable UARTIntDisable
+#define MAP_UARTIntStatus UARTIntStatus
+#define MAP_UARTIntClear UARTIntClear
+#define MAP_UARTFIFOLevelSet UARTFIFOLevelSet
+#define MAP_UARTTxIntModeSet UARTTxIntModeSet
+#define MAP_UtilsDelay UtilsDelay
+#define MAP_UARTBusy UARTBusy
+#define MAP_UARTCharsAvail UARTCharsAvail
+#define MAP_UARTCharGetNonBlocking UARTCharGetNonBlocking
+#endif
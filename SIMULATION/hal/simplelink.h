@@ -0,0 +1,40 @@
+/****************************************************************************
+       Module: simplelink.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMFLASH.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+17-OCT-2026    agent       Added sl_Stop.
+****************************************************************************/
+#ifndef __SIMPLELINK_H__
+#define __SIMPLELINK_H__
+typedef unsigned char _u8;
+typedef signed char _i8;
+typedef unsigned short _u16;
+typedef signed short _i16;
+typedef unsigned long _u32;
+typedef signed long _i32;
+typedef void (*P_INIT_CALLBACK)(_u32 Status);
+// The access mode and size are packed differently from the SDK, and
+// unpacked by SIMFLASH.c....
+#define FS_MODE_OPEN_READ 0x00000000
+#define FS_MODE_OPEN_WRITE 0x10000000
+#define FS_MODE_OPEN_CREATE(maxSizeInBytes, accessModeFlags) (0x20000000 | (((accessModeFlags) & 0xFF) << 20) | ((maxSizeInBytes) & 0xFFFFF))
+#define FS_MODE_ACCESS(mode) (((mode) >> 28) & 0xF)
+#define FS_MODE_SIZE(mode) ((mode) & 0xFFFFF)
+#define _FS_FILE_PUBLIC_WRITE 0x20
+typedef struct SlWlanEvent_t SlWlanEvent_t;
+typedef struct SlNetAppEvent_t SlNetAppEvent_t;
+typedef struct SlHttpServerEvent_t SlHttpServerEvent_t;
+typedef struct SlHttpServerResponse_t SlHttpServerResponse_t;
+typedef struct SlDeviceEvent_t SlDeviceEvent_t;
+typedef struct SlSockEvent_t SlSockEvent_t;
+_i16 sl_Start(const void *pIfHdl, _i8 *pDevName, const P_INIT_CALLBACK pInitCallBack);
+_i16 sl_Stop(const _u16 timeout);
+_i32 sl_FsOpen(const _u8 *pFileName, const _u32 AccessModeAndMaxSize, _u32 *pToken, _i32 *pFileHandle);
+_i16 sl_FsClose(const _i32 FileHdl, const _u8 *pCeritificateFileName, const _u8 *pSignature, const _u32 SignatureLen);
+_i32 sl_FsRead(const _i32 FileHdl, _u32 Offset, _u8 *pData, _u32 Len);
+_i32 sl_FsWrite(const _i32 FileHdl, _u32 Offset, _u8 *pData, _u32 Len);
+#endif
@@ -0,0 +1,20 @@
+/****************************************************************************
+       Module: systick.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __SYSTICK_H__
+#define __SYSTICK_H__
+void SysTickEnable(void);
+void SysTickDisable(void);
+void SysTickIntRegister(void (*pfnHandler)(void));
+void SysTickIntEnable(void);
+void SysTickIntDisable(void);
+void SysTickPeriodSet(unsigned long ulPeriod);
+unsigned long SysTickPeriodGet(void);
+unsigned long SysTickValueGet(void);
+#endif
@@ -0,0 +1,24 @@
+/****************************************************************************
+       Module: timer_if.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __TIMER_IF_H__
+#define __TIMER_IF_H__
+#define SYS_CLK 80000000
+#define MILLISECONDS_TO_TICKS(ms) ((SYS_CLK/1000) * (ms))
+#define PERIODIC_TEST_CYCLES 80000000
+#define PERIODIC_TEST_COUNT 2
+void Timer_IF_Init(unsigned long ePeripheralc, unsigned long ulBase, unsigned long ulConfig, unsigned long ulTimer, unsigned long ulValue);
+void Timer_IF_IntSetup(unsigned long ulBase, unsigned long ulTimer, void (*TimerBaseIntHandler)(void));
+void Timer_IF_InterruptClear(unsigned long ulBase);
+void Timer_IF_Start(unsigned long ulBase, unsigned long ulTimer, unsigned long ulValue);
+void Timer_IF_Stop(unsigned long ulBase, unsigned long ulTimer);
+void Timer_IF_ReLoad(unsigned long ulBase, unsigned long ulTimer, unsigned long ulValue);
+unsigned int Timer_IF_GetCount(unsigned long ulBase, unsigned long ulTimer);
+void Timer_IF_DeInit(unsigned long ulBase, unsigned long ulTimer);
+#endif
@@ -0,0 +1,39 @@
+/****************************************************************************
+       Module: uart.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __UART_H__
+#define __UART_H__
+#include "hw_types.h"
+#define UART_INT_TX 0x020
+#define UART_INT_RX 0x010
+#define UART_FIFO_TX1_8 0x00000000
+#define UART_FIFO_TX2_8 0x00000001
+#define UART_FIFO_TX4_8 0x00000002
+#define UART_FIFO_RX4_8 0x00000010
+#define UART_CONFIG_WLEN_8 0x00000060
+#define UART_CONFIG_STOP_ONE 0x00000000
+#define UART_CONFIG_PAR_NONE 0x00000000
+void UARTConfigSetExpClk(unsigned long ulBase, unsigned long ulUARTClk, unsigned long ulBaud, unsigned long ulConfig);
+void UARTCharPut(unsigned long ulBase, unsigned char ucData);
+tBoolean UARTCharPutNonBlocking(unsigned long ulBase, unsigned char ucData);
+tBoolean UARTSpaceAvail(unsigned long ulBase);
+tBoolean UARTBusy(unsigned long ulBase);
+tBoolean UARTCharsAvail(unsigned long ulBase);
+long UARTCharGetNonBlocking(unsigned long ulBase);
+void UARTIntRegister(unsigned long ulBase, void (*pfnHandler)(void));
+void UARTIntEnable(unsigned long ulBase, unsigned long ulIntFlags);
+void UARTIntDisable(unsigned long ulBase, unsigned long ulIntFlags);
+unsigned long UARTIntStatus(unsigned long ulBase, tBoolean bMasked);
+void UARTIntClear(unsigned long ulBase, unsigned long ulIntFlags);
+void UARTFIFOLevelSet(unsigned long ulBase, unsigned long ulTxLevel, unsigned long ulRxLevel);
+void UARTFIFOEnable(unsigned long ulBase);
+void UARTTxIntModeSet(unsigned long ulBase, unsigned long ulMode);
+#define UART_TXINT_MODE_FIFO 0x00000000
+#define UART_TXINT_MODE_EOT 0x00000010
+#endif
@@ -0,0 +1,16 @@
+/****************************************************************************
+       Module: uart_if.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __uart_if_h__
+#define __uart_if_h__
+#define UART_BAUD_RATE 115200
+#define SYSCLK 80000000
+#define CONSOLE UARTA0_BASE
+#define CONSOLE_PERIPH PRCM_UARTA0
+#endif
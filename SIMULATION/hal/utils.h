@@ -0,0 +1,13 @@
+/****************************************************************************
+       Module: utils.h
+     Engineer: agent
+  Description: Simulation stand-in for the CC3200 SDK header of the same name.
+               Only what the firmware uses is declared, and it is
+               implemented by SIMHAL.c.
+Date           Initials    Description
+17-OCT-2026    agent       Initial
+****************************************************************************/
+#ifndef __UTILS_H__
+#define __UTILS_H__
+void UtilsDelay(unsigned long ulCount);
+#endif
@@ -0,0 +1,360 @@
+#!/usr/bin/env python3
+#
+# Reports the memory used by the firmware against a budget.
+#
+# Usage:
+#    memory_budget.py [FIRMWARE.map] [-c callgraph_dir] [budget options]
+#
+# The map written by the CCS linker gives the .text, .const, .data and .bss
+# of each module, and the heap (.sysmem) and stack sizes. These are checked
+# against the SRAM_CODE and SRAM_DATA regions, or the budgets given. With
+# --sources, the map must have been linked from those sources: a map that
+# is older than one of them, or has no object for one, is stale and is
+# not reported against.
+#
+# The worst case stack use is estimated from the call graph written by gcc
+# with -fcallgraph-info=su (see the budget target of SIMULATION/Makefile),
+# as the TI compiler does not report it. The frames are those of the host
+# build, so the figure is a guide rather than exact. The deepest call chain
+# from main is added to the deepest interrupt handler (the handlers are all
+# at the same priority, so do not nest) and the exception frame.
+#
+# Indirect calls are resolved by kind (see INDIRECT_KINDS): the functions
+# registered with the scheduler are called from SCHEDULER_Run, the timer
+# callbacks from the SysTick interrupt, and so on. The registrations are
+# found in the sources given with --sources. The chains printed name the
+# functions reached through them.
+#
+# Calls out of the firmware (driverlib) are allowed --external-frame bytes,
+# and calls into the SimpleLink host driver (sl_*) --simplelink-frame bytes,
+# as neither is in the call graph.
+#
+# The exit status is 1 if anything is over budget.
+
+import argparse
+import glob
+import os
+import re
+import sys
+
+# Exception frame stacked by the Cortex-M4 on interrupt entry: 8 words, as
+# the CC3200 has no floating point unit....
+EXCEPTION_FRAME = 32
+
+MAP_REGION = re.compile(r'^\s+(\w+)\s+([0-9a-f]{8})\s+([0-9a-f]{8})\s+([0-9a-f]{8})\s+([0-9a-f]{8})\s')
+MAP_OUTPUT = re.compile(r'^(\.\w+)\s+\d+\s+[0-9a-f]{8}\s+([0-9a-f]{8})')
+MAP_INPUT = re.compile(r'^\s+[0-9a-f]{8}\s+([0-9a-f]{8})\s+(.*)$')
+
+CI_NODE = re.compile(r'^node: \{ title: "([^"]+)" label: "([^"]*)"')
+CI_EDGE = re.compile(r'^edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+CI_BYTES = re.compile(r'\\n(\d+) bytes \(([^)]*)\)')
+
+INDIRECT = '__indirect_call'
+
+# Kinds of indirect call: the functions that make the call, and how the
+# functions they call are registered, as the names of the functions they
+# are passed to and / or a pattern matching an assignment of one....
+INDIRECT_KINDS = [
+    ('scheduler handler', ['SCHEDULER_Run'], ['SCHEDULER_Post'], None),
+    ('timer callback', ['DELAY_SysTickInterrupt'], ['TIMER_Start'], None),
+    ('I2C completion', ['I2CQUEUE_Complete'], [], r'[Tt]ransaction\.tyCallback\s*=\s*(\w+)'),
+    ('HDC1080 callback', ['HDC1080_FinishRead'],
+     ['HDC1080_ReadTemperatureAsync', 'HDC1080_ReadHumidityAsync', 'HDC1080_ReadTemperatureAndHumidityAsync'], None),
+    ('TLC59116 write callback', ['TLC59116_WriteComplete'], ['TLC59116_QueueWrite'], None),
+    ('TLC59116 commit callback', ['TLC59116_CommitWriteComplete', 'TLC59116_CommitAsync'], ['TLC59116_CommitAsync'], None),
+    ('PPD42NJ notification', ['PPD42NJ_ProcessNotifications'], ['PPD42NJ_SetupNotifications'], None),
+]
+
+SIMPLELINK = re.compile(r'^sl_')
+
+SECTIONS = ['.text', '.const', '.data', '.bss']
+
+
+def read_map(path):
+    """Returns (regions, section totals, {module: {section: bytes}})."""
+    regions = {}
+    totals = {}
+    modules = {}
+    output = None
+    library = None
+    in_sections = False
+
+    for line in open(path, errors='replace'):
+        line = line.rstrip()
+        match = MAP_REGION.match(line)
+        if match and not in_sections:
+            regions[match.group(1)] = (int(match.group(3), 16), int(match.group(4), 16))
+            continue
+        if line.startswith('SECTION ALLOCATION MAP'):
+            in_sections = True
+            continue
+        if not in_sections:
+            continue
+        if line.startswith('MODULE SUMMARY') or line.startswith('LINKER GENERATED'):
+            break
+
+        match = MAP_OUTPUT.match(line)
+        if match:
+            output = match.group(1)
+            totals[output] = int(match.group(2), 16)
+            continue
+        match = MAP_INPUT.match(line)
+        if not match or output is None:
+            continue
+
+        length = int(match.group(1), 16)
+        source = match.group(2).strip()
+        if source.startswith('--HOLE--'):
+            continue
+        if source.startswith('('):
+            # Common symbols and linker generated tables have no module....
+            module = '(linker)' if source.startswith('(.cinit') or source.startswith('(__TI') else '(common)'
+        else:
+            source = re.sub(r'\s*\(.*\)$', '', source)
+            if ':' in source:
+                name, obj = [part.strip() for part in source.split(':', 1)]
+                if name:
+                    library = name
+                module = '%s:%s' % (library, obj)
+            else:
+                module = source
+                library = None
+
+        section = output if output in SECTIONS else None
+        if section is None:
+            continue
+        modules.setdefault(module, {})
+        modules[module][section] = modules[module].get(section, 0) + length
+
+    return regions, totals, modules
+
+
+def stale_map(path, modules, directory):
+    """Returns why the map is out of date with the sources, or None."""
+    objects = set(module.rsplit(':', 1)[-1] for module in modules)
+    linked = os.path.getmtime(path)
+    sources = sorted(glob.glob(os.path.join(directory, '*.c')))
+    if not sources:
+        return 'no .c files in %s' % directory
+
+    missing = [os.path.basename(s) for s in sources
+               if os.path.splitext(os.path.basename(s))[0] + '.obj' not in objects]
+    if missing:
+        return 'it has no object for %s' % ', '.join(missing)
+    newer = [os.path.basename(s) for s in sources if os.path.getmtime(s) > linked]
+    if newer:
+        return '%s changed since it was linked' % ', '.join(newer)
+    return None
+
+
+def read_callgraph(directory):
+    """Returns ({function: frame bytes}, {function: set of callees})."""
+    frames = {}
+    calls = {}
+    files = glob.glob(os.path.join(directory, '*.ci'))
+    if not files:
+        raise ValueError('no .ci files in %s' % directory)
+
+    for path in files:
+        for line in open(path):
+            match = CI_NODE.match(line)
+            if match:
+                size = CI_BYTES.search(match.group(2))
+                if size:
+                    frames[match.group(1)] = int(size.group(1))
+                    if 'dynamic' in size.group(2) and 'bounded' not in size.group(2):
+                        sys.stderr.write('warning: %s has a dynamic stack frame\n' % match.group(1))
+                continue
+            match = CI_EDGE.match(line)
+            if match:
+                calls.setdefault(match.group(1), set()).add(match.group(2))
+
+    return frames, calls
+
+
+def short_name(function):
+    """Static functions are titled file:function."""
+    return function.rsplit(':', 1)[-1]
+
+
+def call_arguments(text, position):
+    """Returns the argument list of the call whose ( is at position."""
+    depth = 0
+    for end in range(position, len(text)):
+        if text[end] == '(':
+            depth += 1
+        elif text[end] == ')':
+            depth -= 1
+            if depth == 0:
+                return text[position + 1:end]
+    return text[position + 1:]
+
+
+def indirect_targets(frames, directory):
+    """Returns {caller: set of functions called indirectly}, by kind."""
+    titles = {}
+    for function in frames:
+        titles.setdefault(short_name(function), []).append(function)
+
+    sources = sorted(glob.glob(os.path.join(directory, '*.c')))
+    if not sources:
+        raise ValueError('no .c files in %s' % directory)
+    text = ''
+    for path in sources:
+        source = open(path, errors='replace').read()
+        source = re.sub(r'/\*.*?\*/', ' ', source, flags=re.S)
+        text += re.sub(r'//[^\n]*', ' ', source) + '\n'
+
+    targets = {}
+    for kind, callers, registrations, assignment in INDIRECT_KINDS:
+        names = set()
+        for registration in registrations:
+            for match in re.finditer(r'\b%s\s*\(' % registration, text):
+                arguments = call_arguments(text, match.end() - 1)
+                # Functions passed, rather than called....
+                names.update(re.findall(r'\b(\w+)\b(?!\s*\()', arguments))
+        if assignment:
+            names.update(re.findall(assignment, text))
+
+        found = set(f for name in names for f in titles.get(name, ()))
+        if not found:
+            raise ValueError('no %s is registered' % kind)
+        for caller in callers:
+            for function in titles.get(caller, ()):
+                targets.setdefault(function, set()).update(found)
+
+    return targets
+
+
+def deepest(function, frames, calls, targets, args, memo, active):
+    """Returns (bytes, chain) of the deepest call chain from a function."""
+    if function in memo:
+        return memo[function]
+    if function in active:
+        raise ValueError('recursion through %s' % short_name(function))
+    if function not in frames:
+        # Outside the firmware (driverlib, SimpleLink), or a stand-in of it....
+        if SIMPLELINK.match(short_name(function)):
+            return args.simplelink_frame, [short_name(function)]
+        return args.external_frame, [short_name(function)]
+
+    active.add(function)
+    best = (0, [])
+    for callee in calls.get(function, ()):
+        if callee == INDIRECT:
+            if function not in targets:
+                raise ValueError('indirect call in %s is not of a known kind' % short_name(function))
+            callees = targets[function]
+        else:
+            callees = [callee]
+        for target in callees:
+            result = deepest(target, frames, calls, targets, args, memo, active)
+            if result[0] > best[0]:
+                best = result
+    active.discard(function)
+
+    memo[function] = (frames[function] + best[0], [short_name(function)] + best[1])
+    return memo[function]
+
+
+def stack_estimate(frames, calls, args):
+    """Returns the (thread, interrupt) worst cases as (bytes, chain)."""
+    called = set()
+    for callees in calls.values():
+        called.update(callees)
+
+    roots = [f for f in frames if f not in called]
+    threads = [f for f in roots if short_name(f) in ('main', 'FIRMWARE_Main')]
+    interrupts = [f for f in roots if re.search(args.interrupt, short_name(f))]
+    if not threads:
+        raise ValueError('main is not in the call graph')
+
+    targets = indirect_targets(frames, args.sources)
+
+    memo = {}
+    thread = max((deepest(f, frames, calls, targets, args, memo, set()) for f in threads),
+                 key=lambda result: result[0])
+    interrupt = max((deepest(f, frames, calls, targets, args, memo, set()) for f in interrupts),
+                    key=lambda result: result[0], default=(0, []))
+    return thread, interrupt
+
+
+def check(label, used, budget, failures):
+    """Prints a line of the budget and notes whether it is exceeded."""
+    if used > budget:
+        failures.append(label)
+    percent = '%5.1f %%' % (100.0 * used / budget) if budget else '    - '
+    print('%-28s %8d of %8d bytes  %s  %s' % (label, used, budget, percent, 'ok' if used <= budget else 'OVER'))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Reports the firmware memory use against a budget.')
+    parser.add_argument('map', nargs='?', help='map file written by the CCS linker')
+    parser.add_argument('-c', '--callgraph', help='directory of gcc -fcallgraph-info=su .ci files')
+    parser.add_argument('-s', '--sources', help='directory of the firmware sources, which the map must be linked from')
+    parser.add_argument('--code-budget', type=lambda v: int(v, 0), help='bytes (default SRAM_CODE)')
+    parser.add_argument('--data-budget', type=lambda v: int(v, 0), help='bytes of .data, .bss, heap and stack (default SRAM_DATA)')
+    parser.add_argument('--heap-budget', type=lambda v: int(v, 0), default=0, help='bytes (default 0)')
+    parser.add_argument('--stack-budget', type=lambda v: int(v, 0), help='bytes (default the .stack size in the map, or 0x1000)')
+    parser.add_argument('--interrupt', default=r'Interrupt$', help='pattern matching the interrupt handlers')
+    parser.add_argument('--external-frame', type=int, default=32, help='bytes allowed for a call outside the firmware (default 32)')
+    parser.add_argument('--simplelink-frame', type=int, default=512, help='bytes allowed for a SimpleLink call (default 512)')
+    args = parser.parse_args()
+
+    if args.map is None and args.callgraph is None:
+        parser.error('give a map file and / or a call graph directory')
+    if args.callgraph and args.sources is None:
+        parser.error('the call graph needs the sources (-s), for the indirect calls')
+
+    failures = []
+    totals = {}
+
+    if args.map:
+        if not os.path.isfile(args.map):
+            sys.exit('error: no map file at %s, build the firmware in CCS first' % args.map)
+        regions, totals, modules = read_map(args.map)
+        reason = stale_map(args.map, modules, args.sources) if args.sources else None
+        if reason:
+            sys.exit('error: %s is stale (%s), rebuild the firmware in CCS first' % (args.map, reason))
+
+        print('%-44s %8s %8s %8s %8s' % ('module', '.text', '.const', '.data', '.bss'))
+        order = sorted(modules, key=lambda m: (-(modules[m].get('.data', 0) + modules[m].get('.bss', 0)),
+                                               -modules[m].get('.text', 0), m))
+        for module in order:
+            sizes = modules[module]
+            print('%-44s %8d %8d %8d %8d' % (module[-44:], *(sizes.get(s, 0) for s in SECTIONS)))
+        print('%-44s %8d %8d %8d %8d' % ('total', *(totals.get(s, 0) for s in SECTIONS)))
+        print()
+
+        code = sum(totals.get(s, 0) for s in ('.intvecs', '.text', '.const', '.cinit', '.init_array', '.vtable', '.pinit'))
+        data = sum(totals.get(s, 0) for s in ('.data', '.bss', '.sysmem', '.stack'))
+        code_budget = args.code_budget if args.code_budget is not None else regions.get('SRAM_CODE', (0, 0))[0]
+        data_budget = args.data_budget if args.data_budget is not None else regions.get('SRAM_DATA', (0, 0))[0]
+
+        check('SRAM_CODE', code, code_budget, failures)
+        check('SRAM_DATA', data, data_budget, failures)
+        check('heap (.sysmem)', totals.get('.sysmem', 0), args.heap_budget, failures)
+
+    if args.callgraph:
+        frames, calls = read_callgraph(args.callgraph)
+        try:
+            thread, interrupt = stack_estimate(frames, calls, args)
+        except ValueError as error:
+            print('stack: unbounded (%s)' % error)
+            failures.append('stack')
+        else:
+            worst = thread[0] + interrupt[0] + EXCEPTION_FRAME
+            stack_budget = args.stack_budget if args.stack_budget is not None else totals.get('.stack', 0x1000)
+            print()
+            print('stack, main:                 %6d bytes  %s' % (thread[0], ' > '.join(thread[1])))
+            print('stack, interrupt:            %6d bytes  %s' % (interrupt[0], ' > '.join(interrupt[1])))
+            print('exception frame:             %6d bytes' % EXCEPTION_FRAME)
+            check('stack (host estimate)', worst, stack_budget, failures)
+
+    if failures:
+        print('\nover budget: %s' % ', '.join(failures))
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+#
+# Decodes the binary telemetry frames sent by the firmware on the console
+# UART (see FIRMWARE/TELEMETRY.c) and writes the samples as CSV.
+#
+# Usage:
+#    telemetry_decode.py [input] [-o output.csv]
+#
+# The input is a capture of the serial stream (or a serial device, e.g.
+# /dev/ttyUSB0 already set to 115200 baud); stdin is used if it is not
+# given. Text messages between frames are written to stderr, as are frames
+# with a bad CRC and gaps in the sequence numbers.
+
+import argparse
+import struct
+import sys
+
+FRAME_VERSION = 3
+HEADER = struct.Struct('<BHB')
+SAMPLE = struct.Struct('<LhHLLLLLLBHH')
+CRC_SIZE = 2
+
+COLUMNS = ['timestamp_s', 'temperature_c', 'humidity_pc', 'p1_low_us',
+           'p2_low_us', 'p1_hour_low_us', 'p2_hour_low_us', 'pm25_ugm3',
+           'pm10_ugm3', 'idle_pc', 'max_latency_ms',
+           'flashlog_failures']
+
+
+def crc16(data):
+    """CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF)."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            if crc & 0x8000:
+                crc = ((crc << 1) ^ 0x1021) & 0xFFFF
+            else:
+                crc = (crc << 1) & 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    """Returns the decoded bytes, or None if the data is not valid COBS."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def decode_frame(frame):
+    """Returns (sequence, samples) or raises ValueError."""
+    if len(frame) < HEADER.size + CRC_SIZE:
+        raise ValueError('short frame')
+    body, crc = frame[:-CRC_SIZE], struct.unpack('<H', frame[-CRC_SIZE:])[0]
+    if crc16(body) != crc:
+        raise ValueError('bad CRC')
+    version, sequence, count = HEADER.unpack_from(body)
+    if version != FRAME_VERSION:
+        raise ValueError('unknown version %d' % version)
+    if len(body) != HEADER.size + count * SAMPLE.size:
+        raise ValueError('bad length')
+    samples = [SAMPLE.unpack_from(body, HEADER.size + n * SAMPLE.size)
+               for n in range(count)]
+    return sequence, samples
+
+
+def format_sample(sample):
+    (timestamp, temperature, humidity, p1, p2, p1_hour, p2_hour, pm25, pm10,
+     idle, latency, flashlog_failures) = sample
+    return '%d,%.2f,%.2f,%d,%d,%d,%d,%.2f,%.2f,%d,%d,%d' % (
+        timestamp, temperature / 100.0, humidity / 100.0, p1, p2, p1_hour,
+        p2_hour, pm25 / 100.0, pm10 / 100.0, idle, latency,
+        flashlog_failures)
+
+
+def chunks(stream):
+    """Yields the bytes between zero delimiters."""
+    pending = bytearray()
+    while True:
+        block = stream.read1(4096) if hasattr(stream, 'read1') else stream.read(4096)
+        if not block:
+            break
+        pending += block
+        while True:
+            end = pending.find(b'\x00')
+            if end < 0:
+                break
+            if end > 0:
+                yield bytes(pending[:end])
+            del pending[:end + 1]
+    if pending:
+        yield bytes(pending)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decodes the firmware telemetry frames to CSV.')
+    parser.add_argument('input', nargs='?', help='capture file or serial device')
+    parser.add_argument('-o', '--output', help='CSV file (default stdout)')
+    args = parser.parse_args()
+
+    source = open(args.input, 'rb') if args.input else sys.stdin.buffer
+    output = open(args.output, 'w') if args.output else sys.stdout
+
+    output.write(','.join(COLUMNS) + '\n')
+    expected = None
+
+    for chunk in chunks(source):
+        frame = cobs_decode(chunk)
+        try:
+            if frame is None:
+                raise ValueError('bad encoding')
+            sequence, samples = decode_frame(frame)
+        except ValueError as error:
+            text = chunk.decode('ascii', 'replace').strip()
+            if text and all(c.isprintable() or c.isspace() for c in text):
+                sys.stderr.write('text: %s\n' % text)
+            else:
+                sys.stderr.write('dropped frame: %s\n' % error)
+            continue
+
+        if expected is not None and sequence != expected:
+            sys.stderr.write('sequence gap: expected %d, got %d\n' % (expected, sequence))
+        expected = (sequence + 1) & 0xFFFF
+
+        for sample in samples:
+            output.write(format_sample(sample) + '\n')
+        output.flush()
+
+
+if __name__ == '__main__':
+    main()